@@ -53,6 +53,7 @@ init_command_line_settings(App_Settings *settings, Plat_Settings *plat_settings,
                                 case 'f': action = CLAct_FontSize; break;
                                 case 'h': action = CLAct_FontUseHinting; --i; break;
                                 case 'U': action = CLAct_UserDirectory; break;
+                                case 'l': action = CLAct_LogFile; break;
                                 
                                 case 'L': action = CLAct_Nothing; break;
                                 //case 'L': enables log, parsed before this is called (because I'm a dumbass)
@@ -149,6 +150,14 @@ init_command_line_settings(App_Settings *settings, Plat_Settings *plat_settings,
                         }
                         action = CLAct_Nothing;
                     }break;
+                    
+                    case CLAct_LogFile:
+                    {
+                        if (i < argc){
+                            settings->log_file_name = argv[i];
+                        }
+                        action = CLAct_Nothing;
+                    }break;
                 }
             }break;
             
@@ -204,6 +213,7 @@ App_Init_Sig(app_init){
     Models *models = (Models*)base_ptr;
     models->keep_playing = true;
     models->hard_exit = false;
+    models->layout_cache_budget = MB(8);
     
     models->config_api = api;
     models->virtual_event_arena = make_arena_system();
@@ -313,7 +323,7 @@ App_Init_Sig(app_init){
         }
         
         File_Attributes attributes = {};
-        file_create_from_string(tctx, models, file, SCu8(), attributes);
+        file_create_from_string(tctx, models, file, SCu8(), attributes, TextStorage_GapBuffer);
         if (init_files[i].read_only){
             file->settings.read_only = true;
             history_free(tctx, &file->state.history);
@@ -325,6 +335,16 @@ App_Init_Sig(app_init){
     
     models->begin_buffer = begin_buffer_func;
     
+    // NOTE(allen): start the log file over, log_flush streams to it from here on
+    if (models->settings.log_file_name != 0){
+        Scratch_Block scratch(tctx);
+        String_Const_u8 file_name = SCu8(models->settings.log_file_name);
+        system_save_file(scratch, models->settings.log_file_name, SCu8());
+        String_Const_u8 note = push_u8_stringf(scratch, "the log is written to %.*s\n",
+                                               string_expand(file_name));
+        output_file_append(tctx, models, models->log_buffer, note);
+    }
+    
     // NOTE(allen): setup first panel
     {
         Panel *panel = layout_initialize(arena, &models->layout);
@@ -339,6 +359,19 @@ App_Step_Sig(app_step){
     Mutex_Lock file_order_lock(models->working_set.mutex);
     Scratch_Block scratch(tctx);
     
+    // NOTE(allen): files that changed on disk copy their text out of the mapping
+    // before anything reads them this frame, the mapping no longer shows what the
+    // buffer was loaded from.  They are kept from saving until they are reopened.
+    {
+        Working_Set *working_set = &models->working_set;
+        for (Node *node = working_set->has_external_mod_sentinel.next;
+             node != &working_set->has_external_mod_sentinel;
+             node = node->next){
+            Editing_File *file = CastFromMember(Editing_File, external_mod_node, node);
+            file_detach_mapping(tctx, file);
+        }
+    }
+    
     models->next_animate_delay = max_u32;
     models->animate_next_frame = false;
     
@@ -350,8 +350,8 @@ buffer_seek_character_class(Application_Links *app, Buffer_ID buffer, Character_
             // really tedious stuff.  Anyway, this is all just to say, cleaning this up would be really nice, but
             // there are almost certainly lower hanging fruit with higher payoffs elsewhere... unless need to change
             // this anyway or whatever.
-            String_Const_u8 chunk_mem[3] = {};
-            String_Const_u8_Array chunks = {chunk_mem};
+            String_Const_u8_Array chunks = {};
+            chunks.vals = push_array(scratch, String_Const_u8, chunks_list.node_count);
             for (Node_String_Const_u8 *node = chunks_list.first;
                  node != 0;
                  node = node->next){
@@ -710,6 +710,30 @@ buffer_clear_layout_cache(Application_Links *app, Buffer_ID buffer_id){
     return(result);
 }
 
+api(custom) function Layout_Cache_Stats
+buffer_get_layout_cache_stats(Application_Links *app, Buffer_ID buffer_id){
+    Models *models = (Models*)app->cmd_context;
+    Editing_File *file = imp_get_file(models, buffer_id);
+    Layout_Cache_Stats result = {};
+    if (api_check_buffer(file)){
+        result = file->state.layout_cache.stats;
+        result.byte_budget = models->layout_cache_budget;
+    }
+    return(result);
+}
+
+api(custom) function void
+set_layout_cache_budget(Application_Links *app, u64 bytes_per_buffer){
+    Models *models = (Models*)app->cmd_context;
+    models->layout_cache_budget = bytes_per_buffer;
+    for (Node *node = models->working_set.active_file_sentinel.next;
+         node != &models->working_set.active_file_sentinel;
+         node = node->next){
+        Editing_File *file = CastFromMember(Editing_File, main_chain_node, node);
+        layout_cache_trim(&file->state.layout_cache, bytes_per_buffer, 0);
+    }
+}
+
 api(custom) function Layout_Function*
 buffer_get_layout(Application_Links *app, Buffer_ID buffer_id){
     Models *models = (Models*)app->cmd_context;
@@ -864,6 +888,14 @@ buffer_save(Application_Links *app, Buffer_ID buffer_id, String_Const_u8 file_na
             }
         }
         
+        if (!skip_save && file->state.mapping_changed){
+            skip_save = true;
+#define M \
+"ERROR: the file under this buffer changed on disk while it was mapped, the text may be damaged; reopen the buffer before saving it.\n"
+            print_message(app, string_u8_litexpr(M));
+#undef M
+        }
+        
         if (!skip_save){
             Thread_Context *tctx = app->tctx;
             Scratch_Block scratch(tctx);
@@ -894,7 +926,8 @@ buffer_kill(Application_Links *app, Buffer_ID buffer_id, Buffer_Kill_Flag flags)
                 
                 buffer_unbind_name_low_level(working_set, file);
                 if (file->canon.name_size != 0){
-                    buffer_unbind_file(working_set, file);
+                    Scratch_Block scratch(tctx);
+                    buffer_unbind_file(scratch, working_set, file);
                 }
                 file_free(tctx, models, file);
                 working_set_free_file(&models->heap, working_set, file);
@@ -957,10 +990,14 @@ buffer_reopen(Application_Links *app, Buffer_ID buffer_id, Buffer_Reopen_Flag fl
             if (system_load_handle(scratch, (char*)file->canon.name_space, &handle)){
                 File_Attributes attributes = system_load_attributes(handle);
                 
-                char *file_memory = push_array(scratch, char, (i32)attributes.size);
+                String_Const_u8 mapping = file_load_mapping(handle, attributes);
+                u8 *file_memory = 0;
+                if (mapping.str == 0){
+                    file_memory = push_array(scratch, u8, attributes.size);
+                }
                 
-                if (file_memory != 0){
-                    if (system_load_file(handle, file_memory, (i32)attributes.size)){
+                if (mapping.str != 0 || file_memory != 0){
+                    if (mapping.str != 0 || file_load_contents(handle, file_memory, attributes.size)){
                         system_load_close(handle);
                         
                         // TODO(allen): try(perform a diff maybe apply edits in reopen)
@@ -987,9 +1024,15 @@ buffer_reopen(Application_Links *app, Buffer_ID buffer_id, Buffer_Reopen_Flag fl
                         }
                         
                         Working_Set *working_set = &models->working_set;
+                        Text_Storage_Kind storage_kind = file->state.buffer.storage_kind;
                         file_free(tctx, models, file);
                         working_set_file_default_settings(working_set, file);
-                        file_create_from_string(tctx, models, file, SCu8(file_memory, attributes.size), attributes);
+                        if (mapping.str != 0){
+                            file_create_from_mapping(tctx, models, file, mapping, attributes);
+                        }
+                        else{
+                            file_create_from_string(tctx, models, file, SCu8(file_memory, attributes.size), attributes, storage_kind);
+                        }
                         
                         for (i32 i = 0; i < vptr_count; ++i){
                             view_set_file(tctx, models, vptrs[i], file);
@@ -3194,6 +3237,31 @@ buffer_find_all_matches(Application_Links *app, Arena *arena, Buffer_ID buffer,
     return(list);
 }
 
+// NOTE(allen): Does not touch any editor state, so it can be called from the
+// async workers on a copy of a buffer's text.  The matches are tagged with
+// buffer and positioned at base_index plus their offset in string.
+api(custom) function String_Match_List
+string_find_all_matches(Application_Links *app, Arena *arena, Buffer_ID buffer,
+                        i32 string_id, String_Const_u8 string, i64 base_index,
+                        String_Const_u8 needle, Character_Predicate *predicate,
+                        Scan_Direction direction){
+    String_Match_List list = {};
+    if (needle.size > 0 && string.size > 0){
+        Scratch_Block scratch(app, arena);
+        List_String_Const_u8 chunks = {};
+        string_list_push(scratch, &chunks, string);
+        u64_Array jump_table = string_compute_needle_jump_table(scratch, needle, direction);
+        Character_Predicate dummy = {};
+        if (predicate == 0){
+            predicate = &dummy;
+        }
+        list = find_all_matches(arena, max_i32,
+                                chunks, needle, jump_table, predicate,
+                                direction, base_index, buffer, string_id);
+    }
+    return(list);
+}
+
 ////////////////////////////////
 
 api(custom) function Profile_Global_List*
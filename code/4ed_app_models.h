@@ -24,6 +24,8 @@ struct App_Settings{
     
     i32 font_size;
     b8 use_hinting;
+    
+    char *log_file_name;
 };
 
 enum App_State{
@@ -82,6 +84,7 @@ struct Models{
     Buffer_Edit_Range_Function *buffer_edit_range;
     Buffer_Region_Function *buffer_region;
     Layout_Function *layout_func;
+    u64 layout_cache_budget;
     View_Change_Buffer_Function *view_change_buffer;
     
     Color_Table color_table_;
@@ -188,6 +191,7 @@ enum Command_Line_Action{
     CLAct_FontSize,
     CLAct_FontUseHinting,
     CLAct_UserDirectory,
+    CLAct_LogFile,
     //
     CLAct_COUNT,
 };
@@ -45,8 +45,12 @@
 
 #include "4ed_buffer_model.h"
 #include "4ed_translation.h"
+#include "4ed_treap.h"
+#include "4ed_piece_tree.h"
+#include "4ed_line_index.h"
 #include "4ed_buffer.h"
 #include "4ed_history.h"
+#include "4ed_line_height_index.h"
 #include "4ed_file.h"
 
 #include "4ed_working_set.h"
@@ -109,9 +113,13 @@
 #include "4ed_translation.cpp"
 #include "4ed_render_target.cpp"
 #include "4ed_app_models.cpp"
+#include "4ed_treap.cpp"
+#include "4ed_piece_tree.cpp"
+#include "4ed_line_index.cpp"
 #include "4ed_buffer.cpp"
 #include "4ed_string_matching.cpp"
 #include "4ed_history.cpp"
+#include "4ed_line_height_index.cpp"
 #include "4ed_file.cpp"
 #include "4ed_working_set.cpp"
 #include "4ed_hot_directory.cpp"
@@ -174,27 +174,37 @@ buffer_update_cursors_lean_r(Cursor_With_Index *sorted_positions, i32 count,
 
 internal b32
 buffer_good(Gap_Buffer *buffer){
-    return(buffer->data != 0);
+    b32 result = false;
+    if (buffer->storage_kind == TextStorage_PieceTree){
+        result = (buffer->tree.nodes.arena.base_allocator != 0);
+    }
+    else{
+        result = (buffer->data != 0);
+    }
+    return(result);
 }
 
 internal i64
 buffer_size(Gap_Buffer *buffer){
-    return(buffer->size1 + buffer->size2);
+    i64 result = 0;
+    if (buffer->storage_kind == TextStorage_PieceTree){
+        result = piece_tree_size(&buffer->tree);
+    }
+    else{
+        result = buffer->size1 + buffer->size2;
+    }
+    return(result);
 }
 
 internal i64
 buffer_line_count(Gap_Buffer *buffer){
-    return(buffer->line_start_count - 1);
+    return(line_index_line_count(&buffer->line_index));
 }
 
 internal void
-buffer_init(Gap_Buffer *buffer, u8 *data, u64 size, Base_Allocator *allocator){
-    block_zero_struct(buffer);
-    
-    buffer->allocator = allocator;
-    
+gap_buffer__init(Gap_Buffer *buffer, u8 *data, u64 size){
     u64 capacity = round_up_u64(size*2, KB(4));
-    String_Const_u8 memory = base_allocate(allocator, capacity);
+    String_Const_u8 memory = base_allocate(buffer->allocator, capacity);
     buffer->data = (u8*)memory.str;
     buffer->size1 = size/2;
     buffer->gap_size = capacity - size;
@@ -205,12 +215,98 @@ buffer_init(Gap_Buffer *buffer, u8 *data, u64 size, Base_Allocator *allocator){
     block_copy(buffer->data + buffer->size1 + buffer->gap_size, data + buffer->size1, buffer->size2);
 }
 
-internal b32
-buffer_replace_range(Gap_Buffer *buffer, Range_i64 range, String_Const_u8 text, i64 shift_amount){
+internal void
+buffer_init(Gap_Buffer *buffer, u8 *data, u64 size, Base_Allocator *allocator, Text_Storage_Kind storage_kind){
+    block_zero_struct(buffer);
+    
+    buffer->allocator = allocator;
+    buffer->storage_kind = storage_kind;
+    line_index_init(&buffer->line_index, allocator);
+    
+    switch (storage_kind){
+        case TextStorage_GapBuffer:
+        {
+            gap_buffer__init(buffer, data, size);
+        }break;
+        case TextStorage_PieceTree:
+        {
+            piece_tree_init(&buffer->tree, allocator, data, size);
+        }break;
+    }
+}
+
+internal void
+buffer_init(Gap_Buffer *buffer, u8 *data, u64 size, Base_Allocator *allocator){
+    buffer_init(buffer, data, size, allocator, TextStorage_GapBuffer);
+}
+
+// NOTE(allen): The buffer reads its text straight out of the caller's memory
+// (a file mapping) and only allocates for the text that edits add.
+internal void
+buffer_init_borrowed(Gap_Buffer *buffer, u8 *data, u64 size, Base_Allocator *allocator){
+    block_zero_struct(buffer);
+    
+    buffer->allocator = allocator;
+    buffer->storage_kind = TextStorage_PieceTree;
+    line_index_init(&buffer->line_index, allocator);
+    piece_tree_init_borrowed(&buffer->tree, allocator, data, size);
+}
+
+internal String_Const_u8
+buffer_get_borrowed_original(Gap_Buffer *buffer){
+    String_Const_u8 result = {};
+    if (buffer->storage_kind == TextStorage_PieceTree && buffer->tree.original_is_borrowed){
+        result = SCu8(buffer->tree.original, buffer->tree.original_size);
+    }
+    return(result);
+}
+
+// NOTE(allen): Moves the buffer off of its borrowed original and returns the
+// memory it borrowed, which the caller can then let go of.
+internal String_Const_u8
+buffer_release_borrowed_original(Gap_Buffer *buffer){
+    String_Const_u8 result = buffer_get_borrowed_original(buffer);
+    if (result.str != 0){
+        piece_tree_own_original(&buffer->tree, buffer->allocator);
+    }
+    return(result);
+}
+
+// NOTE(allen): Throws away the edit history of the pieces and makes data the
+// whole text of the buffer.  data must hold exactly the current text, so the
+// line index stays as it is.
+internal void
+buffer_rebase_original(Gap_Buffer *buffer, u8 *data, u64 size, b32 borrow){
+    Assert(buffer->storage_kind == TextStorage_PieceTree);
+    Assert((i64)size == buffer_size(buffer));
+    piece_tree_free(&buffer->tree, buffer->allocator);
+    if (borrow){
+        piece_tree_init_borrowed(&buffer->tree, buffer->allocator, data, size);
+    }
+    else{
+        piece_tree_init(&buffer->tree, buffer->allocator, data, size);
+    }
+}
+
+internal void
+buffer_free(Gap_Buffer *buffer){
+    switch (buffer->storage_kind){
+        case TextStorage_GapBuffer:
+        {
+            base_free(buffer->allocator, buffer->data);
+        }break;
+        case TextStorage_PieceTree:
+        {
+            piece_tree_free(&buffer->tree, buffer->allocator);
+        }break;
+    }
+    line_index_free(&buffer->line_index);
+    buffer->data = 0;
+}
+
+internal void
+gap_buffer__replace_range(Gap_Buffer *buffer, Range_i64 range, String_Const_u8 text, i64 shift_amount){
     i64 size = buffer_size(buffer);
-    Assert(0 <= range.start);
-    Assert(range.start <= range.end);
-    Assert(range.end <= size);
     
     if (shift_amount + size > buffer->max){
         i64 new_max = round_up_i64(2*(shift_amount + size), KB(4));
@@ -228,8 +324,6 @@ buffer_replace_range(Gap_Buffer *buffer, Range_i64 range, String_Const_u8 text,
     
     Assert(shift_amount + size <= buffer->max);
     
-    b32 result = false;
-    
     if (range.end < buffer->size1){
         i64 move_size = buffer->size1 - range.end;
         block_copy(buffer->data + buffer->size1 + buffer->gap_size - move_size,
@@ -254,6 +348,27 @@ buffer_replace_range(Gap_Buffer *buffer, Range_i64 range, String_Const_u8 text,
     
     Assert(buffer->size1 + buffer->size2 == size + shift_amount);
     Assert(buffer->size1 + buffer->gap_size + buffer->size2 == buffer->max);
+}
+
+internal b32
+buffer_replace_range(Gap_Buffer *buffer, Range_i64 range, String_Const_u8 text, i64 shift_amount){
+    i64 size = buffer_size(buffer);
+    Assert(0 <= range.start);
+    Assert(range.start <= range.end);
+    Assert(range.end <= size);
+    
+    b32 result = false;
+    
+    switch (buffer->storage_kind){
+        case TextStorage_GapBuffer:
+        {
+            gap_buffer__replace_range(buffer, range, text, shift_amount);
+        }break;
+        case TextStorage_PieceTree:
+        {
+            piece_tree_replace_range(&buffer->tree, range, text);
+        }break;
+    }
     
     return(result);
 }
@@ -263,12 +378,21 @@ buffer_replace_range(Gap_Buffer *buffer, Range_i64 range, String_Const_u8 text,
 internal List_String_Const_u8
 buffer_get_chunks(Arena *arena, Gap_Buffer *buffer){
     List_String_Const_u8 list = {};
-    if (buffer->size1 > 0){
-        string_list_push(arena, &list, SCu8(buffer->data, buffer->size1));
-    }
-    if (buffer->size2 > 0){
-        u64 gap_2_pos = buffer->size1 + buffer->gap_size;
-        string_list_push(arena, &list, SCu8(buffer->data + gap_2_pos, buffer->size2));
+    switch (buffer->storage_kind){
+        case TextStorage_GapBuffer:
+        {
+            if (buffer->size1 > 0){
+                string_list_push(arena, &list, SCu8(buffer->data, buffer->size1));
+            }
+            if (buffer->size2 > 0){
+                u64 gap_2_pos = buffer->size1 + buffer->gap_size;
+                string_list_push(arena, &list, SCu8(buffer->data + gap_2_pos, buffer->size2));
+            }
+        }break;
+        case TextStorage_PieceTree:
+        {
+            list = piece_tree_get_chunks(arena, &buffer->tree, Ii64(0, buffer_size(buffer)));
+        }break;
     }
     return(list);
 }
@@ -298,8 +422,15 @@ buffer_chunks_clamp(List_String_Const_u8 *chunks, Range_i64 range){
 
 internal String_Const_u8
 buffer_stringify(Arena *arena, Gap_Buffer *buffer, Range_i64 range){
-    List_String_Const_u8 list = buffer_get_chunks(arena, buffer);
-    buffer_chunks_clamp(&list, range);
+    List_String_Const_u8 list = {};
+    if (buffer->storage_kind == TextStorage_PieceTree){
+        // NOTE(allen): Only visit the pieces that overlap the range.
+        list = piece_tree_get_chunks(arena, &buffer->tree, range);
+    }
+    else{
+        list = buffer_get_chunks(arena, buffer);
+        buffer_chunks_clamp(&list, range);
+    }
     return(string_list_flatten(arena, list, StringFill_NullTerminate));
 }
 
@@ -360,208 +491,180 @@ buffer_count_newlines(Arena *scratch, Gap_Buffer *buffer, i64 start, i64 end){
 }
 #endif
 
-internal void
-buffer_starts__ensure_max_size(Gap_Buffer *buffer, i64 max_size){
-    if (max_size > buffer->line_start_max){
-        i64 new_max = round_up_i64(max_size*2, KB(1));
-        String_Const_u8 memory = base_allocate(buffer->allocator, sizeof(*buffer->line_starts)*new_max);
-        i64 *new_line_starts = (i64*)memory.str;
-        block_copy_dynamic_array(new_line_starts, buffer->line_starts, buffer->line_start_count);
-        buffer->line_start_max = new_max;
-        base_free(buffer->allocator, buffer->line_starts);
-        buffer->line_starts = new_line_starts;
+//
+// Newline scanning
+//
+
+// NOTE(allen): Opening a file spends most of its time in these two loops, so they
+// compare 16 (SSE2) or 32 (AVX2) bytes per step and fall back to bytes for the
+// tail and on targets without SIMD.
+
+function i64
+count_lines(String_Const_u8 string){
+    i64 result = 0;
+    u8 *ptr = string.str;
+    u8 *opl = ptr + string.size;
+#if ARCH_AVX2
+    __m256i newline_x32 = _mm256_set1_epi8('\n');
+    for (;ptr + 32 <= opl;){
+        // NOTE(allen): each lane counts at most 255 matches before it is summed
+        __m256i counts = _mm256_setzero_si256();
+        u8 *block_opl = ptr + Min(255*32, (opl - ptr) & ~31);
+        for (;ptr < block_opl; ptr += 32){
+            __m256i v = _mm256_loadu_si256((__m256i*)ptr);
+            counts = _mm256_sub_epi8(counts, _mm256_cmpeq_epi8(v, newline_x32));
+        }
+        __m256i sums = _mm256_sad_epu8(counts, _mm256_setzero_si256());
+        result += _mm256_extract_epi64(sums, 0) + _mm256_extract_epi64(sums, 1);
+        result += _mm256_extract_epi64(sums, 2) + _mm256_extract_epi64(sums, 3);
+    }
+#elif ARCH_SSE2
+    __m128i newline_x16 = _mm_set1_epi8('\n');
+    for (;ptr + 16 <= opl;){
+        __m128i counts = _mm_setzero_si128();
+        u8 *block_opl = ptr + Min(255*16, (opl - ptr) & ~15);
+        for (;ptr < block_opl; ptr += 16){
+            __m128i v = _mm_loadu_si128((__m128i*)ptr);
+            counts = _mm_sub_epi8(counts, _mm_cmpeq_epi8(v, newline_x16));
+        }
+        __m128i sums = _mm_sad_epu8(counts, _mm_setzero_si128());
+        result += _mm_cvtsi128_si32(sums) + _mm_cvtsi128_si32(_mm_srli_si128(sums, 8));
+    }
+#endif
+    for (;ptr < opl; ptr += 1){
+        if (*ptr == '\n'){
+            result += 1;
+        }
     }
+    return(result);
 }
 
-internal void
-buffer_measure_starts__write(Gap_Buffer *buffer, i64 pos){
-    buffer_starts__ensure_max_size(buffer, buffer->line_start_count + 1);
-    buffer->line_starts[buffer->line_start_count] = pos;
-    buffer->line_start_count += 1;
+// NOTE(allen): For every newline in string writes the length of the line it ends
+// into lengths and returns the advanced pointer.  *line_start is the position
+// (relative to string.str) where the current line began, and is updated as lines
+// are closed, so the scan can continue across chunks.
+function i64*
+fill_line_lengths(i64 *lengths, String_Const_u8 string, i64 *line_start){
+    i64 *out = lengths;
+    i64 start = *line_start;
+    u8 *str = string.str;
+    i64 size = (i64)string.size;
+    i64 i = 0;
+#if ARCH_AVX2
+    __m256i newline_x32 = _mm256_set1_epi8('\n');
+    for (;i + 32 <= size; i += 32){
+        __m256i v = _mm256_loadu_si256((__m256i*)(str + i));
+        u32 mask = (u32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, newline_x32));
+        for (;mask != 0; mask &= mask - 1){
+            i64 end = i + bit_scan_forward_u32(mask) + 1;
+            *out = end - start;
+            out += 1;
+            start = end;
+        }
+    }
+#elif ARCH_SSE2
+    __m128i newline_x16 = _mm_set1_epi8('\n');
+    for (;i + 16 <= size; i += 16){
+        __m128i v = _mm_loadu_si128((__m128i*)(str + i));
+        u32 mask = (u32)_mm_movemask_epi8(_mm_cmpeq_epi8(v, newline_x16));
+        for (;mask != 0; mask &= mask - 1){
+            i64 end = i + bit_scan_forward_u32(mask) + 1;
+            *out = end - start;
+            out += 1;
+            start = end;
+        }
+    }
+#endif
+    for (;i < size; i += 1){
+        if (str[i] == '\n'){
+            *out = i + 1 - start;
+            out += 1;
+            start = i + 1;
+        }
+    }
+    *line_start = start - size;
+    return(out);
 }
 
 internal void
 buffer_measure_starts(Arena *scratch, Gap_Buffer *buffer){
     Temp_Memory temp = begin_temp(scratch);
     List_String_Const_u8 list = buffer_get_chunks(scratch, buffer);
-    buffer->line_start_count = 0;
-    buffer_measure_starts__write(buffer, 0);
-    i64 index = 0;
+    
+    // NOTE(allen): Count first so the lengths array is reserved exactly once.
+    i64 line_count = 1;
     for (Node_String_Const_u8 *node = list.first;
          node != 0;
          node = node->next){
-        u8 *byte = node->string.str;
-        u8 *byte_opl = byte + node->string.size;
-        for (;byte < byte_opl; byte += 1){
-            index += 1;
-            if (*byte == '\n'){
-                buffer_measure_starts__write(buffer, index);
-            }
-        }
+        line_count += count_lines(node->string);
     }
-    buffer_measure_starts__write(buffer, buffer_size(buffer));
+    
+    i64 *lengths = push_array(scratch, i64, line_count);
+    i64 *length = lengths;
+    i64 line_start = 0;
+    for (Node_String_Const_u8 *node = list.first;
+         node != 0;
+         node = node->next){
+        length = fill_line_lengths(length, node->string, &line_start);
+    }
+    *length = -line_start;
+    Assert(length + 1 == lengths + line_count);
+    
+    line_index_set(&buffer->line_index, lengths, line_count);
     end_temp(temp);
 }
 
 internal i64
 buffer_get_line_index(Gap_Buffer *buffer, i64 pos){
-    i64 i = 0;
-    if (buffer->line_start_count > 2){
-        i64 start = 0;
-        i64 one_past_last = buffer->line_start_count - 1;
-        i64 *array = buffer->line_starts;
-        pos = clamp_bot(0, pos);
-        for (;;){
-            i = (start + one_past_last) >> 1;
-            if (array[i] < pos){
-                start = i;
-            }
-            else if (array[i] > pos){
-                one_past_last = i;
-            }
-            else{
-                break;
-            }
-            if (start + 1 >= one_past_last){
-                i = start;
-                break;
-            }
-        }
-    }
-    return(i);
-}
-
-Line_Move*
-push_line_move(Arena *arena, Line_Move *moves, i64 new_line_first,
-               i64 old_line_first, i64 old_line_opl, i64 text_shift){
-    Line_Move *move = push_array(arena, Line_Move, 1);
-    move->next = moves;
-    move->kind = LineMove_ShiftOldValues;
-    move->new_line_first = new_line_first;
-    move->old_line_first = old_line_first;
-    move->old_line_opl = old_line_opl;
-    move->text_shift = text_shift;
-    return(move);
-}
-
-Line_Move*
-push_line_move(Arena *arena, Line_Move *moves, i64 new_line_first,
-               String_Const_u8 string, i64 text_base){
-    Line_Move *move = push_array(arena, Line_Move, 1);
-    move->next = moves;
-    move->kind = LineMove_MeasureString;
-    move->new_line_first = new_line_first;
-    move->string = string;
-    move->text_base = text_base;
-    return(move);
-}
-
-function i64
-count_lines(String_Const_u8 string){
-    i64 result = 0;
-    for (u64 i = 0; i < string.size; i += 1){
-        if (string.str[i] == '\n'){
-            result += 1;
-        }
-    }
-    return(result);
-}
-
-function void
-fill_line_starts(i64 *lines_starts, String_Const_u8 string, i64 text_base){
-    i64 *ptr = lines_starts;
-    for (u64 i = 0; i < string.size; i += 1){
-        if (string.str[i] == '\n'){
-            *ptr = text_base + i + 1;
-            ptr += 1;
-        }
-    }
+    return(line_index_line_from_pos(&buffer->line_index, pos, 0));
 }
 
 function void
 buffer_remeasure_starts(Thread_Context *tctx, Gap_Buffer *buffer, Batch_Edit *batch){
     Scratch_Block scratch(tctx);
+    Line_Index *index = &buffer->line_index;
     
-    i64 line_start_count = buffer_line_count(buffer) + 1;
-    
-    Line_Move *moves = 0;
-    i64 current_line = 0;
+    // NOTE(allen): The batch is sorted and in pre-edit positions; by the time each
+    // edit is reached the index already reflects the ones before it, so shift the
+    // range by the text they added.
     i64 text_shift = 0;
-    i64 line_shift = 0;
     for (Batch_Edit *node = batch;
          node != 0;
          node = node->next){
-        i64 first_line = buffer_get_line_index(buffer, node->edit.range.first);
-        i64 opl_line = buffer_get_line_index(buffer, node->edit.range.one_past_last);
-        i64 new_line_count = count_lines(node->edit.text);
-        i64 deleted_line_count = opl_line - first_line;
+        Temp_Memory temp = begin_temp(scratch);
         
-        Assert(first_line <= opl_line);
-        Assert(opl_line <= line_start_count);
+        Range_i64 range = node->edit.range;
+        range.first += text_shift;
+        range.one_past_last += text_shift;
         
-        if (current_line <= first_line &&
-            (text_shift != 0 || line_shift != 0)){
-            moves = push_line_move(scratch, moves, current_line + line_shift,
-                                   current_line, first_line + 1, text_shift);
-        }
+        i64 first_start = 0;
+        i64 opl_start = 0;
+        i64 first_line = line_index_line_from_pos(index, range.first, &first_start);
+        i64 opl_line = line_index_line_from_pos(index, range.one_past_last, &opl_start);
+        i64 opl_end = line_index_line_start(index, opl_line + 1);
+        Assert(first_line <= opl_line);
         
-        if (new_line_count != 0){
-            moves = push_line_move(scratch, moves, first_line + 1 + line_shift,
-                                   node->edit.text, node->edit.range.first + text_shift);
-        }
+        String_Const_u8 text = node->edit.text;
+        i64 new_line_count = count_lines(text) + 1;
+        i64 *lengths = push_array(scratch, i64, new_line_count);
+        // NOTE(allen): The first new line keeps the part of the old line in front
+        // of the edit and the last one keeps the part after it.
+        i64 line_start = first_start - range.first;
+        i64 *last_length = fill_line_lengths(lengths, text, &line_start);
+        *last_length = opl_end - range.one_past_last - line_start;
+        line_index_replace(index, scratch, first_line, opl_line - first_line + 1, lengths, new_line_count);
         
-        text_shift += node->edit.text.size - range_size(node->edit.range);
-        line_shift += new_line_count - deleted_line_count;
-        current_line = opl_line + 1;
-    }
-    
-    moves = push_line_move(scratch, moves, current_line + line_shift,
-                           current_line, line_start_count, text_shift);
-    line_start_count = line_start_count + line_shift;
-    
-    buffer_starts__ensure_max_size(buffer, line_start_count + 1);
-    buffer->line_start_count = line_start_count;
-    
-    i64 *array = buffer->line_starts;
-    
-    for (Line_Move *node = moves;
-         node != 0;
-         node = node->next){
-        if (node->kind == LineMove_ShiftOldValues){
-            i64 line_index_shift = node->new_line_first - node->old_line_first;
-            i64 move_text_shift = node->text_shift;
-            if (line_index_shift > 0){
-                for (i64 i = node->old_line_opl - 1;
-                     i >= node->old_line_first;
-                     i -= 1){
-                    array[i + line_index_shift] = array[i] + move_text_shift;
-                }
-            }
-            else{
-                for (i64 i = node->old_line_first;
-                     i < node->old_line_opl;
-                     i += 1){
-                    array[i + line_index_shift] = array[i] + move_text_shift;
-                }
-            }
-        }
-    }
-    
-    for (Line_Move *node = moves;
-         node != 0;
-         node = node->next){
-        if (node->kind == LineMove_MeasureString){
-            fill_line_starts(array + node->new_line_first, node->string, node->text_base);
-        }
+        text_shift += text.size - range_size(node->edit.range);
+        end_temp(temp);
     }
 }
 
 internal Range_i64
 buffer_get_pos_range_from_line_number(Gap_Buffer *buffer, i64 line_number){
     Range_i64 result = {};
-    if (1 <= line_number && line_number < buffer->line_start_count){
-        result.first = buffer->line_starts[line_number - 1];
-        result.one_past_last = buffer->line_starts[line_number];
+    if (1 <= line_number && line_number <= buffer_line_count(buffer)){
+        result.first = line_index_line_start(&buffer->line_index, line_number - 1);
+        result.one_past_last = line_index_line_start(&buffer->line_index, line_number);
     }
     return(result);
 }
@@ -572,11 +675,11 @@ buffer_get_first_pos_from_line_number(Gap_Buffer *buffer, i64 line_number){
     if (line_number < 1){
         result = 0;
     }
-    else if (line_number >= buffer->line_start_count){
+    else if (line_number > buffer_line_count(buffer)){
         result = buffer_size(buffer);
     }
     else{
-        result = buffer->line_starts[line_number - 1];
+        result = line_index_line_start(&buffer->line_index, line_number - 1);
     }
     return(result);
 }
@@ -587,11 +690,11 @@ buffer_get_last_pos_from_line_number(Gap_Buffer *buffer, i64 line_number){
     if (line_number < 1){
         result = 0;
     }
-    else if (line_number >= buffer->line_start_count - 1){
+    else if (line_number >= buffer_line_count(buffer)){
         result = buffer_size(buffer);
     }
     else{
-        result = buffer->line_starts[line_number] - 1;
+        result = line_index_line_start(&buffer->line_index, line_number) - 1;
     }
     return(result);
 }
@@ -600,12 +703,13 @@ internal Buffer_Cursor
 buffer_cursor_from_pos(Gap_Buffer *buffer, i64 pos){
     i64 size = buffer_size(buffer);
     pos = clamp(0, pos, size);
-    i64 line_index = buffer_get_line_index(buffer, pos);
+    i64 line_start = 0;
+    i64 line_index = line_index_line_from_pos(&buffer->line_index, pos, &line_start);
     
     Buffer_Cursor result = {};
     result.pos = pos;
     result.line = line_index + 1;
-    result.col = pos - buffer->line_starts[line_index] + 1;
+    result.col = pos - line_start + 1;
     return(result);
 }
 
@@ -616,8 +720,8 @@ buffer_cursor_from_line_col(Gap_Buffer *buffer, i64 line, i64 col){
     i64 line_count = buffer_line_count(buffer);
     line_index = clamp(0, line_index, line_count - 1);
     
-    i64 this_start = buffer->line_starts[line_index];
-    i64 max_col = (buffer->line_starts[line_index + 1] - this_start);
+    i64 this_start = line_index_line_start(&buffer->line_index, line_index);
+    i64 max_col = (line_index_line_start(&buffer->line_index, line_index + 1) - this_start);
     if (line_index + 1 == line_count){
         max_col += 1;
     }
@@ -17,22 +17,31 @@ struct Cursor_With_Index{
     i32 index;
 };
 
+typedef i32 Text_Storage_Kind;
+enum{
+    TextStorage_GapBuffer,
+    TextStorage_PieceTree,
+};
+
 struct Gap_Buffer{
     Base_Allocator *allocator;
     
+    // NOTE(allen): Large buffers may keep their text in a piece tree instead of
+    // the gap.  Everything outside of the text storage routines in 4ed_buffer.cpp
+    // goes through buffer_get_chunks/buffer_replace_range/buffer_stringify and
+    // does not care which one is in use.
+    Text_Storage_Kind storage_kind;
+    Piece_Tree tree;
+    
     u8 *data;
     i64 size1;
     i64 gap_size;
     i64 size2;
     i64 max;
     
-    // NOTE(allen): If there are N lines I store N + 1 slots in this array with
-    // line_starts[N] = size of the buffer.
-    //    The variable line_start_count stores N + 1; call buffer_line_count(buffer)
-    // to get "N" the actual number of lines.
-    i64 *line_starts;
-    i64 line_start_count;
-    i64 line_start_max;
+    // NOTE(allen): A buffer with N lines has N entries in the line index, the
+    // last line is the only one that does not end in a newline and may be empty.
+    Line_Index line_index;
 };
 
 struct Buffer_Chunk_Position{
@@ -41,28 +50,6 @@ struct Buffer_Chunk_Position{
     i64 chunk_index;
 };
 
-typedef i32 Line_Move_Kind;
-enum{
-    LineMove_ShiftOldValues,
-    LineMove_MeasureString,
-};
-struct Line_Move{
-    Line_Move *next;
-    Line_Move_Kind kind;
-    i64 new_line_first;
-    union{
-        struct{
-            i64 old_line_first;
-            i64 old_line_opl;
-            i64 text_shift;
-        };
-        struct{
-            String_Const_u8 string;
-            i64 text_base;
-        };
-    };
-};
-
 #endif
 
 // BOTTOM
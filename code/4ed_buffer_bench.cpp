@@ -0,0 +1,115 @@
+/*
+4ed_buffer_bench.cpp - Compares the gap buffer and piece tree text storage on edit traces.
+
+Build from the code directory, for example:
+g++ -O2 -I. -Icustom 4ed_buffer_bench.cpp -o buffer_bench
+*/
+
+// TOP
+
+#include "4coder_base_types.h"
+#include "4coder_table.h"
+#include "4coder_events.h"
+#include "4coder_types.h"
+#include "4ed_treap.h"
+#include "4ed_piece_tree.h"
+#include "4ed_line_index.h"
+#include "4ed_buffer.h"
+
+#include "4coder_base_types.cpp"
+#include "4coder_malloc_allocator.cpp"
+#include "4ed_treap.cpp"
+#include "4ed_piece_tree.cpp"
+#include "4ed_line_index.cpp"
+#include "4ed_buffer.cpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+internal u64
+bench_now_us(void){
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return((u64)t.tv_sec*Million(1) + (u64)t.tv_nsec/Thousand(1));
+}
+
+typedef i32 Bench_Trace_Kind;
+enum{
+    BenchTrace_Random,
+    BenchTrace_Clustered,
+};
+
+internal u64
+bench_run(Base_Allocator *allocator, Text_Storage_Kind kind, Bench_Trace_Kind trace,
+          String_Const_u8 text, i32 edit_count, String_Const_u8 *check_out, Arena *arena){
+    Gap_Buffer buffer = {};
+    buffer_init(&buffer, text.str, text.size, allocator, kind);
+    
+    u32 seed = 0x1234567;
+    i64 cluster = 0;
+    u8 insert_text[] = "inserted_text\n";
+    
+    u64 start = bench_now_us();
+    for (i32 i = 0; i < edit_count; i += 1){
+        seed = seed*1664525 + 1013904223;
+        i64 size = buffer_size(&buffer);
+        i64 pos = 0;
+        if (trace == BenchTrace_Random){
+            pos = (i64)(seed % (u32)(size + 1));
+        }
+        else{
+            // NOTE(allen): Clustered edits jump somewhere new every 64 edits and
+            // stay within a few hundred bytes of that spot in between.
+            if ((i % 64) == 0){
+                cluster = (i64)(seed % (u32)(size + 1));
+            }
+            pos = clamp(0, cluster + (i64)((seed >> 16) % 512) - 256, size);
+        }
+        Range_i64 range = Ii64(pos, clamp_top(pos + (i64)(seed >> 28), size));
+        String_Const_u8 string = SCu8(insert_text, (i64)((seed >> 8) % sizeof(insert_text)));
+        buffer_replace_range(&buffer, range, string, replace_range_shift(range, string.size));
+    }
+    u64 time = bench_now_us() - start;
+    
+    *check_out = buffer_stringify(arena, &buffer, Ii64(0, buffer_size(&buffer)));
+    buffer_free(&buffer);
+    return(time);
+}
+
+int main(int argc, char **argv){
+    Base_Allocator *allocator = get_allocator_malloc();
+    Arena arena = make_arena(allocator, MB(64));
+    
+    i64 size = MB(64);
+    i32 edit_count = 2000;
+    if (argc > 1){
+        size = MB((i64)atoi(argv[1]));
+    }
+    if (argc > 2){
+        edit_count = atoi(argv[2]);
+    }
+    
+    String_Const_u8 text = {};
+    text.size = size;
+    text.str = push_array(&arena, u8, size);
+    for (i64 i = 0; i < size; i += 1){
+        text.str[i] = ((i % 80) == 79)?'\n':(u8)('a' + (i % 26));
+    }
+    
+    char *trace_names[] = {"random", "clustered"};
+    printf("buffer size %lld MB, %d edits\n", size/MB(1), edit_count);
+    for (i32 trace = BenchTrace_Random; trace <= BenchTrace_Clustered; trace += 1){
+        String_Const_u8 gap_result = {};
+        String_Const_u8 tree_result = {};
+        u64 gap_time = bench_run(allocator, TextStorage_GapBuffer, trace, text, edit_count, &gap_result, &arena);
+        u64 tree_time = bench_run(allocator, TextStorage_PieceTree, trace, text, edit_count, &tree_result, &arena);
+        printf("%-10s gap buffer %10llu us | piece tree %10llu us | %s\n",
+               trace_names[trace], gap_time, tree_time,
+               string_match(gap_result, tree_result)?"contents match":"CONTENTS DIFFER");
+    }
+    
+    return(0);
+}
+
+// BOTTOM
@@ -3,12 +3,14 @@
  *
  * 19.07.2017
  *
- * Coroutine implementation from thread+mutex+cv
+ * Coroutine implementation from user space stack switching or thread+mutex+cv
  *
  */
 
 // TOP
 
+#if FRED_COROUTINE_THREADS
+
 internal void
 coroutine__pass_control(Coroutine *me, Coroutine *other,
                         Coroutine_State my_new_state, Coroutine_Pass_Control control){
@@ -80,25 +82,240 @@ coroutine_sub_init(Coroutine *co, Coroutine_Group *sys){
     }
 }
 
+#else
+
+// NOTE(allen): coroutine__switch pushes the registers the caller expects to be
+// kept, puts the stack pointer in *from, and pops the same set from the stack
+// in to.  A new stack is set up so that the first switch onto it returns into
+// coroutine__entry, which calls the function in the second saved register with
+// the first saved register as the argument.
+
+extern "C" void coroutine__switch(void **from, void *to);
+extern "C" void coroutine__entry(void);
+
+#if ARCH_X64
+
+// NOTE(allen): rbp rbx r12-r15, then the mxcsr and x87 control words.
+#define coroutine_frame_size 64
+
+asm(R"asm(
+    .text
+    .p2align 4
+    .globl coroutine__switch
+    .hidden coroutine__switch
+    .type coroutine__switch, %function
+coroutine__switch:
+    pushq %rbp
+    pushq %rbx
+    pushq %r12
+    pushq %r13
+    pushq %r14
+    pushq %r15
+    subq $8, %rsp
+    stmxcsr (%rsp)
+    fnstcw 4(%rsp)
+    movq %rsp, (%rdi)
+    movq %rsi, %rsp
+    ldmxcsr (%rsp)
+    fldcw 4(%rsp)
+    addq $8, %rsp
+    popq %r15
+    popq %r14
+    popq %r13
+    popq %r12
+    popq %rbx
+    popq %rbp
+    ret
+    .size coroutine__switch, .-coroutine__switch
+
+    .p2align 4
+    .globl coroutine__entry
+    .hidden coroutine__entry
+    .type coroutine__entry, %function
+coroutine__entry:
+    movq %r12, %rdi
+    callq *%r13
+    ud2
+    .size coroutine__entry, .-coroutine__entry
+)asm");
+
+internal void*
+coroutine__initial_frame(u8 *top, Coroutine *co, void (*func)(Coroutine*)){
+    // NOTE(allen): The return address goes where a call would have put it, so
+    // coroutine__entry starts with the stack aligned to 16.
+    u64 *frame = (u64*)(top - coroutine_frame_size);
+    block_zero(frame, coroutine_frame_size);
+    frame[0] = 0x1F80 | ((u64)0x037F << 32);
+    frame[3] = (u64)func;
+    frame[4] = (u64)co;
+    frame[7] = (u64)coroutine__entry;
+    return(frame);
+}
+
+#elif ARCH_ARM64
+
+// NOTE(allen): x19-x28, the frame pointer and link register, then d8-d15.
+#define coroutine_frame_size 160
+
+asm(R"asm(
+    .text
+    .p2align 4
+    .globl coroutine__switch
+    .hidden coroutine__switch
+    .type coroutine__switch, %function
+coroutine__switch:
+    sub sp, sp, #160
+    stp x19, x20, [sp, #0]
+    stp x21, x22, [sp, #16]
+    stp x23, x24, [sp, #32]
+    stp x25, x26, [sp, #48]
+    stp x27, x28, [sp, #64]
+    stp x29, x30, [sp, #80]
+    stp d8, d9, [sp, #96]
+    stp d10, d11, [sp, #112]
+    stp d12, d13, [sp, #128]
+    stp d14, d15, [sp, #144]
+    mov x9, sp
+    str x9, [x0]
+    mov sp, x1
+    ldp x19, x20, [sp, #0]
+    ldp x21, x22, [sp, #16]
+    ldp x23, x24, [sp, #32]
+    ldp x25, x26, [sp, #48]
+    ldp x27, x28, [sp, #64]
+    ldp x29, x30, [sp, #80]
+    ldp d8, d9, [sp, #96]
+    ldp d10, d11, [sp, #112]
+    ldp d12, d13, [sp, #128]
+    ldp d14, d15, [sp, #144]
+    add sp, sp, #160
+    ret
+    .size coroutine__switch, .-coroutine__switch
+
+    .p2align 4
+    .globl coroutine__entry
+    .hidden coroutine__entry
+    .type coroutine__entry, %function
+coroutine__entry:
+    mov x0, x19
+    blr x20
+    brk #0
+    .size coroutine__entry, .-coroutine__entry
+)asm");
+
+internal void*
+coroutine__initial_frame(u8 *top, Coroutine *co, void (*func)(Coroutine*)){
+    u64 *frame = (u64*)(top - coroutine_frame_size);
+    block_zero(frame, coroutine_frame_size);
+    frame[0] = (u64)co;
+    frame[1] = (u64)func;
+    frame[11] = (u64)coroutine__entry;
+    return(frame);
+}
+
+#else
+# error no user space coroutine switch for this architecture, define FRED_COROUTINE_THREADS
+#endif
+
+// NOTE(allen): The stacks are as big as the default thread stacks that came
+// before them.  Only the pages that get touched are ever committed, and the
+// lowest aligned block is left unmapped so running off the end faults instead
+// of writing over something else.  The guard is 64K so it is made of whole
+// pages with any page size the kernel picks.
+#define coroutine_stack_size MB(8)
+#define coroutine_guard_size KB(64)
+
+internal void
+coroutine__pass_control(Coroutine *me, Coroutine *other,
+                        Coroutine_State my_new_state, Coroutine_Pass_Control control){
+    Assert(me->state == CoroutineState_Active);
+    Assert(me->sys == other->sys);
+    
+    me->state = my_new_state;
+    other->state = CoroutineState_Active;
+    me->sys->active = other;
+    coroutine__switch(&me->stack_pointer, other->stack_pointer);
+}
+
+internal void
+coroutine_main(Coroutine *me){
+    Thread_Context_Extra_Info tctx_info = {};
+    tctx_info.coroutine = me;
+    
+    Thread_Context tctx_ = {};
+    thread_ctx_init(&tctx_, ThreadKind_MainCoroutine,
+                    get_base_allocator_system(), get_base_allocator_system());
+    tctx_.user_data = &tctx_info;
+    // NOTE(allen): Every coroutine runs on the main thread now, it gets an id of
+    // its own so its profile records are not mixed in with the main thread's.
+    me->sys->prof_thread_counter += 1;
+    tctx_.prof_thread_id = -me->sys->prof_thread_counter;
+    me->tctx = &tctx_;
+    
+    for (;;){
+        Assert(me->state == CoroutineState_Active);
+        Assert(me->type != CoroutineType_Root);
+        Assert(me->yield_ctx != 0);
+        Assert(me->func != 0);
+        
+        me->func(me);
+        
+        // NOTE(allen): Wake up the caller and set this coroutine back to being dead.
+        // The function is cleared first, this stack only comes back here once the
+        // coroutine is created again.
+        Coroutine *other = me->yield_ctx;
+        Assert(other != 0);
+        Assert(other->state == CoroutineState_Waiting);
+        
+        me->func = 0;
+        coroutine__pass_control(me, other, CoroutineState_Dead, CoroutinePassControl_ExitMe);
+    }
+}
+
+internal void
+coroutine_sub_init(Coroutine *co, Coroutine_Group *sys){
+    block_zero_struct(co);
+    co->sys = sys;
+    co->state = CoroutineState_Dead;
+    co->type = CoroutineType_Sub;
+    
+    u64 size = coroutine_guard_size*2 + coroutine_stack_size;
+    u8 *memory = (u8*)system_memory_allocate(size, file_name_line_number_lit_u8);
+    Assert(memory != 0);
+    u8 *guard = (u8*)round_up_u64((u64)memory, coroutine_guard_size);
+    system_memory_set_protection(guard, coroutine_guard_size, 0);
+    u8 *top = (u8*)round_down_u64((u64)(memory + size), 16);
+    co->stack_memory = memory;
+    co->stack_pointer = coroutine__initial_frame(top, co, coroutine_main);
+}
+
+#endif
+
 internal void
 coroutine_system_init(Coroutine_Group *sys){
     sys->arena = make_arena_system();
     
     Coroutine *root = &sys->root;
-    
+
+#if FRED_COROUTINE_THREADS
     sys->lock = system_mutex_make();
     sys->init_cv = system_condition_variable_make();
+#endif
     sys->active = root;
     
     block_zero_struct(root);
     root->sys = sys;
     root->state = CoroutineState_Active;
     root->type = CoroutineType_Root;
+#if FRED_COROUTINE_THREADS
     root->cv = system_condition_variable_make();
+#endif
     
     sys->unused = 0;
-    
+
+#if FRED_COROUTINE_THREADS
     system_mutex_acquire(sys->lock);
+#endif
 }
 
 internal Coroutine*
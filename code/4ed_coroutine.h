@@ -3,7 +3,7 @@
  *
  * 03.08.2019
  *
- * Coroutine implementation from thread+mutex+cv
+ * Coroutine implementation from user space stack switching or thread+mutex+cv
  *
  */
 
@@ -12,6 +12,18 @@
 #if !defined(FRED_COROUTINE_H)
 #define FRED_COROUTINE_H
 
+// NOTE(allen): On Linux x64 and arm64 every coroutine has a stack of its own
+// and control is switched onto it in user space.  Everywhere else, or when
+// FRED_COROUTINE_THREADS is defined to 1, every coroutine is a thread that is
+// handed control through a condition variable.
+#if !defined(FRED_COROUTINE_THREADS)
+# if OS_LINUX && (ARCH_X64 || ARCH_ARM64)
+#  define FRED_COROUTINE_THREADS 0
+# else
+#  define FRED_COROUTINE_THREADS 1
+# endif
+#endif
+
 typedef void Coroutine_Function(struct Coroutine *head);
 
 typedef u32 Coroutine_State;
@@ -36,6 +48,8 @@ struct Coroutine{
     void *out;
     System_Thread thread;
     System_Condition_Variable cv;
+    void *stack_memory;
+    void *stack_pointer;
     struct Coroutine_Group *sys;
     Coroutine_Function *func;
     Coroutine *yield_ctx;
@@ -52,6 +66,7 @@ struct Coroutine_Group{
     Coroutine *active;
     Coroutine *unused;
     Coroutine root;
+    i32 prof_thread_counter;
 };
 
 ////////////////////////////////
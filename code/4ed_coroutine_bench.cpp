@@ -0,0 +1,243 @@
+/*
+4ed_coroutine_bench.cpp - Measures the cost of passing control in and out of a coroutine.
+
+Times a coroutine_run / coroutine_yield round trip, the same round trip through
+a coroutine nested in another one, and creating a coroutine and running it to
+the end, which goes through the pool of dead coroutines.  The values passed
+through in and out are checked along the way.
+
+Build from the code directory once for each implementation, for example:
+g++ -O2 -pthread -I. -Icustom 4ed_coroutine_bench.cpp -o coroutine_bench
+g++ -O2 -pthread -I. -Icustom -DFRED_COROUTINE_THREADS=1 4ed_coroutine_bench.cpp -o coroutine_bench_threads
+The round trip count can be passed as the first argument.
+*/
+
+// TOP
+
+#include "4coder_base_types.h"
+#include "4coder_table.h"
+#include "4coder_events.h"
+#include "4coder_types.h"
+
+#include "4coder_system_types.h"
+#define STATIC_LINK_API
+#include "generated/system_api.h"
+
+#include "4ed_coroutine.h"
+
+#include "4coder_base_types.cpp"
+#include "4coder_stringf.cpp"
+#include "4coder_system_allocator.cpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/mman.h>
+
+////////////////////////////////
+
+// NOTE(allen): The bench is its own little platform layer, it only has to
+// provide what the coroutines and the system allocator call.
+
+internal void*
+system_memory_allocate(u64 size, String_Const_u8 location){
+    void *result = mmap(0, size, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+    if (result == MAP_FAILED){
+        result = 0;
+    }
+    return(result);
+}
+
+internal b32
+system_memory_set_protection(void *ptr, u64 size, u32 flags){
+    int protect = 0;
+    MovFlag(flags, MemProtect_Read, protect, PROT_READ);
+    MovFlag(flags, MemProtect_Write, protect, PROT_WRITE);
+    MovFlag(flags, MemProtect_Execute, protect, PROT_EXEC);
+    return(mprotect(ptr, size, protect) == 0);
+}
+
+internal void
+system_memory_free(void *ptr, u64 size){
+    munmap(ptr, size);
+}
+
+struct Bench_Thread{
+    Thread_Function *proc;
+    void *ptr;
+};
+
+internal void*
+bench_thread_start(void *ptr){
+    Bench_Thread *thread = (Bench_Thread*)ptr;
+    thread->proc(thread->ptr);
+    return(0);
+}
+
+internal System_Thread
+system_thread_launch(Thread_Function *proc, void *ptr){
+    System_Thread result = {};
+    Bench_Thread *thread = (Bench_Thread*)malloc(sizeof(Bench_Thread));
+    thread->proc = proc;
+    thread->ptr = ptr;
+    pthread_t pthread;
+    pthread_create(&pthread, 0, bench_thread_start, thread);
+    pthread_detach(pthread);
+    return(result);
+}
+
+internal System_Mutex
+system_mutex_make(void){
+    System_Mutex result = {};
+    pthread_mutex_t *mutex = (pthread_mutex_t*)malloc(sizeof(pthread_mutex_t));
+    pthread_mutex_init(mutex, 0);
+    *(pthread_mutex_t**)&result = mutex;
+    return(result);
+}
+
+internal void
+system_mutex_acquire(System_Mutex mutex){
+    pthread_mutex_lock(*(pthread_mutex_t**)&mutex);
+}
+
+internal void
+system_mutex_release(System_Mutex mutex){
+    pthread_mutex_unlock(*(pthread_mutex_t**)&mutex);
+}
+
+internal System_Condition_Variable
+system_condition_variable_make(void){
+    System_Condition_Variable result = {};
+    pthread_cond_t *cv = (pthread_cond_t*)malloc(sizeof(pthread_cond_t));
+    pthread_cond_init(cv, 0);
+    *(pthread_cond_t**)&result = cv;
+    return(result);
+}
+
+internal void
+system_condition_variable_wait(System_Condition_Variable cv, System_Mutex mutex){
+    pthread_cond_wait(*(pthread_cond_t**)&cv, *(pthread_mutex_t**)&mutex);
+}
+
+internal void
+system_condition_variable_signal(System_Condition_Variable cv){
+    pthread_cond_signal(*(pthread_cond_t**)&cv);
+}
+
+#include "4ed_coroutine.cpp"
+
+////////////////////////////////
+
+global Coroutine_Group bench_group = {};
+global i32 bench_round_trips = 0;
+global b32 bench_failed = false;
+
+internal u64
+bench_now_ns(void){
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return((u64)t.tv_sec*Billion(1) + (u64)t.tv_nsec);
+}
+
+// NOTE(allen): Doubles whatever it is handed and gives it back, once for every
+// round trip.
+internal void
+bench_echo(Coroutine *me){
+    for (i32 i = 0; i < bench_round_trips; i += 1){
+        i32 value = *(i32*)me->in;
+        *(i32*)me->out = value*2;
+        coroutine_yield(me);
+    }
+}
+
+// NOTE(allen): Passes every value through a coroutine of its own, like a command
+// that runs a lister inside of it.
+internal void
+bench_nested(Coroutine *me){
+    i32 inner_out = 0;
+    Coroutine *inner = coroutine_create(&bench_group, bench_echo);
+    for (i32 i = 0; i < bench_round_trips; i += 1){
+        i32 value = *(i32*)me->in;
+        inner = coroutine_run(&bench_group, inner, &value, &inner_out);
+        *(i32*)me->out = inner_out;
+        coroutine_yield(me);
+    }
+    if (inner != 0){
+        i32 value = 0;
+        inner = coroutine_run(&bench_group, inner, &value, &inner_out);
+    }
+    if (inner != 0){
+        bench_failed = true;
+    }
+}
+
+internal void
+bench_finish_at_once(Coroutine *me){
+    *(i32*)me->out = *(i32*)me->in + 1;
+}
+
+internal f64
+bench_round_trip(Coroutine_Function *func){
+    i32 in = 0;
+    i32 out = 0;
+    Coroutine *co = coroutine_create(&bench_group, func);
+    u64 start = bench_now_ns();
+    for (i32 i = 0; i < bench_round_trips; i += 1){
+        in = i;
+        co = coroutine_run(&bench_group, co, &in, &out);
+        if (co == 0 || out != i*2){
+            bench_failed = true;
+            break;
+        }
+    }
+    u64 end = bench_now_ns();
+    if (co != 0){
+        co = coroutine_run(&bench_group, co, &in, &out);
+    }
+    if (co != 0){
+        bench_failed = true;
+    }
+    return((f64)(end - start)/bench_round_trips);
+}
+
+internal f64
+bench_create_and_finish(i32 count){
+    u64 start = bench_now_ns();
+    for (i32 i = 0; i < count; i += 1){
+        i32 in = i;
+        i32 out = 0;
+        Coroutine *co = coroutine_create(&bench_group, bench_finish_at_once);
+        co = coroutine_run(&bench_group, co, &in, &out);
+        if (co != 0 || out != i + 1){
+            bench_failed = true;
+            break;
+        }
+    }
+    u64 end = bench_now_ns();
+    return((f64)(end - start)/count);
+}
+
+int
+main(int argc, char **argv){
+    bench_round_trips = 1000000;
+    if (argc > 1){
+        bench_round_trips = clamp_bot(1, atoi(argv[1]));
+    }
+    
+    coroutine_system_init(&bench_group);
+    
+    char *kind = (char*)(FRED_COROUTINE_THREADS?"threads":"user space");
+    printf("coroutines: %s, %d round trips\n", kind, bench_round_trips);
+    printf("run/yield round trip        %10.1f ns\n", bench_round_trip(bench_echo));
+    printf("nested run/yield round trip %10.1f ns\n", bench_round_trip(bench_nested));
+    printf("create and run to the end   %10.1f ns\n", bench_create_and_finish(bench_round_trips));
+    
+    if (bench_failed){
+        printf("error: a coroutine passed back the wrong value or did not finish\n");
+    }
+    return(bench_failed?1:0);
+}
+
+// BOTTOM
+
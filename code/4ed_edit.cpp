@@ -263,7 +263,10 @@ edit_single(Thread_Context *tctx, Models *models, Editing_File *file,
     
     edit__apply(tctx, models, file, range, string, behaviors);
     
-    file_clear_layout_cache(file);
+    file_clear_layout_cache_lines(tctx, file, cursor_range.min.line,
+                                  cursor_range.max.line - cursor_range.min.line + 1,
+                                  count_lines(string) + 1,
+                                  replace_range_shift(range, string.size));
     
     Batch_Edit batch = {};
     batch.edit.text = string;
@@ -472,6 +475,17 @@ edit_batch(Thread_Context *tctx, Models *models, Editing_File *file,
             Range_i64 new_range = Ii64_neg_inf;
             Gap_Buffer *buffer = &file->state.buffer;
             
+            // NOTE(allen): The line index is only remeasured in edit_fix_markers,
+            // so the number of lines the batch leaves behind comes from the edits.
+            i64 new_line_count = cursor_range.max.line - cursor_range.min.line + 1;
+            for (Batch_Edit *edit = batch;
+                 edit != 0;
+                 edit = edit->next){
+                new_line_count += count_lines(edit->edit.text);
+                new_line_count -= (buffer_get_line_index(buffer, edit->edit.range.max) -
+                                   buffer_get_line_index(buffer, edit->edit.range.min));
+            }
+            
             i32 batch_count = 0;
             i64 shift = 0;
             for (Batch_Edit *edit = batch;
@@ -512,7 +526,9 @@ edit_batch(Thread_Context *tctx, Models *models, Editing_File *file,
                 }
             }
             
-            file_clear_layout_cache(file);
+            file_clear_layout_cache_lines(tctx, file, cursor_range.min.line,
+                                          cursor_range.max.line - cursor_range.min.line + 1,
+                                          new_line_count, shift);
             
             edit_fix_markers(tctx, models, file, batch);
             
@@ -583,44 +599,67 @@ create_file(Thread_Context *tctx, Models *models, String_Const_u8 file_name, Buf
                     file = working_set_allocate_file(working_set, &models->lifetime_allocator);
                     if (file != 0){
                         if (has_canon_name){
-                            file_bind_file_name(working_set, file, string_from_file_name(&canon));
+                            file_bind_file_name(scratch, working_set, file, string_from_file_name(&canon));
                         }
                         String_Const_u8 front = string_front_of_path(file_name);
                         buffer_bind_name(tctx, models, scratch, working_set, file, front);
                         File_Attributes attributes = {};
-                        file_create_from_string(tctx, models, file, SCu8(""), attributes);
+                        Text_Storage_Kind storage_kind = file_storage_kind_from_size(flags, 0);
+                        file_create_from_string(tctx, models, file, SCu8(""), attributes, storage_kind);
                         result = file;
                     }
                 }
             }
             else{
                 File_Attributes attributes = system_load_attributes(handle);
-                b32 in_heap_mem = false;
-                char *buffer = push_array(scratch, char, (i32)attributes.size);
-                
-                if (buffer == 0){
-                    buffer = heap_array(heap, char, (i32)attributes.size);
-                    Assert(buffer != 0);
-                    in_heap_mem = true;
-                }
                 
-                if (system_load_file(handle, buffer, (i32)attributes.size)){
+                // NOTE(allen): Big files are mapped rather than read, so opening
+                // one costs no copies and only the parts that get looked at or
+                // edited take up memory.
+                String_Const_u8 mapping = file_load_mapping(handle, attributes);
+                if (mapping.str != 0){
                     system_load_close(handle);
                     file = working_set_allocate_file(working_set, &models->lifetime_allocator);
                     if (file != 0){
-                        file_bind_file_name(working_set, file, string_from_file_name(&canon));
+                        file_bind_file_name(scratch, working_set, file, string_from_file_name(&canon));
                         String_Const_u8 front = string_front_of_path(file_name);
                         buffer_bind_name(tctx, models, scratch, working_set, file, front);
-                        file_create_from_string(tctx, models, file, SCu8(buffer, (i32)attributes.size), attributes);
+                        file_create_from_mapping(tctx, models, file, mapping, attributes);
                         result = file;
                     }
+                    else{
+                        system_load_unmap(mapping.str, mapping.size);
+                    }
                 }
                 else{
-                    system_load_close(handle);
-                }
-                
-                if (in_heap_mem){
-                    heap_free(heap, buffer);
+                    b32 in_heap_mem = false;
+                    u8 *buffer = push_array(scratch, u8, attributes.size);
+                    
+                    if (buffer == 0){
+                        buffer = heap_array(heap, u8, attributes.size);
+                        Assert(buffer != 0);
+                        in_heap_mem = true;
+                    }
+                    
+                    if (file_load_contents(handle, buffer, attributes.size)){
+                        system_load_close(handle);
+                        file = working_set_allocate_file(working_set, &models->lifetime_allocator);
+                        if (file != 0){
+                            file_bind_file_name(scratch, working_set, file, string_from_file_name(&canon));
+                            String_Const_u8 front = string_front_of_path(file_name);
+                            buffer_bind_name(tctx, models, scratch, working_set, file, front);
+                            Text_Storage_Kind storage_kind = file_storage_kind_from_size(flags, attributes.size);
+                            file_create_from_string(tctx, models, file, SCu8(buffer, attributes.size), attributes, storage_kind);
+                            result = file;
+                        }
+                    }
+                    else{
+                        system_load_close(handle);
+                    }
+                    
+                    if (in_heap_mem){
+                        heap_free(heap, buffer);
+                    }
                 }
             }
         }
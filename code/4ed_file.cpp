@@ -119,6 +119,39 @@ file_name_terminate(Editing_File_Name *name){
 
 ////////////////////////////////
 
+// NOTE(allen): Files at least this large are kept in a piece tree, spread out
+// edits in a gap buffer of this size spend all of their time moving the gap.
+// They are also mapped instead of read when the platform can do it, the piece
+// tree then reads the unedited text straight from the mapping.
+global i64 file_large_threshold = MB(64);
+
+// NOTE(allen): Returns an empty string when the file is too small to bother or
+// the platform could not map it, in which case the caller reads it instead.
+internal String_Const_u8
+file_load_mapping(Plat_Handle handle, File_Attributes attributes){
+    String_Const_u8 result = {};
+    if (attributes.size >= (u64)file_large_threshold){
+        result.str = (u8*)system_load_map(handle, attributes.size);
+        if (result.str != 0){
+            result.size = attributes.size;
+        }
+    }
+    return(result);
+}
+
+internal b32
+file_load_contents(Plat_Handle handle, u8 *buffer, u64 size){
+    b32 result = true;
+    // NOTE(allen): system_load_file takes a u32 size, so big files are read in
+    // pieces to get past 4GB.
+    for (u64 pos = 0; pos < size && result;){
+        u64 chunk_size = clamp_top(size - pos, (u64)GB(1));
+        result = system_load_file(handle, (char*)buffer + pos, (u32)chunk_size);
+        pos += chunk_size;
+    }
+    return(result);
+}
+
 // TODO(allen): file_name should be String_Const_u8
 internal b32
 save_file_to_name(Thread_Context *tctx, Models *models, Editing_File *file, u8 *file_name){
@@ -154,7 +187,38 @@ save_file_to_name(Thread_Context *tctx, Models *models, Editing_File *file, u8 *
         
         String_Const_u8 saveable_string = buffer_stringify(scratch, buffer, Ii64(0, buffer_size(buffer)));
         
+        // NOTE(allen): Writing over the file under a mapping would change the text
+        // of the buffer underneath it (or fault on the truncated tail), so the
+        // buffer lets go of the mapping before the save and maps the new file
+        // after it.
+        String_Const_u8 mapping = {};
+        if (using_actual_file_name){
+            mapping = buffer_get_borrowed_original(buffer);
+        }
+        if (mapping.str != 0){
+            buffer_rebase_original(buffer, saveable_string.str, saveable_string.size, true);
+            system_load_unmap(mapping.str, mapping.size);
+        }
+        
         File_Attributes new_attributes = system_save_file(scratch, (char*)file_name, saveable_string);
+        
+        if (mapping.str != 0){
+            String_Const_u8 new_mapping = {};
+            Plat_Handle handle = {};
+            if (system_load_handle(scratch, (char*)file_name, &handle)){
+                File_Attributes attributes = system_load_attributes(handle);
+                if (attributes.size == saveable_string.size){
+                    new_mapping = file_load_mapping(handle, attributes);
+                }
+                system_load_close(handle);
+            }
+            if (new_mapping.str != 0){
+                buffer_rebase_original(buffer, new_mapping.str, new_mapping.size, true);
+            }
+            else{
+                buffer_rebase_original(buffer, saveable_string.str, saveable_string.size, false);
+            }
+        }
         if (new_attributes.last_write_time > 0 &&
             using_actual_file_name){
             file->state.saved_record_index = file->state.current_record_index;
@@ -193,13 +257,233 @@ file_get_layout_func(Editing_File *file){
     return(file->settings.layout_func);
 }
 
+internal Text_Storage_Kind
+file_storage_kind_from_size(Buffer_Create_Flag flags, u64 size){
+    Text_Storage_Kind result = TextStorage_GapBuffer;
+    if (HasFlag(flags, BufferCreate_PieceTree) || size >= (u64)file_large_threshold){
+        result = TextStorage_PieceTree;
+    }
+    return(result);
+}
+
+// NOTE(allen): Every block handed out starts after a u64 that says whether it is
+// a chunk (0) or came from the base allocator (1), so free knows where it goes.
+internal void*
+layout_cache__chunk_reserve(void *user_data, u64 size, u64 *size_out, String_Const_u8 location){
+    Line_Layout_Cache *cache = (Line_Layout_Cache*)user_data;
+    u64 *header = 0;
+    if (size <= layout_cache_chunk_size){
+        Layout_Cache_Chunk *chunk = cache->free_chunks;
+        if (chunk != 0){
+            sll_stack_pop(cache->free_chunks);
+            header = (u64*)chunk;
+        }
+        else{
+            header = (u64*)push_array(&cache->chunk_arena, u8, sizeof(u64) + layout_cache_chunk_size);
+        }
+        header[0] = 0;
+        size = layout_cache_chunk_size;
+    }
+    else{
+        header = (u64*)base_allocate__inner(cache->chunk_arena.base_allocator, sizeof(u64) + size, location).str;
+        header[0] = 1;
+    }
+    *size_out = size;
+    return(header + 1);
+}
+
+internal void
+layout_cache__chunk_free(void *user_data, void *ptr){
+    Line_Layout_Cache *cache = (Line_Layout_Cache*)user_data;
+    u64 *header = (u64*)ptr - 1;
+    if (header[0] == 0){
+        Layout_Cache_Chunk *chunk = (Layout_Cache_Chunk*)header;
+        sll_stack_push(cache->free_chunks, chunk);
+    }
+    else{
+        base_free(cache->chunk_arena.base_allocator, header);
+    }
+}
+
+internal void
+layout_cache_init(Line_Layout_Cache *cache, Base_Allocator *allocator){
+    block_zero_struct(cache);
+    cache->entry_arena = make_arena(allocator, sizeof(Line_Layout_Entry)*64);
+    cache->chunk_arena = make_arena(allocator, (sizeof(u64) + layout_cache_chunk_size)*layout_cache_chunks_per_slab);
+    cache->chunk_allocator = make_base_allocator(layout_cache__chunk_reserve, 0, 0,
+                                                 layout_cache__chunk_free, 0, cache);
+    dll_init_sentinel(&cache->lru);
+    cache->table = make_table_Data_u64(allocator, 500);
+}
+
+internal u64
+layout_cache__arena_size(Arena *arena){
+    u64 result = 0;
+    for (Cursor_Node *node = arena->cursor_node;
+         node != 0;
+         node = node->prev){
+        result += sizeof(*node) + node->cursor.cap;
+    }
+    return(result);
+}
+
+internal void
+layout_cache__release(Line_Layout_Cache *cache, Line_Layout_Entry *entry){
+    table_erase(&cache->table, make_data_struct(&entry->key));
+    dll_remove(entry);
+    linalloc_clear(&entry->arena);
+    cache->stats.entry_count -= 1;
+    cache->stats.bytes_in_use -= entry->size;
+    sll_stack_push(cache->free_entries, entry);
+}
+
+internal void
+layout_cache_clear(Line_Layout_Cache *cache){
+    for (;cache->lru.next != &cache->lru;){
+        layout_cache__release(cache, cache->lru.next);
+    }
+}
+
+internal void
+layout_cache_free(Line_Layout_Cache *cache){
+    layout_cache_clear(cache);
+    table_free(&cache->table);
+    linalloc_clear(&cache->entry_arena);
+    linalloc_clear(&cache->chunk_arena);
+    block_zero_struct(cache);
+}
+
+internal Layout_Item_List*
+layout_cache_lookup(Line_Layout_Cache *cache, Line_Layout_Key *key){
+    Layout_Item_List *result = 0;
+    u64 val = 0;
+    if (table_read(&cache->table, make_data_struct(key), &val)){
+        Line_Layout_Entry *entry = (Line_Layout_Entry*)IntAsPtr(val);
+        dll_remove(entry);
+        dll_insert(&cache->lru, entry);
+        cache->stats.hit_count += 1;
+        result = &entry->list;
+    }
+    else{
+        cache->stats.miss_count += 1;
+    }
+    return(result);
+}
+
+// NOTE(allen): The new entry's arena is where the layout function puts the
+// layout; the entry is not in the cache until layout_cache_insert.
+internal Line_Layout_Entry*
+layout_cache_new_entry(Line_Layout_Cache *cache, Line_Layout_Key *key){
+    Line_Layout_Entry *entry = cache->free_entries;
+    if (entry != 0){
+        sll_stack_pop(cache->free_entries);
+    }
+    else{
+        entry = push_array(&cache->entry_arena, Line_Layout_Entry, 1);
+    }
+    block_zero_struct(entry);
+    block_copy_struct(&entry->key, key);
+    entry->arena = make_arena(&cache->chunk_allocator, layout_cache_chunk_size - sizeof(Cursor_Node));
+    return(entry);
+}
+
+// NOTE(allen): Evicts from the least recently used end until the cache fits in
+// budget again, but never the entry keep (the one just inserted), so the layout
+// that is returned stays valid until the next layout is requested from this cache.
+internal void
+layout_cache_trim(Line_Layout_Cache *cache, u64 budget, Line_Layout_Entry *keep){
+    cache->stats.byte_budget = budget;
+    for (;cache->stats.bytes_in_use > budget &&
+         cache->lru.prev != &cache->lru && cache->lru.prev != keep;){
+        layout_cache__release(cache, cache->lru.prev);
+        cache->stats.eviction_count += 1;
+    }
+}
+
+internal void
+layout_cache_insert(Line_Layout_Cache *cache, Line_Layout_Entry *entry, u64 budget){
+    entry->size = sizeof(*entry) + layout_cache__arena_size(&entry->arena);
+    dll_insert(&cache->lru, entry);
+    table_insert(&cache->table, make_data_struct(&entry->key), (u64)PtrAsInt(entry));
+    cache->stats.entry_count += 1;
+    cache->stats.bytes_in_use += entry->size;
+    layout_cache_trim(cache, budget, entry);
+}
+
+internal void
+layout_cache__shift_list(Layout_Item_List *list, i64 shift){
+    for (Layout_Item_Block *block = list->first;
+         block != 0;
+         block = block->next){
+        Layout_Item *item = block->items;
+        for (i64 i = 0; i < block->item_count; i += 1, item += 1){
+            item->index += shift;
+        }
+    }
+    list->input_index_range.first += shift;
+    list->input_index_range.one_past_last += shift;
+    list->manifested_index_range.first += shift;
+    list->manifested_index_range.one_past_last += shift;
+}
+
+// NOTE(allen): For an edit that replaced the lines [first_line, first_line +
+// old_count) with new_count lines and moved the text after them by pos_shift.
+// The layouts of the replaced lines are dropped, the ones below the edit are
+// renumbered and shifted into place, and the ones above stay as they are.
+internal void
+layout_cache_edit_lines(Line_Layout_Cache *cache, i64 first_line, i64 old_count, i64 new_count, i64 pos_shift){
+    i64 one_past_last = first_line + old_count;
+    i64 line_shift = new_count - old_count;
+    
+    Line_Layout_Entry *moved = 0;
+    for (Line_Layout_Entry *entry = cache->lru.next, *next = 0;
+         entry != &cache->lru;
+         entry = next){
+        next = entry->next;
+        i64 line_number = entry->key.line_number;
+        if (first_line <= line_number && line_number < one_past_last){
+            layout_cache__release(cache, entry);
+        }
+        else if (line_number >= one_past_last && (line_shift != 0 || pos_shift != 0)){
+            // NOTE(allen): Everything gets out of the table before anything goes
+            // back in, a renumbered line could land on a key that is still there.
+            table_erase(&cache->table, make_data_struct(&entry->key));
+            entry->key.line_number += line_shift;
+            layout_cache__shift_list(&entry->list, pos_shift);
+            entry->next_moved = moved;
+            moved = entry;
+        }
+    }
+    for (Line_Layout_Entry *entry = moved;
+         entry != 0;
+         entry = entry->next_moved){
+        table_insert(&cache->table, make_data_struct(&entry->key), (u64)PtrAsInt(entry));
+    }
+}
+
+internal void
+file_clear_line_heights(Editing_File *file){
+    for (i32 i = 0; i < file_line_heights_max; i += 1){
+        File_Line_Heights *heights = &file->state.line_heights[i];
+        if (heights->in_use){
+            line_height_index_free(&heights->index);
+            heights->in_use = false;
+        }
+    }
+}
+
 internal void
-file_create_from_string(Thread_Context *tctx, Models *models, Editing_File *file, String_Const_u8 val, File_Attributes attributes){
+file_create__buffer(Thread_Context *tctx, Models *models, Editing_File *file, String_Const_u8 val, File_Attributes attributes, Text_Storage_Kind storage_kind, b32 borrow){
     Scratch_Block scratch(tctx);
     
     Base_Allocator *allocator = tctx->allocator;
     block_zero_struct(&file->state);
-    buffer_init(&file->state.buffer, val.str, val.size, allocator);
+    if (borrow){
+        buffer_init_borrowed(&file->state.buffer, val.str, val.size, allocator);
+    }
+    else{
+        buffer_init(&file->state.buffer, val.str, val.size, allocator, storage_kind);
+    }
     
     if (buffer_size(&file->state.buffer) < (i64)val.size){
         file->settings.dos_write_mode = true;
@@ -215,8 +499,7 @@ file_create_from_string(Thread_Context *tctx, Models *models, Editing_File *file
     file->lifetime_object = lifetime_alloc_object(&models->lifetime_allocator, DynamicWorkspace_Buffer, file);
     history_init(tctx, models, &file->state.history);
     
-    file->state.cached_layouts_arena = make_arena(allocator);
-    file->state.line_layout_table = make_table_Data_u64(allocator, 500);
+    layout_cache_init(&file->state.layout_cache, allocator);
     
     file->settings.is_initialized = true;
     
@@ -240,6 +523,17 @@ file_create_from_string(Thread_Context *tctx, Models *models, Editing_File *file
     }
 }
 
+internal void
+file_create_from_string(Thread_Context *tctx, Models *models, Editing_File *file, String_Const_u8 val, File_Attributes attributes, Text_Storage_Kind storage_kind){
+    file_create__buffer(tctx, models, file, val, attributes, storage_kind, false);
+}
+
+// NOTE(allen): The file takes ownership of the mapping and unmaps it in file_free.
+internal void
+file_create_from_mapping(Thread_Context *tctx, Models *models, Editing_File *file, String_Const_u8 mapping, File_Attributes attributes){
+    file_create__buffer(tctx, models, file, mapping, attributes, TextStorage_PieceTree, true);
+}
+
 internal void
 file_free(Thread_Context *tctx, Models *models, Editing_File *file){
     Lifetime_Allocator *lifetime_allocator = &models->lifetime_allocator;
@@ -247,16 +541,16 @@ file_free(Thread_Context *tctx, Models *models, Editing_File *file){
     
     lifetime_free_object(lifetime_allocator, file->lifetime_object);
     
-    Gap_Buffer *buffer = &file->state.buffer;
-    if (buffer->data){
-        base_free(buffer->allocator, buffer->data);
-        base_free(buffer->allocator, buffer->line_starts);
+    String_Const_u8 mapping = buffer_get_borrowed_original(&file->state.buffer);
+    buffer_free(&file->state.buffer);
+    if (mapping.str != 0){
+        system_load_unmap(mapping.str, mapping.size);
     }
     
     history_free(tctx, &file->state.history);
     
-    linalloc_clear(&file->state.cached_layouts_arena);
-    table_free(&file->state.line_layout_table);
+    layout_cache_free(&file->state.layout_cache);
+    file_clear_line_heights(file);
 }
 
 ////////////////////////////////
@@ -278,6 +572,62 @@ file_get_managed_scope(Editing_File *file){
 
 ////////////////////////////////
 
+internal Line_Height_Key
+file_line_height_key(Layout_Function *layout_func, f32 width, Face *face){
+    Line_Height_Key key = {};
+    key.layout_func = layout_func;
+    key.face_id = face->id;
+    key.face_version_number = face->version_number;
+    key.width = width;
+    return(key);
+}
+
+internal File_Line_Heights*
+file_find_line_heights(Editing_File *file, Line_Height_Key key){
+    File_Line_Heights *result = 0;
+    for (i32 i = 0; i < file_line_heights_max; i += 1){
+        File_Line_Heights *heights = &file->state.line_heights[i];
+        if (heights->in_use && block_match_struct(&heights->key, &key)){
+            result = heights;
+            break;
+        }
+    }
+    return(result);
+}
+
+internal Line_Height_Index*
+file_get_line_heights(Thread_Context *tctx, Editing_File *file,
+                      Layout_Function *layout_func, f32 width, Face *face){
+    Line_Height_Key key = file_line_height_key(layout_func, width, face);
+    File_Line_Heights *heights = file_find_line_heights(file, key);
+    if (heights == 0){
+        heights = &file->state.line_heights[0];
+        for (i32 i = 1; i < file_line_heights_max && heights->in_use; i += 1){
+            File_Line_Heights *slot = &file->state.line_heights[i];
+            if (!slot->in_use || slot->last_use < heights->last_use){
+                heights = slot;
+            }
+        }
+        if (heights->in_use){
+            line_height_index_free(&heights->index);
+        }
+        heights->in_use = true;
+        heights->key = key;
+        line_height_index_init(&heights->index, tctx->allocator);
+    }
+    
+    // NOTE(allen): Every edit path keeps the heights in step with the line count,
+    // a mismatch means something changed the text behind our back.
+    i64 line_count = buffer_line_count(&file->state.buffer);
+    if (line_height_index_line_count(&heights->index) != line_count){
+        line_height_index_reset(&heights->index, line_count);
+    }
+    
+    file->state.line_heights_use_counter += 1;
+    heights->last_use = file->state.line_heights_use_counter;
+    return(&heights->index);
+}
+
 internal Layout_Item_List
 file_get_line_layout(Thread_Context *tctx, Models *models, Editing_File *file,
                      Layout_Function *layout_func, f32 width, Face *face, i64 line_number){
@@ -291,27 +641,24 @@ file_get_line_layout(Thread_Context *tctx, Models *models, Editing_File *file,
         key.width = width;
         key.line_number = line_number;
         
-        String_Const_u8 key_data = make_data_struct(&key);
-        
-        Layout_Item_List *list = 0;
-        
-        Table_Lookup lookup = table_lookup(&file->state.line_layout_table, key_data);
-        if (lookup.found_match){
-            u64 val = 0;
-            table_read(&file->state.line_layout_table, lookup, &val);
-            list = (Layout_Item_List*)IntAsPtr(val);
-        }
-        else{
-            list = push_array(&file->state.cached_layouts_arena, Layout_Item_List, 1);
+        Line_Layout_Cache *cache = &file->state.layout_cache;
+        Layout_Item_List *list = layout_cache_lookup(cache, &key);
+        if (list == 0){
+            Line_Layout_Entry *entry = layout_cache_new_entry(cache, &key);
             Range_i64 line_range = buffer_get_pos_range_from_line_number(&file->state.buffer, line_number);
             
             Application_Links app = {};
             app.tctx = tctx;
             app.cmd_context = models;
-            *list = layout_func(&app, &file->state.cached_layouts_arena,
-                                file->id, line_range, face->id, width);
-            key_data = push_data_copy(&file->state.cached_layouts_arena, key_data);
-            table_insert(&file->state.line_layout_table, key_data, (u64)PtrAsInt(list));
+            entry->list = layout_func(&app, &entry->arena,
+                                      file->id, line_range, face->id, width);
+            layout_cache_insert(cache, entry, models->layout_cache_budget);
+            list = &entry->list;
+            
+            File_Line_Heights *heights = file_find_line_heights(file, file_line_height_key(layout_func, width, face));
+            if (heights != 0){
+                line_height_index_set(&heights->index, line_number - 1, list->height);
+            }
         }
         block_copy_struct(&result, list);
     }
@@ -321,8 +668,64 @@ file_get_line_layout(Thread_Context *tctx, Models *models, Editing_File *file,
 
 internal void
 file_clear_layout_cache(Editing_File *file){
-    linalloc_clear(&file->state.cached_layouts_arena);
-    table_clear(&file->state.line_layout_table);
+    layout_cache_clear(&file->state.layout_cache);
+    file_clear_line_heights(file);
+}
+
+// NOTE(allen): A mapping follows the file on disk, so once something else
+// writes the file the text under the buffer can change or, if the file got
+// shorter, stop being there.  The pieces that still use the mapping are copied
+// out and the mapping is let go, so the text stops moving.  Whatever was written
+// before this point is already in the text with no edit record, so the buffer
+// is marked and refuses to save until it is reopened, and the line starts and
+// layouts are measured again to match it.
+internal void
+file_detach_mapping(Thread_Context *tctx, Editing_File *file){
+    String_Const_u8 mapping = buffer_release_borrowed_original(&file->state.buffer);
+    if (mapping.str != 0){
+        file->state.mapping_changed = true;
+        system_load_unmap(mapping.str, mapping.size);
+        Scratch_Block scratch(tctx);
+        buffer_measure_starts(scratch, &file->state.buffer);
+        file_clear_layout_cache(file);
+    }
+}
+
+// NOTE(allen): For an edit that replaced the lines [first_line, first_line +
+// old_count) with new_count lines (line numbers are one based) and moved the
+// text after them by pos_shift.  The layouts and heights of the other lines
+// stay as they were.
+internal void
+file_clear_layout_cache_lines(Thread_Context *tctx, Editing_File *file,
+                              i64 first_line, i64 old_count, i64 new_count, i64 pos_shift){
+    layout_cache_edit_lines(&file->state.layout_cache, first_line, old_count, new_count, pos_shift);
+    Scratch_Block scratch(tctx);
+    for (i32 i = 0; i < file_line_heights_max; i += 1){
+        File_Line_Heights *heights = &file->state.line_heights[i];
+        if (heights->in_use){
+            Line_Height_Index *index = &heights->index;
+            if (1 <= first_line && first_line - 1 + old_count <= line_height_index_line_count(index)){
+                line_height_index_replace(index, scratch, first_line - 1, old_count, new_count);
+            }
+            else{
+                line_height_index_reset(index, 0);
+            }
+        }
+    }
+}
+
+// NOTE(allen): Lays out every line in [first, one_past_last) (zero based) that
+// the index does not have a height for yet.
+internal void
+file_fill_line_heights(Thread_Context *tctx, Models *models, Editing_File *file,
+                       Line_Height_Index *index, Layout_Function *layout_func, f32 width, Face *face,
+                       i64 first, i64 one_past_last){
+    for (i64 line = line_height_index_first_unknown(index, first, one_past_last);
+         line < one_past_last;
+         line = line_height_index_first_unknown(index, line + 1, one_past_last)){
+        Layout_Item_List list = file_get_line_layout(tctx, models, file, layout_func, width, face, line + 1);
+        line_height_index_set(index, line, list.height);
+    }
 }
 
 internal Line_Shift_Vertical
@@ -331,57 +734,39 @@ file_line_shift_y(Thread_Context *tctx, Models *models, Editing_File *file,
                   i64 line_number, f32 y_delta){
     Line_Shift_Vertical result = {};
     
-    f32 line_y = 0.f;
+    Line_Height_Index *heights = file_get_line_heights(tctx, file, layout_func, width, face);
+    i64 line_count = line_height_index_line_count(heights);
+    i64 base_line = clamp(1, line_number, line_count) - 1;
     
-    if (y_delta < 0.f){
-        // NOTE(allen): Iterating upward
-        b32 has_result = false;
-        for (;;){
-            if (line_y <= y_delta){
-                has_result = true;
-                result.line = line_number;
-                result.y_delta = line_y;
-                break;
-            }
-            line_number -= 1;
-            if (line_number <= 0){
-                line_number = 1;
-                break;
-            }
-            Layout_Item_List line = file_get_line_layout(tctx, models, file, layout_func,
-                                                         width, face, line_number);
-            line_y -= line.height;
-        }
-        if (!has_result){
-            result.line = line_number;
-            result.y_delta = line_y;
+    // NOTE(allen): Search with the lines that have no height yet counted as one
+    // line of text, then lay out whatever lies between the base line and the
+    // line that was found and search again.  Once that stretch is all known the
+    // answer is exact, so only the lines that are crossed ever get laid out.
+    f32 unknown_height = face->metrics.line_height;
+    f64 base_y = 0;
+    i64 line = base_line;
+    for (;;){
+        base_y = line_height_index_y_of_line(heights, base_line, unknown_height);
+        line = line_height_index_line_from_y(heights, base_y + y_delta, unknown_height);
+        Range_i64 range = {};
+        if (y_delta < 0.f){
+            line = clamp_top(line, base_line);
+            range = Ii64(line, base_line);
         }
-    }
-    else{
-        // NOTE(allen): Iterating downward
-        b32 has_result = false;
-        i64 line_count = buffer_line_count(&file->state.buffer);
-        for (;;line_number += 1){
-            Layout_Item_List line = file_get_line_layout(tctx, models, file, layout_func,
-                                                         width, face, line_number);
-            f32 next_y = line_y + line.height;
-            if (y_delta < next_y){
-                has_result = true;
-                result.line = line_number;
-                result.y_delta = line_y;
-                break;
-            }
-            if (line_number >= line_count){
-                break;
-            }
-            line_y = next_y;
+        else{
+            line = clamp_bot(line, base_line);
+            range = Ii64(base_line, line + 1);
         }
-        if (!has_result){
-            result.line = line_number;
-            result.y_delta = line_y;
+        if (line_height_index_first_unknown(heights, range.first, range.one_past_last) == range.one_past_last){
+            break;
         }
+        file_fill_line_heights(tctx, models, file, heights, layout_func, width, face,
+                               range.first, range.one_past_last);
     }
     
+    result.line = line + 1;
+    result.y_delta = (f32)(line_height_index_y_of_line(heights, line, unknown_height) - base_y);
+    
     return(result);
 }
 
@@ -391,11 +776,15 @@ file_line_y_difference(Thread_Context *tctx, Models *models, Editing_File *file,
                        i64 line_a, i64 line_b){
     f32 result = 0.f;
     if (line_a != line_b){
+        Line_Height_Index *heights = file_get_line_heights(tctx, file, layout_func, width, face);
+        i64 line_count = line_height_index_line_count(heights);
         Range_i64 line_range = Ii64(line_a, line_b);
-        for (i64 i = line_range.min; i < line_range.max; i += 1){
-            Layout_Item_List line = file_get_line_layout(tctx, models, file, layout_func, width, face, i);
-            result += line.height;
-        }
+        i64 first = clamp(1, line_range.min, line_count + 1) - 1;
+        i64 one_past_last = clamp(1, line_range.max, line_count + 1) - 1;
+        file_fill_line_heights(tctx, models, file, heights, layout_func, width, face,
+                               first, one_past_last);
+        result = (f32)(line_height_index_y_of_line(heights, one_past_last, 0.f) -
+                       line_height_index_y_of_line(heights, first, 0.f));
         if (line_a < line_b){
             result *= -1.f;
         }
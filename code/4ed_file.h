@@ -42,6 +42,59 @@ struct Line_Layout_Key{
     i64 line_number;
 };
 
+// NOTE(allen): Every cached line layout lives in its own arena so that it can be
+// thrown out by itself.  The entries are kept in least recently used order and
+// the least recently used ones go when the cache is over its byte budget.
+struct Line_Layout_Entry{
+    Line_Layout_Entry *next;
+    Line_Layout_Entry *prev;
+    Line_Layout_Entry *next_moved;
+    Line_Layout_Key key;
+    Arena arena;
+    Layout_Item_List list;
+    u64 size;
+};
+
+// NOTE(allen): The entry arenas take their memory in chunks of
+// layout_cache_chunk_size cut from slabs of the cache's own, and released chunks
+// go on a free list for the next entry, so caching a line does not go to the
+// system allocator.  Anything bigger than a chunk is passed through.
+#define layout_cache_chunk_size KB(4)
+#define layout_cache_chunks_per_slab 64
+
+struct Layout_Cache_Chunk{
+    Layout_Cache_Chunk *next;
+};
+
+struct Line_Layout_Cache{
+    Arena entry_arena;
+    Arena chunk_arena;
+    Base_Allocator chunk_allocator;
+    Layout_Cache_Chunk *free_chunks;
+    Line_Layout_Entry lru;
+    Line_Layout_Entry *free_entries;
+    Table_Data_u64 table;
+    Layout_Cache_Stats stats;
+};
+
+struct Line_Height_Key{
+    Layout_Function *layout_func;
+    Face_ID face_id;
+    i32 face_version_number;
+    f32 width;
+};
+
+// NOTE(allen): Views that show a file with different widths or faces each get
+// their own heights, the least recently used slot is recycled for a new key.
+#define file_line_heights_max 4
+
+struct File_Line_Heights{
+    b32 in_use;
+    u64 last_use;
+    Line_Height_Key key;
+    Line_Height_Index index;
+};
+
 typedef i32 File_Save_State;
 enum{
     FileSaveState_Normal,
@@ -57,6 +110,10 @@ struct Editing_File_State{
     
     Dirty_State dirty;
     File_Save_State save_state;
+    // NOTE(allen): Set when the file under the buffer's mapping changed on disk,
+    // the text may have taken some of the new bytes with no edit to show for it.
+    // The buffer is not saved again until it is reopened.
+    b32 mapping_changed;
     
     File_Edit_Positions edit_pos_most_recent;
     File_Edit_Positions edit_pos_stack[16];
@@ -64,8 +121,10 @@ struct Editing_File_State{
     
     Child_Process_ID attached_child_process;
     
-    Arena cached_layouts_arena;
-    Table_Data_u64 line_layout_table;
+    Line_Layout_Cache layout_cache;
+    
+    File_Line_Heights line_heights[file_line_heights_max];
+    u64 line_heights_use_counter;
 };
 
 struct Editing_File_Name{
@@ -88,6 +147,7 @@ struct Editing_File{
     Editing_File_Name base_name;
     Editing_File_Name unique_name;
     Editing_File_Name canon;
+    b32 has_listener;
 };
 
 struct Buffer_Point_Delta{
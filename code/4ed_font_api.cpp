@@ -24,6 +24,17 @@ define_api(Arena *arena){
         api_param(arena, call, "f32", "scale_factor");
     }
     
+    {
+        API_Call *call = api_call(arena, api, "make_glyph", "b32");
+        api_param(arena, call, "Face*", "face");
+        api_param(arena, call, "u16", "index");
+    }
+    
+    {
+        API_Call *call = api_call(arena, api, "release_face", "void");
+        api_param(arena, call, "Face*", "face");
+    }
+    
     return(api);
 }
 
@@ -46,12 +46,20 @@ struct Face{
     Texture_Kind texture_kind;
     u32 texture;
     Vec3_f32 texture_dim;
+    
+    // NOTE(allen): Only set on faces that rasterize each glyph the first time it
+    // is drawn, with font_make_glyph.  The rest of the state belongs to the font
+    // provider.
+    b8 *glyph_is_ready;
+    void *lazy_glyphs;
 };
 
 ////////////////////////////////
 
 // NOTE(allen): Platform layer calls - implemented in a "font provider"
 typedef Face *Font_Make_Face_Function(Arena *arena, Face_Description *description, f32 scale_factor);
+typedef b32 Font_Make_Glyph_Function(Face *face, u16 index);
+typedef void Font_Release_Face_Function(Face *face);
 
 #endif
 
@@ -14,6 +14,7 @@
 #undef internal
 #include <ft2build.h>
 #include FT_FREETYPE_H
+#include FT_ADVANCES_H
 #define internal static
 
 internal u32
@@ -183,6 +184,319 @@ ft__glyph_bounds_store_uv_raw(Vec3_i32 p, Vec2_i32 dim, Glyph_Bounds *bounds){
     bounds->w = (f32)p.z;
 }
 
+// NOTE(allen): Copies the glyph the slot holds out as one byte per pixel.
+internal void
+ft__copy_glyph_bitmap(FT_GlyphSlot ft_glyph, Vec2_i32 dim, b32 aa_1bit_mono, u8 *dst){
+    switch (ft_glyph->bitmap.pixel_mode){
+        case FT_PIXEL_MODE_MONO:
+        {
+            NotImplemented;
+        }break;
+        
+        case FT_PIXEL_MODE_GRAY:
+        {
+            u8 *src_line = ft_glyph->bitmap.buffer;
+            if (ft_glyph->bitmap.pitch < 0){
+                src_line = ft_glyph->bitmap.buffer + (-ft_glyph->bitmap.pitch)*(dim.y - 1);
+            }
+            for (i32 y = 0; y < dim.y; y += 1){
+                u8 *src_pixel = src_line;
+                for (i32 x = 0; x < dim.x; x += 1){
+                    if (aa_1bit_mono){
+                        u8 s = *src_pixel;
+                        if (s > 0){
+                            s = 255;
+                        }
+                        *dst = s;
+                    }
+                    else{
+                        *dst = *src_pixel;
+                    }
+                    dst += 1;
+                    src_pixel += 1;
+                }
+                src_line += ft_glyph->bitmap.pitch;
+            }
+        }break;
+        
+        default:
+        {
+            NotImplemented;
+        }break;
+    }
+}
+
+internal void
+ft__glyph_bounds_store_xy_off(FT_GlyphSlot ft_glyph, Vec2_i32 dim, f32 ascent, Glyph_Bounds *bounds){
+    bounds->xy_off.x0 = (f32)(ft_glyph->bitmap_left);
+    bounds->xy_off.y0 = (f32)(ascent - ft_glyph->bitmap_top);
+    bounds->xy_off.x1 = (f32)(bounds->xy_off.x0 + dim.x);
+    bounds->xy_off.y1 = (f32)(bounds->xy_off.y0 + dim.y);
+}
+
+internal void
+ft__glyph_bounds_normalize_uv(Vec3_f32 texture_dim, Glyph_Bounds *bounds){
+    bounds->uv.x1 = (bounds->uv.x0 + bounds->uv.x1)/texture_dim.x;
+    bounds->uv.y1 = (bounds->uv.y0 + bounds->uv.y1)/texture_dim.y;
+    bounds->uv.x0 =  bounds->uv.x0/texture_dim.x;
+    bounds->uv.y0 =  bounds->uv.y0/texture_dim.y;
+}
+
+global u8 ft__white_data[16] = {
+    0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF,
+};
+
+////////////////////////////////
+
+// NOTE(allen): Rasterizes every glyph of the face up front and packs them into
+// one texture that is just big enough.
+internal void
+ft__face_make_all_glyphs(Arena *arena, Face *face, FT_Face ft_face, u32 load_flags, b32 aa_1bit_mono){
+    Face_Metrics *met = &face->metrics;
+    u16 index_count = face->advance_map.index_count;
+    
+    Temp_Memory_Block temp_memory(arena);
+    struct Bitmap{
+        Vec2_i32 dim;
+        u8 *data;
+    };
+    Bitmap *glyph_bitmaps = push_array(arena, Bitmap, index_count);
+    
+    for (u16 i = 0; i < index_count; i += 1){
+        Bitmap *bitmap = &glyph_bitmaps[i];
+        
+        FT_Error error = FT_Load_Glyph(ft_face, i, load_flags);
+        if (error == 0){
+            FT_GlyphSlot ft_glyph = ft_face->glyph;
+            Vec2_i32 dim = V2i32(ft_glyph->bitmap.width, ft_glyph->bitmap.rows);
+            bitmap->dim = dim;
+            bitmap->data = push_array(arena, u8, dim.x*dim.y);
+            
+            ft__glyph_bounds_store_xy_off(ft_glyph, dim, met->ascent, &face->bounds[i]);
+            ft__copy_glyph_bitmap(ft_glyph, dim, aa_1bit_mono, bitmap->data);
+            
+            face->advance_map.advance[i] = f32_ceil32(ft_glyph->advance.x/64.0f);
+        }
+    }
+    
+    Bitmap white = {};
+    white.dim = V2i32(4, 4);
+    white.data = ft__white_data;
+    
+    Bad_Rect_Pack pack = {};
+    ft__bad_rect_pack_init(&pack, V2i32(1024, 1024));
+    ft__glyph_bounds_store_uv_raw(ft__bad_rect_pack_next(&pack, white.dim), white.dim, &face->white);
+    for (u16 i = 0; i < index_count; i += 1){
+        Vec2_i32 dim = glyph_bitmaps[i].dim;
+        ft__glyph_bounds_store_uv_raw(ft__bad_rect_pack_next(&pack, dim), dim, &face->bounds[i]);
+    }
+    ft__bad_rect_store_finish(&pack);
+    
+    Texture_Kind texture_kind = TextureKind_Mono;
+    u32 texture = graphics_get_texture(pack.dim, texture_kind);
+    
+    /* NOTE simon (06/01/25): This assumes that every platforms don't use 0 as a valid texture id.
+    This is valid for OpenGL and the DX11 implementaion. Someone needs to check the MAC versions. */
+    if (texture != 0 ){
+        
+        face->texture_kind = texture_kind;
+        face->texture = texture;
+        
+        Vec3_f32 texture_dim = V3f32(pack.dim);
+        face->texture_dim = texture_dim;
+        
+        {
+            Vec3_i32 p = V3i32((i32)face->white.uv.x0, (i32)face->white.uv.y0, (i32)face->white.w);
+            Vec3_i32 dim = V3i32(white.dim.x, white.dim.y, 1);
+            graphics_fill_texture(texture_kind, texture, p, dim, white.data);
+            ft__glyph_bounds_normalize_uv(texture_dim, &face->white);
+        }
+        
+        for (u16 i = 0; i < index_count; i += 1){
+            Vec3_i32 p = V3i32((i32)face->bounds[i].uv.x0, (i32)face->bounds[i].uv.y0, (i32)face->bounds[i].w);
+            Vec3_i32 dim = V3i32(glyph_bitmaps[i].dim.x, glyph_bitmaps[i].dim.y, 1);
+            graphics_fill_texture(texture_kind, texture, p, dim, glyph_bitmaps[i].data);
+            ft__glyph_bounds_normalize_uv(texture_dim, &face->bounds[i]);
+        }
+    }
+}
+
+////////////////////////////////
+
+// NOTE(allen): Fonts with more glyphs than this, which is CJK fonts and the big
+// symbol fonts, only get their advances when they are loaded.  Latin fonts with
+// a few thousand glyphs stay under it and are rasterized up front as always.  A glyph is rasterized
+// the first time draw_font_glyph needs it and packed into the next free spot of
+// a texture array of fixed size pages.  The pages are also kept in memory, so
+// when the last page fills up the texture can be remade with room for twice as
+// many and filled back in.  The page size never changes, so the uvs of the
+// glyphs that are already out stay good.
+#define ft__eager_glyph_limit 8192
+#define ft__lazy_page_dim 512
+
+struct FT_Lazy_Glyphs{
+    FT_Library ft;
+    FT_Face ft_face;
+    u32 load_flags;
+    b32 aa_1bit_mono;
+    Bad_Rect_Pack pack;
+    Base_Allocator *allocator;
+    u8 *pages;
+    i32 page_count;
+};
+
+internal b32
+ft__lazy_glyphs_reserve_pages(Face *face, FT_Lazy_Glyphs *lazy, i32 page_count){
+    b32 result = true;
+    if (page_count > lazy->page_count){
+        i32 new_page_count = Max(page_count, lazy->page_count*2);
+        u64 page_size = ft__lazy_page_dim*ft__lazy_page_dim;
+        u32 texture = graphics_get_texture(V3i32(ft__lazy_page_dim, ft__lazy_page_dim, new_page_count), face->texture_kind);
+        if (texture != 0){
+            u8 *pages = base_array(lazy->allocator, u8, page_size*new_page_count);
+            block_zero(pages + page_size*lazy->page_count, page_size*(new_page_count - lazy->page_count));
+            if (lazy->pages != 0){
+                block_copy(pages, lazy->pages, page_size*lazy->page_count);
+                base_free(lazy->allocator, lazy->pages);
+                for (i32 i = 0; i < lazy->page_count; i += 1){
+                    graphics_fill_texture(face->texture_kind, texture, V3i32(0, 0, i),
+                                          V3i32(ft__lazy_page_dim, ft__lazy_page_dim, 1), pages + page_size*i);
+                }
+            }
+            if (face->texture != 0){
+                graphics_free_texture(face->texture);
+            }
+            face->texture = texture;
+            face->texture_dim = V3f32((f32)ft__lazy_page_dim, (f32)ft__lazy_page_dim, (f32)new_page_count);
+            lazy->pages = pages;
+            lazy->page_count = new_page_count;
+        }
+        else{
+            result = false;
+        }
+    }
+    return(result);
+}
+
+// NOTE(allen): Writes the bitmap into its spot in the pages and in the texture.
+internal void
+ft__lazy_glyphs_store(Face *face, FT_Lazy_Glyphs *lazy, Vec3_i32 p, Vec2_i32 dim, u8 *data){
+    u64 page_size = ft__lazy_page_dim*ft__lazy_page_dim;
+    u8 *dst = lazy->pages + page_size*p.z + ft__lazy_page_dim*p.y + p.x;
+    u8 *src = data;
+    for (i32 y = 0; y < dim.y; y += 1){
+        block_copy(dst, src, dim.x);
+        dst += ft__lazy_page_dim;
+        src += dim.x;
+    }
+    graphics_fill_texture(face->texture_kind, face->texture, p, V3i32(dim.x, dim.y, 1), data);
+}
+
+internal b32
+ft__face_init_lazy_glyphs(Arena *arena, Face *face, FT_Library ft, FT_Face ft_face, u32 load_flags, b32 aa_1bit_mono){
+    Face_Metrics *met = &face->metrics;
+    u16 index_count = face->advance_map.index_count;
+    
+    FT_Lazy_Glyphs *lazy = push_array_zero(arena, FT_Lazy_Glyphs, 1);
+    lazy->ft = ft;
+    lazy->ft_face = ft_face;
+    lazy->load_flags = load_flags;
+    lazy->aa_1bit_mono = aa_1bit_mono;
+    lazy->allocator = arena->base_allocator;
+    ft__bad_rect_pack_init(&lazy->pack, V2i32(ft__lazy_page_dim, ft__lazy_page_dim));
+    face->lazy_glyphs = lazy;
+    face->glyph_is_ready = push_array_zero(arena, b8, index_count);
+    block_zero(face->bounds, sizeof(*face->bounds)*index_count);
+    
+    // NOTE(allen): The advances come from the font tables without loading any
+    // outlines, taken down to the 26.6 precision a loaded glyph would report.
+    // Light hinting only rounds them, so that is all that is done here when
+    // hinting is on.
+    {
+        Temp_Memory_Block temp(arena);
+        FT_Fixed *advances = push_array_zero(arena, FT_Fixed, index_count);
+        FT_Get_Advances(ft_face, 0, index_count, FT_LOAD_NO_HINTING, advances);
+        b32 hinting = face->description.parameters.hinting;
+        for (u16 i = 0; i < index_count; i += 1){
+            f32 advance = ((advances[i] + 512) >> 10)/64.f;
+            if (hinting){
+                advance = f32_round32(advance);
+            }
+            face->advance_map.advance[i] = f32_ceil32(advance);
+        }
+    }
+    
+    face->texture_kind = TextureKind_Mono;
+    b32 result = ft__lazy_glyphs_reserve_pages(face, lazy, 1);
+    if (result){
+        Vec2_i32 dim = V2i32(4, 4);
+        Vec3_i32 p = ft__bad_rect_pack_next(&lazy->pack, dim);
+        ft__glyph_bounds_store_uv_raw(p, dim, &face->white);
+        ft__lazy_glyphs_store(face, lazy, p, dim, ft__white_data);
+        ft__glyph_bounds_normalize_uv(face->texture_dim, &face->white);
+    }
+    else{
+        face->lazy_glyphs = 0;
+        face->glyph_is_ready = 0;
+    }
+    return(result);
+}
+
+internal b32
+ft__font_make_glyph(Face *face, u16 index){
+    b32 result = false;
+    FT_Lazy_Glyphs *lazy = (FT_Lazy_Glyphs*)face->lazy_glyphs;
+    if (lazy != 0 && index < face->advance_map.index_count){
+        if (face->glyph_is_ready[index]){
+            result = true;
+        }
+        else{
+            // NOTE(allen): A glyph that fails is marked ready anyway with empty
+            // bounds, so it is not tried again every frame.
+            face->glyph_is_ready[index] = true;
+            Glyph_Bounds *bounds = &face->bounds[index];
+            FT_Error error = FT_Load_Glyph(lazy->ft_face, index, lazy->load_flags);
+            if (error == 0){
+                FT_GlyphSlot ft_glyph = lazy->ft_face->glyph;
+                Vec2_i32 dim = V2i32(ft_glyph->bitmap.width, ft_glyph->bitmap.rows);
+                if (dim.x > ft__lazy_page_dim || dim.y > ft__lazy_page_dim){
+                    dim = V2i32(0, 0);
+                }
+                Vec3_i32 p = ft__bad_rect_pack_next(&lazy->pack, dim);
+                if (ft__lazy_glyphs_reserve_pages(face, lazy, p.z + 1)){
+                    u8 *data = base_array(lazy->allocator, u8, clamp_bot(1, dim.x*dim.y));
+                    ft__copy_glyph_bitmap(ft_glyph, dim, lazy->aa_1bit_mono, data);
+                    ft__lazy_glyphs_store(face, lazy, p, dim, data);
+                    base_free(lazy->allocator, data);
+                    ft__glyph_bounds_store_xy_off(ft_glyph, dim, face->metrics.ascent, bounds);
+                    ft__glyph_bounds_store_uv_raw(p, dim, bounds);
+                    ft__glyph_bounds_normalize_uv(face->texture_dim, bounds);
+                    result = true;
+                }
+            }
+        }
+    }
+    return(result);
+}
+
+internal void
+ft__font_release_face(Face *face){
+    FT_Lazy_Glyphs *lazy = (FT_Lazy_Glyphs*)face->lazy_glyphs;
+    if (lazy != 0){
+        if (lazy->pages != 0){
+            base_free(lazy->allocator, lazy->pages);
+        }
+        FT_Done_FreeType(lazy->ft);
+        face->lazy_glyphs = 0;
+        face->glyph_is_ready = 0;
+    }
+}
+
+////////////////////////////////
+
 internal Face*
 ft__font_make_face(Arena *arena, Face_Description *description, f32 scale_factor){
     String_Const_u8 file_name = push_string_copy(arena, description->font.file_name);
@@ -239,161 +553,52 @@ ft__font_make_face(Arena *arena, Face_Description *description, f32 scale_factor
         face->advance_map.advance = push_array_zero(arena, f32, index_count);
         face->bounds = push_array(arena, Glyph_Bounds, index_count);
         
-        Temp_Memory_Block temp_memory(arena);
-        struct Bitmap{
-            Vec2_i32 dim;
-            u8 *data;
-        };
-        Bitmap *glyph_bitmaps = push_array(arena, Bitmap, index_count);
-        
         u32 load_flags = ft__load_flags(hinting);
-        for (u16 i = 0; i < index_count; i += 1){
-            Bitmap *bitmap = &glyph_bitmaps[i];
-            
-            error = FT_Load_Glyph(ft_face, i, load_flags);
-            if (error == 0){
-                FT_GlyphSlot ft_glyph = ft_face->glyph;
-                Vec2_i32 dim = V2i32(ft_glyph->bitmap.width, ft_glyph->bitmap.rows);
-                bitmap->dim = dim;
-                bitmap->data = push_array(arena, u8, dim.x*dim.y);
-                
-                face->bounds[i].xy_off.x0 = (f32)(ft_face->glyph->bitmap_left);
-                face->bounds[i].xy_off.y0 = (f32)(met->ascent - ft_face->glyph->bitmap_top);
-                face->bounds[i].xy_off.x1 = (f32)(face->bounds[i].xy_off.x0 + dim.x);
-                face->bounds[i].xy_off.y1 = (f32)(face->bounds[i].xy_off.y0 + dim.y);
-                
-                switch (ft_glyph->bitmap.pixel_mode){
-                    case FT_PIXEL_MODE_MONO:
-                    {
-                        NotImplemented;
-                    }break;
-                    
-                    case FT_PIXEL_MODE_GRAY:
-                    {
-                        b32 aa_1bit_mono = (description->parameters.aa_mode == FaceAntialiasingMode_1BitMono);
-                        
-                        u8 *src_line = ft_glyph->bitmap.buffer;
-                        if (ft_glyph->bitmap.pitch < 0){
-                            src_line = ft_glyph->bitmap.buffer + (-ft_glyph->bitmap.pitch)*(dim.y - 1);
-                        }
-                        u8 *dst = bitmap->data;
-                        for (i32 y = 0; y < dim.y; y += 1){
-                            u8 *src_pixel = src_line;
-                            for (i32 x = 0; x < dim.x; x += 1){
-                                if (aa_1bit_mono){
-                                    u8 s = *src_pixel;
-                                    if (s > 0){
-                                        s = 255;
-                                    }
-                                    *dst = s;
-                                }
-                                else{
-                                    *dst = *src_pixel;
-                                }
-                                dst += 1;
-                                src_pixel += 1;
-                            }
-                            src_line += ft_glyph->bitmap.pitch;
-                        }
-                    }break;
-                    
-                    default:
-                    {
-                        NotImplemented;
-                    }break;
-                }
-                
-                face->advance_map.advance[i] = f32_ceil32(ft_glyph->advance.x/64.0f);
+        b32 aa_1bit_mono = (description->parameters.aa_mode == FaceAntialiasingMode_1BitMono);
+        if (index_count > ft__eager_glyph_limit){
+            // NOTE(allen): The face keeps the library from here on.
+            if (ft__face_init_lazy_glyphs(arena, face, ft, ft_face, load_flags, aa_1bit_mono)){
+                ft = 0;
             }
         }
-        
-        u8 white_data[16] = {
-            0xFF, 0xFF, 0xFF, 0xFF,
-            0xFF, 0xFF, 0xFF, 0xFF,
-            0xFF, 0xFF, 0xFF, 0xFF,
-            0xFF, 0xFF, 0xFF, 0xFF,
-        };
-        
-        Bitmap white = {};
-        white.dim = V2i32(4, 4);
-        white.data = white_data;
-        
-        Bad_Rect_Pack pack = {};
-        ft__bad_rect_pack_init(&pack, V2i32(1024, 1024));
-        ft__glyph_bounds_store_uv_raw(ft__bad_rect_pack_next(&pack, white.dim), white.dim, &face->white);
-        for (u16 i = 0; i < index_count; i += 1){
-            Vec2_i32 dim = glyph_bitmaps[i].dim;
-            ft__glyph_bounds_store_uv_raw(ft__bad_rect_pack_next(&pack, dim), dim, &face->bounds[i]);
+        else{
+            ft__face_make_all_glyphs(arena, face, ft_face, load_flags, aa_1bit_mono);
         }
-        ft__bad_rect_store_finish(&pack);
         
-        Texture_Kind texture_kind = TextureKind_Mono;
-        u32 texture = graphics_get_texture(pack.dim, texture_kind);
-        
-        /* NOTE simon (06/01/25): This assumes that every platforms don't use 0 as a valid texture id.
-        This is valid for OpenGL and the DX11 implementaion. Someone needs to check the MAC versions. */
-        if (texture != 0 ){
-            
-            face->texture_kind = texture_kind;
-            face->texture = texture;
-            
-            Vec3_f32 texture_dim = V3f32(pack.dim);
-            face->texture_dim = texture_dim;
-            
-            {
-                Vec3_i32 p = V3i32((i32)face->white.uv.x0, (i32)face->white.uv.y0, (i32)face->white.w);
-                Vec3_i32 dim = V3i32(white.dim.x, white.dim.y, 1);
-                graphics_fill_texture(texture_kind, texture, p, dim, white.data);
-                face->white.uv.x1 = (face->white.uv.x0 + face->white.uv.x1)/texture_dim.x;
-                face->white.uv.y1 = (face->white.uv.y0 + face->white.uv.y1)/texture_dim.y;
-                face->white.uv.x0 =  face->white.uv.x0/texture_dim.x;
-                face->white.uv.y0 =  face->white.uv.y0/texture_dim.y;
-            }
-            
-            for (u16 i = 0; i < index_count; i += 1){
-                Vec3_i32 p = V3i32((i32)face->bounds[i].uv.x0, (i32)face->bounds[i].uv.y0, (i32)face->bounds[i].w);
-                Vec3_i32 dim = V3i32(glyph_bitmaps[i].dim.x, glyph_bitmaps[i].dim.y, 1);
-                graphics_fill_texture(texture_kind, texture, p, dim, glyph_bitmaps[i].data);
-                face->bounds[i].uv.x1 = (face->bounds[i].uv.x0 + face->bounds[i].uv.x1)/texture_dim.x;
-                face->bounds[i].uv.y1 = (face->bounds[i].uv.y0 + face->bounds[i].uv.y1)/texture_dim.y;
-                face->bounds[i].uv.x0 =  face->bounds[i].uv.x0/texture_dim.x;
-                face->bounds[i].uv.y0 =  face->bounds[i].uv.y0/texture_dim.y;
-            }
-            
-            {
-                Face_Advance_Map *advance_map = &face->advance_map;
-                
-                met->space_advance = font_get_glyph_advance(advance_map, met, ' ', 0);
-                met->decimal_digit_advance =
-                    font_get_max_glyph_advance_range(advance_map, met, '0', '9', 0);
-                met->hex_digit_advance =
-                    font_get_max_glyph_advance_range(advance_map, met, 'A', 'F', 0);
-                met->hex_digit_advance =
-                    Max(met->hex_digit_advance, met->decimal_digit_advance);
-                met->byte_sub_advances[0] =
-                    font_get_glyph_advance(advance_map, met, '\\', 0);
-                met->byte_sub_advances[1] = met->hex_digit_advance;
-                met->byte_sub_advances[2] = met->hex_digit_advance;
-                met->byte_advance =
-                    met->byte_sub_advances[0] +
-                    met->byte_sub_advances[1] +
-                    met->byte_sub_advances[2];
-                met->normal_lowercase_advance =
-                    font_get_average_glyph_advance_range(advance_map, met, 'a', 'z', 0);
-                met->normal_uppercase_advance =
-                    font_get_average_glyph_advance_range(advance_map, met, 'A', 'Z', 0);
-                met->normal_advance = (26*met->normal_lowercase_advance +
-                                       26*met->normal_uppercase_advance +
-                                       10*met->decimal_digit_advance)/62.f;
-            }
+        if (face->texture != 0){
+            Face_Advance_Map *advance_map = &face->advance_map;
             
+            met->space_advance = font_get_glyph_advance(advance_map, met, ' ', 0);
+            met->decimal_digit_advance =
+                font_get_max_glyph_advance_range(advance_map, met, '0', '9', 0);
+            met->hex_digit_advance =
+                font_get_max_glyph_advance_range(advance_map, met, 'A', 'F', 0);
+            met->hex_digit_advance =
+                Max(met->hex_digit_advance, met->decimal_digit_advance);
+            met->byte_sub_advances[0] =
+                font_get_glyph_advance(advance_map, met, '\\', 0);
+            met->byte_sub_advances[1] = met->hex_digit_advance;
+            met->byte_sub_advances[2] = met->hex_digit_advance;
+            met->byte_advance =
+                met->byte_sub_advances[0] +
+                met->byte_sub_advances[1] +
+                met->byte_sub_advances[2];
+            met->normal_lowercase_advance =
+                font_get_average_glyph_advance_range(advance_map, met, 'a', 'z', 0);
+            met->normal_uppercase_advance =
+                font_get_average_glyph_advance_range(advance_map, met, 'A', 'Z', 0);
+            met->normal_advance = (26*met->normal_lowercase_advance +
+                                   26*met->normal_uppercase_advance +
+                                   10*met->decimal_digit_advance)/62.f;
         } else {
             pop_array(arena, Face, 1);
             face = 0;
         }
     }
     
-    FT_Done_FreeType(ft);
+    if (ft != 0){
+        FT_Done_FreeType(ft);
+    }
     
     return(face);
 }
@@ -60,6 +60,7 @@ font_set__alloc_face_slot(Font_Set *set){
 internal void
 font_set__free_face_slot(Font_Set *set, Font_Face_Slot *slot){
     if (slot->arena.base_allocator != 0){
+        font_release_face(slot->face);
         table_free(&slot->face->advance_map.codepoint_to_index.table);
         linalloc_clear(&slot->arena);
     }
@@ -156,6 +157,7 @@ font_set_modify_face(Font_Set *set, Face_ID id, Face_Description *description){
             if (slot->face->texture != 0){
                 graphics_free_texture(slot->face->texture);
             }
+            font_release_face(slot->face);
             linalloc_clear(&slot->arena);
             slot->arena = arena;
             slot->face = face;
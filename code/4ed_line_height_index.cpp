@@ -0,0 +1,301 @@
+/*
+4ed_line_height_index.cpp - Line heights kept in blocks of a treap, for y positions of lines in long files.
+*/
+
+// TOP
+
+internal Line_Height_Block*
+line_height__block(Treap_Node *node){
+    return((Line_Height_Block*)node);
+}
+
+internal i64
+line_height__unknown(Treap_Node *node){
+    return((node == 0)?0:line_height__block(node)->total_unknown);
+}
+
+// NOTE(allen): Lines that have not been laid out count as unknown_height.
+internal f64
+line_height__height(Treap_Node *node, f32 unknown_height){
+    f64 result = 0;
+    if (node != 0){
+        Line_Height_Block *block = line_height__block(node);
+        result = block->total_height + (f64)block->total_unknown*unknown_height;
+    }
+    return(result);
+}
+
+internal void
+line_height__update(Treap_Node *node){
+    Line_Height_Block *block = line_height__block(node);
+    Treap_Node *l = node->left;
+    Treap_Node *r = node->right;
+    block->total_unknown = line_height__unknown(l) + block->unknown_count + line_height__unknown(r);
+    block->total_height = line_height__height(l, 0.f) + block->height + line_height__height(r, 0.f);
+}
+
+internal void
+line_height__measure_block(Line_Height_Block *block){
+    block->unknown_count = 0;
+    block->height = 0;
+    for (i64 i = 0; i < block->node.weight; i += 1){
+        if (block->heights[i] < 0.f){
+            block->unknown_count += 1;
+        }
+        else{
+            block->height += block->heights[i];
+        }
+    }
+}
+
+internal Treap_Node*
+line_height__alloc_block(Line_Height_Index *index, f32 *heights, i32 count){
+    Treap_Node *node = treap_alloc_node(&index->treap, count);
+    Line_Height_Block *block = line_height__block(node);
+    block_copy_dynamic_array(block->heights, heights, count);
+    line_height__measure_block(block);
+    treap_update_node(&index->treap, node);
+    return(node);
+}
+
+internal Treap_Node*
+line_height__build(Line_Height_Index *index, f32 *heights, i64 count){
+    Treap_Node *result = 0;
+    if (count > 0){
+        i64 block_count = (count + line_height_block_cap - 1)/line_height_block_cap;
+        i64 pos = 0;
+        for (i64 i = 0; i < block_count; i += 1){
+            i64 next_pos = (count*(i + 1))/block_count;
+            Treap_Node *block = line_height__alloc_block(index, heights + pos, (i32)(next_pos - pos));
+            result = treap_merge(&index->treap, result, block);
+            pos = next_pos;
+        }
+    }
+    return(result);
+}
+
+internal Treap_Node*
+line_height__build_unknown(Line_Height_Index *index, i64 count){
+    f32 unknown[line_height_block_cap];
+    for (i32 i = 0; i < line_height_block_cap; i += 1){
+        unknown[i] = line_height_unknown;
+    }
+    Treap_Node *result = 0;
+    for (i64 pos = 0; pos < count; pos += line_height_block_cap){
+        i32 block_count = (i32)clamp_top(count - pos, line_height_block_cap);
+        result = treap_merge(&index->treap, result, line_height__alloc_block(index, unknown, block_count));
+    }
+    return(result);
+}
+
+internal void
+line_height_index_init(Line_Height_Index *index, Base_Allocator *allocator){
+    treap_init(&index->treap, allocator, sizeof(Line_Height_Block), 8, line_height__update, 0x6C8E9CF5);
+}
+
+internal void
+line_height_index_free(Line_Height_Index *index){
+    treap_free(&index->treap);
+}
+
+internal i64
+line_height_index_line_count(Line_Height_Index *index){
+    return(treap_total(index->treap.root));
+}
+
+// NOTE(allen): Forgets every height and sizes the index for line_count lines.
+internal void
+line_height_index_reset(Line_Height_Index *index, i64 line_count){
+    treap_free_subtree(&index->treap, index->treap.root);
+    index->treap.root = line_height__build_unknown(index, line_count);
+}
+
+internal void
+line_height__set(Line_Height_Index *index, Treap_Node *node, i64 line, f32 height){
+    i64 left_count = treap_total(node->left);
+    if (line < left_count){
+        line_height__set(index, node->left, line, height);
+    }
+    else if (line - left_count < node->weight){
+        Line_Height_Block *block = line_height__block(node);
+        block->heights[line - left_count] = height;
+        line_height__measure_block(block);
+    }
+    else{
+        line_height__set(index, node->right, line - left_count - node->weight, height);
+    }
+    treap_update_node(&index->treap, node);
+}
+
+internal void
+line_height_index_set(Line_Height_Index *index, i64 line, f32 height){
+    if (0 <= line && line < treap_total(index->treap.root)){
+        line_height__set(index, index->treap.root, line, height);
+    }
+}
+
+internal i64
+line_height__first_unknown(Treap_Node *node, i64 base, i64 first, i64 one_past_last){
+    i64 result = -1;
+    if (node != 0 && line_height__unknown(node) > 0 &&
+        first < base + node->total_weight && base < one_past_last){
+        result = line_height__first_unknown(node->left, base, first, one_past_last);
+        if (result < 0){
+            Line_Height_Block *block = line_height__block(node);
+            i64 block_first = base + treap_total(node->left);
+            if (block->unknown_count > 0){
+                i64 a = clamp_bot(first, block_first);
+                i64 b = clamp_top(one_past_last, block_first + node->weight);
+                for (i64 line = a; line < b; line += 1){
+                    if (block->heights[line - block_first] < 0.f){
+                        result = line;
+                        break;
+                    }
+                }
+            }
+            if (result < 0){
+                result = line_height__first_unknown(node->right, block_first + node->weight,
+                                                    first, one_past_last);
+            }
+        }
+    }
+    return(result);
+}
+
+// NOTE(allen): The first line in [first, one_past_last) that has not been laid
+// out yet, or one_past_last if every line in the range has a height.
+internal i64
+line_height_index_first_unknown(Line_Height_Index *index, i64 first, i64 one_past_last){
+    i64 result = line_height__first_unknown(index->treap.root, 0, first, one_past_last);
+    if (result < 0){
+        result = one_past_last;
+    }
+    return(result);
+}
+
+// NOTE(allen): The summed height of the lines before line; asking for the line
+// one past the last one gives the height of the whole index.
+internal f64
+line_height_index_y_of_line(Line_Height_Index *index, i64 line, f32 unknown_height){
+    f64 result = 0;
+    Treap_Node *node = index->treap.root;
+    if (line >= treap_total(node)){
+        result = line_height__height(node, unknown_height);
+        node = 0;
+    }
+    for (;node != 0 && line > 0;){
+        i64 left_count = treap_total(node->left);
+        if (line < left_count){
+            node = node->left;
+        }
+        else{
+            Line_Height_Block *block = line_height__block(node);
+            line -= left_count;
+            result += line_height__height(node->left, unknown_height);
+            if (line < node->weight){
+                for (i64 i = 0; i < line; i += 1){
+                    f32 height = block->heights[i];
+                    result += (height < 0.f)?unknown_height:height;
+                }
+                break;
+            }
+            line -= node->weight;
+            result += block->height + (f64)block->unknown_count*unknown_height;
+            node = node->right;
+        }
+    }
+    return(result);
+}
+
+// NOTE(allen): Returns the line that contains y, lines of zero height never
+// contain anything.  Any y before the first line gives the first line and any y
+// after the last gives the last.
+internal i64
+line_height_index_line_from_y(Line_Height_Index *index, f64 y, f32 unknown_height){
+    i64 line = 0;
+    Treap_Node *node = index->treap.root;
+    if (y >= line_height__height(node, unknown_height)){
+        line = clamp_bot(0, treap_total(node) - 1);
+        node = 0;
+    }
+    for (;node != 0;){
+        f64 left_height = line_height__height(node->left, unknown_height);
+        if (y < left_height && node->left != 0){
+            node = node->left;
+        }
+        else{
+            Line_Height_Block *block = line_height__block(node);
+            y -= left_height;
+            line += treap_total(node->left);
+            i64 i = 0;
+            for (; i < node->weight; i += 1){
+                f32 height = block->heights[i];
+                height = (height < 0.f)?unknown_height:height;
+                if (y < height){
+                    break;
+                }
+                y -= height;
+            }
+            if (i < node->weight || node->right == 0){
+                line += clamp_top(i, node->weight - 1);
+                break;
+            }
+            line += node->weight;
+            node = node->right;
+        }
+    }
+    return(line);
+}
+
+// NOTE(allen): Replaces the lines [first, first + old_count) with new_count
+// lines that have not been laid out.  As in line_index_replace only the blocks at
+// the ends of the range are rewritten.
+internal void
+line_height_index_replace(Line_Height_Index *index, Arena *scratch, i64 first, i64 old_count, i64 new_count){
+    Temp_Memory temp = begin_temp(scratch);
+    Treap *treap = &index->treap;
+    
+    Treap_Node *l = 0;
+    Treap_Node *m = 0;
+    Treap_Node *r = 0;
+    treap_split(treap, treap->root, first, false, &l, &m);
+    i64 base = treap_total(l);
+    treap_split(treap, m, first + old_count - 1 - base, true, &m, &r);
+    
+    i64 prefix_count = 0;
+    i64 suffix_first = 0;
+    i64 suffix_count = 0;
+    Treap_Node *head = treap_first(m);
+    Treap_Node *tail = treap_last(m);
+    if (m != 0){
+        prefix_count = first - base;
+        suffix_first = first + old_count - base - (treap_total(m) - tail->weight);
+        suffix_count = tail->weight - suffix_first;
+    }
+    
+    i64 count = prefix_count + new_count + suffix_count;
+    f32 *joined = push_array(scratch, f32, count + line_height_block_cap*2);
+    if (m != 0){
+        block_copy_dynamic_array(joined, line_height__block(head)->heights, prefix_count);
+        block_copy_dynamic_array(joined + prefix_count + new_count, line_height__block(tail)->heights + suffix_first, suffix_count);
+    }
+    for (i64 i = 0; i < new_count; i += 1){
+        joined[prefix_count + i] = line_height_unknown;
+    }
+    treap_free_subtree(treap, m);
+    
+    for (;count < line_height_block_cap/2 && r != 0;){
+        Treap_Node *next = 0;
+        treap_split(treap, r, 0, true, &next, &r);
+        block_copy_dynamic_array(joined + count, line_height__block(next)->heights, next->weight);
+        count += next->weight;
+        treap_free_subtree(treap, next);
+    }
+    
+    Treap_Node *mid = line_height__build(index, joined, count);
+    treap->root = treap_merge(treap, treap_merge(treap, l, mid), r);
+    
+    end_temp(temp);
+}
+
+// BOTTOM
@@ -0,0 +1,34 @@
+/*
+4ed_line_height_index.h - Line heights kept in blocks of a treap, for y positions of lines in long files.
+*/
+
+// TOP
+
+#if !defined(FRED_LINE_HEIGHT_INDEX_H)
+#define FRED_LINE_HEIGHT_INDEX_H
+
+// NOTE(allen): The line height index stores the laid out height of every line
+// for one layout configuration, in blocks of up to line_height_block_cap lines.
+// Like the line index the blocks form a treap weighted by their line count, each
+// node also keeping the summed height and the number of lines not laid out yet
+// in its subtree.  Heights are filled in as lines get laid out and an edit only
+// forgets the lines it touched.
+#define line_height_block_cap 256
+#define line_height_unknown (-1.f)
+
+struct Line_Height_Block{
+    Treap_Node node;
+    i32 unknown_count;
+    f64 height;
+    i64 total_unknown;
+    f64 total_height;
+    f32 heights[line_height_block_cap];
+};
+
+struct Line_Height_Index{
+    Treap treap;
+};
+
+#endif
+
+// BOTTOM
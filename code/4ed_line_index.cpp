@@ -0,0 +1,202 @@
+/*
+4ed_line_index.cpp - Line starts kept in blocks of a treap, so edits only touch the blocks they hit.
+*/
+
+// TOP
+
+internal Line_Index_Block*
+line_index__block(Treap_Node *node){
+    return((Line_Index_Block*)node);
+}
+
+internal i64
+line_index__size(Treap_Node *node){
+    return((node == 0)?0:line_index__block(node)->total_size);
+}
+
+internal void
+line_index__update(Treap_Node *node){
+    Line_Index_Block *block = line_index__block(node);
+    block->total_size = line_index__size(node->left) + block->size + line_index__size(node->right);
+}
+
+internal Treap_Node*
+line_index__alloc_block(Line_Index *index, i64 *lengths, i32 count){
+    Treap_Node *node = treap_alloc_node(&index->treap, count);
+    Line_Index_Block *block = line_index__block(node);
+    block->size = 0;
+    for (i32 i = 0; i < count; i += 1){
+        block->lengths[i] = lengths[i];
+        block->size += lengths[i];
+    }
+    treap_update_node(&index->treap, node);
+    return(node);
+}
+
+internal Treap_Node*
+line_index__build(Line_Index *index, i64 *lengths, i64 count){
+    Treap_Node *result = 0;
+    if (count > 0){
+        // NOTE(allen): Spread the lines evenly so no block starts out tiny.
+        i64 block_count = (count + line_index_block_cap - 1)/line_index_block_cap;
+        i64 pos = 0;
+        for (i64 i = 0; i < block_count; i += 1){
+            i64 next_pos = (count*(i + 1))/block_count;
+            Treap_Node *block = line_index__alloc_block(index, lengths + pos, (i32)(next_pos - pos));
+            result = treap_merge(&index->treap, result, block);
+            pos = next_pos;
+        }
+    }
+    return(result);
+}
+
+internal void
+line_index_init(Line_Index *index, Base_Allocator *allocator){
+    treap_init(&index->treap, allocator, sizeof(Line_Index_Block), 8, line_index__update, 0x2545F491);
+}
+
+internal void
+line_index_free(Line_Index *index){
+    treap_free(&index->treap);
+}
+
+internal i64
+line_index_line_count(Line_Index *index){
+    return(treap_total(index->treap.root));
+}
+
+internal void
+line_index_set(Line_Index *index, i64 *lengths, i64 count){
+    treap_free_subtree(&index->treap, index->treap.root);
+    index->treap.root = line_index__build(index, lengths, count);
+}
+
+// NOTE(allen): The position of the first character of line; asking for the line
+// one past the last one gives the size of the text.
+internal i64
+line_index_line_start(Line_Index *index, i64 line){
+    i64 result = 0;
+    Treap_Node *node = index->treap.root;
+    if (line >= treap_total(node)){
+        result = line_index__size(node);
+        node = 0;
+    }
+    for (;node != 0 && line > 0;){
+        i64 left_count = treap_total(node->left);
+        if (line < left_count){
+            node = node->left;
+        }
+        else{
+            Line_Index_Block *block = line_index__block(node);
+            line -= left_count;
+            result += line_index__size(node->left);
+            if (line < node->weight){
+                for (i64 i = 0; i < line; i += 1){
+                    result += block->lengths[i];
+                }
+                break;
+            }
+            line -= node->weight;
+            result += block->size;
+            node = node->right;
+        }
+    }
+    return(result);
+}
+
+// NOTE(allen): Returns the index of the line containing pos; positions at or
+// past the end of the text belong to the last line.
+internal i64
+line_index_line_from_pos(Line_Index *index, i64 pos, i64 *line_start_out){
+    i64 line = 0;
+    i64 line_start = 0;
+    pos = clamp_bot(0, pos);
+    Treap_Node *node = index->treap.root;
+    if (pos >= line_index__size(node)){
+        line = clamp_bot(0, treap_total(node) - 1);
+        line_start = line_index_line_start(index, line);
+        node = 0;
+    }
+    for (;node != 0;){
+        i64 left_size = line_index__size(node->left);
+        if (pos < left_size){
+            node = node->left;
+        }
+        else{
+            Line_Index_Block *block = line_index__block(node);
+            pos -= left_size;
+            line_start += left_size;
+            line += treap_total(node->left);
+            if (pos < block->size){
+                i64 *length = block->lengths;
+                for (;pos >= *length; length += 1){
+                    pos -= *length;
+                    line_start += *length;
+                }
+                line += (length - block->lengths);
+                break;
+            }
+            pos -= block->size;
+            line_start += block->size;
+            line += node->weight;
+            node = node->right;
+        }
+    }
+    if (line_start_out != 0){
+        *line_start_out = line_start;
+    }
+    return(line);
+}
+
+// NOTE(allen): Replaces the lengths of the lines [first, first + old_count) with
+// the new_count lengths in the lengths array.  Only the blocks at the two ends of
+// the replaced range are rewritten, every block in between is released whole.
+internal void
+line_index_replace(Line_Index *index, Arena *scratch, i64 first, i64 old_count, i64 *lengths, i64 new_count){
+    Temp_Memory temp = begin_temp(scratch);
+    Treap *treap = &index->treap;
+    
+    Treap_Node *l = 0;
+    Treap_Node *m = 0;
+    Treap_Node *r = 0;
+    treap_split(treap, treap->root, first, false, &l, &m);
+    i64 base = treap_total(l);
+    treap_split(treap, m, first + old_count - 1 - base, true, &m, &r);
+    
+    i64 prefix_count = 0;
+    i64 suffix_first = 0;
+    i64 suffix_count = 0;
+    Treap_Node *head = treap_first(m);
+    Treap_Node *tail = treap_last(m);
+    if (m != 0){
+        prefix_count = first - base;
+        suffix_first = first + old_count - base - (treap_total(m) - tail->weight);
+        suffix_count = tail->weight - suffix_first;
+    }
+    
+    i64 count = prefix_count + new_count + suffix_count;
+    i64 *joined = push_array(scratch, i64, count + line_index_block_cap*2);
+    if (m != 0){
+        block_copy_dynamic_array(joined, line_index__block(head)->lengths, prefix_count);
+        block_copy_dynamic_array(joined + prefix_count + new_count, line_index__block(tail)->lengths + suffix_first, suffix_count);
+    }
+    block_copy_dynamic_array(joined + prefix_count, lengths, new_count);
+    treap_free_subtree(treap, m);
+    
+    // NOTE(allen): Pull in the following block while the rewritten lines would
+    // make a small block, so that edits do not leave the index fragmented.
+    for (;count < line_index_block_cap/2 && r != 0;){
+        Treap_Node *next = 0;
+        treap_split(treap, r, 0, true, &next, &r);
+        block_copy_dynamic_array(joined + count, line_index__block(next)->lengths, next->weight);
+        count += next->weight;
+        treap_free_subtree(treap, next);
+    }
+    
+    Treap_Node *mid = line_index__build(index, joined, count);
+    treap->root = treap_merge(treap, treap_merge(treap, l, mid), r);
+    
+    end_temp(temp);
+}
+
+// BOTTOM
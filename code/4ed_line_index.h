@@ -0,0 +1,30 @@
+/*
+4ed_line_index.h - Line starts kept in blocks of a treap, so edits only touch the blocks they hit.
+*/
+
+// TOP
+
+#if !defined(FRED_LINE_INDEX_H)
+#define FRED_LINE_INDEX_H
+
+// NOTE(allen): The line index stores the length of every line (newline
+// included) in blocks of up to line_index_block_cap lines.  The blocks form a
+// treap weighted by their line count, and every node also keeps the byte count
+// of its subtree, so line number <-> position queries and edits are O(log n) plus
+// a scan inside of one block, no matter where the edit lands.
+#define line_index_block_cap 256
+
+struct Line_Index_Block{
+    Treap_Node node;
+    i64 size;
+    i64 total_size;
+    i64 lengths[line_index_block_cap];
+};
+
+struct Line_Index{
+    Treap treap;
+};
+
+#endif
+
+// BOTTOM
@@ -17,19 +17,208 @@ log_init(void){
     global_log.arena = make_arena_system();
 }
 
+// NOTE(allen): A thread only ever looks for its own id, so once it has a ring it
+// can use it without the lock.  The lock is taken once per thread, the first time
+// it logs, to claim a free ring.  The id 0 marks a free ring, so a thread with
+// that id never gets one and logs through the lock.
+internal Log_Ring*
+log__get_ring(i32 thread_id){
+    Log_Ring *result = 0;
+    u32 key = (u32)thread_id;
+    u32 first = ((key*0x9E3779B1) >> 16)%log_ring_count;
+    for (u32 i = 0; key != 0 && i < log_ring_count; i += 1){
+        Log_Ring *ring = &global_log.rings[(first + i)%log_ring_count];
+        u32 ring_thread_id = atomic_load_acquire_u32(&ring->thread_id);
+        if (ring_thread_id == key){
+            result = ring;
+            break;
+        }
+        if (ring_thread_id == 0){
+            system_mutex_acquire(global_log.mutex);
+            for (;i < log_ring_count; i += 1){
+                ring = &global_log.rings[(first + i)%log_ring_count];
+                if (ring->thread_id == 0){
+                    u8 *memory = (u8*)system_memory_allocate(log_ring_size, file_name_line_number_lit_u8);
+                    if (memory != 0){
+                        ring->memory = memory;
+                        ring->next_index = 0;
+                        ring->write_pos = 0;
+                        ring->read_pos = 0;
+                        ring->overflowing = false;
+                        atomic_store_release_u32(&ring->thread_id, key);
+                        result = ring;
+                    }
+                    break;
+                }
+            }
+            system_mutex_release(global_log.mutex);
+            break;
+        }
+    }
+    return(result);
+}
+
+internal void
+log__ring_write(Log_Ring *ring, u32 pos, void *data, u32 size){
+    u32 offset = pos%log_ring_size;
+    u32 first_size = Min(size, log_ring_size - offset);
+    block_copy(ring->memory + offset, data, first_size);
+    block_copy(ring->memory, (u8*)data + first_size, size - first_size);
+}
+
+internal void
+log__ring_read(Log_Ring *ring, u32 pos, void *data, u32 size){
+    u32 offset = pos%log_ring_size;
+    u32 first_size = Min(size, log_ring_size - offset);
+    block_copy(data, ring->memory + offset, first_size);
+    block_copy((u8*)data + first_size, ring->memory, size - first_size);
+}
+
+// NOTE(allen): Records start at multiples of 8, so only a header in the last
+// few bytes of the ring has to be copied out to be read.
+internal Log_Record*
+log__ring_record(Log_Ring *ring, u32 pos, Log_Record *header){
+    Log_Record *result = header;
+    u32 offset = pos%log_ring_size;
+    if (offset + sizeof(*header) <= log_ring_size){
+        result = (Log_Record*)(ring->memory + offset);
+    }
+    else{
+        log__ring_read(ring, pos, header, sizeof(*header));
+    }
+    return(result);
+}
+
+internal u32
+log__record_footprint(Log_Record *record){
+    return(round_up_u32(sizeof(*record) + record->size, 8));
+}
+
+internal u8*
+log__record_text(Log_Record *record){
+    return((u8*)(record + 1));
+}
+
+internal b32
+log__ring_push(Log_Ring *ring, Log_Record *record, u8 *text){
+    b32 result = false;
+    u32 write_pos = ring->write_pos;
+    u32 read_pos = atomic_load_acquire_u32(&ring->read_pos);
+    u32 record_size = log__record_footprint(record);
+    if (write_pos - read_pos + record_size <= log_ring_size){
+        u32 offset = write_pos%log_ring_size;
+        if (offset + sizeof(*record) <= log_ring_size){
+            *(Log_Record*)(ring->memory + offset) = *record;
+        }
+        else{
+            log__ring_write(ring, write_pos, record, sizeof(*record));
+        }
+        log__ring_write(ring, write_pos + sizeof(*record), text, record->size);
+        atomic_store_release_u32(&ring->write_pos, write_pos + record_size);
+        result = true;
+    }
+    return(result);
+}
+
 internal b32
 log_string(String_Const_u8 str){
     b32 result = false;
     i32 thread_id = system_thread_get_id();
     if (global_log.disabled_thread_id != thread_id){
-        system_mutex_acquire(global_log.mutex);
-        string_list_push(&global_log.arena, &global_log.list, push_string_copy(&global_log.arena, str));
-        system_mutex_release(global_log.mutex);
+        Log_Record record = {};
+        record.time = system_now_time();
+        record.thread_id = thread_id;
+        record.size = (u32)str.size;
+        
+        b32 pushed = false;
+        Log_Ring *ring = log__get_ring(thread_id);
+        if (ring != 0){
+            record.index = ring->next_index;
+            ring->next_index += 1;
+            if (ring->overflowing &&
+                ring->overflow_generation != atomic_load_acquire_u32(&global_log.overflow_generation)){
+                ring->overflowing = false;
+            }
+            if (!ring->overflowing && str.size <= log_ring_size/4){
+                pushed = log__ring_push(ring, &record, str.str);
+            }
+        }
+        
+        // NOTE(allen): Long strings, full rings, and threads that could not get
+        // a ring go through the lock, nothing is dropped.
+        if (!pushed){
+            system_mutex_acquire(global_log.mutex);
+            if (ring != 0){
+                ring->overflowing = true;
+                ring->overflow_generation = global_log.overflow_generation;
+            }
+            else{
+                record.index = global_log.overflow_index;
+                global_log.overflow_index += 1;
+            }
+            Log_Record_Node *node = (Log_Record_Node*)push_array(&global_log.arena, u8, sizeof(*node) + record.size);
+            node->next = 0;
+            node->record = record;
+            block_copy(log__record_text(&node->record), str.str, record.size);
+            sll_queue_push(global_log.first_overflow, global_log.last_overflow, node);
+            global_log.overflow_size += log__record_footprint(&record);
+            system_mutex_release(global_log.mutex);
+        }
+        
         result = true;
     }
     return(result);
 }
 
+internal b32
+log__record_less(Log_Record *a, Log_Record *b){
+    b32 result = false;
+    if (a->time != b->time){
+        result = (a->time < b->time);
+    }
+    else if (a->thread_id != b->thread_id){
+        result = (a->thread_id < b->thread_id);
+    }
+    else{
+        result = (a->index < b->index);
+    }
+    return(result);
+}
+
+// NOTE(allen): The records of each ring come in already in order, so most halves
+// are found to be in order by the first check and are not merged.  When only one
+// thread logged the sort is skipped altogether.
+internal void
+log__sort_records(Log_Record **records, Log_Record **temp, i32 first, i32 one_past_last){
+    if (first + 1 < one_past_last){
+        i32 mid = (first + one_past_last)/2;
+        log__sort_records(records, temp, first, mid);
+        log__sort_records(records, temp, mid, one_past_last);
+        if (log__record_less(records[mid], records[mid - 1])){
+            i32 i = first;
+            i32 j = mid;
+            i32 k = first;
+            for (;i < mid && j < one_past_last; k += 1){
+                if (log__record_less(records[j], records[i])){
+                    temp[k] = records[j];
+                    j += 1;
+                }
+                else{
+                    temp[k] = records[i];
+                    i += 1;
+                }
+            }
+            for (;i < mid; i += 1, k += 1){
+                temp[k] = records[i];
+            }
+            for (;j < one_past_last; j += 1, k += 1){
+                temp[k] = records[j];
+            }
+            block_copy_dynamic_array(records + first, temp + first, one_past_last - first);
+        }
+    }
+}
+
 internal void
 output_file_append(Thread_Context *tctx, Models *models, Editing_File *file, String_Const_u8 value);
 
@@ -37,19 +226,130 @@ internal b32
 log_flush(Thread_Context *tctx, Models *models){
     b32 result = false;
     
-    system_mutex_acquire(global_log.mutex);
     global_log.disabled_thread_id = system_thread_get_id();
     
-    if (global_log.list.total_size > 0){
-        String_Const_u8 text = string_list_flatten(&global_log.arena, global_log.list);
-        output_file_append(tctx, models, models->log_buffer, text);
-        result = true;
+    Scratch_Block scratch(tctx);
+    List_String_Const_u8 blocks = {};
+    
+    // NOTE(allen): The overflow list is taken before the rings are read, so every
+    // ring record that came before a record in the list is already in its ring.
+    system_mutex_acquire(global_log.mutex);
+    if (global_log.overflow_size > 0){
+        String_Const_u8 block = {};
+        block.str = push_array(scratch, u8, global_log.overflow_size);
+        for (Log_Record_Node *node = global_log.first_overflow;
+             node != 0;
+             node = node->next){
+            block_copy(block.str + block.size, &node->record, sizeof(node->record) + node->record.size);
+            block.size += log__record_footprint(&node->record);
+        }
+        string_list_push(scratch, &blocks, block);
     }
     linalloc_clear(&global_log.arena);
-    block_zero_struct(&global_log.list);
+    global_log.first_overflow = 0;
+    global_log.last_overflow = 0;
+    global_log.overflow_size = 0;
+    atomic_store_release_u32(&global_log.overflow_generation, global_log.overflow_generation + 1);
+    system_mutex_release(global_log.mutex);
+    
+    // NOTE(allen): Records are read in place, so the positions are held here and
+    // a ring's space only goes back to its thread once the text is copied out.
+    u32 read_positions[log_ring_count];
+    u32 write_positions[log_ring_count];
+    i32 count = 0;
+    u64 total_size = 0;
+    for (i32 i = 0; i < log_ring_count; i += 1){
+        Log_Ring *ring = &global_log.rings[i];
+        read_positions[i] = 0;
+        write_positions[i] = 0;
+        if (atomic_load_acquire_u32(&ring->thread_id) != 0){
+            read_positions[i] = ring->read_pos;
+            write_positions[i] = atomic_load_acquire_u32(&ring->write_pos);
+            for (u32 pos = read_positions[i]; pos != write_positions[i];){
+                Log_Record header = {};
+                Log_Record *record = log__ring_record(ring, pos, &header);
+                count += 1;
+                total_size += record->size;
+                pos += log__record_footprint(record);
+            }
+        }
+    }
+    for (Node_String_Const_u8 *node = blocks.first;
+         node != 0;
+         node = node->next){
+        for (u64 pos = 0; pos < node->string.size;){
+            Log_Record *record = (Log_Record*)(node->string.str + pos);
+            count += 1;
+            total_size += record->size;
+            pos += log__record_footprint(record);
+        }
+    }
+    
+    if (count > 0){
+        Log_Record **records = push_array(scratch, Log_Record*, count);
+        Log_Record **temp = push_array(scratch, Log_Record*, count);
+        i32 index = 0;
+        for (i32 i = 0; i < log_ring_count; i += 1){
+            Log_Ring *ring = &global_log.rings[i];
+            for (u32 pos = read_positions[i]; pos != write_positions[i]; index += 1){
+                Log_Record header = {};
+                Log_Record *record = log__ring_record(ring, pos, &header);
+                u32 footprint = log__record_footprint(record);
+                if (pos%log_ring_size + footprint <= log_ring_size){
+                    records[index] = record;
+                }
+                else{
+                    // NOTE(allen): The record goes past the end of the ring.
+                    records[index] = (Log_Record*)push_array(scratch, u8, footprint);
+                    log__ring_read(ring, pos, records[index], footprint);
+                }
+                pos += footprint;
+            }
+        }
+        for (Node_String_Const_u8 *node = blocks.first;
+             node != 0;
+             node = node->next){
+            for (u64 pos = 0; pos < node->string.size; index += 1){
+                Log_Record *record = (Log_Record*)(node->string.str + pos);
+                records[index] = record;
+                pos += log__record_footprint(record);
+            }
+        }
+        for (i32 i = 1; i < count; i += 1){
+            if (log__record_less(records[i], records[i - 1])){
+                log__sort_records(records, temp, 0, count);
+                break;
+            }
+        }
+        
+        String_Const_u8 text = {};
+        text.str = push_array(scratch, u8, total_size);
+        for (i32 i = 0; i < count; i += 1){
+            Log_Record *record = records[i];
+            block_copy(text.str + text.size, log__record_text(record), record->size);
+            text.size += record->size;
+        }
+        
+        for (i32 i = 0; i < log_ring_count; i += 1){
+            if (read_positions[i] != write_positions[i]){
+                atomic_store_release_u32(&global_log.rings[i].read_pos, write_positions[i]);
+            }
+        }
+        
+        // NOTE(allen): With a log file set the text is streamed out to the file,
+        // and the *log* buffer does not grow at all.
+        if (text.size > 0){
+            if (models->settings.log_file_name != 0){
+                system_append_file(scratch, models->settings.log_file_name, text);
+            }
+            else{
+                output_file_append(tctx, models, models->log_buffer, text);
+            }
+            result = true;
+        }
+    }
     
     global_log.disabled_thread_id = 0;
-    system_mutex_release(global_log.mutex);
     
     return(result);
 }
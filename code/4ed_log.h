@@ -12,10 +12,54 @@
 #if !defined(FRED_LOG_H)
 #define FRED_LOG_H
 
+// NOTE(allen): Every thread that logs gets a ring of its own.  The thread is the
+// only writer and log_flush is the only reader, so neither has to take a lock.
+// The mutex is only taken to hand out rings, and for the records that do not fit
+// in a ring, which go in the overflow list.
+#define log_ring_count 64
+#define log_ring_size KB(64)
+
+// NOTE(allen): The text follows right after the record, and the next record
+// starts at the next multiple of 8.  Records are ordered by time, and by index
+// between records of one thread with the same time.
+struct Log_Record{
+    u64 time;
+    i32 thread_id;
+    u32 index;
+    u32 size;
+    u32 unused__;
+};
+
+struct Log_Record_Node{
+    Log_Record_Node *next;
+    Log_Record record;
+};
+
+// NOTE(allen): Once a thread has had to put a record in the overflow list, the
+// records after it follow it there until a flush takes the list, or a flush could
+// take a later record out of the ring before the earlier one in the list.
+struct Log_Ring{
+    volatile u32 thread_id;
+    u32 next_index;
+    u8 *memory;
+    volatile u32 write_pos;
+    volatile u32 read_pos;
+    b32 overflowing;
+    u32 overflow_generation;
+    // NOTE(allen): Keeps the owners of neighbouring rings off of each other's
+    // cache lines.
+    u8 unused__[32];
+};
+
 struct Log{
     System_Mutex mutex;
+    Log_Ring rings[log_ring_count];
     Arena arena;
-    List_String_Const_u8 list;
+    Log_Record_Node *first_overflow;
+    Log_Record_Node *last_overflow;
+    u64 overflow_size;
+    u32 overflow_index;
+    volatile u32 overflow_generation;
     volatile i32 disabled_thread_id;
     b32 stdout_log_enabled;
 };
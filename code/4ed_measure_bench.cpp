@@ -0,0 +1,164 @@
+/*
+4ed_measure_bench.cpp - Measures the newline scanning throughput of buffer_measure_starts.
+
+Runs over every file in non-source/test_data and over a synthetic text buffer
+(1 GB by default, the size in MB can be passed as the first argument).
+
+Build from the code directory, for example:
+g++ -O2 -I. -Icustom 4ed_measure_bench.cpp -o measure_bench
+add -mavx2 to measure the AVX2 kernel.
+*/
+
+// TOP
+
+#include "4coder_base_types.h"
+#include "4coder_table.h"
+#include "4coder_events.h"
+#include "4coder_types.h"
+#include "4ed_treap.h"
+#include "4ed_piece_tree.h"
+#include "4ed_line_index.h"
+#include "4ed_buffer.h"
+
+#include "4coder_base_types.cpp"
+#include "4coder_stringf.cpp"
+#include "4coder_malloc_allocator.cpp"
+#include "4ed_treap.cpp"
+#include "4ed_piece_tree.cpp"
+#include "4ed_line_index.cpp"
+#include "4ed_buffer.cpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <dirent.h>
+
+internal u64
+bench_now_us(void){
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return((u64)t.tv_sec*Million(1) + (u64)t.tv_nsec/Thousand(1));
+}
+
+internal String_Const_u8
+bench_read_file(Arena *arena, char *name){
+    String_Const_u8 result = {};
+    FILE *file = fopen(name, "rb");
+    if (file != 0){
+        fseek(file, 0, SEEK_END);
+        result.size = ftell(file);
+        fseek(file, 0, SEEK_SET);
+        result.str = push_array(arena, u8, result.size);
+        fread(result.str, result.size, 1, file);
+        fclose(file);
+    }
+    return(result);
+}
+
+internal void
+bench_read_folder(Arena *arena, List_String_Const_u8 *list, char *folder){
+    DIR *dir = opendir(folder);
+    if (dir != 0){
+        for (struct dirent *entry = readdir(dir);
+             entry != 0;
+             entry = readdir(dir)){
+            if (entry->d_name[0] == '.'){
+                continue;
+            }
+            String_Const_u8 path = push_u8_stringf(arena, "%s/%s", folder, entry->d_name);
+            if (entry->d_type == DT_DIR){
+                bench_read_folder(arena, list, (char*)path.str);
+            }
+            else{
+                String_Const_u8 text = bench_read_file(arena, (char*)path.str);
+                if (text.size > 0){
+                    string_list_push(arena, list, text);
+                }
+            }
+        }
+        closedir(dir);
+    }
+}
+
+internal void
+bench_measure(Thread_Context *tctx, char *name, List_String_Const_u8 texts, i32 repeat){
+    Scratch_Block scratch(tctx);
+    u64 count_time = 0;
+    u64 measure_time = 0;
+    i64 line_count = 0;
+    for (i32 r = 0; r < repeat; r += 1){
+        for (Node_String_Const_u8 *node = texts.first;
+             node != 0;
+             node = node->next){
+            Gap_Buffer buffer = {};
+            buffer_init(&buffer, node->string.str, node->string.size, tctx->allocator);
+            
+            u64 start = bench_now_us();
+            line_count += count_lines(node->string);
+            u64 middle = bench_now_us();
+            buffer_measure_starts(scratch, &buffer);
+            u64 end = bench_now_us();
+            
+            count_time += middle - start;
+            measure_time += end - middle;
+            buffer_free(&buffer);
+        }
+    }
+    f64 mb = (f64)texts.total_size*repeat/(f64)MB(1);
+    printf("%-12s %10.1f MB %12lld lines | count_lines %8.1f MB/s | buffer_measure_starts %8.1f MB/s\n",
+           name, mb, line_count/repeat,
+           mb/((f64)clamp_bot(1, count_time)/Million(1)),
+           mb/((f64)clamp_bot(1, measure_time)/Million(1)));
+}
+
+int main(int argc, char **argv){
+    Base_Allocator *allocator = get_allocator_malloc();
+    Thread_Context tctx_ = {};
+    thread_ctx_init(&tctx_, ThreadKind_Main, allocator, allocator);
+    Thread_Context *tctx = &tctx_;
+    Arena arena = make_arena(allocator, MB(16));
+    
+    i64 synthetic_size = MB(1024);
+    if (argc > 1){
+        synthetic_size = MB((i64)atoi(argv[1]));
+    }
+    
+    String_Const_u8 path_to_self = string_u8_litexpr(__FILE__);
+    path_to_self = string_remove_last_folder(path_to_self);
+    String_Const_u8 corpus_path = push_u8_stringf(&arena, "%.*s../non-source/test_data",
+                                                  string_expand(path_to_self));
+    
+    List_String_Const_u8 corpus = {};
+    bench_read_folder(&arena, &corpus, (char*)corpus_path.str);
+    if (corpus.node_count == 0){
+        printf("error: could not read the corpus at %s\n", corpus_path.str);
+    }
+    else{
+        bench_measure(tctx, "test_data", corpus, 20);
+    }
+    
+    // NOTE(allen): Lines of varying length so the scan sees both dense and sparse
+    // newlines.
+    String_Const_u8 synthetic = {};
+    synthetic.size = synthetic_size;
+    synthetic.str = (u8*)malloc(synthetic_size);
+    u32 seed = 0xC0FFEE;
+    i64 line_end = 0;
+    for (i64 i = 0; i < synthetic_size; i += 1){
+        if (i == line_end){
+            seed = seed*1664525 + 1013904223;
+            line_end = i + 1 + (seed >> 25);
+            synthetic.str[i] = '\n';
+        }
+        else{
+            synthetic.str[i] = (u8)('a' + (i % 26));
+        }
+    }
+    List_String_Const_u8 synthetic_list = {};
+    string_list_push(&arena, &synthetic_list, synthetic);
+    bench_measure(tctx, "synthetic", synthetic_list, 1);
+    
+    return(0);
+}
+
+// BOTTOM
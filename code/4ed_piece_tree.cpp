@@ -0,0 +1,191 @@
+/*
+4ed_piece_tree.cpp - Piece tree text storage.
+*/
+
+// TOP
+
+internal Piece_Node*
+piece_tree__piece(Treap_Node *node){
+    return((Piece_Node*)node);
+}
+
+internal Treap_Node*
+piece_tree__alloc_node(Piece_Tree *tree, u8 *str, i64 size){
+    Treap_Node *node = treap_alloc_node(&tree->nodes, size);
+    piece_tree__piece(node)->str = str;
+    return(node);
+}
+
+// NOTE(allen): Splits node so that *l_out holds the first pos bytes of text and
+// *r_out the rest.  If pos falls inside of a piece, that piece is cut in two.
+internal void
+piece_tree__split(Piece_Tree *tree, Treap_Node *node, i64 pos, Treap_Node **l_out, Treap_Node **r_out){
+    Treap *treap = &tree->nodes;
+    treap_split(treap, node, pos, false, l_out, r_out);
+    i64 cut = pos - treap_total(*l_out);
+    if (cut > 0 && *r_out != 0){
+        Treap_Node *piece = 0;
+        treap_split(treap, *r_out, 0, true, &piece, r_out);
+        Treap_Node *tail = piece_tree__alloc_node(tree, piece_tree__piece(piece)->str + cut, piece->weight - cut);
+        piece->weight = cut;
+        treap_update_node(treap, piece);
+        *l_out = treap_merge(treap, *l_out, piece);
+        *r_out = treap_merge(treap, tail, *r_out);
+    }
+}
+
+internal void
+piece_tree__init(Piece_Tree *tree, Base_Allocator *allocator){
+    block_zero_struct(tree);
+    treap_init(&tree->nodes, allocator, sizeof(Piece_Node), 256, 0, 0x9E3779B9);
+    // NOTE(allen): The add arena is byte aligned so that consecutive insertions
+    // land next to each other and can be coalesced into a single piece.
+    tree->add_arena = make_arena(allocator, KB(64), 1);
+}
+
+internal void
+piece_tree_init(Piece_Tree *tree, Base_Allocator *allocator, u8 *data, u64 size){
+    piece_tree__init(tree, allocator);
+    if (size > 0){
+        String_Const_u8 memory = base_allocate(allocator, size);
+        block_copy(memory.str, data, size);
+        tree->original = memory.str;
+        tree->original_size = size;
+        tree->nodes.root = piece_tree__alloc_node(tree, tree->original, size);
+    }
+}
+
+// NOTE(allen): Uses data as the original block without copying it.  The memory
+// has to stay valid and unchanged until the tree is freed.
+internal void
+piece_tree_init_borrowed(Piece_Tree *tree, Base_Allocator *allocator, u8 *data, u64 size){
+    piece_tree__init(tree, allocator);
+    tree->original_is_borrowed = true;
+    if (size > 0){
+        tree->original = data;
+        tree->original_size = size;
+        tree->nodes.root = piece_tree__alloc_node(tree, tree->original, size);
+    }
+}
+
+internal i64
+piece_tree__borrowed_size(Treap_Node *node, u8 *first, u8 *one_past_last){
+    i64 result = 0;
+    if (node != 0){
+        result += piece_tree__borrowed_size(node->left, first, one_past_last);
+        u8 *str = piece_tree__piece(node)->str;
+        if (first <= str && str < one_past_last){
+            result += node->weight;
+        }
+        result += piece_tree__borrowed_size(node->right, first, one_past_last);
+    }
+    return(result);
+}
+
+internal void
+piece_tree__copy_borrowed(Treap_Node *node, u8 *first, u8 *one_past_last, u8 **cursor){
+    if (node != 0){
+        piece_tree__copy_borrowed(node->left, first, one_past_last, cursor);
+        Piece_Node *piece = piece_tree__piece(node);
+        if (first <= piece->str && piece->str < one_past_last){
+            block_copy(*cursor, piece->str, node->weight);
+            piece->str = *cursor;
+            *cursor += node->weight;
+        }
+        piece_tree__copy_borrowed(node->right, first, one_past_last, cursor);
+    }
+}
+
+// NOTE(allen): Copies the text the pieces still use out of a borrowed original
+// into a block the tree owns, after which the borrowed memory can go away.
+internal void
+piece_tree_own_original(Piece_Tree *tree, Base_Allocator *allocator){
+    if (tree->original_is_borrowed){
+        u8 *first = tree->original;
+        u8 *one_past_last = first + tree->original_size;
+        i64 size = piece_tree__borrowed_size(tree->nodes.root, first, one_past_last);
+        String_Const_u8 memory = {};
+        if (size > 0){
+            memory = base_allocate(allocator, size);
+            u8 *cursor = memory.str;
+            piece_tree__copy_borrowed(tree->nodes.root, first, one_past_last, &cursor);
+        }
+        tree->original = memory.str;
+        tree->original_size = size;
+        tree->original_is_borrowed = false;
+    }
+}
+
+internal void
+piece_tree_free(Piece_Tree *tree, Base_Allocator *allocator){
+    if (tree->original != 0 && !tree->original_is_borrowed){
+        base_free(allocator, tree->original);
+    }
+    treap_free(&tree->nodes);
+    linalloc_clear(&tree->add_arena);
+    block_zero_struct(tree);
+}
+
+internal i64
+piece_tree_size(Piece_Tree *tree){
+    return(treap_total(tree->nodes.root));
+}
+
+internal void
+piece_tree_replace_range(Piece_Tree *tree, Range_i64 range, String_Const_u8 text){
+    Treap *treap = &tree->nodes;
+    Treap_Node *l = 0;
+    Treap_Node *m = 0;
+    Treap_Node *r = 0;
+    piece_tree__split(tree, treap->root, range.first, &l, &r);
+    piece_tree__split(tree, r, range.one_past_last - range.first, &m, &r);
+    treap_free_subtree(treap, m);
+    
+    if (text.size > 0){
+        u8 *dst = push_array(&tree->add_arena, u8, text.size);
+        block_copy(dst, text.str, text.size);
+        
+        Treap_Node *last = treap_last(l);
+        if (last != 0 && piece_tree__piece(last)->str + last->weight == dst){
+            // NOTE(allen): Typing appends to the add arena right after the piece
+            // that was inserted last, so it can grow that piece in place.
+            for (Treap_Node *node = l; node != 0; node = node->right){
+                node->total_weight += text.size;
+            }
+            last->weight += text.size;
+        }
+        else{
+            l = treap_merge(treap, l, piece_tree__alloc_node(tree, dst, text.size));
+        }
+    }
+    
+    treap->root = treap_merge(treap, l, r);
+}
+
+internal void
+piece_tree__push_chunks(Arena *arena, List_String_Const_u8 *list, Treap_Node *node, i64 base, Range_i64 range){
+    if (node != 0){
+        i64 first = base + treap_total(node->left);
+        i64 one_past_last = first + node->weight;
+        if (range.first < first){
+            piece_tree__push_chunks(arena, list, node->left, base, range);
+        }
+        if (range.first < one_past_last && first < range.one_past_last){
+            i64 a = Max(first, range.first) - first;
+            i64 b = Min(one_past_last, range.one_past_last) - first;
+            string_list_push(arena, list, SCu8(piece_tree__piece(node)->str + a, b - a));
+        }
+        if (one_past_last < range.one_past_last){
+            piece_tree__push_chunks(arena, list, node->right, one_past_last, range);
+        }
+    }
+}
+
+internal List_String_Const_u8
+piece_tree_get_chunks(Arena *arena, Piece_Tree *tree, Range_i64 range){
+    List_String_Const_u8 list = {};
+    piece_tree__push_chunks(arena, &list, tree->nodes.root, 0, range);
+    return(list);
+}
+
+// BOTTOM
@@ -0,0 +1,33 @@
+/*
+4ed_piece_tree.h - Piece tree text storage.
+*/
+
+// TOP
+
+#if !defined(FRED_PIECE_TREE_H)
+#define FRED_PIECE_TREE_H
+
+// NOTE(allen): The piece tree is a treap weighted by the size of each piece.
+// Every node describes one contiguous piece of text that lives either in the
+// original block (the text the buffer was created with) or in the append-only
+// add arena.  Pieces never move in memory, so an edit anywhere in the buffer is
+// two splits and a merge: O(log n) in the number of pieces, independent of how
+// far apart consecutive edits are.
+struct Piece_Node{
+    Treap_Node node;
+    u8 *str;
+};
+
+struct Piece_Tree{
+    Treap nodes;
+    Arena add_arena;
+    u8 *original;
+    i64 original_size;
+    // NOTE(allen): A borrowed original (a read-only file mapping) belongs to
+    // whoever created it; the tree never writes to it or frees it.
+    b32 original_is_borrowed;
+};
+
+#endif
+
+// BOTTOM
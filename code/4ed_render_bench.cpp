@@ -0,0 +1,527 @@
+/*
+4ed_render_bench.cpp - Replays a scripted session through the render target and the software renderer.
+
+Every frame is built the way a file view draws itself, with draw_rectangle and
+draw_string into a Render_Target, and then rasterized by sw_render.  The build
+and raster time of each frame is printed, then a summary and a hash of all the
+frames, so a change in the output shows up next to a change in the time.
+
+Build from the code directory, for example:
+g++ -O2 -I. -Icustom -I../non-source/foreign/freetype2 4ed_render_bench.cpp -o render_bench -lfreetype
+
+Usage: render_bench [script] [-o last_frame.ppm]
+
+The script has one command per line, # starts a comment:
+size <width> <height>       size of the window
+font <file> <pt> [hinting]  the face everything is drawn with
+open <file>                 the file shown in every panel
+panels <count>              side by side file views
+scroll <lines> <frames>     scroll every panel by lines each frame
+idle <frames>               draw frames without changing anything
+Without a script bench_default_script is played, from the code directory.
+*/
+
+// TOP
+
+#include "4coder_base_types.h"
+#include "4coder_version.h"
+#include "4coder_table.h"
+#include "4coder_events.h"
+#include "4coder_types.h"
+#include "4coder_default_colors.h"
+
+#include "4coder_system_types.h"
+#define STATIC_LINK_API
+#include "generated/system_api.h"
+#include "4ed_font_interface.h"
+#define STATIC_LINK_API
+#include "generated/graphics_api.h"
+#define STATIC_LINK_API
+#include "generated/font_api.h"
+
+#include "4ed_render_target.h"
+#include "4ed_buffer_model.h"
+#include "4ed_translation.h"
+#include "4ed_font_set.h"
+#include "4ed_font_provider_freetype.h"
+
+#include "4coder_base_types.cpp"
+#include "4coder_stringf.cpp"
+#include "4coder_hash_functions.cpp"
+#include "4coder_table.cpp"
+#include "4coder_system_allocator.cpp"
+#include "4coder_malloc_allocator.cpp"
+#include "4coder_codepoint_map.cpp"
+
+#include "4ed_font_set.cpp"
+#include "4ed_translation.cpp"
+#include "4ed_render_target.cpp"
+#include "software/4ed_software_render.cpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+////////////////////////////////
+
+// NOTE(allen): The bench is its own little platform layer, it only has to
+// provide what the font set, the font provider and the render target call.
+
+internal void*
+system_memory_allocate(u64 size, String_Const_u8 location){
+    return(malloc(size));
+}
+
+internal b32
+system_memory_set_protection(void *ptr, u64 size, u32 flags){
+    return(true);
+}
+
+internal void
+system_memory_free(void *ptr, u64 size){
+    free(ptr);
+}
+
+internal f32
+system_get_screen_scale_factor(void){
+    return(1.f);
+}
+
+internal
+graphics_get_texture_sig(){
+    return(sw__get_texture(dim, texture_kind));
+}
+
+internal
+graphics_fill_texture_sig(){
+    return(sw__fill_texture(texture_kind, texture, p, dim, data));
+}
+
+internal
+graphics_free_texture_sig(){
+    sw__free_texture(texid);
+}
+
+#include "4ed_font_provider_freetype.cpp"
+
+internal Face*
+font_make_face(Arena *arena, Face_Description *description, f32 scale_factor){
+    return(ft__font_make_face(arena, description, scale_factor));
+}
+
+internal b32
+font_make_glyph(Face *face, u16 index){
+    return(ft__font_make_glyph(face, index));
+}
+
+internal void
+font_release_face(Face *face){
+    ft__font_release_face(face);
+}
+
+////////////////////////////////
+
+global char bench_default_script[] =
+"size 1920 1080\n"
+"font ../non-source/dist_files/fonts/liberation-mono.ttf 12\n"
+"open 4ed_render_target.cpp\n"
+"panels 2\n"
+"scroll 1 240\n"
+"scroll -4 60\n"
+"idle 30\n";
+
+struct Bench_Frame_Time{
+    u64 build_us;
+    u64 raster_us;
+};
+
+struct Bench_State{
+    Arena *arena;
+    Render_Target target;
+    Font_Set font_set;
+    Face *face;
+    
+    String_Const_u8 file_name;
+    String_Const_u8 text;
+    i64 *line_starts;
+    i64 line_count;
+    
+    i32 panel_count;
+    i64 first_line;
+    
+    Bench_Frame_Time *times;
+    i32 frame_count;
+    i32 frame_max;
+    u64 hash;
+};
+
+internal u64
+bench_now_us(void){
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return((u64)t.tv_sec*Million(1) + (u64)t.tv_nsec/Thousand(1));
+}
+
+internal String_Const_u8
+bench_read_file(Arena *arena, char *name){
+    String_Const_u8 result = {};
+    FILE *file = fopen(name, "rb");
+    if (file != 0){
+        fseek(file, 0, SEEK_END);
+        result.size = ftell(file);
+        fseek(file, 0, SEEK_SET);
+        result.str = push_array(arena, u8, result.size + 1);
+        fread(result.str, result.size, 1, file);
+        result.str[result.size] = 0;
+        fclose(file);
+    }
+    return(result);
+}
+
+internal void
+bench_open(Bench_State *state, String_Const_u8 file_name){
+    Arena *arena = state->arena;
+    state->file_name = push_string_copy(arena, file_name);
+    state->text = bench_read_file(arena, (char*)state->file_name.str);
+    if (state->text.str == 0){
+        printf("could not read %.*s\n", string_expand(file_name));
+    }
+    
+    i64 line_count = 1;
+    for (u64 i = 0; i < state->text.size; i += 1){
+        if (state->text.str[i] == '\n'){
+            line_count += 1;
+        }
+    }
+    state->line_starts = push_array(arena, i64, line_count + 1);
+    state->line_count = 0;
+    state->line_starts[state->line_count++] = 0;
+    for (u64 i = 0; i < state->text.size; i += 1){
+        if (state->text.str[i] == '\n'){
+            state->line_starts[state->line_count++] = (i64)i + 1;
+        }
+    }
+    state->line_starts[state->line_count] = (i64)state->text.size + 1;
+    state->first_line = 0;
+}
+
+internal String_Const_u8
+bench_line(Bench_State *state, i64 line){
+    i64 first = state->line_starts[line];
+    i64 one_past_last = state->line_starts[line + 1] - 1;
+    String_Const_u8 result = SCu8(state->text.str + first, (u64)(one_past_last - first));
+    if (result.size > 0 && result.str[result.size - 1] == '\r'){
+        result.size -= 1;
+    }
+    return(result);
+}
+
+// NOTE(allen): A rough stand in for the lexer, enough to break lines into the
+// runs of colors a code file really shows.
+internal ARGB_Color
+bench_run_color(u8 *str, u64 size, u64 *run_size){
+    ARGB_Color color = 0xFF90B080;
+    u64 i = 1;
+    if (size >= 2 && str[0] == '/' && str[1] == '/'){
+        color = 0xFF2090F0;
+        i = size;
+    }
+    else if (character_is_alpha(str[0])){
+        color = 0xFFA08563;
+        for (; i < size && character_is_alpha_numeric(str[i]); i += 1);
+    }
+    else if (character_is_base10(str[0])){
+        color = 0xFF6B8E23;
+        for (; i < size && character_is_alpha_numeric(str[i]); i += 1);
+    }
+    else if (str[0] == '"'){
+        color = 0xFF6B8E23;
+        for (; i < size && str[i] != '"'; i += 1);
+        i = clamp_top(i + 1, size);
+    }
+    else if (character_is_whitespace(str[0])){
+        for (; i < size && character_is_whitespace(str[i]); i += 1);
+    }
+    *run_size = i;
+    return(color);
+}
+
+internal void
+bench_draw_panel(Bench_State *state, Rect_f32 rect, b32 is_active){
+    Render_Target *target = &state->target;
+    Face *face = state->face;
+    f32 line_height = face->metrics.line_height;
+    f32 digit_advance = face->metrics.decimal_digit_advance;
+    
+    draw_set_clip(target, rect);
+    draw_rectangle(target, rect, 0.f, 0xFF0C0C0C);
+    
+    Rect_f32 bar = Rf32(rect.x0, rect.y0, rect.x1, rect.y0 + line_height + 2.f);
+    draw_rectangle(target, bar, 0.f, 0xFF888888);
+    draw_string(target, face, state->file_name, V2f32(bar.x0 + 4.f, bar.y0 + 1.f), 0xFF0C0C0C);
+    
+    Rect_f32 margin = Rf32(rect.x0, bar.y1, rect.x0 + digit_advance*6.f, rect.y1);
+    Rect_f32 text_rect = Rf32(margin.x1 + 2.f, bar.y1, rect.x1, rect.y1);
+    draw_rectangle(target, margin, 0.f, 0xFF101010);
+    
+    i64 visible_count = (i64)((text_rect.y1 - text_rect.y0)/line_height) + 1;
+    i64 first_line = clamp(0, state->first_line, clamp_bot(0, state->line_count - 1));
+    i64 one_past_last = clamp_top(first_line + visible_count, state->line_count);
+    i64 cursor_line = (first_line + one_past_last)/2;
+    
+    draw_set_clip(target, margin);
+    for (i64 line = first_line; line < one_past_last; line += 1){
+        Temp_Memory temp = begin_temp(state->arena);
+        f32 y = text_rect.y0 + (line - first_line)*line_height;
+        String_Const_u8 number = push_u8_stringf(state->arena, "%5lld", line + 1);
+        draw_string(target, face, number, V2f32(margin.x0, y), 0xFF404040);
+        end_temp(temp);
+    }
+    
+    draw_set_clip(target, text_rect);
+    {
+        f32 y = text_rect.y0 + (cursor_line - first_line)*line_height;
+        draw_rectangle(target, Rf32(text_rect.x0, y, text_rect.x1, y + line_height), 0.f, 0xFF181818);
+    }
+    for (i64 line = first_line; line < one_past_last; line += 1){
+        String_Const_u8 string = bench_line(state, line);
+        Vec2_f32 p = V2f32(text_rect.x0, text_rect.y0 + (line - first_line)*line_height);
+        for (u64 i = 0; i < string.size;){
+            u64 run_size = 0;
+            ARGB_Color color = bench_run_color(string.str + i, string.size - i, &run_size);
+            p.x += draw_string(target, face, SCu8(string.str + i, run_size), p, color);
+            i += run_size;
+        }
+    }
+    {
+        f32 y = text_rect.y0 + (cursor_line - first_line)*line_height;
+        Rect_f32 cursor = Rf32(text_rect.x0 + digit_advance*4.f, y,
+                               text_rect.x0 + digit_advance*5.f, y + line_height);
+        if (is_active){
+            draw_rectangle(target, cursor, 1.f, 0xFF00EE00);
+        }
+        else{
+            draw_rectangle_outline(target, cursor, 1.f, 1.f, 0xFF00EE00);
+        }
+    }
+    
+    draw_set_clip(target, rect);
+    draw_rectangle_outline(target, rect, 3.f, 1.f, is_active?0xFF00EE00:0xFF404040);
+}
+
+internal void
+bench_frame(Bench_State *state){
+    Render_Target *target = &state->target;
+    
+    u64 build_start = bench_now_us();
+    begin_frame(target, &state->font_set);
+    begin_render_section(target, state->frame_count, 1.f/60.f, 1.f/60.f);
+    if (state->face != 0 && state->text.str != 0){
+        f32 width = (f32)target->width;
+        f32 height = (f32)target->height;
+        i32 panel_count = clamp_bot(1, state->panel_count);
+        for (i32 i = 0; i < panel_count; i += 1){
+            Rect_f32 rect = Rf32(width*i/panel_count, 0.f, width*(i + 1)/panel_count, height);
+            bench_draw_panel(state, rect, (i == 0));
+        }
+    }
+    end_render_section(target);
+    u64 raster_start = bench_now_us();
+    sw_render(target);
+    u64 raster_end = bench_now_us();
+    
+    if (state->frame_count == state->frame_max){
+        Base_Allocator *allocator = get_allocator_malloc();
+        i32 new_max = clamp_bot(256, state->frame_max*2);
+        Bench_Frame_Time *new_times = base_array(allocator, Bench_Frame_Time, new_max);
+        block_copy_dynamic_array(new_times, state->times, state->frame_count);
+        if (state->times != 0){
+            base_free(allocator, state->times);
+        }
+        state->times = new_times;
+        state->frame_max = new_max;
+    }
+    Bench_Frame_Time *time = &state->times[state->frame_count];
+    time->build_us = raster_start - build_start;
+    time->raster_us = raster_end - raster_start;
+    state->frame_count += 1;
+    
+    // NOTE(allen): FNV-1a a pixel at a time over every frame, it only changes
+    // with the output.
+    u64 pixel_count = (u64)g_sw.width*g_sw.height;
+    u64 hash = state->hash;
+    for (u64 i = 0; i < pixel_count; i += 1){
+        hash = (hash ^ g_sw.pixels[i])*0x100000001B3llu;
+    }
+    state->hash = hash;
+    
+    printf("frame %4d  build %6llu us  raster %6llu us\n", state->frame_count - 1,
+           time->build_us, time->raster_us);
+}
+
+internal void
+bench_run_script(Bench_State *state, String_Const_u8 script){
+    Arena *arena = state->arena;
+    List_String_Const_u8 lines = string_split(arena, script, (u8*)"\n", 1);
+    for (Node_String_Const_u8 *node = lines.first;
+         node != 0;
+         node = node->next){
+        Temp_Memory temp = begin_temp(arena);
+        String_Const_u8 line = string_skip_chop_whitespace(node->string);
+        List_String_Const_u8 args = string_split(arena, line, (u8*)" \t\r", 3);
+        String_Const_u8 arg[4] = {};
+        i32 arg_count = 0;
+        for (Node_String_Const_u8 *arg_node = args.first;
+             arg_node != 0 && arg_count < ArrayCount(arg);
+             arg_node = arg_node->next){
+            arg[arg_count++] = arg_node->string;
+        }
+        
+        if (arg_count == 0 || arg[0].str[0] == '#'){
+            // NOTE(allen): blank line or comment
+        }
+        else if (string_match(arg[0], string_u8_litexpr("size")) && arg_count >= 3){
+            state->target.width = (i32)string_to_integer(arg[1], 10);
+            state->target.height = (i32)string_to_integer(arg[2], 10);
+        }
+        else if (string_match(arg[0], string_u8_litexpr("font")) && arg_count >= 3){
+            end_temp(temp);
+            Face_Description description = {};
+            description.font.file_name = push_string_copy(arena, arg[1]);
+            description.parameters.pt_size = (u32)string_to_integer(arg[2], 10);
+            description.parameters.hinting = (arg_count >= 4 && string_to_integer(arg[3], 10) != 0);
+            if (state->face != 0){
+                font_set_release_face(&state->font_set, state->face->id);
+            }
+            state->face = font_set_new_face(&state->font_set, &description);
+            if (state->face == 0){
+                printf("could not load font %.*s\n", string_expand(arg[1]));
+            }
+            temp = begin_temp(arena);
+        }
+        else if (string_match(arg[0], string_u8_litexpr("open")) && arg_count >= 2){
+            end_temp(temp);
+            bench_open(state, arg[1]);
+            temp = begin_temp(arena);
+        }
+        else if (string_match(arg[0], string_u8_litexpr("panels")) && arg_count >= 2){
+            state->panel_count = (i32)string_to_integer(arg[1], 10);
+        }
+        else if (string_match(arg[0], string_u8_litexpr("scroll")) && arg_count >= 3){
+            b32 negative = (arg[1].str[0] == '-');
+            i64 lines_per_frame = (i64)string_to_integer(negative?string_skip(arg[1], 1):arg[1], 10);
+            if (negative){
+                lines_per_frame = -lines_per_frame;
+            }
+            i32 frames = (i32)string_to_integer(arg[2], 10);
+            for (i32 i = 0; i < frames; i += 1){
+                state->first_line = clamp(0, state->first_line + lines_per_frame,
+                                          clamp_bot(0, state->line_count - 1));
+                bench_frame(state);
+            }
+        }
+        else if (string_match(arg[0], string_u8_litexpr("idle")) && arg_count >= 2){
+            i32 frames = (i32)string_to_integer(arg[1], 10);
+            for (i32 i = 0; i < frames; i += 1){
+                bench_frame(state);
+            }
+        }
+        else{
+            printf("unknown command: %.*s\n", string_expand(line));
+        }
+        end_temp(temp);
+    }
+}
+
+internal int
+bench_compare_u64(const void *a, const void *b){
+    u64 x = *(u64*)a;
+    u64 y = *(u64*)b;
+    return((x < y)?-1:((x > y)?1:0));
+}
+
+internal void
+bench_print_summary(Arena *arena, char *name, Bench_Frame_Time *times, i32 count, b32 raster){
+    Temp_Memory temp = begin_temp(arena);
+    u64 *values = push_array(arena, u64, count);
+    u64 total = 0;
+    for (i32 i = 0; i < count; i += 1){
+        values[i] = raster?times[i].raster_us:times[i].build_us;
+        total += values[i];
+    }
+    qsort(values, count, sizeof(*values), bench_compare_u64);
+    printf("%-6s  avg %6llu us  min %6llu  p50 %6llu  p95 %6llu  max %6llu\n", name,
+           total/count, values[0], values[count/2], values[(count*95)/100], values[count - 1]);
+    end_temp(temp);
+}
+
+internal void
+bench_write_ppm(char *name){
+    FILE *file = fopen(name, "wb");
+    if (file != 0){
+        fprintf(file, "P6\n%d %d\n255\n", g_sw.width, g_sw.height);
+        for (i32 i = 0; i < g_sw.width*g_sw.height; i += 1){
+            u32 pixel = g_sw.pixels[i];
+            u8 rgb[3] = { (u8)(pixel >> 16), (u8)(pixel >> 8), (u8)(pixel), };
+            fwrite(rgb, 3, 1, file);
+        }
+        fclose(file);
+    }
+    else{
+        printf("could not write %s\n", name);
+    }
+}
+
+int
+main(int argc, char **argv){
+    Arena arena_ = make_arena_malloc();
+    Arena *arena = &arena_;
+    
+    char *script_name = 0;
+    char *ppm_name = 0;
+    for (i32 i = 1; i < argc; i += 1){
+        if (string_match(SCu8(argv[i]), string_u8_litexpr("-o")) && i + 1 < argc){
+            i += 1;
+            ppm_name = argv[i];
+        }
+        else{
+            script_name = argv[i];
+        }
+    }
+    
+    String_Const_u8 script = SCu8(bench_default_script);
+    if (script_name != 0){
+        script = bench_read_file(arena, script_name);
+        if (script.str == 0){
+            printf("could not read %s\n", script_name);
+        }
+    }
+    
+    sw_init(get_allocator_malloc());
+    
+    Bench_State state = {};
+    state.arena = arena;
+    state.target.arena = make_arena_malloc();
+    state.target.width = 1280;
+    state.target.height = 720;
+    state.panel_count = 1;
+    state.hash = 0xCBF29CE484222325llu;
+    font_set_init(&state.font_set);
+    
+    bench_run_script(&state, script);
+    
+    if (state.frame_count > 0){
+        printf("\n%d frames at %dx%d\n", state.frame_count, state.target.width, state.target.height);
+        bench_print_summary(arena, "build", state.times, state.frame_count, false);
+        bench_print_summary(arena, "raster", state.times, state.frame_count, true);
+        printf("frames hash %016llx\n", state.hash);
+        if (ppm_name != 0){
+            bench_write_ppm(ppm_name);
+        }
+    }
+    
+    return(0);
+}
+
+// BOTTOM
+
@@ -176,6 +176,9 @@ draw_font_glyph(Render_Target *target, Face *face, u32 codepoint, Vec2_f32 p,
                                   codepoint, &glyph_index)){
         glyph_index = 0;
     }
+    if (face->glyph_is_ready != 0 && !face->glyph_is_ready[glyph_index]){
+        font_make_glyph(face, glyph_index);
+    }
     Glyph_Bounds bounds = face->bounds[glyph_index];
     Vec3_f32 texture_dim = face->texture_dim;
     
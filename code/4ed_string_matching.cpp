@@ -65,6 +65,187 @@ string_compute_needle_jump_table(Arena *arena, String_Const_u8 needle, Scan_Dire
 
 #define character_predicate_check_character(p, c) (((p).b[(c)/8] & (1 << ((c)%8))) != 0)
 
+// NOTE(allen): While the matcher has no partial match going, every byte that
+// cannot start a match is rejected one at a time with nothing else changing, so
+// the matchers skip over those runs with the candidate filter.  A candidate is a
+// byte equal to the byte a match starts on, ignoring case, and when the byte a
+// match would end on is in the same chunk, that one has to be equal too.
+//  Rejecting a candidate on its end byte only gives the same flags as running
+// the partial match when no prefix of the needle ends with a shorter prefix of
+// it, so that no match can start inside the partial match, and when the
+// predicate does not care about case, because the matcher takes the sloppy side
+// from the needle after a failed partial match instead of the text.  Otherwise
+// only the start byte is checked.
+struct String_Match_Filter{
+    u8 first_lo;
+    u8 first_hi;
+    u8 last_lo;
+    u8 last_hi;
+    u64 span;
+};
+
+internal String_Match_Filter
+string_match_filter_make(String_Const_u8 needle, u64_Array jump_table, Character_Predicate *predicate,
+                         Scan_Direction direction){
+    b32 check_last = (needle.size > 1);
+    for (u64 n = 1; n < needle.size && check_last; n += 1){
+        if (jump_table.vals[n] != n){
+            check_last = false;
+        }
+    }
+    for (u8 c = 'a'; c <= 'z' && check_last; c += 1){
+        if (character_predicate_check_character(*predicate, c) !=
+            character_predicate_check_character(*predicate, character_to_upper(c))){
+            check_last = false;
+        }
+    }
+    
+    u8 first = needle.str[0];
+    u8 last = needle.str[needle.size - 1];
+    if (direction == Scan_Backward){
+        Swap(u8, first, last);
+    }
+    if (!check_last){
+        last = first;
+    }
+    
+    String_Match_Filter filter = {};
+    filter.first_lo = character_to_lower(first);
+    filter.first_hi = character_to_upper(first);
+    filter.last_lo = character_to_lower(last);
+    filter.last_hi = character_to_upper(last);
+    filter.span = check_last?(needle.size - 1):0;
+    return(filter);
+}
+
+internal b32
+string_match_filter_check(String_Match_Filter *filter, u8 first, u8 last){
+    return((first == filter->first_lo || first == filter->first_hi) &&
+           (last == filter->last_lo || last == filter->last_hi));
+}
+
+// NOTE(allen): Returns the first candidate in [pos, size - 1), or size - 1, the
+// last byte of the chunk is always left to the matcher which handles the step to
+// the next chunk.
+internal u64
+string_match_skip_forward(String_Match_Filter *filter, u8 *str, u64 pos, u64 size){
+    u64 span = filter->span;
+    u64 end = size - 1;
+    u64 result = end;
+    b32 found = false;
+#if ARCH_AVX2
+    __m256i first_lo = _mm256_set1_epi8((char)filter->first_lo);
+    __m256i first_hi = _mm256_set1_epi8((char)filter->first_hi);
+    __m256i last_lo = _mm256_set1_epi8((char)filter->last_lo);
+    __m256i last_hi = _mm256_set1_epi8((char)filter->last_hi);
+    for (;!found && pos + 32 <= end && pos + span + 32 <= size;){
+        __m256i a = _mm256_loadu_si256((__m256i*)(str + pos));
+        __m256i b = _mm256_loadu_si256((__m256i*)(str + pos + span));
+        __m256i a_eq = _mm256_or_si256(_mm256_cmpeq_epi8(a, first_lo), _mm256_cmpeq_epi8(a, first_hi));
+        __m256i b_eq = _mm256_or_si256(_mm256_cmpeq_epi8(b, last_lo), _mm256_cmpeq_epi8(b, last_hi));
+        u32 mask = (u32)_mm256_movemask_epi8(_mm256_and_si256(a_eq, b_eq));
+        if (mask != 0){
+            result = pos + bit_scan_forward_u32(mask);
+            found = true;
+        }
+        else{
+            pos += 32;
+        }
+    }
+#elif ARCH_SSE2
+    __m128i first_lo = _mm_set1_epi8((char)filter->first_lo);
+    __m128i first_hi = _mm_set1_epi8((char)filter->first_hi);
+    __m128i last_lo = _mm_set1_epi8((char)filter->last_lo);
+    __m128i last_hi = _mm_set1_epi8((char)filter->last_hi);
+    for (;!found && pos + 16 <= end && pos + span + 16 <= size;){
+        __m128i a = _mm_loadu_si128((__m128i*)(str + pos));
+        __m128i b = _mm_loadu_si128((__m128i*)(str + pos + span));
+        __m128i a_eq = _mm_or_si128(_mm_cmpeq_epi8(a, first_lo), _mm_cmpeq_epi8(a, first_hi));
+        __m128i b_eq = _mm_or_si128(_mm_cmpeq_epi8(b, last_lo), _mm_cmpeq_epi8(b, last_hi));
+        u32 mask = (u32)_mm_movemask_epi8(_mm_and_si128(a_eq, b_eq));
+        if (mask != 0){
+            result = pos + bit_scan_forward_u32(mask);
+            found = true;
+        }
+        else{
+            pos += 16;
+        }
+    }
+#endif
+    for (;!found && pos < end;){
+        u8 first = str[pos];
+        u8 last = (pos + span < size)?str[pos + span]:filter->last_lo;
+        if (string_match_filter_check(filter, first, last)){
+            result = pos;
+            found = true;
+        }
+        else{
+            pos += 1;
+        }
+    }
+    return(result);
+}
+
+// NOTE(allen): Returns the last candidate in (0, pos], or 0, the first byte of
+// the chunk is always left to the matcher.
+internal u64
+string_match_skip_backward(String_Match_Filter *filter, u8 *str, u64 pos){
+    u64 span = filter->span;
+    u64 result = 0;
+    b32 found = false;
+#if ARCH_AVX2
+    __m256i first_lo = _mm256_set1_epi8((char)filter->first_lo);
+    __m256i first_hi = _mm256_set1_epi8((char)filter->first_hi);
+    __m256i last_lo = _mm256_set1_epi8((char)filter->last_lo);
+    __m256i last_hi = _mm256_set1_epi8((char)filter->last_hi);
+    for (;!found && pos >= 32 && pos >= span + 31;){
+        __m256i a = _mm256_loadu_si256((__m256i*)(str + pos - 31));
+        __m256i b = _mm256_loadu_si256((__m256i*)(str + pos - 31 - span));
+        __m256i a_eq = _mm256_or_si256(_mm256_cmpeq_epi8(a, first_lo), _mm256_cmpeq_epi8(a, first_hi));
+        __m256i b_eq = _mm256_or_si256(_mm256_cmpeq_epi8(b, last_lo), _mm256_cmpeq_epi8(b, last_hi));
+        u32 mask = (u32)_mm256_movemask_epi8(_mm256_and_si256(a_eq, b_eq));
+        if (mask != 0){
+            result = pos - 31 + bit_scan_reverse_u32(mask);
+            found = true;
+        }
+        else{
+            pos -= 32;
+        }
+    }
+#elif ARCH_SSE2
+    __m128i first_lo = _mm_set1_epi8((char)filter->first_lo);
+    __m128i first_hi = _mm_set1_epi8((char)filter->first_hi);
+    __m128i last_lo = _mm_set1_epi8((char)filter->last_lo);
+    __m128i last_hi = _mm_set1_epi8((char)filter->last_hi);
+    for (;!found && pos >= 16 && pos >= span + 15;){
+        __m128i a = _mm_loadu_si128((__m128i*)(str + pos - 15));
+        __m128i b = _mm_loadu_si128((__m128i*)(str + pos - 15 - span));
+        __m128i a_eq = _mm_or_si128(_mm_cmpeq_epi8(a, first_lo), _mm_cmpeq_epi8(a, first_hi));
+        __m128i b_eq = _mm_or_si128(_mm_cmpeq_epi8(b, last_lo), _mm_cmpeq_epi8(b, last_hi));
+        u32 mask = (u32)_mm_movemask_epi8(_mm_and_si128(a_eq, b_eq));
+        if (mask != 0){
+            result = pos - 15 + bit_scan_reverse_u32(mask);
+            found = true;
+        }
+        else{
+            pos -= 16;
+        }
+    }
+#endif
+    for (;!found && pos > 0;){
+        u8 first = str[pos];
+        u8 last = (pos >= span)?str[pos - span]:filter->last_lo;
+        if (string_match_filter_check(filter, first, last)){
+            result = pos;
+            found = true;
+        }
+        else{
+            pos -= 1;
+        }
+    }
+    return(result);
+}
+
 internal String_Match_List
 find_all_matches_forward(Arena *arena, i32 maximum_output_count,
                          List_String_Const_u8 chunks, String_Const_u8 needle,
@@ -84,6 +265,8 @@ find_all_matches_forward(Arena *arena, i32 maximum_output_count,
         
         i32 jump_back_code = 0;
         
+        String_Match_Filter filter = string_match_filter_make(needle, jump_table, predicate, Scan_Forward);
+        
         u8 c = 0;
         u64 n = 0;
         u8 needle_c = 0;
@@ -112,6 +295,17 @@ find_all_matches_forward(Arena *arena, i32 maximum_output_count,
         }
         
         for (;node != 0;){
+            if (i == j){
+                u64 skip_pos = string_match_skip_forward(&filter, node->string.str, chunk_pos, node->string.size);
+                if (skip_pos > (u64)chunk_pos){
+                    u64 skip = skip_pos - chunk_pos;
+                    i += skip;
+                    j += skip;
+                    chunk_pos = skip_pos;
+                    current_l = character_predicate_check_character(*predicate, node->string.str[chunk_pos - 1]);
+                }
+            }
+            
             c = node->string.str[chunk_pos];
             n = i - j;
             needle_c = needle.str[n];
@@ -202,6 +396,8 @@ find_all_matches_backward(Arena *arena, i32 maximum_output_count,
         
         i32 jump_back_code = 0;
         
+        String_Match_Filter filter = string_match_filter_make(needle, jump_table, predicate, Scan_Backward);
+        
         u8 c = 0;
         u64 n = 0;
         u8 needle_c = 0;
@@ -232,6 +428,17 @@ find_all_matches_backward(Arena *arena, i32 maximum_output_count,
         }
         
         for (;node != 0;){
+            if (i == j){
+                u64 skip_pos = string_match_skip_backward(&filter, node->string.str, chunk_pos);
+                if (skip_pos < (u64)chunk_pos){
+                    u64 skip = chunk_pos - skip_pos;
+                    i -= skip;
+                    j -= skip;
+                    chunk_pos = skip_pos;
+                    current_r = character_predicate_check_character(*predicate, node->string.str[chunk_pos + 1]);
+                }
+            }
+            
             c = node->string.str[chunk_pos];
             n = j - i;
             needle_c = needle.str[needle.size - 1 - n];
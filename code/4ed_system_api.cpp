@@ -46,6 +46,25 @@ define_api(Arena *arena){
         api_param(arena, call, "String_Const_u8", "file_name");
     }
     
+    {
+        API_Call *call = api_call(arena, api, "add_listener", "b32");
+        api_param(arena, call, "Arena*", "scratch");
+        api_param(arena, call, "String_Const_u8", "dir_name");
+    }
+    
+    {
+        API_Call *call = api_call(arena, api, "remove_listener", "b32");
+        api_param(arena, call, "Arena*", "scratch");
+        api_param(arena, call, "String_Const_u8", "dir_name");
+    }
+    
+    {
+        API_Call *call = api_call(arena, api, "get_file_changes", "List_String_Const_u8");
+        api_param(arena, call, "Arena*", "arena");
+        api_param(arena, call, "u64", "wait_us");
+        api_param(arena, call, "b32*", "lost_changes");
+    }
+    
     {
         API_Call *call = api_call(arena, api, "load_handle", "b32");
         api_param(arena, call, "Arena*", "scratch");
@@ -65,6 +84,18 @@ define_api(Arena *arena){
         api_param(arena, call, "u32", "size");
     }
     
+    {
+        API_Call *call = api_call(arena, api, "load_map", "void*");
+        api_param(arena, call, "Plat_Handle", "handle");
+        api_param(arena, call, "u64", "size");
+    }
+    
+    {
+        API_Call *call = api_call(arena, api, "load_unmap", "b32");
+        api_param(arena, call, "void*", "ptr");
+        api_param(arena, call, "u64", "size");
+    }
+    
     {
         API_Call *call = api_call(arena, api, "load_close", "b32");
         api_param(arena, call, "Plat_Handle", "handle");
@@ -77,6 +108,25 @@ define_api(Arena *arena){
         api_param(arena, call, "String_Const_u8", "data");
     }
     
+    {
+        API_Call *call = api_call(arena, api, "append_file", "b32");
+        api_param(arena, call, "Arena*", "scratch");
+        api_param(arena, call, "char*", "file_name");
+        api_param(arena, call, "String_Const_u8", "data");
+    }
+    
+    {
+        API_Call *call = api_call(arena, api, "create_directory", "b32");
+        api_param(arena, call, "Arena*", "scratch");
+        api_param(arena, call, "char*", "path");
+    }
+    
+    {
+        API_Call *call = api_call(arena, api, "delete_file", "b32");
+        api_param(arena, call, "Arena*", "scratch");
+        api_param(arena, call, "char*", "file_name");
+    }
+    
     {
         API_Call *call = api_call(arena, api, "load_library", "b32");
         api_param(arena, call, "Arena*", "scratch");
@@ -212,6 +262,10 @@ define_api(Arena *arena){
         api_call(arena, api, "thread_get_id", "i32");
     }
     
+    {
+        api_call(arena, api, "thread_get_processor_count", "i32");
+    }
+    
     {
         API_Call *call = api_call(arena, api, "acquire_global_frame_mutex", "void");
         api_param(arena, call, "Thread_Context*", "tctx");
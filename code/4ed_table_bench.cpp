@@ -0,0 +1,492 @@
+/*
+4ed_table_bench.cpp - Compares the group probed tables with the linear probing tables they replaced.
+
+Runs Table_Data_u64 on short names through the same inserts, lookups that hit,
+lookups that miss, and erase/insert churn.  The linear probing table and the
+byte at a time hash are copied below as they were, so both sides go through the
+same API.  Values read back are checked against each other.  Also times the two
+string hashes.
+
+The integer keyed tables still probe linearly from key % slot_count, so there
+is nothing to compare for them here.
+
+Build from the code directory, for example:
+g++ -O2 -I. -Icustom 4ed_table_bench.cpp -o table_bench
+The key count can be passed as the first argument.
+*/
+
+// TOP
+
+#include "4coder_base_types.h"
+#include "4coder_table.h"
+
+#include "4coder_base_types.cpp"
+#include "4coder_stringf.cpp"
+#include "4coder_malloc_allocator.cpp"
+#include "4coder_hash_functions.cpp"
+#include "4coder_table.cpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+////////////////////////////////
+
+// NOTE(allen): The tables as they were before the control bytes.
+
+struct Linear_Table_Data_u64{
+    Base_Allocator *allocator;
+    void *memory;
+    u64 *hashes;
+    String_Const_u8 *keys;
+    u64 *vals;
+    u32 slot_count;
+    u32 used_count;
+    u32 dirty_count;
+};
+
+global_const u64 linear_table_empty_slot = 0;
+global_const u64 linear_table_erased_slot = 1;
+
+internal u64
+linear_hash_u8(u8 *v, u64 size){
+    u64 hash = 0;
+    for (u8 *p = v, *e = v + size; p < e; p += 1){
+        u8 k = *p;
+        k *= 81;
+        k = ((u8)(k << 4)) | ((u8)(k >> 4));
+        hash ^= k;
+        hash *= 11;
+        hash += 237;
+    }
+    return(hash);
+}
+
+internal u64
+linear_table_hash(String_Const_u8 key){
+    return(linear_hash_u8((u8*)key.str, key.size) | bit_64);
+}
+
+
+internal Linear_Table_Data_u64
+make_linear_table_Data_u64__inner(Base_Allocator *allocator, u32 slot_count, String_Const_u8 location){
+    Linear_Table_Data_u64 table = {};
+    table.allocator = allocator;
+    slot_count = clamp_bot(8, slot_count);
+    String_Const_u8 mem = base_allocate__inner(allocator, slot_count*(sizeof(*table.hashes) + sizeof(*table.keys) + sizeof(*table.vals)), location);
+    block_zero(mem.str, mem.size);
+    table.memory = mem.str;
+    table.hashes = (u64*)table.memory;
+    table.keys = (String_Const_u8*)(table.hashes + slot_count);
+    table.vals = (u64*)(table.keys + slot_count);
+    table.slot_count = slot_count;
+    table.used_count = 0;
+    table.dirty_count = 0;
+    return(table);
+}
+
+#define make_linear_table_Data_u64(a,s) make_linear_table_Data_u64__inner((a),(s),file_name_line_number_lit_u8)
+
+internal void
+table_free(Linear_Table_Data_u64 *table){
+    base_free(table->allocator, table->memory);
+    block_zero_struct(table);
+}
+
+internal Table_Lookup
+table_lookup(Linear_Table_Data_u64 *table, String_Const_u8 key){
+    Table_Lookup result = {};
+    
+    if (table->slot_count > 0){
+        u64 *hashes = table->hashes;
+        u32 slot_count = table->slot_count;
+        
+        u64 hash = linear_table_hash(key);
+        u32 first_index = hash % slot_count;
+        u32 index = first_index;
+        result.hash = hash;
+        for (;;){
+            if (hash == hashes[index]){
+                if (data_match(key, table->keys[index])){
+                    result.index = index;
+                    result.found_match = true;
+                    result.found_empty_slot = false;
+                    result.found_erased_slot = false;
+                    break;
+                }
+            }
+            if (linear_table_empty_slot == hashes[index]){
+                if (!result.found_erased_slot){
+                    result.index = index;
+                    result.found_empty_slot = true;
+                }
+                break;
+            }
+            if (linear_table_erased_slot == hashes[index]){
+                if (!result.found_erased_slot){
+                    result.index = index;
+                    result.found_erased_slot = true;
+                }
+            }
+            index += 1;
+            if (index >= slot_count){
+                index = 0;
+            }
+            if (index == first_index){
+                break;
+            }
+        }
+    }
+    
+    return(result);
+}
+
+internal b32
+table_read(Linear_Table_Data_u64 *table, Table_Lookup lookup, u64 *val_out){
+    b32 result = false;
+    if (lookup.found_match){
+        *val_out = table->vals[lookup.index];
+        result = true;
+    }
+    return(result);
+}
+
+internal b32
+table_read(Linear_Table_Data_u64 *table, String_Const_u8 key, u64 *val_out){
+    Table_Lookup lookup = table_lookup(table, key);
+    return(table_read(table, lookup, val_out));
+}
+
+internal void
+table_insert__inner(Linear_Table_Data_u64 *table, Table_Lookup lookup, String_Const_u8 key, u64 val){
+    Assert(lookup.found_empty_slot || lookup.found_erased_slot);
+    table->hashes[lookup.index] = lookup.hash;
+    table->keys[lookup.index] = key;
+    table->vals[lookup.index] = val;
+    table->used_count += 1;
+    if (lookup.found_empty_slot){
+        table->dirty_count += 1;
+    }
+}
+
+internal b32
+table_rehash(Linear_Table_Data_u64 *dst, Linear_Table_Data_u64 *src){
+    b32 result = false;
+    u32 src_slot_count = src->slot_count;
+    if ((dst->dirty_count + src->used_count)*8 < dst->slot_count*7){
+        u64 *src_hashes = src->hashes;
+        for (u32 i = 0; i < src_slot_count; i += 1){
+            if (HasFlag(src_hashes[i], bit_64)){
+                String_Const_u8 key = src->keys[i];
+                Table_Lookup lookup = table_lookup(dst, key);
+                table_insert__inner(dst, lookup, key, src->vals[i]);
+            }
+        }
+        result = true;
+    }
+    return(result);
+}
+
+internal b32
+table_insert(Linear_Table_Data_u64 *table, String_Const_u8 key, u64 val){
+    b32 result = false;
+    if (key.str != 0){
+        Table_Lookup lookup = table_lookup(table, key);
+        if (!lookup.found_match){
+            if ((table->dirty_count + 1)*8 >= table->slot_count*7){
+                i32 new_slot_count = table->slot_count;
+                if (table->used_count*2 >= table->slot_count){
+                    new_slot_count = table->slot_count*4;
+                }
+                Linear_Table_Data_u64 new_table = make_linear_table_Data_u64(table->allocator, new_slot_count);
+                table_rehash(&new_table, table);
+                table_free(table);
+                *table = new_table;
+                lookup = table_lookup(table, key);
+                Assert(lookup.found_empty_slot);
+            }
+            table_insert__inner(table, lookup, key, val);
+            result = true;
+        }
+    }
+    return(result);
+}
+
+internal b32
+table_erase(Linear_Table_Data_u64 *table, String_Const_u8 key){
+    b32 result = false;
+    Table_Lookup lookup = table_lookup(table, key);
+    if (lookup.found_match){
+        table->hashes[lookup.index] = linear_table_erased_slot;
+        block_zero_struct(&table->keys[lookup.index]);
+        table->vals[lookup.index] = 0;
+        table->used_count -= 1;
+        result = true;
+    }
+    return(result);
+}
+
+
+////////////////////////////////
+
+typedef i32 Bench_Table_Kind;
+enum{
+    BenchTable_Linear,
+    BenchTable_Groups,
+    BenchTable_COUNT,
+};
+
+global char *bench_table_kind_names[BenchTable_COUNT] = {
+    "linear",
+    "groups",
+};
+
+struct Bench_Table{
+    Bench_Table_Kind kind;
+    Linear_Table_Data_u64 linear_data;
+    Table_Data_u64 groups_data;
+};
+
+internal void
+bench_table_init(Bench_Table *table, Bench_Table_Kind kind, Base_Allocator *allocator){
+    block_zero_struct(table);
+    table->kind = kind;
+    switch (kind){
+        case BenchTable_Linear:
+        {
+            table->linear_data = make_linear_table_Data_u64(allocator, 100);
+        }break;
+        case BenchTable_Groups:
+        {
+            table->groups_data = make_table_Data_u64(allocator, 100);
+        }break;
+    }
+}
+
+internal void
+bench_table_free(Bench_Table *table){
+    switch (table->kind){
+        case BenchTable_Linear:
+        {
+            table_free(&table->linear_data);
+        }break;
+        case BenchTable_Groups:
+        {
+            table_free(&table->groups_data);
+        }break;
+    }
+}
+
+internal void
+bench_insert(Bench_Table *table, String_Const_u8 key, u64 val){
+    switch (table->kind){
+        case BenchTable_Linear:
+        {
+            table_insert(&table->linear_data, key, val);
+        }break;
+        case BenchTable_Groups:
+        {
+            table_insert(&table->groups_data, key, val);
+        }break;
+    }
+}
+
+internal b32
+bench_read(Bench_Table *table, String_Const_u8 key, u64 *val_out){
+    b32 result = false;
+    switch (table->kind){
+        case BenchTable_Linear:
+        {
+            result = table_read(&table->linear_data, key, val_out);
+        }break;
+        case BenchTable_Groups:
+        {
+            result = table_read(&table->groups_data, key, val_out);
+        }break;
+    }
+    return(result);
+}
+
+internal void
+bench_erase(Bench_Table *table, String_Const_u8 key){
+    switch (table->kind){
+        case BenchTable_Linear:
+        {
+            table_erase(&table->linear_data, key);
+        }break;
+        case BenchTable_Groups:
+        {
+            table_erase(&table->groups_data, key);
+        }break;
+    }
+}
+
+////////////////////////////////
+
+global b32 bench_failed = false;
+
+internal u64
+bench_now_ns(void){
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return((u64)t.tv_sec*Billion(1) + (u64)t.tv_nsec);
+}
+
+// NOTE(allen): The first count keys go in the table, the second count keys are
+// only used for lookups that miss and for churn.  Lookups go through the keys in
+// a shuffled order, so keys made in sequence do not walk the table front to back.
+struct Bench_Keys{
+    char *name;
+    String_Const_u8 *strings;
+    i32 count;
+    i32 *order;
+};
+
+struct Bench_Times{
+    f64 insert;
+    f64 hit;
+    f64 miss;
+    f64 churn;
+    u64 check;
+};
+
+internal Bench_Times
+bench_run(Base_Allocator *allocator, Bench_Table_Kind kind, Bench_Keys *keys){
+    Bench_Times times = {};
+    Bench_Table table = {};
+    bench_table_init(&table, kind, allocator);
+    i32 count = keys->count;
+    
+    u64 start = bench_now_ns();
+    for (i32 i = 0; i < count; i += 1){
+        bench_insert(&table, keys->strings[i], i + 1);
+    }
+    times.insert = (f64)(bench_now_ns() - start)/count;
+    
+    start = bench_now_ns();
+    for (i32 i = 0; i < count; i += 1){
+        i32 k = keys->order[i];
+        u64 val = 0;
+        if (!bench_read(&table, keys->strings[k], &val) || val != (u64)(k + 1)){
+            bench_failed = true;
+        }
+        times.check += val;
+    }
+    times.hit = (f64)(bench_now_ns() - start)/count;
+    
+    start = bench_now_ns();
+    for (i32 i = 0; i < count; i += 1){
+        u64 val = 0;
+        if (bench_read(&table, keys->strings[count + keys->order[i]], &val)){
+            bench_failed = true;
+        }
+    }
+    times.miss = (f64)(bench_now_ns() - start)/count;
+    
+    // NOTE(allen): Erases a key and puts a new one in its place, the way ids and
+    // names come and go while the editor runs, which leaves erased slots behind.
+    u32 seed = 0x1234567;
+    start = bench_now_ns();
+    for (i32 i = 0; i < count; i += 1){
+        seed = seed*1664525 + 1013904223;
+        i32 out = (i32)(seed % (u32)count);
+        bench_erase(&table, keys->strings[out]);
+        bench_insert(&table, keys->strings[count + i], i + 1);
+        bench_insert(&table, keys->strings[out], out + 1);
+        bench_erase(&table, keys->strings[count + i]);
+    }
+    times.churn = (f64)(bench_now_ns() - start)/count;
+    
+    for (i32 i = 0; i < count; i += 1){
+        u64 val = 0;
+        if (!bench_read(&table, keys->strings[i], &val)){
+            bench_failed = true;
+        }
+        times.check += val;
+    }
+    
+    bench_table_free(&table);
+    return(times);
+}
+
+internal f64
+bench_hash(u64 (*hash_func)(u8 *v, u64 size), u8 *data, u64 size, i32 count, u64 *check){
+    u64 start = bench_now_ns();
+    for (i32 i = 0; i < count; i += 1){
+        *check += hash_func(data + (i & 63), size);
+    }
+    return((f64)(bench_now_ns() - start)/count);
+}
+
+int
+main(int argc, char **argv){
+    i32 count = 20000;
+    if (argc > 1){
+        count = clamp_bot(1, atoi(argv[1]));
+    }
+    
+    Base_Allocator *allocator = get_allocator_malloc();
+    Arena arena = make_arena(allocator, MB(16));
+    
+    i32 *order = push_array(&arena, i32, count);
+    for (i32 i = 0; i < count; i += 1){
+        order[i] = i;
+    }
+    u32 seed = 0x7654321;
+    for (i32 i = count - 1; i > 0; i -= 1){
+        seed = seed*1664525 + 1013904223;
+        i32 j = (i32)(seed % (u32)(i + 1));
+        Swap(i32, order[i], order[j]);
+    }
+    
+    Bench_Keys name_keys = {"names"};
+    name_keys.strings = push_array(&arena, String_Const_u8, count*2);
+    name_keys.count = count;
+    name_keys.order = order;
+    for (i32 i = 0; i < count*2; i += 1){
+        name_keys.strings[i] = push_u8_stringf(&arena, "code/custom/file_%d.cpp", i);
+    }
+    
+    printf("%d keys, ns per operation\n", count);
+    printf("%-9s %-7s %8s %8s %8s %8s\n", "keys", "table", "insert", "hit", "miss", "churn");
+    Bench_Keys *key_sets[] = {&name_keys};
+    for (i32 i = 0; i < ArrayCount(key_sets); i += 1){
+        u64 check = 0;
+        for (i32 kind = 0; kind < BenchTable_COUNT; kind += 1){
+            Bench_Times times = bench_run(allocator, kind, key_sets[i]);
+            printf("%-9s %-7s %8.1f %8.1f %8.1f %8.1f\n",
+                   key_sets[i]->name, bench_table_kind_names[kind],
+                   times.insert, times.hit, times.miss, times.churn);
+            if (kind > 0 && times.check != check){
+                bench_failed = true;
+            }
+            check = times.check;
+        }
+    }
+    
+    u8 data[4096 + 64];
+    for (i32 i = 0; i < ArrayCount(data); i += 1){
+        data[i] = (u8)(i*131 + 7);
+    }
+    printf("\nstring hash, ns per call\n");
+    printf("%-9s %8s %8s\n", "bytes", "bytes", "words");
+    u64 sizes[] = {8, 24, 64, 256, 4096};
+    u64 check = 0;
+    for (i32 i = 0; i < ArrayCount(sizes); i += 1){
+        i32 calls = (i32)clamp_bot(1000, 20000000/(sizes[i] + 16));
+        f64 old_time = bench_hash(linear_hash_u8, data, sizes[i], calls, &check);
+        f64 new_time = bench_hash(table_hash_u8, data, sizes[i], calls, &check);
+        printf("%-9llu %8.1f %8.1f\n", sizes[i], old_time, new_time);
+    }
+    if (check == 0){
+        printf("\n");
+    }
+    
+    if (bench_failed){
+        printf("error: the tables did not agree on the values read back\n");
+    }
+    return(bench_failed?1:0);
+}
+
+// BOTTOM
+
@@ -0,0 +1,145 @@
+/*
+4ed_treap.cpp - Treap ordered by summed node weights, the base of the line indexes and the piece tree.
+*/
+
+// TOP
+
+internal i64
+treap_total(Treap_Node *node){
+    return((node == 0)?0:node->total_weight);
+}
+
+internal void
+treap_update_node(Treap *treap, Treap_Node *node){
+    node->total_weight = treap_total(node->left) + node->weight + treap_total(node->right);
+    if (treap->update != 0){
+        treap->update(node);
+    }
+}
+
+internal void
+treap_init(Treap *treap, Base_Allocator *allocator, u64 node_size, u64 nodes_per_chunk,
+           Treap_Update *update, u32 seed){
+    block_zero_struct(treap);
+    treap->arena = make_arena(allocator, node_size*nodes_per_chunk);
+    treap->node_size = node_size;
+    treap->update = update;
+    treap->rng = seed;
+}
+
+internal void
+treap_free(Treap *treap){
+    linalloc_clear(&treap->arena);
+    block_zero_struct(treap);
+}
+
+// NOTE(allen): Only the header is set up, the caller fills in the rest of its
+// node and then calls treap_update_node.
+internal Treap_Node*
+treap_alloc_node(Treap *treap, i64 weight){
+    Treap_Node *node = treap->free_nodes;
+    if (node != 0){
+        treap->free_nodes = node->left;
+    }
+    else{
+        node = (Treap_Node*)push_array(&treap->arena, u8, treap->node_size);
+    }
+    node->left = 0;
+    node->right = 0;
+    node->weight = weight;
+    node->total_weight = weight;
+    // NOTE(allen): xorshift32; the priorities only have to be distinct enough
+    // to keep the treap balanced in expectation.
+    u32 x = treap->rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    treap->rng = x;
+    node->priority = x;
+    treap->node_count += 1;
+    return(node);
+}
+
+internal void
+treap_free_subtree(Treap *treap, Treap_Node *node){
+    if (node != 0){
+        treap_free_subtree(treap, node->left);
+        treap_free_subtree(treap, node->right);
+        node->left = treap->free_nodes;
+        treap->free_nodes = node;
+        treap->node_count -= 1;
+    }
+}
+
+internal Treap_Node*
+treap_merge(Treap *treap, Treap_Node *a, Treap_Node *b){
+    Treap_Node *result = 0;
+    if (a == 0){
+        result = b;
+    }
+    else if (b == 0){
+        result = a;
+    }
+    else if (a->priority > b->priority){
+        a->right = treap_merge(treap, a->right, b);
+        treap_update_node(treap, a);
+        result = a;
+    }
+    else{
+        b->left = treap_merge(treap, a, b->left);
+        treap_update_node(treap, b);
+        result = b;
+    }
+    return(result);
+}
+
+// NOTE(allen): Splits on node boundaries at a summed weight of key.  The node
+// that key falls inside of goes to *l_out when include_node is set and to *r_out
+// otherwise; a key at or past the total weight leaves everything on the left.
+internal void
+treap_split(Treap *treap, Treap_Node *node, i64 key, b32 include_node,
+            Treap_Node **l_out, Treap_Node **r_out){
+    if (node == 0){
+        *l_out = 0;
+        *r_out = 0;
+    }
+    else{
+        i64 left_total = treap_total(node->left);
+        if (key < left_total){
+            treap_split(treap, node->left, key, include_node, l_out, &node->left);
+            treap_update_node(treap, node);
+            *r_out = node;
+        }
+        else if (key >= left_total + node->weight){
+            treap_split(treap, node->right, key - left_total - node->weight, include_node, &node->right, r_out);
+            treap_update_node(treap, node);
+            *l_out = node;
+        }
+        else if (include_node){
+            *r_out = node->right;
+            node->right = 0;
+            treap_update_node(treap, node);
+            *l_out = node;
+        }
+        else{
+            *l_out = node->left;
+            node->left = 0;
+            treap_update_node(treap, node);
+            *r_out = node;
+        }
+    }
+}
+
+internal Treap_Node*
+treap_first(Treap_Node *node){
+    for (;node != 0 && node->left != 0; node = node->left);
+    return(node);
+}
+
+internal Treap_Node*
+treap_last(Treap_Node *node){
+    for (;node != 0 && node->right != 0; node = node->right);
+    return(node);
+}
+
+// BOTTOM
@@ -0,0 +1,37 @@
+/*
+4ed_treap.h - Treap ordered by summed node weights, the base of the line indexes and the piece tree.
+*/
+
+// TOP
+
+#if !defined(FRED_TREAP_H)
+#define FRED_TREAP_H
+
+// NOTE(allen): A treap keyed implicitly by the running sum of node weights (the
+// lines in a block, the bytes in a piece).  Every user embeds Treap_Node as the
+// first member of its own node type and passes that type's size to treap_init.
+// Aggregates other than the weight are folded by the update function, which runs
+// after total_weight has been summed for the node.
+struct Treap_Node{
+    Treap_Node *left;
+    Treap_Node *right;
+    u32 priority;
+    i64 weight;
+    i64 total_weight;
+};
+
+typedef void Treap_Update(Treap_Node *node);
+
+struct Treap{
+    Treap_Node *root;
+    Treap_Node *free_nodes;
+    Treap_Update *update;
+    Arena arena;
+    u64 node_size;
+    i64 node_count;
+    u32 rng;
+};
+
+#endif
+
+// BOTTOM
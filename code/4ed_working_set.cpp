@@ -16,62 +16,6 @@ working_set_file_default_settings(Working_Set *working_set, Editing_File *file){
 
 ////////////////////////////////
 
-internal void
-file_change_notification_check(Arena *scratch, Working_Set *working_set, Editing_File *file){
-    if (file->canon.name_size > 0 && !file->settings.unimportant){
-        String_Const_u8 name = SCu8(file->canon.name_space, file->canon.name_size);
-        File_Attributes attributes = system_quick_file_attributes(scratch, name);
-        if ((attributes.last_write_time > file->attributes.last_write_time) ||
-            (attributes.last_write_time == 0 && file->attributes.last_write_time > 0)){
-            if (file->state.save_state == FileSaveState_SavedWaitingForNotification){
-                file->state.save_state = FileSaveState_Normal;
-                file->attributes = attributes;
-            }
-            else{
-                file_add_dirty_flag(file, DirtyState_UnloadedChanges);
-                if (file->external_mod_node.next == 0){
-                    LogEventF(log_string(M), &working_set->arena, file->id, 0, system_thread_get_id(),
-                              "external modification [lwt=0x%llx]", attributes.last_write_time);
-                    dll_insert_back(&working_set->has_external_mod_sentinel, &file->external_mod_node);
-                    system_signal_step(0);
-                }
-            }
-        }
-        file->attributes = attributes;
-    }
-}
-
-internal void
-file_change_notification_thread_main(void *ptr){
-    Models *models = (Models*)ptr;
-    Arena arena = make_arena_system();
-    Working_Set *working_set = &models->working_set;
-    for (;;){
-        system_sleep(Thousand(250));
-        Mutex_Lock lock(working_set->mutex);
-        if (working_set->active_file_count > 0){
-            i32 check_count = working_set->active_file_count/16;
-            check_count = clamp(1, check_count, 100);
-            Node *used = &working_set->active_file_sentinel;
-            Node *node = working_set->sync_check_iterator;
-            if (node == 0 || node == used){
-                node = used->next;
-            }
-            for (i32 i = 0; i < check_count; i += 1){
-                Editing_File *file = CastFromMember(Editing_File, main_chain_node, node);
-                node = node->next;
-                if (node == used){
-                    node = node->next;
-                }
-                file_change_notification_check(&arena, working_set, file);
-            }
-            working_set->sync_check_iterator = node;
-        }
-    }
-}
-
-////////////////////////////////
-
 internal Editing_File*
 working_set_allocate_file(Working_Set *working_set, Lifetime_Allocator *lifetime_allocator){
     Editing_File *file = working_set->free_files;
@@ -120,27 +64,6 @@ working_set_get_file(Working_Set *working_set, Buffer_ID id){
     return(result);
 }
 
-internal void
-working_set_init(Models *models, Working_Set *working_set){
-    block_zero_struct(working_set);
-    working_set->arena = make_arena_system();
-    
-    working_set->id_counter = 1;
-    
-    dll_init_sentinel(&working_set->active_file_sentinel);
-    dll_init_sentinel(&working_set->touch_order_sentinel);
-    
-    local_const i32 slot_count = 128;
-    Base_Allocator *allocator = get_base_allocator_system();
-    working_set->id_to_ptr_table = make_table_u64_u64(allocator, slot_count);
-    working_set->canon_table = make_table_Data_u64(allocator, slot_count);
-    working_set->name_table = make_table_Data_u64(allocator, slot_count);
-    
-    dll_init_sentinel(&working_set->has_external_mod_sentinel);
-    working_set->mutex = system_mutex_make();
-    working_set->file_change_thread = system_thread_launch(file_change_notification_thread_main, models);
-}
-
 internal Editing_File*
 working_set_contains__generic(Working_Set *working_set, Table_Data_u64 *table, String_Const_u8 name){
     Editing_File *result = 0;
@@ -206,6 +129,121 @@ get_file_from_identifier(Working_Set *working_set, Buffer_Identifier buffer){
 
 ////////////////////////////////
 
+internal void
+file_change_notification_check(Arena *scratch, Working_Set *working_set, Editing_File *file){
+    if (file->canon.name_size > 0 && !file->settings.unimportant){
+        String_Const_u8 name = SCu8(file->canon.name_space, file->canon.name_size);
+        File_Attributes attributes = system_quick_file_attributes(scratch, name);
+        if ((attributes.last_write_time > file->attributes.last_write_time) ||
+            (attributes.last_write_time == 0 && file->attributes.last_write_time > 0)){
+            if (file->state.save_state == FileSaveState_SavedWaitingForNotification){
+                file->state.save_state = FileSaveState_Normal;
+                file->attributes = attributes;
+            }
+            else{
+                file_add_dirty_flag(file, DirtyState_UnloadedChanges);
+                if (file->external_mod_node.next == 0){
+                    LogEventF(log_string(M), &working_set->arena, file->id, 0, system_thread_get_id(),
+                              "external modification [lwt=0x%llx]", attributes.last_write_time);
+                    dll_insert_back(&working_set->has_external_mod_sentinel, &file->external_mod_node);
+                    system_signal_step(0);
+                }
+            }
+        }
+        file->attributes = attributes;
+    }
+}
+
+// NOTE(allen): Files in a directory the platform listens on are checked as soon
+// as it reports a change to them.  The rest are polled a few at a time every
+// quarter second, which is all there is on platforms without listeners, or once
+// the listener limit runs out.  When the platform loses track of changes every
+// file is checked.
+internal void
+file_change_notification_thread_main(void *ptr){
+    Models *models = (Models*)ptr;
+    Arena arena = make_arena_system();
+    Working_Set *working_set = &models->working_set;
+    u64 poll_interval = Thousand(250);
+    u64 next_poll_time = system_now_time() + poll_interval;
+    for (;;){
+        Temp_Memory temp = begin_temp(&arena);
+        u64 now = system_now_time();
+        u64 wait = (next_poll_time > now)?(next_poll_time - now):0;
+        b32 lost_changes = false;
+        List_String_Const_u8 changes = system_get_file_changes(&arena, wait, &lost_changes);
+        
+        Mutex_Lock lock(working_set->mutex);
+        for (Node_String_Const_u8 *change = changes.first;
+             change != 0;
+             change = change->next){
+            Editing_File *file = working_set_contains_canon(working_set, change->string);
+            if (file != 0){
+                file_change_notification_check(&arena, working_set, file);
+            }
+        }
+        
+        Node *used = &working_set->active_file_sentinel;
+        if (lost_changes){
+            for (Node *node = used->next;
+                 node != used;
+                 node = node->next){
+                Editing_File *file = CastFromMember(Editing_File, main_chain_node, node);
+                file_change_notification_check(&arena, working_set, file);
+            }
+        }
+        
+        now = system_now_time();
+        if (now >= next_poll_time){
+            next_poll_time = now + poll_interval;
+            if (working_set->active_file_count > 0){
+                i32 check_count = working_set->active_file_count/16;
+                check_count = clamp(1, check_count, 100);
+                Node *node = working_set->sync_check_iterator;
+                if (node == 0 || node == used){
+                    node = used->next;
+                }
+                for (i32 i = 0, j = 0; i < check_count && j < working_set->active_file_count; j += 1){
+                    Editing_File *file = CastFromMember(Editing_File, main_chain_node, node);
+                    node = node->next;
+                    if (node == used){
+                        node = node->next;
+                    }
+                    if (!file->has_listener){
+                        file_change_notification_check(&arena, working_set, file);
+                        i += 1;
+                    }
+                }
+                working_set->sync_check_iterator = node;
+            }
+        }
+        end_temp(temp);
+    }
+}
+
+internal void
+working_set_init(Models *models, Working_Set *working_set){
+    block_zero_struct(working_set);
+    working_set->arena = make_arena_system();
+    
+    working_set->id_counter = 1;
+    
+    dll_init_sentinel(&working_set->active_file_sentinel);
+    dll_init_sentinel(&working_set->touch_order_sentinel);
+    
+    local_const i32 slot_count = 128;
+    Base_Allocator *allocator = get_base_allocator_system();
+    working_set->id_to_ptr_table = make_table_u64_u64(allocator, slot_count);
+    working_set->canon_table = make_table_Data_u64(allocator, slot_count);
+    working_set->name_table = make_table_Data_u64(allocator, slot_count);
+    
+    dll_init_sentinel(&working_set->has_external_mod_sentinel);
+    working_set->mutex = system_mutex_make();
+    working_set->file_change_thread = system_thread_launch(file_change_notification_thread_main, models);
+}
+
+////////////////////////////////
+
 #if 0
 // TODO(allen): Bring the clipboard fully to the custom side.
 internal void
@@ -276,7 +314,7 @@ get_canon_name(Arena *scratch, String_Const_u8 file_name, Editing_File_Name *can
 }
 
 internal void
-file_bind_file_name(Working_Set *working_set, Editing_File *file, String_Const_u8 canon_file_name){
+file_bind_file_name(Arena *scratch, Working_Set *working_set, Editing_File *file, String_Const_u8 canon_file_name){
     Assert(file->unique_name.name_size == 0);
     Assert(file->canon.name_size == 0);
     u64 size = canon_file_name.size;
@@ -286,13 +324,20 @@ file_bind_file_name(Working_Set *working_set, Editing_File *file, String_Const_u
     file_name_terminate(&file->canon);
     b32 result = working_set_canon_add(working_set, file, string_from_file_name(&file->canon));
     Assert(result);
+    String_Const_u8 dir_name = string_remove_front_of_path(string_from_file_name(&file->canon));
+    file->has_listener = system_add_listener(scratch, dir_name);
 }
 
 internal void
-buffer_unbind_file(Working_Set *working_set, Editing_File *file){
+buffer_unbind_file(Arena *scratch, Working_Set *working_set, Editing_File *file){
     Assert(file->unique_name.name_size == 0);
     Assert(file->canon.name_size != 0);
     working_set_canon_remove(working_set, string_from_file_name(&file->canon));
+    if (file->has_listener){
+        String_Const_u8 dir_name = string_remove_front_of_path(string_from_file_name(&file->canon));
+        system_remove_listener(scratch, dir_name);
+        file->has_listener = false;
+    }
     file->canon.name_size = 0;
 }
 
@@ -11,21 +11,179 @@
 global Async_System global_async_system = {};
 
 function Async_Node*
-async_pop_node(Async_System *async_system){
-    for (;async_system->task_count == 0;){
-        system_condition_variable_wait(async_system->cv, async_system->mutex);
+async_find_in_list(Node *sent, Async_Task task){
+    Async_Node *result = 0;
+    for (Node *node = sent->next;
+         node != sent;
+         node = node->next){
+        Async_Node *a_node = CastFromMember(Async_Node, node, node);
+        if (a_node->task == task){
+            result = a_node;
+            break;
+        }
+    }
+    return(result);
+}
+
+// NOTE(allen): The owner takes from the back of its queue and a thief from the
+// front, so the two only go for the same task when one is left.  The worker is
+// marked as running the task before the queue lock is let go, so anyone who
+// looks for the task afterwards finds it one way or the other.
+function Async_Node*
+async_claim_node(Async_Thread *thread, Async_Thread *queue_thread, Async_Priority priority){
+    Async_Node *result = 0;
+    system_mutex_acquire(queue_thread->queue_mutex);
+    Node *sent = &queue_thread->queue_sent[priority];
+    if (sent->next != sent){
+        Node *node = (queue_thread == thread)?sent->prev:sent->next;
+        dll_remove(node);
+        result = CastFromMember(Async_Node, node, node);
+        result->next = 0;
+        result->thread = thread;
+        thread->node = result;
+        thread->cancel_signal = false;
+        atomic_store_release_u64(&thread->task, result->task);
+    }
+    system_mutex_release(queue_thread->queue_mutex);
+    return(result);
+}
+
+function Async_Node*
+async_find_work(Async_System *async_system, Async_Thread *thread){
+    Async_Node *result = 0;
+    i32 thread_count = async_system->thread_count;
+    for (i32 priority = AsyncPriority_COUNT - 1;
+         priority >= 0 && result == 0;
+         priority -= 1){
+        for (i32 i = 0; i < thread_count && result == 0; i += 1){
+            Async_Thread *queue_thread = &async_system->threads[(thread->index + i) % thread_count];
+            result = async_claim_node(thread, queue_thread, priority);
+        }
+    }
+    return(result);
+}
+
+// NOTE(allen): Called with the system mutex held.  Tasks are only queued with it
+// held as well, so a worker that checks this before it sleeps cannot miss one.
+function b32
+async_has_work(Async_System *async_system){
+    b32 result = false;
+    for (i32 i = 0; i < async_system->thread_count && !result; i += 1){
+        Async_Thread *thread = &async_system->threads[i];
+        system_mutex_acquire(thread->queue_mutex);
+        for (i32 priority = 0; priority < AsyncPriority_COUNT; priority += 1){
+            Node *sent = &thread->queue_sent[priority];
+            if (sent->next != sent){
+                result = true;
+                break;
+            }
+        }
+        system_mutex_release(thread->queue_mutex);
+    }
+    return(result);
+}
+
+function Async_Node*
+async_pop_node(Async_System *async_system, Async_Thread *thread){
+    Async_Node *result = 0;
+    for (;;){
+        result = async_find_work(async_system, thread);
+        if (result != 0){
+            break;
+        }
+        system_mutex_acquire(async_system->mutex);
+        for (;!async_has_work(async_system);){
+            system_condition_variable_wait(async_system->cv, async_system->mutex);
+        }
+        system_mutex_release(async_system->mutex);
+    }
+    return(result);
+}
+
+// NOTE(allen): Takes task out of the worker queue it is waiting in, a task in the
+// blocked list stays where it is.
+function Async_Node*
+async_take_queued_node(Async_System *async_system, Async_Task task){
+    Async_Node *result = 0;
+    if (task != 0){
+        for (i32 i = 0; i < async_system->thread_count && result == 0; i += 1){
+            Async_Thread *thread = &async_system->threads[i];
+            system_mutex_acquire(thread->queue_mutex);
+            for (i32 priority = 0; priority < AsyncPriority_COUNT && result == 0; priority += 1){
+                result = async_find_in_list(&thread->queue_sent[priority], task);
+            }
+            if (result != 0){
+                dll_remove(&result->node);
+                result->next = 0;
+            }
+            system_mutex_release(thread->queue_mutex);
+        }
     }
-    Node *node = async_system->task_sent.next;
-    Assert(node != &async_system->task_sent);
-    dll_remove(node);
-    async_system->task_count -= 1;
-    Async_Node *a_node = CastFromMember(Async_Node, node, node);
-    a_node->next = 0;
-    return(a_node);
+    return(result);
 }
 
+// NOTE(allen): With the system mutex held a pending node can still be claimed by
+// a worker at any moment, so the result only says that task has not started.
 function Async_Node*
-async_push_node__inner(Async_System *async_system, Async_Task_Function_Type *func, String_Const_u8 data){
+async_get_pending_node(Async_System *async_system, Async_Task task){
+    Async_Node *result = 0;
+    if (task != 0){
+        for (i32 i = 0; i < async_system->thread_count && result == 0; i += 1){
+            Async_Thread *thread = &async_system->threads[i];
+            system_mutex_acquire(thread->queue_mutex);
+            for (i32 priority = 0; priority < AsyncPriority_COUNT && result == 0; priority += 1){
+                result = async_find_in_list(&thread->queue_sent[priority], task);
+            }
+            system_mutex_release(thread->queue_mutex);
+        }
+        if (result == 0){
+            result = async_find_in_list(&async_system->blocked_sent, task);
+        }
+    }
+    return(result);
+}
+
+// NOTE(allen): Look for pending nodes first; a node claimed after its queue was
+// searched is already marked as running by the time this looks.  Once a worker
+// is running a node only that worker changes its node, and only with the system
+// mutex held, so the chain of joined nodes is safe to walk here.
+function Async_Node*
+async_get_running_node(Async_System *async_system, Async_Task task){
+    Async_Node *result = 0;
+    if (task != 0){
+        for (i32 i = 0; i < async_system->thread_count && result == 0; i += 1){
+            Async_Thread *thread = &async_system->threads[i];
+            if (atomic_load_acquire_u64(&thread->task) != 0){
+                for (Async_Node *node = thread->node;
+                     node != 0;
+                     node = node->outer){
+                    if (node->task == task){
+                        result = node;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+    return(result);
+}
+
+function void
+async_queue_node(Async_System *async_system, Async_Node *node, Async_Thread *queue){
+    if (queue == 0){
+        queue = &async_system->threads[async_system->next_queue];
+        async_system->next_queue = (async_system->next_queue + 1) % async_system->thread_count;
+    }
+    node->dependency = 0;
+    system_mutex_acquire(queue->queue_mutex);
+    dll_insert_back(&queue->queue_sent[node->priority], &node->node);
+    system_mutex_release(queue->queue_mutex);
+    system_condition_variable_signal(async_system->cv);
+}
+
+function Async_Node*
+async_push_node__inner(Async_System *async_system, Async_Task_Function_Type *func, String_Const_u8 data,
+                       Async_Priority priority, Async_Task dependency){
     Async_Task result = async_system->task_id_counter;
     async_system->task_id_counter += 1;
     
@@ -38,29 +196,83 @@ async_push_node__inner(Async_System *async_system, Async_Task_Function_Type *fun
     }
     node->task = result;
     node->thread = 0;
+    node->first_joiner = 0;
+    node->outer = 0;
+    node->canceled = false;
+    node->priority = clamp(AsyncPriority_Low, priority, AsyncPriority_High);
+    node->dependency = 0;
     node->func = func;
     node->data.str = (u8*)heap_allocate(&async_system->node_heap, data.size);
     block_copy(node->data.str, data.str, data.size);
     node->data.size = data.size;
-    dll_insert_back(&async_system->task_sent, &node->node);
-    async_system->task_count += 1;
-    system_condition_variable_signal(async_system->cv);
+    
+    // NOTE(allen): A dependency that already finished does not hold anything up.
+    if (async_get_pending_node(async_system, dependency) != 0 ||
+        async_get_running_node(async_system, dependency) != 0){
+        node->dependency = dependency;
+        dll_insert_back(&async_system->blocked_sent, &node->node);
+    }
+    else{
+        async_queue_node(async_system, node, 0);
+    }
     
     return(node);
 }
 
 function Async_Task
-async_push_node(Async_System *async_system, Async_Task_Function_Type *func, String_Const_u8 data){
-    Async_Node *node = async_push_node__inner(async_system, func, data);
+async_push_node(Async_System *async_system, Async_Task_Function_Type *func, String_Const_u8 data,
+                Async_Priority priority, Async_Task dependency){
+    Async_Node *node = async_push_node__inner(async_system, func, data, priority, dependency);
     return(node->task);
 }
 
 function void
 async_free_node(Async_System *async_system, Async_Node *node){
+    for (Async_Thread *joiner = node->first_joiner, *next = 0;
+         joiner != 0;
+         joiner = next){
+        next = joiner->next_joiner;
+        joiner->join_node = 0;
+        joiner->next_joiner = 0;
+        system_condition_variable_signal(joiner->join_cv);
+    }
+    node->first_joiner = 0;
     heap_free(&async_system->node_heap, node->data.str);
     sll_stack_push(async_system->free_nodes, node);
 }
 
+// NOTE(allen): Releases the tasks blocked on task.  When task finished they are
+// queued on the worker that ran it, when it was canceled they are canceled along
+// with everything blocked on them in turn.
+function void
+async_release_dependents(Async_System *async_system, Async_Task task, Async_Thread *thread, b32 canceled){
+    Node released = {};
+    dll_init_sentinel(&released);
+    for (Node *node = async_system->blocked_sent.next;
+         node != &async_system->blocked_sent;){
+        Node *next = node->next;
+        Async_Node *a_node = CastFromMember(Async_Node, node, node);
+        if (a_node->dependency == task){
+            dll_remove(node);
+            dll_insert_back(&released, node);
+        }
+        node = next;
+    }
+    for (;released.next != &released;){
+        Node *node = released.next;
+        dll_remove(node);
+        Async_Node *a_node = CastFromMember(Async_Node, node, node);
+        if (canceled){
+            Async_Task dependent = a_node->task;
+            async_free_node(async_system, a_node);
+            async_release_dependents(async_system, dependent, 0, true);
+        }
+        else{
+            async_queue_node(async_system, a_node, thread);
+        }
+    }
+}
+
 function void
 async_task_thread(void *thread_ptr){
     Base_Allocator *allocator = get_base_allocator_system();
@@ -85,53 +297,24 @@ async_task_thread(void *thread_ptr){
     Async_Context ctx = {&app, thread};
     
     for (;;){
-        system_mutex_acquire(async_system->mutex);
-        Async_Node *node = async_pop_node(async_system);
-        node->thread = thread;
-        thread->node = node;
-        thread->task = node->task;
-        thread->cancel_signal = false;
-        system_mutex_release(async_system->mutex);
+        Async_Node *node = async_pop_node(async_system, thread);
         
         node->func(&ctx, node->data);
         
         system_mutex_acquire(async_system->mutex);
+        b32 canceled = atomic_read_b32(&thread->cancel_signal);
+        Async_Task task = node->task;
         node->thread = 0;
         thread->node = 0;
-        thread->task = 0;
+        atomic_store_release_u64(&thread->task, 0);
         thread->cancel_signal = false;
         async_free_node(async_system, node);
+        async_release_dependents(async_system, task, thread, canceled);
         system_condition_variable_signal(async_system->join_cv);
         system_mutex_release(async_system->mutex);
     }
 }
 
-function Async_Node*
-async_get_pending_node(Async_System *async_system, Async_Task task){
-    Async_Node *result = 0;
-    if (task != 0){
-        for (Node *node = async_system->task_sent.next;
-             node != &async_system->task_sent;
-             node = node->next){
-            Async_Node *a_node = CastFromMember(Async_Node, node, node);
-            if (a_node->task == task){
-                result = a_node;
-                break;
-            }
-        }
-    }
-    return(result);
-}
-
-function Async_Node*
-async_get_running_node(Async_System *async_system, Async_Task task){
-    Async_Node *result = 0;
-    if (task != 0 && async_system->thread.task == task){
-        result = async_system->thread.node;
-    }
-    return(result);
-}
-
 ////////////////////////////////
 
 function void
@@ -143,19 +326,89 @@ async_task_handler_init(Application_Links *app, Async_System *async_system){
     async_system->mutex = system_mutex_make();
     async_system->cv = system_condition_variable_make();
     async_system->join_cv = system_condition_variable_make();
-    dll_init_sentinel(&async_system->task_sent);
-    async_system->thread.async_system = async_system;
-    async_system->thread.thread = system_thread_launch(async_task_thread, &async_system->thread);
+    async_system->task_id_counter = 1;
+    dll_init_sentinel(&async_system->blocked_sent);
+    
+    // NOTE(allen): Leave a core for the main thread.
+    i32 thread_count = system_thread_get_processor_count() - 1;
+    thread_count = clamp(1, thread_count, async_thread_max);
+    async_system->thread_count = thread_count;
+    for (i32 i = 0; i < thread_count; i += 1){
+        Async_Thread *thread = &async_system->threads[i];
+        thread->async_system = async_system;
+        thread->index = i;
+        thread->join_cv = system_condition_variable_make();
+        thread->queue_mutex = system_mutex_make();
+        for (i32 priority = 0; priority < AsyncPriority_COUNT; priority += 1){
+            dll_init_sentinel(&thread->queue_sent[priority]);
+        }
+    }
+    for (i32 i = 0; i < thread_count; i += 1){
+        Async_Thread *thread = &async_system->threads[i];
+        thread->thread = system_thread_launch(async_task_thread, thread);
+    }
+}
+
+function Async_Task
+async_task_no_dep(Async_System *async_system, Async_Task_Function_Type *func, String_Const_u8 data,
+                  Async_Priority priority){
+    system_mutex_acquire(async_system->mutex);
+    Async_Task result = async_push_node(async_system, func, data, priority, 0);
+    system_mutex_release(async_system->mutex);
+    return(result);
 }
 
 function Async_Task
 async_task_no_dep(Async_System *async_system, Async_Task_Function_Type *func, String_Const_u8 data){
+    return(async_task_no_dep(async_system, func, data, AsyncPriority_Normal));
+}
+
+// NOTE(allen): The new task runs once dependency finishes, or never if dependency
+// gets canceled.  A running task can pass its own task to set up a continuation.
+function Async_Task
+async_task_single_dep(Async_System *async_system, Async_Task dependency, Async_Task_Function_Type *func,
+                      String_Const_u8 data, Async_Priority priority){
     system_mutex_acquire(async_system->mutex);
-    Async_Task result = async_push_node(async_system, func, data);
+    Async_Task result = async_push_node(async_system, func, data, priority, dependency);
     system_mutex_release(async_system->mutex);
     return(result);
 }
 
+function Async_Task
+async_task_single_dep(Async_System *async_system, Async_Task dependency, Async_Task_Function_Type *func,
+                      String_Const_u8 data){
+    return(async_task_single_dep(async_system, dependency, func, data, AsyncPriority_Normal));
+}
+
+// NOTE(allen): Only moves a task that is still waiting for a worker, a running
+// task keeps going at whatever priority it started with.
+function void
+async_task_set_priority(Async_System *async_system, Async_Task task, Async_Priority priority){
+    system_mutex_acquire(async_system->mutex);
+    priority = clamp(AsyncPriority_Low, priority, AsyncPriority_High);
+    Async_Node *node = 0;
+    for (i32 i = 0; i < async_system->thread_count && node == 0; i += 1){
+        Async_Thread *thread = &async_system->threads[i];
+        system_mutex_acquire(thread->queue_mutex);
+        for (i32 p = 0; p < AsyncPriority_COUNT && node == 0; p += 1){
+            node = async_find_in_list(&thread->queue_sent[p], task);
+        }
+        if (node != 0 && node->priority != priority){
+            node->priority = priority;
+            dll_remove(&node->node);
+            dll_insert_back(&thread->queue_sent[priority], &node->node);
+        }
+        system_mutex_release(thread->queue_mutex);
+    }
+    if (node == 0){
+        node = async_find_in_list(&async_system->blocked_sent, task);
+        if (node != 0){
+            node->priority = priority;
+        }
+    }
+    system_mutex_release(async_system->mutex);
+}
+
 function b32
 async_task_is_pending(Async_System *async_system, Async_Task task){
     system_mutex_acquire(async_system->mutex);
@@ -207,18 +460,85 @@ async_task_wait(Application_Links *app, Async_System *async_system, Async_Task t
     system_mutex_release(async_system->mutex);
 }
 
+// NOTE(allen): Waits on task from inside the running task actx.  A task that is
+// still sitting in a queue is taken out and run right here instead, so a task
+// that splits its work up can never end up waiting on pieces that are queued
+// behind it on a busy or single worker system.  The task run here sees the
+// cancel signal of the joining task, and it is the worker's running node until it
+// returns so waits, cancels and dependents treat it like any other running task.
+function void
+async_task_join(Async_Context *actx, Async_System *async_system, Async_Task task){
+    Async_Thread *thread = actx->thread;
+    system_mutex_acquire(async_system->mutex);
+    Async_Node *node = async_take_queued_node(async_system, task);
+    if (node != 0){
+        Async_Node *outer = thread->node;
+        node->thread = thread;
+        node->outer = outer;
+        thread->node = node;
+        atomic_store_release_u64(&thread->task, task);
+        system_mutex_release(async_system->mutex);
+        
+        node->func(actx, node->data);
+        
+        system_mutex_acquire(async_system->mutex);
+        b32 canceled = atomic_read_b32(&thread->cancel_signal);
+        // NOTE(allen): Canceling the joined task must not cancel the tasks that
+        // joined it, so the signal is set back from what was asked of them.
+        b32 outer_canceled = false;
+        for (Async_Node *n = outer; n != 0; n = n->outer){
+            outer_canceled = (outer_canceled || n->canceled);
+        }
+        thread->node = outer;
+        atomic_store_release_u64(&thread->task, outer->task);
+        atomic_write_b32(&thread->cancel_signal, outer_canceled);
+        node->thread = 0;
+        node->outer = 0;
+        async_free_node(async_system, node);
+        async_release_dependents(async_system, task, thread, canceled);
+        system_condition_variable_signal(async_system->join_cv);
+    }
+    else{
+        // NOTE(allen): The thread stays on the node's list until the node is
+        // freed, a wake up while it is still on it goes back to sleep.
+        for (;;){
+            if (thread->join_node == 0){
+                node = async_get_pending_node(async_system, task);
+                if (node == 0){
+                    node = async_get_running_node(async_system, task);
+                }
+                if (node == 0){
+                    break;
+                }
+                thread->join_node = node;
+                thread->next_joiner = node->first_joiner;
+                node->first_joiner = thread;
+            }
+            system_condition_variable_wait(thread->join_cv, async_system->mutex);
+        }
+    }
+    system_mutex_release(async_system->mutex);
+}
+
 function void
 async_task_cancel(Application_Links *app, Async_System *async_system, Async_Task task){
     system_mutex_acquire(async_system->mutex);
-    Async_Node *node = async_get_pending_node(async_system, task);
+    Async_Node *node = async_take_queued_node(async_system, task);
+    if (node == 0){
+        node = async_find_in_list(&async_system->blocked_sent, task);
+        if (node != 0){
+            dll_remove(&node->node);
+        }
+    }
     if (node != 0){
-        dll_remove(&node->node);
-        async_system->task_count -= 1;
         async_free_node(async_system, node);
+        async_release_dependents(async_system, task, 0, true);
+        system_condition_variable_signal(async_system->join_cv);
     }
     else{
         node = async_get_running_node(async_system, task);
         if (node != 0){
+            node->canceled = true;
             b32 *cancel_signal = &node->thread->cancel_signal;
             atomic_write_b32(cancel_signal, true);
             async_task_wait__inner(app, async_system, task);
@@ -10,12 +10,43 @@
 typedef void Async_Task_Function_Type(struct Async_Context *actx, String_Const_u8 data);
 typedef u64 Async_Task;
 
+typedef i32 Async_Priority;
+enum{
+    AsyncPriority_Low,
+    AsyncPriority_Normal,
+    AsyncPriority_High,
+    AsyncPriority_COUNT,
+};
+
+#define async_thread_max 16
+
+// NOTE(allen): Every worker owns a queue per priority behind a lock of its own.
+// New tasks are dealt out to the workers in turn.  A worker takes its newest
+// task from the back of its own queues and, when they are empty, steals the
+// oldest task from the front of another worker's queues, always going through
+// the priorities from high to low.  The system mutex is only needed to push,
+// finish, look up or cancel tasks, and for workers to sleep when every queue is
+// empty.
+//  A task with a dependency waits in the blocked list until the task it depends
+// on finishes, then it goes to the queue of the worker that finished it.  When
+// the dependency is canceled instead, every task waiting on it is canceled too.
+//  A task can join a task it started, the joining worker goes on the node's list
+// of joiners and sleeps on its own join_cv, every joiner on the list gets
+// signaled when the joined node is freed.  A joined task
+// that has not started yet runs on the joining worker instead; while it runs it
+// is the worker's node, and outer points back at the node that joined it.
 struct Async_Thread{
     struct Async_System *async_system;
     System_Thread thread;
     struct Async_Node *node;
-    Async_Task task;
+    volatile Async_Task task;
     b32 cancel_signal;
+    i32 index;
+    System_Condition_Variable join_cv;
+    struct Async_Node *join_node;
+    Async_Thread *next_joiner;
+    System_Mutex queue_mutex;
+    Node queue_sent[AsyncPriority_COUNT];
 };
 
 struct Async_Node{
@@ -25,6 +56,11 @@ struct Async_Node{
     };
     Async_Task task;
     Async_Thread *thread;
+    Async_Thread *first_joiner;
+    Async_Node *outer;
+    b32 canceled;
+    Async_Priority priority;
+    Async_Task dependency;
     Async_Task_Function_Type *func;
     String_Const_u8 data;
 };
@@ -39,10 +75,11 @@ struct Async_System{
     System_Condition_Variable join_cv;
     Async_Task task_id_counter;
     Async_Node *free_nodes;
-    Node task_sent;
-    i32 task_count;
+    Node blocked_sent;
+    i32 next_queue;
     
-    Async_Thread thread;
+    i32 thread_count;
+    Async_Thread threads[async_thread_max];
 };
 
 struct Async_Context{
@@ -61,24 +61,25 @@ set_line_indents(Application_Links *app, Arena *arena, Buffer_ID buffer, Range_i
     }
 }
 
-internal Token*
-find_anchor_token(Application_Links *app, Buffer_ID buffer, Token_Array *tokens, i64 invalid_line){
+internal Token_Iterator_Chunks
+find_anchor_token(Application_Links *app, Buffer_ID buffer, Token_Chunks *tokens, i64 invalid_line){
     ProfileScope(app, "find anchor token");
-    Token *result = 0;
+    Token_Iterator_Chunks result = {};
     
-    if (tokens != 0 && tokens->tokens != 0){
-        result = tokens->tokens;
+    if (tokens != 0 && tokens->count > 0){
+        result = token_iterator(0, tokens);
         i64 invalid_pos = get_line_start_pos(app, buffer, invalid_line);
         i32 scope_counter = 0;
         i32 paren_counter = 0;
-        Token *token = tokens->tokens;
-        for (;;token += 1){
+        Token_Iterator_Chunks it = result;
+        for (;;){
+            Token *token = token_it_read(&it);
             if (token->pos + token->size > invalid_pos){
                 break;
             }
             if (!HasFlag(token->flags,  TokenBaseFlag_PreprocessorBody)){
                 if (scope_counter == 0 && paren_counter == 0){
-                    result = token;
+                    result = it;
                 }
                 switch (token->kind){
                     case TokenBaseKind_ScopeOpen:
@@ -104,6 +105,9 @@ find_anchor_token(Application_Links *app, Buffer_ID buffer, Token_Array *tokens,
                     }break;
                 }
             }
+            if (!token_it_inc_all(&it)){
+                break;
+            }
         }
     }
     
@@ -171,19 +175,15 @@ get_indentation_array(Application_Links *app, Arena *arena, Buffer_ID buffer, Ra
     Token_Array *tokens = scope_attachment(app, scope, attachment_tokens, Token_Array);
 #endif
     
-    Token_Array token_array = get_token_array_from_buffer(app, buffer);
-    Token_Array *tokens = &token_array;
+    Token_Chunks *tokens = get_token_chunks_from_buffer(app, buffer);
     
     i64 anchor_line = clamp_bot(1, lines.first - 1);
-    Token *anchor_token = find_anchor_token(app, buffer, tokens, anchor_line);
-    if (anchor_token != 0 &&
-        anchor_token >= tokens->tokens &&
-        anchor_token < tokens->tokens + tokens->count){
+    Token_Iterator_Chunks token_it = find_anchor_token(app, buffer, tokens, anchor_line);
+    Token *anchor_token = token_it_read(&token_it);
+    if (anchor_token != 0){
         i64 line = get_line_number_from_pos(app, buffer, anchor_token->pos);
         line = clamp_top(line, lines.first);
         
-        Token_Iterator_Array token_it = token_iterator(0, tokens, anchor_token);
-        
         Scratch_Block scratch(app, arena);
         Nest *nest = 0;
         Nest_Alloc nest_alloc = {};
@@ -354,11 +354,10 @@ actual_indent = N; )
 internal b32
 auto_indent_buffer(Application_Links *app, Buffer_ID buffer, Range_i64 pos, Indent_Flag flags, i32 tab_width, i32 indent_width){
     ProfileScope(app, "auto indent buffer");
-    Token_Array token_array = get_token_array_from_buffer(app, buffer);
-    Token_Array *tokens = &token_array;
+    Token_Chunks *tokens = get_token_chunks_from_buffer(app, buffer);
     
     b32 result = false;
-    if (tokens->tokens != 0){
+    if (tokens != 0){
         result = true;
         
         Scratch_Block scratch(app);
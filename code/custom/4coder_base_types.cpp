@@ -146,6 +146,76 @@ round_up_pot_u32(u32 x){
     return(x);
 }
 
+// NOTE(allen): x must not be zero
+function u32
+bit_scan_forward_u32(u32 x){
+#if COMPILER_CL
+    unsigned long index = 0;
+    _BitScanForward(&index, x);
+    return((u32)index);
+#else
+    return((u32)__builtin_ctz(x));
+#endif
+}
+
+// NOTE(allen): x must not be zero
+function u32
+bit_scan_reverse_u32(u32 x){
+#if COMPILER_CL
+    unsigned long index = 0;
+    _BitScanReverse(&index, x);
+    return((u32)index);
+#else
+    return((u32)(31 - __builtin_clz(x)));
+#endif
+}
+
+// NOTE(allen): For handing memory from one thread to another without a lock.
+// Every write made before a store_release is seen by a thread that reads the
+// stored value with a load_acquire.  x86 and x64 already keep that order in the
+// hardware, on those cl only has to be kept from moving things around.
+function u32
+atomic_load_acquire_u32(volatile u32 *ptr){
+#if COMPILER_CL
+    u32 result = *ptr;
+    _ReadWriteBarrier();
+    return(result);
+#else
+    return(__atomic_load_n(ptr, __ATOMIC_ACQUIRE));
+#endif
+}
+
+function void
+atomic_store_release_u32(volatile u32 *ptr, u32 value){
+#if COMPILER_CL
+    _ReadWriteBarrier();
+    *ptr = value;
+#else
+    __atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+#endif
+}
+
+function u64
+atomic_load_acquire_u64(volatile u64 *ptr){
+#if COMPILER_CL
+    u64 result = *ptr;
+    _ReadWriteBarrier();
+    return(result);
+#else
+    return(__atomic_load_n(ptr, __ATOMIC_ACQUIRE));
+#endif
+}
+
+function void
+atomic_store_release_u64(volatile u64 *ptr, u64 value){
+#if COMPILER_CL
+    _ReadWriteBarrier();
+    *ptr = value;
+#else
+    __atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+#endif
+}
+
 ////////////////////////////////
 
 function String_Const_u8
@@ -335,6 +405,11 @@ function f32
 cos_f32(f32 x){
     return(cosf(x));
 }
+
+function f32
+sqrt_f32(f32 x){
+    return(sqrtf(x));
+}
 #endif
 
 ////////////////////////////////
@@ -3449,24 +3524,24 @@ Temp_Memory_Block::restore(void){
 #if defined(DO_HEAP_CHECKS)
 function void
 heap_assert_good(Heap *heap){
-    if (heap->in_order.next != 0){
-        Assert(heap->in_order.prev != 0);
-        Assert(heap->free_nodes.next != 0);
-        Assert(heap->free_nodes.prev != 0);
-        for (Heap_Basic_Node *node = &heap->in_order;;){
+    if (heap->arena != 0){
+        for (Heap_Basic_Node *node = &heap->large_nodes;;){
             Assert(node->next->prev == node);
             Assert(node->prev->next == node);
             node = node->next;
-            if (node == &heap->in_order){
+            if (node == &heap->large_nodes){
                 break;
             }
+            Heap_Large_Node *large = CastFromMember(Heap_Large_Node, node, node);
+            Assert(large->block.flags == HeapBlockFlag_Large);
         }
-        for (Heap_Basic_Node *node = &heap->free_nodes;;){
-            Assert(node->next->prev == node);
-            Assert(node->prev->next == node);
-            node = node->next;
-            if (node == &heap->free_nodes){
-                break;
+        for (u32 i = 0; i < heap_class_count; i += 1){
+            for (Heap_Free_Block *free_block = heap->free_blocks[i];
+                 free_block != 0;
+                 free_block = free_block->next){
+                Heap_Block *block = ((Heap_Block*)free_block) - 1;
+                Assert(block->flags == HeapBlockFlag_Free);
+                Assert(block->class_index == i);
             }
         }
     }
@@ -3477,21 +3552,19 @@ heap_assert_good(Heap *heap){
 
 function void
 heap_init(Heap *heap, Base_Allocator *allocator){
+    block_zero_struct(heap);
     heap->arena_ = make_arena(allocator);
     heap->arena = &heap->arena_;
-    heap__sent_init(&heap->in_order);
-    heap__sent_init(&heap->free_nodes);
-    heap->used_space = 0;
-    heap->total_space = 0;
+    heap__sent_init(&heap->large_nodes);
 }
 
+// NOTE(allen): Blocks over heap_large_size come from the arena's base allocator,
+// not the arena, so whoever clears the arena calls heap_free_all first.
 function void
 heap_init(Heap *heap, Arena *arena){
+    block_zero_struct(heap);
     heap->arena = arena;
-    heap__sent_init(&heap->in_order);
-    heap__sent_init(&heap->free_nodes);
-    heap->used_space = 0;
-    heap->total_space = 0;
+    heap__sent_init(&heap->large_nodes);
 }
 
 function Base_Allocator*
@@ -3501,117 +3574,219 @@ heap_get_base_allocator(Heap *heap){
 
 function void
 heap_free_all(Heap *heap){
-    if (heap->arena == &heap->arena_){
-        linalloc_clear(heap->arena);
+    if (heap->arena != 0){
+        Base_Allocator *allocator = heap->arena->base_allocator;
+        for (Heap_Basic_Node *node = heap->large_nodes.next, *next = 0;
+             node != &heap->large_nodes;
+             node = next){
+            next = node->next;
+            base_free(allocator, node);
+        }
+        if (heap->arena == &heap->arena_){
+            linalloc_clear(heap->arena);
+        }
     }
     block_zero_struct(heap);
 }
 
-function void
-heap__extend(Heap *heap, void *memory, u64 size){
-    heap_assert_good(heap);
-    if (size >= sizeof(Heap_Node)){
-        Heap_Node *new_node = (Heap_Node*)memory;
-        heap__insert_prev(&heap->in_order, &new_node->order);
-        heap__insert_next(&heap->free_nodes, &new_node->alloc);
-        new_node->size = size - sizeof(*new_node);
-        heap->total_space += size;
+function u32
+heap__class_index(u64 size){
+    u32 result = 0;
+    if (size > 128){
+        u32 x = (u32)(size - 1);
+        u32 p = bit_scan_reverse_u32(x);
+        result = 8 + (p - 7)*4 + ((x >> (p - 2))&3);
+    }
+    else if (size > 0){
+        result = (u32)((size - 1)/16);
+    }
+    return(result);
+}
+
+function u64
+heap__class_size(u32 class_index){
+    u64 result = 0;
+    if (class_index < 8){
+        result = (class_index + 1)*16;
     }
-    heap_assert_good(heap);
+    else{
+        u32 p = 7 + (class_index - 8)/4;
+        result = (1llu << p) + (((class_index - 8)%4 + 1llu) << (p - 2));
+    }
+    return(result);
 }
 
 function void
-heap__extend_automatic(Heap *heap, u64 size){
-    void *memory = push_array(heap->arena, u8, size);
-    heap__extend(heap, memory, size);
+heap__push_free(Heap *heap, Heap_Block *block){
+    block->flags = HeapBlockFlag_Free;
+    Heap_Free_Block *free_block = (Heap_Free_Block*)(block + 1);
+    free_block->next = heap->free_blocks[block->class_index];
+    heap->free_blocks[block->class_index] = free_block;
 }
 
-function void*
-heap__reserve_chunk(Heap *heap, Heap_Node *node, u64 size){
-    u8 *ptr = (u8*)(node + 1);
-    Assert(node->size >= size);
-    u64 left_over_size = node->size - size;
-    if (left_over_size > sizeof(*node)){
-        u64 new_node_size = left_over_size - sizeof(*node);
-        Heap_Node *new_node = (Heap_Node*)(ptr + size);
-        heap__insert_next(&node->order, &new_node->order);
-        heap__insert_next(&node->alloc, &new_node->alloc);
-        new_node->size = new_node_size;
-    }
-    heap__remove(&node->alloc);
-    node->alloc.next = 0;
-    node->alloc.prev = 0;
-    node->size = size;
-    heap->used_space += sizeof(*node) + size;
-    return(ptr);
+function Heap_Block*
+heap__cut_block(Heap_Chunk *chunk, u32 class_index){
+    Heap_Block *block = (Heap_Block*)((u8*)(chunk + 1) + chunk->pos);
+    chunk->pos += sizeof(*block) + heap__class_size(class_index);
+    block->size = 0;
+    block->class_index = class_index;
+    block->flags = 0;
+    return(block);
 }
 
-function void*
-heap_allocate(Heap *heap, u64 size){
-    b32 first_try = true;
+// NOTE(allen): Whatever is left at the end of a chunk is cut into the biggest
+// blocks that still fit and handed to the free lists instead of being dropped.
+function void
+heap__retire_chunk(Heap *heap, Heap_Chunk *chunk){
     for (;;){
-        if (heap->in_order.next != 0){
-            heap_assert_good(heap);
-            u64 aligned_size = (size + sizeof(Heap_Node) - 1);
-            aligned_size = aligned_size - (aligned_size%sizeof(Heap_Node));
-            for (Heap_Basic_Node *n = heap->free_nodes.next;
-                 n != &heap->free_nodes;
-                 n = n->next){
-                Heap_Node *node = CastFromMember(Heap_Node, alloc, n);
-                if (node->size >= aligned_size){
-                    void *ptr = heap__reserve_chunk(heap, node, aligned_size);
-                    heap_assert_good(heap);
-                    return(ptr);
-                }
-            }
-            heap_assert_good(heap);
+        u64 left_over = chunk->cap - chunk->pos;
+        if (left_over < sizeof(Heap_Block) + heap__class_size(0)){
+            break;
         }
-        
-        if (first_try){
-            u64 extension_size = clamp_bot(KB(64), size*2);
-            heap__extend_automatic(heap, extension_size);
-            first_try = false;
+        u64 size = clamp_top(left_over - sizeof(Heap_Block), heap_large_size);
+        u32 class_index = heap__class_index(size);
+        if (heap__class_size(class_index) > size){
+            class_index -= 1;
         }
-        else{
-            break;
+        heap__push_free(heap, heap__cut_block(chunk, class_index));
+    }
+}
+
+function Heap_Block*
+heap__new_block(Heap *heap, u32 class_index){
+    u64 block_size = sizeof(Heap_Block) + heap__class_size(class_index);
+    Heap_Chunk *chunk = heap->chunks;
+    if (chunk == 0 || chunk->cap - chunk->pos < block_size){
+        if (chunk != 0){
+            heap__retire_chunk(heap, chunk);
         }
+        u64 cap = KB(64);
+        u64 size = sizeof(Heap_Chunk) + cap + 15;
+        u8 *memory = push_array(heap->arena, u8, size);
+        chunk = (Heap_Chunk*)round_up_u64(PtrAsInt(memory), 16);
+        chunk->next = heap->chunks;
+        chunk->pos = 0;
+        chunk->cap = cap;
+        heap->chunks = chunk;
+        heap->total_space += size;
     }
-    return(0);
+    return(heap__cut_block(chunk, class_index));
 }
 
-function void
-heap__merge(Heap *heap, Heap_Node *l, Heap_Node *r){
-    if (&l->order != &heap->in_order && &r->order != &heap->in_order &&
-        l->alloc.next != 0 && l->alloc.prev != 0 &&
-        r->alloc.next != 0 && r->alloc.prev != 0){
-        u8 *ptr = (u8*)(l + 1) + l->size;
-        if (PtrDif(ptr, r) == 0){
-            heap__remove(&r->order);
-            heap__remove(&r->alloc);
-            heap__remove(&l->alloc);
-            l->size += r->size + sizeof(*r);
-            heap__insert_next(&heap->free_nodes, &l->alloc);
+function void*
+heap_allocate(Heap *heap, u64 size){
+    void *result = 0;
+    if (heap->arena != 0){
+        heap_assert_good(heap);
+        if (size <= heap_large_size){
+            u32 class_index = heap__class_index(size);
+            Heap_Block *block = 0;
+            Heap_Free_Block *free_block = heap->free_blocks[class_index];
+            if (free_block != 0){
+                heap->free_blocks[class_index] = free_block->next;
+                block = ((Heap_Block*)free_block) - 1;
+            }
+            else{
+                block = heap__new_block(heap, class_index);
+            }
+            block->size = size;
+            block->flags = 0;
+            heap->used_space += sizeof(*block) + heap__class_size(class_index);
+            result = block + 1;
+        }
+        else{
+            Base_Allocator *allocator = heap->arena->base_allocator;
+            u64 full_size = sizeof(Heap_Large_Node) + size;
+            Heap_Large_Node *node = (Heap_Large_Node*)base_allocate__inner(allocator, full_size, file_name_line_number_lit_u8).str;
+            if (node != 0){
+                heap__insert_prev(&heap->large_nodes, &node->node);
+                node->block.size = size;
+                node->block.class_index = heap_class_count;
+                node->block.flags = HeapBlockFlag_Large;
+                heap->used_space += full_size;
+                heap->total_space += full_size;
+                result = &node->block + 1;
+            }
         }
+        heap_assert_good(heap);
     }
+    return(result);
 }
 
 function void
 heap_free(Heap *heap, void *memory){
-    if (heap->in_order.next != 0 && memory != 0){
-        Heap_Node *node = ((Heap_Node*)memory) - 1;
-        Assert(node->alloc.next == 0);
-        Assert(node->alloc.prev == 0);
-        heap->used_space -= sizeof(*node) + node->size;
-        heap_assert_good(heap);
-        heap__insert_next(&heap->free_nodes, &node->alloc);
+    if (heap->arena != 0 && memory != 0){
         heap_assert_good(heap);
-        heap__merge(heap, node, CastFromMember(Heap_Node, order, node->order.next));
-        heap_assert_good(heap);
-        heap__merge(heap, CastFromMember(Heap_Node, order, node->order.prev), node);
+        Heap_Block *block = ((Heap_Block*)memory) - 1;
+        Assert(!HasFlag(block->flags, HeapBlockFlag_Free));
+        if (HasFlag(block->flags, HeapBlockFlag_Large)){
+            Heap_Large_Node *node = CastFromMember(Heap_Large_Node, block, block);
+            u64 full_size = sizeof(*node) + block->size;
+            heap__remove(&node->node);
+            heap->used_space -= full_size;
+            heap->total_space -= full_size;
+            base_free(heap->arena->base_allocator, node);
+        }
+        else{
+            Assert(block->class_index < heap_class_count);
+            heap->used_space -= sizeof(*block) + heap__class_size(block->class_index);
+            heap__push_free(heap, block);
+        }
         heap_assert_good(heap);
     }
 }
 
+function Heap_Stats
+heap_get_stats(Heap *heap){
+    Heap_Stats stats = {};
+    for (u32 i = 0; i < heap_class_count; i += 1){
+        stats.classes[i].block_size = heap__class_size(i);
+    }
+    if (heap->arena != 0){
+        for (Heap_Chunk *chunk = heap->chunks;
+             chunk != 0;
+             chunk = chunk->next){
+            u8 *ptr = (u8*)(chunk + 1);
+            u8 *end = ptr + chunk->pos;
+            for (;ptr < end;){
+                Heap_Block *block = (Heap_Block*)ptr;
+                Heap_Class_Stats *class_stats = &stats.classes[block->class_index];
+                u64 block_size = sizeof(*block) + class_stats->block_size;
+                if (HasFlag(block->flags, HeapBlockFlag_Free)){
+                    class_stats->free_count += 1;
+                    stats.free_space += block_size;
+                }
+                else{
+                    class_stats->used_count += 1;
+                    class_stats->requested_space += block->size;
+                    stats.used_space += block_size;
+                    stats.requested_space += block->size;
+                }
+                ptr += block_size;
+            }
+        }
+        for (Heap_Basic_Node *node = heap->large_nodes.next;
+             node != &heap->large_nodes;
+             node = node->next){
+            Heap_Large_Node *large = CastFromMember(Heap_Large_Node, node, node);
+            stats.large_count += 1;
+            stats.large_space += sizeof(*large) + large->block.size;
+            stats.requested_space += large->block.size;
+        }
+        stats.used_space += stats.large_space;
+        stats.total_space = heap->total_space;
+        stats.unused_space = stats.total_space - stats.used_space - stats.free_space;
+        if (stats.used_space > 0){
+            stats.internal_fragmentation = 1.f - (f32)stats.requested_space/(f32)stats.used_space;
+        }
+        u64 block_space = stats.used_space - stats.large_space + stats.free_space;
+        if (block_space > 0){
+            stats.external_fragmentation = (f32)stats.free_space/(f32)block_space;
+        }
+    }
+    return(stats);
+}
+
 #define heap_array(heap, T, c) (T*)(heap_allocate((heap), sizeof(T)*(c)))
 
 ////////////////////////////////
@@ -166,6 +166,27 @@
 # error no name for this architecture
 #endif
 
+// simd
+
+#if ARCH_X64 || ARCH_X86
+# define ARCH_SSE2 1
+# if COMPILER_CL
+#  include <intrin.h>
+# else
+#  include <immintrin.h>
+# endif
+#endif
+
+#if !defined(ARCH_SSE2)
+# define ARCH_SSE2 0
+#endif
+
+#if ARCH_SSE2 && defined(__AVX2__)
+# define ARCH_AVX2 1
+#else
+# define ARCH_AVX2 0
+#endif
+
 ////////////////////////////////
 
 #if COMPILER_CL
@@ -1398,6 +1419,8 @@ struct Thread_Context{
   Profile_Record *prof_first;
   Profile_Record *prof_last;
   i32 prof_record_count;
+  // NOTE(allen): Zero means the records belong to the id of the OS thread.
+  i32 prof_thread_id;
   
   void *user_data;
 };
@@ -1435,26 +1458,75 @@ struct Heap_Basic_Node{
   Heap_Basic_Node *prev;
 };
 
-struct Heap_Node{
-  union{
-    struct{
-      Heap_Basic_Node order;
-      Heap_Basic_Node alloc;
-      u64 size;
-    };
-    u8 force_size__[64];
-  };
+// NOTE(allen): Requests up to heap_large_size are rounded up to one of
+// heap_class_count block sizes, 16 byte steps up to 128 and then four steps
+// per power of two.  Each size has its own free list, so allocating and
+// freeing never search.  Bigger requests go straight to the base allocator.
+#define heap_class_count 40
+#define heap_large_size KB(32)
+
+typedef u32 Heap_Block_Flag;
+enum{
+  HeapBlockFlag_Free = 1,
+  HeapBlockFlag_Large = 2,
+};
+
+struct Heap_Block{
+  u64 size;
+  u32 class_index;
+  Heap_Block_Flag flags;
+};
+
+struct Heap_Free_Block{
+  Heap_Free_Block *next;
+};
+
+struct Heap_Chunk{
+  Heap_Chunk *next;
+  u64 pos;
+  u64 cap;
+  u64 unused__;
+};
+
+struct Heap_Large_Node{
+  Heap_Basic_Node node;
+  Heap_Block block;
 };
 
 struct Heap{
   Arena arena_;
   Arena *arena;
-  Heap_Basic_Node in_order;
-  Heap_Basic_Node free_nodes;
+  Heap_Free_Block *free_blocks[heap_class_count];
+  Heap_Chunk *chunks;
+  Heap_Basic_Node large_nodes;
   u64 used_space;
   u64 total_space;
 };
 
+struct Heap_Class_Stats{
+  u64 block_size;
+  u64 used_count;
+  u64 free_count;
+  u64 requested_space;
+};
+
+struct Heap_Stats{
+  // NOTE(allen): total_space = used_space + free_space + unused_space, where
+  // unused_space is memory taken from the arena that is not cut into blocks yet.
+  u64 total_space;
+  u64 used_space;
+  u64 free_space;
+  u64 unused_space;
+  u64 requested_space;
+  u64 large_count;
+  u64 large_space;
+  // NOTE(allen): Rounding and headers as a share of used_space, and free blocks
+  // as a share of the space set aside for blocks.
+  f32 internal_fragmentation;
+  f32 external_fragmentation;
+  Heap_Class_Stats classes[heap_class_count];
+};
+
 #endif
 
 // BOTTOM
@@ -37,25 +37,39 @@ code_index_get_nest(Code_Index_File *file, i64 pos){
 return(code_index_get_nest_(&file->nest_array, pos));
 }
 
+function u64
+code_index__hash_name(String_Const_u8 string){
+return(table_hash_u8(string.str, string.size));
+}
+
+function Code_Index_Name_Shard*
+code_index__shard_from_hash(u64 hash){
+return(&global_code_index.name_shards[hash % code_index_shard_count]);
+}
+
 function Code_Index_Note_List*
-code_index__list_from_string(String_Const_u8 string){
-u64 hash = table_hash_u8(string.str, string.size);
-Code_Index_Note_List *result = &global_code_index.name_hash[hash % ArrayCount(global_code_index.name_hash)];
-return(result);
+code_index__slot_from_hash(Code_Index_Name_Shard *shard, u64 hash){
+return(&shard->slots[(hash/code_index_shard_count) & (shard->slot_count - 1)]);
 }
 
+// NOTE(allen): The returned note belongs to its file, the caller has to hold
+// code_index_lock for as long as it uses the note.
 function Code_Index_Note*
 code_index_note_from_string(String_Const_u8 string){
-Code_Index_Note_List *list = code_index__list_from_string(string);
+u64 hash = code_index__hash_name(string);
+Code_Index_Name_Shard *shard = code_index__shard_from_hash(hash);
 Code_Index_Note *result = 0;
+system_mutex_acquire(shard->mutex);
+Code_Index_Note_List *list = code_index__slot_from_hash(shard, hash);
 for (Code_Index_Note *node = list->first;
      node != 0;
      node = node->next_in_hash){
-if (string_match(string, node->text)){
+if (node->hash == hash && string_match(string, node->text)){
 result = node;
 break;
 }
 }
+system_mutex_release(shard->mutex);
 return(result);
 }
 
@@ -68,6 +82,14 @@ code_index_init(void){
 global_code_index.mutex = system_mutex_make();
 global_code_index.node_arena = make_arena_system(KB(4));
 global_code_index.buffer_to_index_file = make_table_u64_u64(global_code_index.node_arena.base_allocator, 500);
+Base_Allocator *allocator = global_code_index.node_arena.base_allocator;
+for (i32 i = 0; i < code_index_shard_count; i += 1){
+Code_Index_Name_Shard *shard = &global_code_index.name_shards[i];
+shard->mutex = system_mutex_make();
+shard->slot_count = code_index_shard_initial_slot_count;
+shard->slots = base_array(allocator, Code_Index_Note_List, shard->slot_count);
+block_zero_dynamic_array(shard->slots, shard->slot_count);
+}
 }
 
 function Code_Index_File_Storage*
@@ -138,62 +160,117 @@ system_mutex_release(global_code_index.mutex);
 }
 
 function void
-code_index__hash_file(Code_Index_File *file){
-for (Code_Index_Note *node = file->note_list.first;
+code_index__shard_grow(Code_Index_Name_Shard *shard){
+Base_Allocator *allocator = global_code_index.node_arena.base_allocator;
+Code_Index_Note_List *old_slots = shard->slots;
+u64 old_count = shard->slot_count;
+shard->slot_count = old_count*2;
+shard->slots = base_array(allocator, Code_Index_Note_List, shard->slot_count);
+block_zero_dynamic_array(shard->slots, shard->slot_count);
+for (u64 i = 0; i < old_count; i += 1){
+for (Code_Index_Note *node = old_slots[i].first, *next = 0;
      node != 0;
-     node = node->next){
-Code_Index_Note_List *list = code_index__list_from_string(node->text);
+     node = next){
+next = node->next_in_hash;
+Code_Index_Note_List *list = code_index__slot_from_hash(shard, node->hash);
 zdll_push_back_NP_(list->first, list->last, node, next_in_hash, prev_in_hash);
 list->count += 1;
 }
 }
+base_free(allocator, old_slots);
+}
 
 function void
-code_index__clear_file(Code_Index_File *file){
-for (Code_Index_Note *node = file->note_list.first;
+code_index__hash_names(Code_Index_Note *first){
+for (Code_Index_Note *node = first;
      node != 0;
      node = node->next){
-Code_Index_Note_List *list = code_index__list_from_string(node->text);
+node->hash = code_index__hash_name(node->text);
+}
+}
+
+// NOTE(allen): Takes the first old_count notes from old_first out of the name
+// shards and puts the first new_count notes from new_first in, in one pass per
+// shard with both done under that shard's lock, so a lookup by name never sees a
+// name from both lists or from neither.  The new notes already have their hash.
+function void
+code_index__replace_notes(Code_Index_Note *old_first, i64 old_count,
+                          Code_Index_Note *new_first, i64 new_count){
+for (i32 i = 0; i < code_index_shard_count; i += 1){
+Code_Index_Name_Shard *shard = &global_code_index.name_shards[i];
+system_mutex_acquire(shard->mutex);
+Code_Index_Note *node = old_first;
+for (i64 j = 0; j < old_count; j += 1, node = node->next){
+if (node->hash % code_index_shard_count == (u64)i){
+Code_Index_Note_List *list = code_index__slot_from_hash(shard, node->hash);
 zdll_remove_NP_(list->first, list->last, node, next_in_hash, prev_in_hash);
 list->count -= 1;
+shard->note_count -= 1;
+}
+}
+node = new_first;
+for (i64 j = 0; j < new_count; j += 1, node = node->next){
+if (node->hash % code_index_shard_count == (u64)i){
+if (shard->note_count >= shard->slot_count){
+code_index__shard_grow(shard);
+}
+Code_Index_Note_List *list = code_index__slot_from_hash(shard, node->hash);
+zdll_push_back_NP_(list->first, list->last, node, next_in_hash, prev_in_hash);
+list->count += 1;
+shard->note_count += 1;
+}
+}
+system_mutex_release(shard->mutex);
 }
 }
 
+// NOTE(allen): Takes the index locks itself.  The names of the new notes are
+// hashed before code_index_lock is taken; the old notes come out of the name
+// shards as the new ones go in.
 function void
 code_index_set_file(Buffer_ID buffer, Arena arena, Code_Index_File *index){
+code_index__hash_names(index->note_list.first);
+
+code_index_lock();
 Code_Index_File_Storage *storage = 0;
 Table_Lookup lookup = table_lookup(&global_code_index.buffer_to_index_file, buffer);
 if (lookup.found_match){
 u64 val = 0;
 table_read(&global_code_index.buffer_to_index_file, lookup, &val);
 storage = (Code_Index_File_Storage*)IntAsPtr(val);
-code_index__clear_file(storage->file);
+Code_Index_Note_List *old_list = &storage->file->note_list;
+code_index__replace_notes(old_list->first, old_list->count,
+                          index->note_list.first, index->note_list.count);
 linalloc_clear(&storage->arena);
 }
 else{
 storage = code_index__alloc_storage();
 table_insert(&global_code_index.buffer_to_index_file, buffer, (u64)PtrAsInt(storage));
+code_index__replace_notes(0, 0, index->note_list.first, index->note_list.count);
 }
 storage->arena = arena;
 storage->file = index;
-
-code_index__hash_file(index);
+storage->reparse_size = 0;
+code_index_unlock();
 }
 
 function void
 code_index_erase_file(Buffer_ID buffer){
+code_index_lock();
 Table_Lookup lookup = table_lookup(&global_code_index.buffer_to_index_file, buffer);
 if (lookup.found_match){
 u64 val = 0;
 table_read(&global_code_index.buffer_to_index_file, lookup, &val);
 Code_Index_File_Storage *storage = (Code_Index_File_Storage*)IntAsPtr(val);
 
-code_index__clear_file(storage->file);
+Code_Index_Note_List *old_list = &storage->file->note_list;
+code_index__replace_notes(old_list->first, old_list->count, 0, 0);
 
 linalloc_clear(&storage->arena);
 table_erase(&global_code_index.buffer_to_index_file, lookup);
 code_index__free_storage(storage);
 }
+code_index_unlock();
 }
 
 function Code_Index_File*
@@ -240,6 +317,12 @@ code_index_shift(&nest->nest_array, old_range, new_size);
 function void
 code_index_shift(Code_Index_File *file, Range_i64 old_range, u64 new_size){
 code_index_shift(&file->nest_array, old_range, new_size);
+for (Code_Index_Note *note = file->note_list.first;
+     note != 0;
+     note = note->next){
+index_shift(&note->pos.min, old_range, new_size);
+index_shift(&note->pos.max, old_range, new_size);
+}
 }
 
 
@@ -825,28 +908,203 @@ generic_parse_init(Application_Links *app, Arena *arena, String_Const_u8 content
 generic_parse_init(app, arena, contents, tokens, default_comment_index, state);
 }
 
+function void
+code_index__set_nest_file(Code_Index_Nest *nest, Code_Index_File *file){
+nest->file = file;
+for (Code_Index_Nest *node = nest->nest_list.first;
+     node != 0;
+     node = node->next){
+code_index__set_nest_file(node, file);
+}
+}
+
+// NOTE(allen): Reparses the top level scope or preprocessor nest around dirty in
+// place, nothing outside of it can depend on what is inside as long as it still
+// closes on the same token.  The new nest takes the old one's place, the
+// preprocessor nests and notes inside the old one are swapped for the new ones,
+// and the rest of the file is left as the edits shifted it.  Returns false when
+// the edit does not sit inside such a nest or moved its close, or when the old
+// nests and notes left in the arena add up to more than the file, the caller
+// does a full parse then.  Only the tokens of the nest are copied out of the
+// chunks; a parse that runs off the end of them did not close where the old nest
+// did either.
+function b32
+code_index_reparse_nest(Application_Links *app, Buffer_ID buffer, String_Const_u8 contents,
+                        Token_Chunks *tokens, Range_i64 dirty){
+ProfileScope(app, "reparse nest");
+Scratch_Block scratch(app);
+b32 result = false;
+code_index_lock();
+Table_Lookup lookup = table_lookup(&global_code_index.buffer_to_index_file, buffer);
+if (lookup.found_match){
+u64 val = 0;
+table_read(&global_code_index.buffer_to_index_file, lookup, &val);
+Code_Index_File_Storage *storage = (Code_Index_File_Storage*)IntAsPtr(val);
+Code_Index_File *file = storage->file;
+
+// NOTE(allen): Preprocessor nests inside of scopes are also in the file's list,
+// the outermost nest around the edit is the one to reparse.
+Code_Index_Nest *nest = 0;
+for (i32 i = 0; i < file->nest_array.count; i += 1){
+Code_Index_Nest *candidate = file->nest_array.ptrs[i];
+if ((candidate->kind == CodeIndexNest_Scope ||
+     candidate->kind == CodeIndexNest_Preprocessor) &&
+    candidate->is_closed &&
+    candidate->open.min < dirty.min && candidate->open.max <= dirty.min &&
+    dirty.max <= candidate->close.min){
+if (nest == 0 || candidate->open.min < nest->open.min){
+nest = candidate;
+}
+}
+}
+
+Range_i64 range = {};
+Token_Array range_tokens = {};
+Token *token = 0;
+if (nest != 0){
+range = Ii64(nest->open.min, nest->close.max);
+if (storage->reparse_size + range_size(range) <= contents.size){
+range_tokens = token_array_from_chunks_range(scratch, tokens, range);
+token = range_tokens.tokens;
+}
+}
+
+Token_Base_Kind open_kind = (nest != 0 && nest->kind == CodeIndexNest_Scope)?
+TokenBaseKind_ScopeOpen:TokenBaseKind_Preprocessor;
+if (token != 0 && token->pos == range.min && token->kind == open_kind){
+Arena *arena = &storage->arena;
+Code_Index_File sub = {};
+sub.buffer = buffer;
+
+Generic_Parse_State state = {};
+generic_parse_init(app, arena, contents, &range_tokens, &state);
+state.do_cpp_parse = true;
+for (i64 i = range.min; i > 0; i -= 1){
+if (contents.str[i - 1] == '\n'){
+state.prev_line_start = contents.str + i;
+break;
+}
+}
+
+Code_Index_Nest *new_nest = 0;
+if (nest->kind == CodeIndexNest_Scope){
+new_nest = generic_parse_scope(&sub, &state);
+}
+else{
+new_nest = generic_parse_preprocessor(&sub, &state);
+}
+
+if (new_nest->is_closed &&
+    new_nest->close.min == nest->close.min &&
+    new_nest->close.max == nest->close.max){
+result = true;
+storage->reparse_size += range_size(range);
+
+code_index__set_nest_file(new_nest, file);
+for (Code_Index_Nest *node = sub.nest_list.first;
+     node != 0;
+     node = node->next){
+code_index__set_nest_file(node, file);
+}
+
+Code_Index_Nest_List nest_list = {};
+for (Code_Index_Nest *node = file->nest_list.first, *next = 0;
+     node != 0;
+     node = next){
+next = node->next;
+if (node == nest){
+for (Code_Index_Nest *sub_node = sub.nest_list.first, *sub_next = 0;
+     sub_node != 0;
+     sub_node = sub_next){
+sub_next = sub_node->next;
+code_index_push_nest(&nest_list, sub_node);
+}
+code_index_push_nest(&nest_list, new_nest);
+}
+else if (!range_contains(range, node->open.min)){
+code_index_push_nest(&nest_list, node);
+}
+}
+file->nest_list = nest_list;
+file->nest_array = code_index_nest_ptr_array_from_list(arena, &file->nest_list);
+
+for (Code_Index_Note *note = sub.note_list.first;
+     note != 0;
+     note = note->next){
+note->file = file;
+}
+code_index__hash_names(sub.note_list.first);
+
+Code_Index_Note_List note_list = {};
+Code_Index_Note_List removed = {};
+b32 inserted = false;
+for (Code_Index_Note *note = file->note_list.first, *next = 0;
+     note != 0;
+     note = next){
+next = note->next;
+if (range_contains(range, note->pos.min)){
+sll_queue_push(removed.first, removed.last, note);
+removed.count += 1;
+}
+else{
+if (!inserted && note->pos.min >= range.min){
+inserted = true;
+for (Code_Index_Note *sub_note = sub.note_list.first, *sub_next = 0;
+     sub_note != 0;
+     sub_note = sub_next){
+sub_next = sub_note->next;
+sll_queue_push(note_list.first, note_list.last, sub_note);
+note_list.count += 1;
+}
+}
+sll_queue_push(note_list.first, note_list.last, note);
+note_list.count += 1;
+}
+}
+if (!inserted){
+for (Code_Index_Note *sub_note = sub.note_list.first, *sub_next = 0;
+     sub_note != 0;
+     sub_note = sub_next){
+sub_next = sub_note->next;
+sll_queue_push(note_list.first, note_list.last, sub_note);
+note_list.count += 1;
+}
+}
+// NOTE(allen): The new notes sit together in the list, starting at the
+// first one of sub.
+code_index__replace_notes(removed.first, removed.count,
+                          sub.note_list.first, sub.note_list.count);
+file->note_list = note_list;
+file->note_array = code_index_note_ptr_array_from_list(arena, &file->note_list);
+}
+}
+}
+code_index_unlock();
+return(result);
+}
+
 
 ////////////////////////////////
 // NOTE(allen): Virtual Whitespace Layout
 
 function Token_Pair
-layout_token_pair(Token_Array *tokens, i64 pos){
+layout_token_pair(Token_Chunks *tokens, i64 pos){
 Token_Pair result = {};
-Token_Iterator_Array it = token_iterator_pos(0, tokens, pos);
+if (tokens != 0){
+Token_Iterator_Chunks it = token_iterator_pos(0, tokens, pos);
 Token *b = token_it_read(&it);
 if (b != 0){
 if (b->kind == TokenBaseKind_Whitespace){
 token_it_inc_non_whitespace(&it);
 b = token_it_read(&it);
 }
+result.b = *b;
 }
 token_it_dec_non_whitespace(&it);
 Token *a = token_it_read(&it);
 if (a != 0){
 result.a = *a;
 }
-if (b != 0){
-result.b = *b;
 }
 return(result);
 }
@@ -940,19 +1198,18 @@ function Layout_Item_List
 layout_index__inner(Application_Links *app, Arena *arena, Buffer_ID buffer, Range_i64 range, Face_ID face, f32 width, Code_Index_File *file, Layout_Wrap_Kind kind){
 Scratch_Block scratch(app, arena);
 
-Token_Array tokens = get_token_array_from_buffer(app, buffer);
-Token_Array *tokens_ptr = &tokens;
+Token_Chunks *tokens_ptr = get_token_chunks_from_buffer(app, buffer);
 
 Layout_Item_List list = get_empty_item_list(range);
 String_Const_u8 text = push_buffer_range(app, scratch, buffer, range);
 
 Face_Advance_Map advance_map = get_face_advance_map(app, face);
 Face_Metrics metrics = get_face_metrics(app, face);
-f32 tab_width = (f32)def_get_config_u64(app, vars_save_string_lit("default_tab_width"));
+f32 tab_width = (f32)def_get_config_snapshot(app)->default_tab_width;
 tab_width = clamp_bot(1, tab_width);
 LefRig_TopBot_Layout_Vars pos_vars = get_lr_tb_layout_vars(&advance_map, &metrics, tab_width, width);
 
-u64 vw_indent = def_get_config_u64(app, vars_save_string_lit("virtual_whitespace_regular_indent"));
+u64 vw_indent = def_get_config_snapshot(app)->virtual_whitespace_regular_indent;
 f32 regular_indent = metrics.space_advance*vw_indent;
 f32 wrap_align_x = width - metrics.normal_advance;
 
@@ -1198,7 +1455,7 @@ function Layout_Item_List
 layout_virt_indent_index(Application_Links *app, Arena *arena, Buffer_ID buffer, Range_i64 range, Face_ID face, f32 width, Layout_Wrap_Kind kind){
 Layout_Item_List result = {};
 
-b32 enable_virtual_whitespace = def_get_config_b32(vars_save_string_lit("enable_virtual_whitespace"));
+b32 enable_virtual_whitespace = def_get_config_snapshot(app)->enable_virtual_whitespace;
 if (enable_virtual_whitespace){
 code_index_lock();
 Code_Index_File *file = code_index_get_file(buffer);
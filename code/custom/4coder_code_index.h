@@ -57,6 +57,7 @@ struct Code_Index_Note{
     struct Code_Index_File *file;
     Code_Index_Nest *parent;
     
+    u64 hash;
     Code_Index_Note *prev_in_hash;
     Code_Index_Note *next_in_hash;
 };
@@ -80,13 +81,40 @@ struct Code_Index_File{
     Buffer_ID buffer;
 };
 
+// NOTE(allen): A file parsed off the main thread that is waiting to be put in
+// the index.
+struct Code_Index_Pending_File{
+    Arena arena;
+    Code_Index_File *file;
+};
+
+// NOTE(allen): reparse_size counts the bytes reparsed in place since the file was
+// last set, the nests and notes those reparses replace stay in the arena until
+// the next full parse.
 struct Code_Index_File_Storage{
     Code_Index_File_Storage *next;
     Code_Index_File_Storage *prev;
     Arena arena;
     Code_Index_File *file;
+    u64 reparse_size;
+};
+
+// NOTE(allen): The notes are hashed by name into shards that each have their own
+// lock and their own table, which doubles whenever it holds more notes than
+// slots.  The low bits of the hash pick the shard and the rest pick the slot.
+#define code_index_shard_count 16
+#define code_index_shard_initial_slot_count 256
+
+struct Code_Index_Name_Shard{
+    System_Mutex mutex;
+    Code_Index_Note_List *slots;
+    u64 slot_count;
+    u64 note_count;
 };
 
+// NOTE(allen): mutex guards the buffer to file table and the files in it.
+// Publishing a file only holds it to swap the new file in and unhash the old
+// one, the new notes get hashed before that under the shard locks alone.
 struct Code_Index{
     System_Mutex mutex;
     Arena node_arena;
@@ -96,7 +124,7 @@ struct Code_Index{
     Code_Index_File_Storage *storage_last;
     i32 storage_count;
     
-    Code_Index_Note_List name_hash[4099];
+    Code_Index_Name_Shard name_shards[code_index_shard_count];
 };
 
 ////////////////////////////////
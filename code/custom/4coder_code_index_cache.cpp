@@ -0,0 +1,455 @@
+/*
+4coder_code_index_cache.cpp - On disk cache of lexed and parsed files, so unchanged files skip the lex and parse.
+*/
+
+// TOP
+
+function u64
+code_index_cache_hash(String_Const_u8 data){
+    u64 hash = 0x9E3779B97F4A7C15ULL ^ data.size;
+    u64 i = 0;
+    for (; i + 8 <= data.size; i += 8){
+        u64 v = 0;
+        block_copy(&v, data.str + i, 8);
+        hash = (hash ^ v)*0xff51afd7ed558ccdULL;
+        hash ^= hash >> 32;
+    }
+    for (; i < data.size; i += 1){
+        hash = (hash ^ data.str[i])*0x100000001b3ULL;
+    }
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return(hash);
+}
+
+function String_Const_u8
+code_index_cache_folder(Arena *arena){
+    String_Const_u8 result = {};
+    String_Const_u8 user_directory = system_get_path(arena, SystemPath_UserDirectory);
+    if (user_directory.size > 0){
+        result = push_u8_stringf(arena, "%.*scode_index_cache", string_expand(user_directory));
+    }
+    return(result);
+}
+
+function String_Const_u8
+code_index_cache_path(Arena *arena, String_Const_u8 file_name){
+    String_Const_u8 result = {};
+    String_Const_u8 folder = code_index_cache_folder(arena);
+    if (folder.size > 0){
+        u64 hash = code_index_cache_hash(file_name);
+        result = push_u8_stringf(arena, "%.*s/%016llx.cidx", string_expand(folder), hash);
+    }
+    return(result);
+}
+
+////////////////////////////////
+
+function i32
+code_index_cache__count_nests(Code_Index_Nest_List *list){
+    i32 result = 0;
+    for (Code_Index_Nest *nest = list->first;
+         nest != 0;
+         nest = nest->next){
+        result += 1 + code_index_cache__count_nests(&nest->nest_list);
+    }
+    return(result);
+}
+
+function void
+code_index_cache__gather_nests(Code_Index_Nest **nests, i32 *counter, Table_u64_u64 *nest_to_index,
+                               Code_Index_Nest_List *list){
+    for (Code_Index_Nest *nest = list->first;
+         nest != 0;
+         nest = nest->next){
+        i32 index = *counter;
+        *counter += 1;
+        nests[index] = nest;
+        table_insert(nest_to_index, (u64)PtrAsInt(nest), (u64)index);
+        code_index_cache__gather_nests(nests, counter, nest_to_index, &nest->nest_list);
+    }
+}
+
+function i32
+code_index_cache__nest_index(Table_u64_u64 *nest_to_index, Code_Index_Nest *nest){
+    i32 result = -1;
+    u64 val = 0;
+    if (nest != 0 && table_read(nest_to_index, (u64)PtrAsInt(nest), &val)){
+        result = (i32)val;
+    }
+    return(result);
+}
+
+function void
+code_index_cache__write_nest_lists(Code_Index_Cache_Nest *out, Table_u64_u64 *nest_to_index,
+                                   Code_Index_Nest_List *list, i32 list_index){
+    for (Code_Index_Nest *nest = list->first;
+         nest != 0;
+         nest = nest->next){
+        i32 index = code_index_cache__nest_index(nest_to_index, nest);
+        out[index].list = list_index;
+        code_index_cache__write_nest_lists(out, nest_to_index, &nest->nest_list, index);
+    }
+}
+
+// NOTE(allen): The caller holds code_index_lock while file is read.
+function String_Const_u8
+code_index_cache_serialize(Arena *arena, String_Const_u8 file_name, File_Attributes attributes,
+                           String_Const_u8 contents, Token_Chunks *tokens, Code_Index_File *file){
+    i32 nest_count = code_index_cache__count_nests(&file->nest_list);
+    i32 note_count = file->note_list.count;
+    
+    u64 token_offset = sizeof(Code_Index_Cache_Header);
+    u64 nest_offset = token_offset + sizeof(Token)*tokens->count;
+    u64 note_offset = nest_offset + sizeof(Code_Index_Cache_Nest)*nest_count;
+    u64 path_offset = note_offset + sizeof(Code_Index_Cache_Note)*note_count;
+    u64 size = path_offset + file_name.size;
+    
+    String_Const_u8 result = {};
+    result.str = push_array_zero(arena, u8, size);
+    result.size = size;
+    
+    Code_Index_Cache_Header *header = (Code_Index_Cache_Header*)result.str;
+    header->magic = code_index_cache_magic;
+    header->version = code_index_cache_version;
+    header->lexer_version = lexer_cpp_version;
+    header->parser_version = code_index_parser_version;
+    header->token_size = sizeof(Token);
+    header->file_size = contents.size;
+    header->last_write_time = attributes.last_write_time;
+    header->content_hash = code_index_cache_hash(contents);
+    header->token_count = tokens->count;
+    header->token_offset = token_offset;
+    header->nest_count = nest_count;
+    header->nest_offset = nest_offset;
+    header->note_count = note_count;
+    header->note_offset = note_offset;
+    header->path_size = file_name.size;
+    header->path_offset = path_offset;
+    
+    token_fill_memory_from_chunks((Token*)(result.str + token_offset), tokens);
+    block_copy(result.str + path_offset, file_name.str, file_name.size);
+    
+    Temp_Memory temp = begin_temp(arena);
+    Table_u64_u64 nest_to_index = make_table_u64_u64(arena->base_allocator, nest_count*2 + 8);
+    Code_Index_Nest **nests = push_array(arena, Code_Index_Nest*, nest_count);
+    i32 counter = 0;
+    code_index_cache__gather_nests(nests, &counter, &nest_to_index, &file->nest_list);
+    
+    Code_Index_Cache_Nest *cache_nests = (Code_Index_Cache_Nest*)(result.str + nest_offset);
+    for (i32 i = 0; i < nest_count; i += 1){
+        Code_Index_Nest *nest = nests[i];
+        Code_Index_Cache_Nest *cache_nest = &cache_nests[i];
+        cache_nest->parent = code_index_cache__nest_index(&nest_to_index, nest->parent);
+        cache_nest->kind = nest->kind;
+        cache_nest->is_closed = nest->is_closed;
+        cache_nest->open = nest->open;
+        cache_nest->close = nest->close;
+    }
+    code_index_cache__write_nest_lists(cache_nests, &nest_to_index, &file->nest_list, -1);
+    
+    Code_Index_Cache_Note *cache_note = (Code_Index_Cache_Note*)(result.str + note_offset);
+    for (Code_Index_Note *note = file->note_list.first;
+         note != 0;
+         note = note->next, cache_note += 1){
+        cache_note->kind = note->note_kind;
+        cache_note->parent = code_index_cache__nest_index(&nest_to_index, note->parent);
+        cache_note->pos = note->pos;
+    }
+    
+    table_free(&nest_to_index);
+    end_temp(temp);
+    
+    return(result);
+}
+
+function b32
+code_index_cache__range_in(Range_i64 range, u64 size){
+    return(0 <= range.min && range.min <= range.max && (u64)range.max <= size);
+}
+
+// NOTE(allen): Checks every count, offset, and position in data before using it,
+// so a stale, truncated, or foreign cache file is turned down and never read out
+// of bounds.  On success the tokens are allocated from token_allocator and the
+// file is built on arena.
+function Code_Index_File*
+code_index_cache_deserialize(Arena *arena, Arena *scratch, String_Const_u8 data,
+                             String_Const_u8 file_name, File_Attributes attributes, String_Const_u8 contents,
+                             Base_Allocator *token_allocator, Token_Chunks *tokens_out){
+    Code_Index_File *result = 0;
+    Code_Index_Cache_Header *header = (Code_Index_Cache_Header*)data.str;
+    
+    b32 valid = (data.size >= sizeof(*header));
+    if (valid){
+        valid = (header->magic == code_index_cache_magic &&
+                 header->version == code_index_cache_version &&
+                 header->lexer_version == lexer_cpp_version &&
+                 header->parser_version == code_index_parser_version &&
+                 header->token_size == sizeof(Token) &&
+                 header->file_size == contents.size &&
+                 header->token_count <= data.size/sizeof(Token) &&
+                 header->nest_count <= data.size/sizeof(Code_Index_Cache_Nest) &&
+                 header->note_count <= data.size/sizeof(Code_Index_Cache_Note) &&
+                 header->path_size == file_name.size &&
+                 header->token_offset <= data.size &&
+                 header->nest_offset <= data.size &&
+                 header->note_offset <= data.size &&
+                 header->path_offset <= data.size &&
+                 sizeof(Token)*header->token_count <= data.size - header->token_offset &&
+                 sizeof(Code_Index_Cache_Nest)*header->nest_count <= data.size - header->nest_offset &&
+                 sizeof(Code_Index_Cache_Note)*header->note_count <= data.size - header->note_offset &&
+                 header->path_size <= data.size - header->path_offset);
+    }
+    if (valid){
+        valid = string_match(SCu8(data.str + header->path_offset, header->path_size), file_name);
+    }
+    if (valid && header->last_write_time != attributes.last_write_time){
+        valid = (header->content_hash == code_index_cache_hash(contents));
+    }
+    
+    Token *tokens = (Token*)(data.str + header->token_offset);
+    Code_Index_Cache_Nest *cache_nests = (Code_Index_Cache_Nest*)(data.str + header->nest_offset);
+    Code_Index_Cache_Note *cache_notes = (Code_Index_Cache_Note*)(data.str + header->note_offset);
+    i64 nest_count = valid?(i64)header->nest_count:0;
+    i64 note_count = valid?(i64)header->note_count:0;
+    if (valid){
+        for (u64 i = 0; i < header->token_count && valid; i += 1){
+            valid = code_index_cache__range_in(Ii64_size(tokens[i].pos, tokens[i].size), contents.size);
+        }
+        for (i64 i = 0; i < nest_count && valid; i += 1){
+            Code_Index_Cache_Nest *cache_nest = &cache_nests[i];
+            valid = (-1 <= cache_nest->list && cache_nest->list < i &&
+                     -1 <= cache_nest->parent && cache_nest->parent < nest_count);
+        }
+        for (i64 i = 0; i < note_count && valid; i += 1){
+            Code_Index_Cache_Note *cache_note = &cache_notes[i];
+            valid = (-1 <= cache_note->parent && cache_note->parent < nest_count &&
+                     code_index_cache__range_in(cache_note->pos, contents.size));
+        }
+    }
+    
+    if (valid){
+        Temp_Memory temp = begin_temp(scratch);
+        Code_Index_File *file = push_array_zero(arena, Code_Index_File, 1);
+        
+        Code_Index_Nest **nests = push_array(scratch, Code_Index_Nest*, nest_count);
+        for (i64 i = 0; i < nest_count; i += 1){
+            nests[i] = push_array_zero(arena, Code_Index_Nest, 1);
+        }
+        for (i64 i = 0; i < nest_count; i += 1){
+            Code_Index_Cache_Nest *cache_nest = &cache_nests[i];
+            Code_Index_Nest *nest = nests[i];
+            nest->kind = cache_nest->kind;
+            nest->is_closed = cache_nest->is_closed;
+            nest->open = cache_nest->open;
+            nest->close = cache_nest->close;
+            nest->file = file;
+            nest->parent = (cache_nest->parent < 0)?0:nests[cache_nest->parent];
+            Code_Index_Nest_List *list = &file->nest_list;
+            if (cache_nest->list >= 0){
+                list = &nests[cache_nest->list]->nest_list;
+            }
+            code_index_push_nest(list, nest);
+        }
+        for (i64 i = 0; i < nest_count; i += 1){
+            nests[i]->nest_array = code_index_nest_ptr_array_from_list(arena, &nests[i]->nest_list);
+        }
+        file->nest_array = code_index_nest_ptr_array_from_list(arena, &file->nest_list);
+        
+        for (i64 i = 0; i < note_count; i += 1){
+            Code_Index_Cache_Note *cache_note = &cache_notes[i];
+            Code_Index_Note *note = push_array_zero(arena, Code_Index_Note, 1);
+            sll_queue_push(file->note_list.first, file->note_list.last, note);
+            file->note_list.count += 1;
+            note->note_kind = cache_note->kind;
+            note->pos = cache_note->pos;
+            note->text = push_string_copy(arena, string_substring(contents, note->pos));
+            note->file = file;
+            note->parent = (cache_note->parent < 0)?0:nests[cache_note->parent];
+        }
+        file->note_array = code_index_note_ptr_array_from_list(arena, &file->note_list);
+        end_temp(temp);
+        
+        token_chunks_set(tokens_out, token_allocator, tokens, header->token_count);
+        
+        result = file;
+    }
+    
+    return(result);
+}
+
+////////////////////////////////
+
+// NOTE(allen): Call with the global frame mutex held.  Fills in the buffer's
+// tokens and code index from its cache file when there is a valid one.
+function b32
+code_index_cache_load(Application_Links *app, Buffer_ID buffer){
+    ProfileScope(app, "code index cache load");
+    b32 result = false;
+    Scratch_Block scratch(app);
+    String_Const_u8 file_name = push_buffer_file_name(app, scratch, buffer);
+    String_Const_u8 path = {};
+    if (file_name.size > 0){
+        path = code_index_cache_path(scratch, file_name);
+    }
+    
+    Plat_Handle handle = {};
+    if (path.size > 0 && system_load_handle(scratch, (char*)path.str, &handle)){
+        File_Attributes cache_attributes = system_load_attributes(handle);
+        String_Const_u8 data = {};
+        b32 mapped = false;
+        if (cache_attributes.size >= sizeof(Code_Index_Cache_Header)){
+            data.str = (u8*)system_load_map(handle, cache_attributes.size);
+            if (data.str != 0){
+                mapped = true;
+            }
+            else if (cache_attributes.size <= max_u32){
+                data.str = push_array(scratch, u8, cache_attributes.size);
+                if (!system_load_file(handle, (char*)data.str, (u32)cache_attributes.size)){
+                    data.str = 0;
+                }
+            }
+            if (data.str != 0){
+                data.size = cache_attributes.size;
+            }
+        }
+        
+        Managed_Scope scope = buffer_get_managed_scope(app, buffer);
+        Token_Chunks *tokens_ptr = scope_attachment(app, scope, attachment_tokens, Token_Chunks);
+        if (data.size > 0 && tokens_ptr != 0){
+            String_Const_u8 contents = push_whole_buffer(app, scratch, buffer);
+            File_Attributes attributes = buffer_get_file_attributes(app, buffer);
+            Base_Allocator *allocator = managed_scope_allocator(app, scope);
+            Arena arena = make_arena_system(KB(16));
+            Code_Index_File *file = code_index_cache_deserialize(&arena, scratch, data, file_name, attributes, contents,
+                                                                 allocator, tokens_ptr);
+            if (file != 0){
+                file->buffer = buffer;
+                code_index_set_file(buffer, arena, file);
+                result = true;
+            }
+            else{
+                linalloc_clear(&arena);
+            }
+        }
+        
+        if (mapped){
+            system_load_unmap(data.str, data.size);
+        }
+        system_load_close(handle);
+    }
+    
+    return(result);
+}
+
+// NOTE(allen): Call with the global frame mutex held.  The cache file is pushed
+// on arena and written out by code_index_cache_write, which needs no lock.
+function String_Const_u8
+code_index_cache_serialize_buffer(Application_Links *app, Arena *arena, Buffer_ID buffer, String_Const_u8 *path_out){
+    String_Const_u8 result = {};
+    String_Const_u8 file_name = push_buffer_file_name(app, arena, buffer);
+    Managed_Scope scope = buffer_get_managed_scope(app, buffer);
+    Token_Chunks *tokens_ptr = scope_attachment(app, scope, attachment_tokens, Token_Chunks);
+    if (file_name.size > 0 && tokens_ptr != 0 && tokens_ptr->count > 0){
+        *path_out = code_index_cache_path(arena, file_name);
+        if (path_out->size > 0){
+            String_Const_u8 contents = push_whole_buffer(app, arena, buffer);
+            File_Attributes attributes = buffer_get_file_attributes(app, buffer);
+            code_index_lock();
+            Code_Index_File *file = code_index_get_file(buffer);
+            if (file != 0){
+                result = code_index_cache_serialize(arena, file_name, attributes, contents, tokens_ptr, file);
+            }
+            code_index_unlock();
+        }
+    }
+    return(result);
+}
+
+function b32
+code_index_cache_write(Arena *scratch, String_Const_u8 path, String_Const_u8 data){
+    b32 result = false;
+    if (path.size > 0 && data.size > 0){
+        Temp_Memory temp = begin_temp(scratch);
+        String_Const_u8 user_directory = system_get_path(scratch, SystemPath_UserDirectory);
+        String_Const_u8 folder = code_index_cache_folder(scratch);
+        if (system_create_directory(scratch, (char*)user_directory.str) &&
+            system_create_directory(scratch, (char*)folder.str)){
+            File_Attributes attributes = system_save_file(scratch, (char*)path.str, data);
+            result = (attributes.size == data.size);
+        }
+        end_temp(temp);
+    }
+    return(result);
+}
+
+// NOTE(allen): Only for buffers whose tokens and index match their contents.
+function void
+code_index_cache_store(Application_Links *app, Buffer_ID buffer){
+    ProfileScope(app, "code index cache store");
+    Scratch_Block scratch(app);
+    String_Const_u8 path = {};
+    String_Const_u8 data = code_index_cache_serialize_buffer(app, scratch, buffer, &path);
+    code_index_cache_write(scratch, path, data);
+}
+
+////////////////////////////////
+
+function void
+code_index_cache__sort_by_write_time(File_Info **infos, i32 first, i32 one_past_last){
+    if (one_past_last - first >= 2){
+        i32 pivot = one_past_last - 1;
+        u64 pivot_time = infos[pivot]->attributes.last_write_time;
+        i32 j = first;
+        for (i32 i = first; i < pivot; i += 1){
+            if (infos[i]->attributes.last_write_time < pivot_time){
+                Swap(File_Info*, infos[i], infos[j]);
+                j += 1;
+            }
+        }
+        Swap(File_Info*, infos[pivot], infos[j]);
+        code_index_cache__sort_by_write_time(infos, first, j);
+        code_index_cache__sort_by_write_time(infos, j + 1, one_past_last);
+    }
+}
+
+// NOTE(allen): Deletes the least recently written cache files until the folder
+// is within budget bytes.  A cache file is rewritten each time its source file
+// is saved, so the ones that go first belong to files no one has saved in a
+// long while.
+function void
+code_index_cache_evict(Application_Links *app, u64 budget){
+    ProfileScope(app, "code index cache evict");
+    Scratch_Block scratch(app);
+    String_Const_u8 folder = code_index_cache_folder(scratch);
+    if (folder.size > 0){
+        File_List list = system_get_file_list(scratch, folder);
+        File_Info **infos = push_array(scratch, File_Info*, list.count);
+        i32 count = 0;
+        u64 total = 0;
+        for (u32 i = 0; i < list.count; i += 1){
+            File_Info *info = list.infos[i];
+            if (!HasFlag(info->attributes.flags, FileAttribute_IsDirectory) &&
+                string_match(string_file_extension(info->file_name), string_u8_litexpr("cidx"))){
+                infos[count] = info;
+                count += 1;
+                total += info->attributes.size;
+            }
+        }
+        if (total > budget){
+            code_index_cache__sort_by_write_time(infos, 0, count);
+            for (i32 i = 0; i < count && total > budget; i += 1){
+                Temp_Memory_Block temp(scratch);
+                String_Const_u8 path = push_u8_stringf(scratch, "%.*s/%.*s",
+                                                       string_expand(folder),
+                                                       string_expand(infos[i]->file_name));
+                if (system_delete_file(scratch, (char*)path.str)){
+                    total -= infos[i]->attributes.size;
+                }
+            }
+        }
+    }
+}
+
+// BOTTOM
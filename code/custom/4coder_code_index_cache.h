@@ -0,0 +1,67 @@
+/*
+4coder_code_index_cache.h - Types for the on disk cache of lexed and parsed files.
+*/
+
+// TOP
+
+#if !defined(FCODER_CODE_INDEX_CACHE_H)
+#define FCODER_CODE_INDEX_CACHE_H
+
+// NOTE(allen): Each source file gets one cache file in the code_index_cache folder
+// of the user directory, named after the hash of the source file's path.  The
+// cache file is the header followed by the tokens, the nests, the notes and the
+// path, all addressed by offsets from the start of the file so the whole thing
+// can be read straight out of a mapping.
+//  An entry is used when the path and size match and either the write time
+// matches or the contents hash to the same value.
+//  lexer_version comes from the lexer generator and changes whenever the lexer
+// it emits does.  There is no generator for the parser, so bump
+// code_index_parser_version by hand with any change to what the parser
+// produces.  A file written under other versions is turned down.
+//  The folder is kept under code_index_cache_budget_mb by deleting the least
+// recently written cache files at startup.
+#define code_index_cache_magic 0x58444943
+#define code_index_cache_version 3
+#define code_index_parser_version 1
+
+struct Code_Index_Cache_Header{
+    u32 magic;
+    u32 version;
+    u64 lexer_version;
+    u32 parser_version;
+    u32 unused;
+    u64 token_size;
+    u64 file_size;
+    u64 last_write_time;
+    u64 content_hash;
+    u64 token_count;
+    u64 token_offset;
+    u64 nest_count;
+    u64 nest_offset;
+    u64 note_count;
+    u64 note_offset;
+    u64 path_size;
+    u64 path_offset;
+};
+
+// NOTE(allen): list is the nest whose nest_list holds this nest and parent is the
+// nest in its parent pointer; a preprocessor nest can sit in the file's list and
+// still have a parent.  -1 stands for the file or for no nest.
+struct Code_Index_Cache_Nest{
+    i32 list;
+    i32 parent;
+    Code_Index_Nest_Kind kind;
+    b32 is_closed;
+    Range_i64 open;
+    Range_i64 close;
+};
+
+struct Code_Index_Cache_Note{
+    Code_Index_Note_Kind kind;
+    i64 parent;
+    Range_i64 pos;
+};
+
+#endif
+
+// BOTTOM
@@ -75,22 +75,11 @@ CUSTOM_DOC("Jump to the first definition in the code index matching an identifie
         String_Const_u8 query = push_token_or_word_under_active_cursor(app, scratch);
         
         code_index_lock();
-        for (Buffer_ID buffer = get_buffer_next(app, 0, Access_Always);
-             buffer != 0;
-             buffer = get_buffer_next(app, buffer, Access_Always)){
-            Code_Index_File *file = code_index_get_file(buffer);
-            if (file != 0){
-                for (i32 i = 0; i < file->note_array.count; i += 1){
-                    Code_Index_Note *note = file->note_array.ptrs[i];
-                    if (string_match(note->text, query)){
-                        point_stack_push_view_cursor(app, view);
-                        jump_to_location(app, view, buffer, note->pos.first);
-                        goto done;
-                    }
-                }
-            }
+        Code_Index_Note *note = code_index_note_from_string(query);
+        if (note != 0){
+            point_stack_push_view_cursor(app, view);
+            jump_to_location(app, view, note->file->buffer, note->pos.first);
         }
-        done:;
         code_index_unlock();
     }
 }
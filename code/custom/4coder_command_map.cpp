@@ -126,6 +126,7 @@ mapping_init(Thread_Context *tctx, Mapping *mapping){
 
 function void
 mapping_release(Thread_Context *tctx, Mapping *mapping){
+    heap_free_all(&mapping->heap);
     linalloc_clear(&mapping->node_arena);
     table_free(&mapping->id_to_map);
 }
@@ -856,6 +856,49 @@ def_set_config_u64(Application_Links *app, String_ID key, u64 val){
 }
 
 
+////////////////////////////////
+// NOTE(allen): Config Snapshot
+
+global Def_Config_Snapshot def_config_snapshot = {};
+
+function void
+def_config_snapshot_fill(Application_Links *app, Def_Config_Snapshot *snapshot){
+    snapshot->default_tab_width = def_get_config_u64(app, vars_save_string_lit("default_tab_width"));
+    snapshot->virtual_whitespace_regular_indent = def_get_config_u64(app, vars_save_string_lit("virtual_whitespace_regular_indent"));
+    snapshot->cursor_roundness = def_get_config_u64(app, vars_save_string_lit("cursor_roundness"));
+    snapshot->mark_thickness = def_get_config_u64(app, vars_save_string_lit("mark_thickness"));
+    snapshot->lister_roundness = def_get_config_u64(app, vars_save_string_lit("lister_roundness"));
+    snapshot->layout_cache_budget_kb = def_get_config_u64(app, vars_save_string_lit("layout_cache_budget_kb"));
+    
+    snapshot->enable_virtual_whitespace = def_get_config_b32(vars_save_string_lit("enable_virtual_whitespace"));
+    snapshot->show_line_number_margins = def_get_config_b32(vars_save_string_lit("show_line_number_margins"));
+    snapshot->use_file_bars = def_get_config_b32(vars_save_string_lit("use_file_bars"));
+    snapshot->hide_file_bar_in_ui = def_get_config_b32(vars_save_string_lit("hide_file_bar_in_ui"));
+    snapshot->use_comment_keyword = def_get_config_b32(vars_save_string_lit("use_comment_keyword"));
+    snapshot->use_scope_highlight = def_get_config_b32(vars_save_string_lit("use_scope_highlight"));
+    snapshot->use_error_highlight = def_get_config_b32(vars_save_string_lit("use_error_highlight"));
+    snapshot->use_jump_highlight = def_get_config_b32(vars_save_string_lit("use_jump_highlight"));
+    snapshot->use_paren_helper = def_get_config_b32(vars_save_string_lit("use_paren_helper"));
+    snapshot->highlight_line_at_cursor = def_get_config_b32(vars_save_string_lit("highlight_line_at_cursor"));
+}
+
+// NOTE(allen): Config, project and session values all live in the variables, so
+// the snapshot is rebuilt whenever the variables change counter has moved.
+function Def_Config_Snapshot*
+def_get_config_snapshot(Application_Links *app){
+    u64 counter = vars_get_change_counter();
+    if (!def_config_snapshot.is_built ||
+        def_config_snapshot.vars_change_counter != counter){
+        Def_Config_Snapshot snapshot = {};
+        def_config_snapshot_fill(app, &snapshot);
+        snapshot.is_built = true;
+        snapshot.vars_change_counter = counter;
+        def_config_snapshot = snapshot;
+    }
+    return(&def_config_snapshot);
+}
+
+
 ////////////////////////////////
 // NOTE(allen): Eval
 
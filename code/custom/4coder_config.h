@@ -241,6 +241,37 @@ function void            def_set_config_string(String_ID key, String_Const_u8 va
 function u64  def_get_config_u64(Application_Links *app, String_ID key);
 function void def_set_config_u64(Application_Links *app, String_ID key, u64 val);
 
+////////////////////////////////
+// NOTE(allen): Config Snapshot
+
+// NOTE(allen): The config values that layout and render hooks read for every
+// line or every frame, looked up and parsed once and kept until any variable
+// changes.
+struct Def_Config_Snapshot{
+    b32 is_built;
+    u64 vars_change_counter;
+    
+    u64 default_tab_width;
+    u64 virtual_whitespace_regular_indent;
+    u64 cursor_roundness;
+    u64 mark_thickness;
+    u64 lister_roundness;
+    u64 layout_cache_budget_kb;
+    
+    b32 enable_virtual_whitespace;
+    b32 show_line_number_margins;
+    b32 use_file_bars;
+    b32 hide_file_bar_in_ui;
+    b32 use_comment_keyword;
+    b32 use_scope_highlight;
+    b32 use_error_highlight;
+    b32 use_jump_highlight;
+    b32 use_paren_helper;
+    b32 highlight_line_at_cursor;
+};
+
+function Def_Config_Snapshot* def_get_config_snapshot(Application_Links *app);
+
 #endif
 
 // BOTTOM
@@ -135,7 +135,7 @@ get_view_for_locked_jump_buffer(Application_Links *app){
 // TODO(allen): re-evaluate the setup of this.
 function void
 new_view_settings(Application_Links *app, View_ID view){
-    b32 use_file_bars = def_get_config_b32(vars_save_string_lit("use_file_bars"));
+    b32 use_file_bars = def_get_config_snapshot(app)->use_file_bars;
     view_set_setting(app, view, ViewSetting_ShowFileBar, use_file_bars);
 }
 
@@ -784,8 +784,43 @@ buffer_mark_as_modified(Buffer_ID buffer){
         Buffer_Modified_Node *node = buffer_modified_set__alloc_node(set);
         zdll_push_back(set->first, set->last, node);
         node->buffer = buffer;
+        node->dirty_all = true;
         table_insert(&set->id_to_node, (u64)buffer, (u64)PtrAsInt(node));
     }
+    else{
+        u64 val = 0;
+        table_read(&set->id_to_node, lookup, &val);
+        Buffer_Modified_Node *node = (Buffer_Modified_Node*)IntAsPtr(val);
+        node->dirty_all = true;
+    }
+}
+
+// NOTE(allen): For an edit that replaced old_range with new_size bytes, dirty is
+// the range that has to be looked at again in the new contents.  The dirty range
+// from earlier edits is shifted by this one and joined with it.
+function void
+buffer_mark_as_modified(Buffer_ID buffer, Range_i64 old_range, i64 new_size, Range_i64 dirty){
+    Buffer_Modified_Set *set = &global_buffer_modified_set;
+    
+    Table_Lookup lookup = table_lookup(&set->id_to_node, (u64)buffer);
+    if (!lookup.found_match){
+        Buffer_Modified_Node *node = buffer_modified_set__alloc_node(set);
+        zdll_push_back(set->first, set->last, node);
+        node->buffer = buffer;
+        node->dirty = dirty;
+        node->dirty_all = false;
+        table_insert(&set->id_to_node, (u64)buffer, (u64)PtrAsInt(node));
+    }
+    else{
+        u64 val = 0;
+        table_read(&set->id_to_node, lookup, &val);
+        Buffer_Modified_Node *node = (Buffer_Modified_Node*)IntAsPtr(val);
+        if (!node->dirty_all){
+            index_shift(&node->dirty.min, old_range, new_size);
+            index_shift(&node->dirty.max, old_range, new_size);
+            node->dirty = range_union(node->dirty, dirty);
+        }
+    }
 }
 
 function void
@@ -926,6 +961,7 @@ clipboard_init(Base_Allocator *allocator, u32 history_depth, Clipboard *clipboar
 
 function void
 clipboard_clear(Clipboard *clipboard){
+    heap_free_all(&clipboard->heap);
     linalloc_clear(&clipboard->arena);
     clipboard_init_empty(clipboard, clipboard->clip_capacity);
 }
@@ -100,6 +100,10 @@ struct Buffer_Modified_Node{
     Buffer_Modified_Node *next;
     Buffer_Modified_Node *prev;
     Buffer_ID buffer;
+    // NOTE(allen): The part of the buffer that changed since the last parse, in
+    // the positions of the current contents, unless dirty_all is set.
+    Range_i64 dirty;
+    b32 dirty_all;
 };
 
 struct Buffer_Modified_Set{
@@ -21,7 +21,11 @@ CUSTOM_ID(attachment, view_previous_buffer);
 CUSTOM_ID(attachment, buffer_map_id);
 CUSTOM_ID(attachment, buffer_eol_setting);
 CUSTOM_ID(attachment, buffer_lex_task);
+CUSTOM_ID(attachment, buffer_parse_task);
+CUSTOM_ID(attachment, buffer_index_task);
+CUSTOM_ID(attachment, buffer_pending_index_file);
 CUSTOM_ID(attachment, buffer_wrap_lines);
+CUSTOM_ID(attachment, buffer_trigram_index);
 
 CUSTOM_ID(attachment, sticky_jump_marker_handle);
 CUSTOM_ID(attachment, attachment_tokens);
@@ -91,6 +95,7 @@ global Mapping framework_mapping = {};
 global Buffer_Modified_Set global_buffer_modified_set = {};
 
 global b32 def_enable_virtual_whitespace = false;
+global u64 def_layout_cache_budget_kb = 0;
 
 ////////////////////////////////
 
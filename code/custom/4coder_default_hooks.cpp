@@ -18,6 +18,13 @@ CUSTOM_DOC("Default command for responding to a startup event")
         if (auto_load){
             load_project(app);
         }
+        if (def_get_config_b32(vars_save_string_lit("enable_code_index_cache"))){
+            u64 budget_mb = def_get_config_u64(app, vars_save_string_lit("code_index_cache_budget_mb"));
+            if (budget_mb == 0){
+                budget_mb = 256;
+            }
+            code_index_cache_evict(app, MB(budget_mb));
+        }
     }
     
     {
@@ -127,27 +134,39 @@ code_index_update_tick(Application_Links *app){
         Buffer_ID buffer_id = node->buffer;
         
         String_Const_u8 contents = push_whole_buffer(app, scratch, buffer_id);
-        Token_Array tokens = get_token_array_from_buffer(app, buffer_id);
-        if (tokens.count == 0){
+        Token_Chunks *tokens = get_token_chunks_from_buffer(app, buffer_id);
+        if (tokens == 0){
             continue;
         }
         
-        Arena arena = make_arena_system(KB(16));
-        Code_Index_File *index = push_array_zero(&arena, Code_Index_File, 1);
-        index->buffer = buffer_id;
-        
-        Generic_Parse_State state = {};
-        generic_parse_init(app, &arena, contents, &tokens, &state);
-        // TODO(allen): Actually determine this in a fair way.
-        // Maybe switch to an enum?
-        // Actually probably a pointer to a struct that defines the language.
-        state.do_cpp_parse = true;
-        generic_parse_full_input_breaks(index, &state, max_i32);
-        
-        code_index_lock();
-        code_index_set_file(buffer_id, arena, index);
-        code_index_unlock();
-        buffer_clear_layout_cache(app, buffer_id);
+        if (node->dirty_all ||
+            !code_index_reparse_nest(app, buffer_id, contents, tokens, node->dirty)){
+            // NOTE(allen): A full parse reads every token anyway, so the flat copy
+            // costs no more than the parse.
+            Token_Array token_array = token_chunks_flat(tokens);
+            Arena arena = make_arena_system(KB(16));
+            Code_Index_File *index = push_array_zero(&arena, Code_Index_File, 1);
+            index->buffer = buffer_id;
+            
+            Generic_Parse_State state = {};
+            generic_parse_init(app, &arena, contents, &token_array, &state);
+            // TODO(allen): Actually determine this in a fair way.
+            // Maybe switch to an enum?
+            // Actually probably a pointer to a struct that defines the language.
+            state.do_cpp_parse = true;
+            generic_parse_full_input_breaks(index, &state, max_i32);
+            
+            code_index_set_file(buffer_id, arena, index);
+        }
+        // NOTE(allen): Only the virtual whitespace layout reads the code index,
+        // the other layouts were already fixed up line by line by the edit.
+        if (def_enable_virtual_whitespace){
+            buffer_clear_layout_cache(app, buffer_id);
+        }
+        if (buffer_get_dirty_state(app, buffer_id) == DirtyState_UpToDate &&
+            def_get_config_b32(vars_save_string_lit("enable_code_index_cache"))){
+            code_index_cache_store(app, buffer_id);
+        }
     }
     
     buffer_modified_set_clear();
@@ -160,6 +179,23 @@ default_tick(Application_Links *app, Frame_Info frame_info){
     
     code_index_update_tick(app);
     
+    ////////////////////////////////
+    // NOTE(allen): Lex the buffers on screen first
+    
+    for (View_ID view = get_view_next(app, 0, Access_Always);
+         view != 0;
+         view = get_view_next(app, view, Access_Always)){
+        Buffer_ID buffer = view_get_buffer(app, view, Access_Always);
+        Managed_Scope scope = buffer_get_managed_scope(app, buffer);
+        Managed_ID stage_ids[] = {buffer_lex_task, buffer_parse_task, buffer_index_task};
+        for (i32 i = 0; i < ArrayCount(stage_ids); i += 1){
+            Async_Task *task_ptr = scope_attachment(app, scope, stage_ids[i], Async_Task);
+            if (task_ptr != 0 && *task_ptr != 0){
+                async_task_set_priority(&global_async_system, *task_ptr, AsyncPriority_High);
+            }
+        }
+    }
+    
     ////////////////////////////////
     // NOTE(allen): Update fade ranges
     
@@ -171,12 +207,24 @@ default_tick(Application_Links *app, Frame_Info frame_info){
     // NOTE(allen): Clear layouts if virtual whitespace setting changed.
     
     {
-        b32 enable_virtual_whitespace = def_get_config_b32(vars_save_string_lit("enable_virtual_whitespace"));
+        b32 enable_virtual_whitespace = def_get_config_snapshot(app)->enable_virtual_whitespace;
         if (enable_virtual_whitespace != def_enable_virtual_whitespace){
             def_enable_virtual_whitespace = enable_virtual_whitespace;
             clear_all_layouts(app);
         }
     }
+    
+    ////////////////////////////////
+    // NOTE(allen): Pass the layout cache budget to the core when it changes,
+    // including on the first tick after the config is loaded.
+    
+    {
+        u64 layout_cache_budget_kb = def_get_config_snapshot(app)->layout_cache_budget_kb;
+        if (layout_cache_budget_kb > 0 && layout_cache_budget_kb != def_layout_cache_budget_kb){
+            def_layout_cache_budget_kb = layout_cache_budget_kb;
+            set_layout_cache_budget(app, KB(layout_cache_budget_kb));
+        }
+    }
 }
 
 function Rect_f32
@@ -216,7 +264,7 @@ default_buffer_region(Application_Links *app, View_ID view_id, Rect_f32 region){
     }
     
     // NOTE(allen): line numbers
-    b32 show_line_number_margins = def_get_config_b32(vars_save_string_lit("show_line_number_margins"));
+    b32 show_line_number_margins = def_get_config_snapshot(app)->show_line_number_margins;
     if (show_line_number_margins){
         Rect_f32_Pair pair = layout_line_number_margin(app, buffer, region, digit_advance);
         region = pair.max;
@@ -277,23 +325,23 @@ default_render_buffer(Application_Links *app, View_ID view_id, Face_ID face_id,
     
     // NOTE(allen): Cursor shape
     Face_Metrics metrics = get_face_metrics(app, face_id);
-    u64 cursor_roundness_100 = def_get_config_u64(app, vars_save_string_lit("cursor_roundness"));
+    u64 cursor_roundness_100 = def_get_config_snapshot(app)->cursor_roundness;
     f32 cursor_roundness = metrics.normal_advance*cursor_roundness_100*0.01f;
-    f32 mark_thickness = (f32)def_get_config_u64(app, vars_save_string_lit("mark_thickness"));
+    f32 mark_thickness = (f32)def_get_config_snapshot(app)->mark_thickness;
     
     // NOTE(allen): Token colorizing
-    Token_Array token_array = get_token_array_from_buffer(app, buffer);
-    if (token_array.tokens != 0){
-        draw_cpp_token_colors(app, text_layout_id, &token_array);
+    Token_Chunks *token_chunks = get_token_chunks_from_buffer(app, buffer);
+    if (token_chunks != 0){
+        draw_cpp_token_colors(app, text_layout_id, token_chunks);
         
         // NOTE(allen): Scan for TODOs and NOTEs
-        b32 use_comment_keyword = def_get_config_b32(vars_save_string_lit("use_comment_keyword"));
+        b32 use_comment_keyword = def_get_config_snapshot(app)->use_comment_keyword;
         if (use_comment_keyword){
             Comment_Highlight_Pair pairs[] = {
                 {string_u8_litexpr("NOTE"), finalize_color(defcolor_comment_pop, 0)},
                 {string_u8_litexpr("TODO"), finalize_color(defcolor_comment_pop, 1)},
             };
-            draw_comment_highlights(app, buffer, text_layout_id, &token_array, pairs, ArrayCount(pairs));
+            draw_comment_highlights(app, buffer, text_layout_id, token_chunks, pairs, ArrayCount(pairs));
         }
         
 #if 0
@@ -303,7 +351,7 @@ default_render_buffer(Application_Links *app, View_ID view_id, Face_ID face_id,
         Scratch_Block scratch(app);
         ARGB_Color argb = 0xFFFF00FF;
         
-        Token_Iterator_Array it = token_iterator_pos(0, &token_array, visible_range.first);
+        Token_Iterator_Chunks it = token_iterator_pos(0, token_chunks, visible_range.first);
         for (;;){
             if (!token_it_inc_non_whitespace(&it)){
                 break;
@@ -325,14 +373,14 @@ default_render_buffer(Application_Links *app, View_ID view_id, Face_ID face_id,
     view_correct_mark(app, view_id);
     
     // NOTE(allen): Scope highlight
-    b32 use_scope_highlight = def_get_config_b32(vars_save_string_lit("use_scope_highlight"));
+    b32 use_scope_highlight = def_get_config_snapshot(app)->use_scope_highlight;
     if (use_scope_highlight){
         Color_Array colors = finalize_color_array(defcolor_back_cycle);
         draw_scope_highlight(app, buffer, text_layout_id, cursor_pos, colors.vals, colors.count);
     }
     
-    b32 use_error_highlight = def_get_config_b32(vars_save_string_lit("use_error_highlight"));
-    b32 use_jump_highlight = def_get_config_b32(vars_save_string_lit("use_jump_highlight"));
+    b32 use_error_highlight = def_get_config_snapshot(app)->use_error_highlight;
+    b32 use_jump_highlight = def_get_config_snapshot(app)->use_jump_highlight;
     if (use_error_highlight || use_jump_highlight){
         // NOTE(allen): Error highlight
         String_Const_u8 name = string_u8_litexpr("*compilation*");
@@ -353,14 +401,14 @@ default_render_buffer(Application_Links *app, View_ID view_id, Face_ID face_id,
     }
     
     // NOTE(allen): Color parens
-    b32 use_paren_helper = def_get_config_b32(vars_save_string_lit("use_paren_helper"));
+    b32 use_paren_helper = def_get_config_snapshot(app)->use_paren_helper;
     if (use_paren_helper){
         Color_Array colors = finalize_color_array(defcolor_text_cycle);
         draw_paren_highlight(app, buffer, text_layout_id, cursor_pos, colors.vals, colors.count);
     }
     
     // NOTE(allen): Line highlight
-    b32 highlight_line_at_cursor = def_get_config_b32(vars_save_string_lit("highlight_line_at_cursor"));
+    b32 highlight_line_at_cursor = def_get_config_snapshot(app)->highlight_line_at_cursor;
     if (highlight_line_at_cursor && is_active_view){
         i64 line_number = get_line_number_from_pos(app, buffer, cursor_pos);
         draw_line_highlight(app, text_layout_id, line_number, fcolor_id(defcolor_highlight_cursor_line));
@@ -370,11 +418,11 @@ default_render_buffer(Application_Links *app, View_ID view_id, Face_ID face_id,
     b64 show_whitespace = false;
     view_get_setting(app, view_id, ViewSetting_ShowWhitespace, &show_whitespace);
     if (show_whitespace){
-        if (token_array.tokens == 0){
+        if (token_chunks == 0){
             draw_whitespace_highlight(app, buffer, text_layout_id, cursor_roundness);
         }
         else{
-            draw_whitespace_highlight(app, text_layout_id, &token_array, cursor_roundness);
+            draw_whitespace_highlight(app, text_layout_id, token_chunks, cursor_roundness);
         }
     }
     
@@ -464,7 +512,7 @@ default_render_caller(Application_Links *app, Frame_Info frame_info, View_ID vie
     }
     
     // NOTE(allen): layout line numbers
-    b32 show_line_number_margins = def_get_config_b32(vars_save_string_lit("show_line_number_margins"));
+    b32 show_line_number_margins = def_get_config_snapshot(app)->show_line_number_margins;
     Rect_f32 line_number_rect = {};
     if (show_line_number_margins){
         Rect_f32_Pair pair = layout_line_number_margin(app, buffer, region, digit_advance);
@@ -641,6 +689,7 @@ parse_async__inner(Async_Context *actx, Buffer_ID buffer_id,
     
     Generic_Parse_State state = {};
     generic_parse_init(app, &arena, contents, tokens, &state);
+    state.do_cpp_parse = true;
     
     b32 canceled = false;
     
@@ -655,11 +704,20 @@ parse_async__inner(Async_Context *actx, Buffer_ID buffer_id,
     }
     
     if (!canceled){
+        // NOTE(allen): Hand the result to the index stage.
         acquire_global_frame_mutex(app);
-        code_index_lock();
-        code_index_set_file(buffer_id, arena, index);
-        code_index_unlock();
-        buffer_clear_layout_cache(app, buffer_id);
+        Managed_Scope scope = buffer_get_managed_scope(app, buffer_id);
+        Code_Index_Pending_File *pending = scope_attachment(app, scope, buffer_pending_index_file, Code_Index_Pending_File);
+        if (pending != 0){
+            if (pending->file != 0){
+                linalloc_clear(&pending->arena);
+            }
+            pending->arena = arena;
+            pending->file = index;
+        }
+        else{
+            linalloc_clear(&arena);
+        }
         release_global_frame_mutex(app);
     }
     else{
@@ -667,6 +725,59 @@ parse_async__inner(Async_Context *actx, Buffer_ID buffer_id,
     }
 }
 
+function void
+do_parse_async(Async_Context *actx, String_Const_u8 data){
+    if (data.size == sizeof(Buffer_ID)){
+        Buffer_ID buffer = *(Buffer_ID*)data.str;
+        Application_Links *app = actx->app;
+        Scratch_Block scratch(app);
+        
+        String_Const_u8 contents = {};
+        Token_Array tokens = {};
+        acquire_global_frame_mutex(app);
+        Managed_Scope scope = buffer_get_managed_scope(app, buffer);
+        Token_Chunks *tokens_ptr = scope_attachment(app, scope, attachment_tokens, Token_Chunks);
+        if (tokens_ptr != 0 && tokens_ptr->count > 0){
+            contents = push_whole_buffer(app, scratch, buffer);
+            tokens = token_array_from_chunks(scratch, tokens_ptr);
+        }
+        release_global_frame_mutex(app);
+        
+        if (tokens.count > 0){
+            parse_async__inner(actx, buffer, contents, &tokens, 10000);
+        }
+    }
+}
+
+function void
+do_index_async(Async_Context *actx, String_Const_u8 data){
+    if (data.size == sizeof(Buffer_ID)){
+        Buffer_ID buffer = *(Buffer_ID*)data.str;
+        Application_Links *app = actx->app;
+        ProfileScope(app, "async index");
+        Scratch_Block scratch(app);
+        String_Const_u8 cache_path = {};
+        String_Const_u8 cache_data = {};
+        acquire_global_frame_mutex(app);
+        Managed_Scope scope = buffer_get_managed_scope(app, buffer);
+        Code_Index_Pending_File *pending = scope_attachment(app, scope, buffer_pending_index_file, Code_Index_Pending_File);
+        if (pending != 0 && pending->file != 0 && !async_check_canceled(actx)){
+            code_index_set_file(buffer, pending->arena, pending->file);
+            block_zero_struct(pending);
+            if (def_enable_virtual_whitespace){
+                buffer_clear_layout_cache(app, buffer);
+            }
+            if (buffer_get_dirty_state(app, buffer) == DirtyState_UpToDate &&
+                def_get_config_b32(vars_save_string_lit("enable_code_index_cache"))){
+                cache_data = code_index_cache_serialize_buffer(app, scratch, buffer, &cache_path);
+            }
+        }
+        release_global_frame_mutex(app);
+        // NOTE(allen): The cache file is written without holding up the frame.
+        code_index_cache_write(scratch, cache_path, cache_data);
+    }
+}
+
 function void
 do_full_lex_async__inner(Async_Context *actx, Buffer_ID buffer_id){
     Application_Links *app = actx->app;
@@ -687,16 +798,22 @@ do_full_lex_async__inner(Async_Context *actx, Buffer_ID buffer_id){
     Token_List list = {};
     b32 canceled = false;
     
-    Lex_State_Cpp state = {};
-    lex_full_input_cpp_init(&state, contents);
-    for (;;){
-        ProfileBlock(app, "async lex block");
-        if (lex_full_input_cpp_breaks(scratch, &list, &state, limit_factor)){
-            break;
-        }
-        if (async_check_canceled(actx)){
-            canceled = true;
-            break;
+    Parallel_Lex parallel_lex = {};
+    if (contents.size >= parallel_lex_min_size && global_async_system.thread_count > 1){
+        canceled = !parallel_lex_run(actx, scratch, contents, &parallel_lex, &list);
+    }
+    else{
+        Lex_State_Cpp state = {};
+        lex_full_input_cpp_init(&state, contents);
+        for (;;){
+            ProfileBlock(app, "async lex block");
+            if (lex_full_input_cpp_breaks(scratch, &list, &state, limit_factor)){
+                break;
+            }
+            if (async_check_canceled(actx)){
+                canceled = true;
+                break;
+            }
         }
     }
     
@@ -707,18 +824,13 @@ do_full_lex_async__inner(Async_Context *actx, Buffer_ID buffer_id){
         Managed_Scope scope = buffer_get_managed_scope(app, buffer_id);
         if (scope != 0){
             Base_Allocator *allocator = managed_scope_allocator(app, scope);
-            Token_Array *tokens_ptr = scope_attachment(app, scope, attachment_tokens, Token_Array);
-            base_free(allocator, tokens_ptr->tokens);
-            Token_Array tokens = {};
-            tokens.tokens = base_array(allocator, Token, list.total_count);
-            tokens.count = list.total_count;
-            tokens.max = list.total_count;
-            token_fill_memory_from_list(tokens.tokens, &list);
-            block_copy_struct(tokens_ptr, &tokens);
+            Token_Chunks *tokens_ptr = scope_attachment(app, scope, attachment_tokens, Token_Chunks);
+            token_chunks_set(tokens_ptr, allocator, &list);
         }
-        buffer_mark_as_modified(buffer_id);
         release_global_frame_mutex(app);
     }
+    
+    parallel_lex_release(&parallel_lex);
 }
 
 function void
@@ -729,6 +841,91 @@ do_full_lex_async(Async_Context *actx, String_Const_u8 data){
     }
 }
 
+function Async_Priority
+buffer_lex_priority(Application_Links *app, Buffer_ID buffer){
+    Async_Priority result = AsyncPriority_Normal;
+    for (View_ID view = get_view_next(app, 0, Access_Always);
+         view != 0;
+         view = get_view_next(app, view, Access_Always)){
+        if (view_get_buffer(app, view, Access_Always) == buffer){
+            result = AsyncPriority_High;
+            break;
+        }
+    }
+    return(result);
+}
+
+// NOTE(allen): Lexing, parsing and putting the parse in the code index run as
+// three tasks that wait on each other, canceling the lex cancels the rest.
+function void
+buffer_start_lex_pipeline(Application_Links *app, Buffer_ID buffer_id){
+    Managed_Scope scope = buffer_get_managed_scope(app, buffer_id);
+    Async_Task *lex_task_ptr = scope_attachment(app, scope, buffer_lex_task, Async_Task);
+    Async_Task *parse_task_ptr = scope_attachment(app, scope, buffer_parse_task, Async_Task);
+    Async_Task *index_task_ptr = scope_attachment(app, scope, buffer_index_task, Async_Task);
+    if (lex_task_ptr != 0 && parse_task_ptr != 0 && index_task_ptr != 0){
+        Async_System *async_system = &global_async_system;
+        Async_Priority priority = buffer_lex_priority(app, buffer_id);
+        String_Const_u8 data = make_data_struct(&buffer_id);
+        *lex_task_ptr = async_task_no_dep(async_system, do_full_lex_async, data, priority);
+        *parse_task_ptr = async_task_single_dep(async_system, *lex_task_ptr, do_parse_async, data, priority);
+        *index_task_ptr = async_task_single_dep(async_system, *parse_task_ptr, do_index_async, data, priority);
+    }
+}
+
+// NOTE(allen): Stops the parse and index stages, the lex stage is left to the
+// caller because a finished lex is still good after an edit is relexed.  Returns
+// true when a code index that never got set was thrown away, then the code index
+// the buffer has is older than its tokens.
+function b32
+buffer_cancel_index_stages(Application_Links *app, Buffer_ID buffer_id){
+    b32 result = false;
+    Managed_Scope scope = buffer_get_managed_scope(app, buffer_id);
+    Async_Task *parse_task_ptr = scope_attachment(app, scope, buffer_parse_task, Async_Task);
+    Async_Task *index_task_ptr = scope_attachment(app, scope, buffer_index_task, Async_Task);
+    if (parse_task_ptr != 0 && *parse_task_ptr != 0){
+        if (async_task_is_running_or_pending(&global_async_system, *parse_task_ptr)){
+            result = true;
+        }
+        async_task_cancel(app, &global_async_system, *parse_task_ptr);
+        *parse_task_ptr = 0;
+    }
+    if (index_task_ptr != 0 && *index_task_ptr != 0){
+        if (async_task_is_running_or_pending(&global_async_system, *index_task_ptr)){
+            result = true;
+        }
+        async_task_cancel(app, &global_async_system, *index_task_ptr);
+        *index_task_ptr = 0;
+    }
+    Code_Index_Pending_File *pending = scope_attachment(app, scope, buffer_pending_index_file, Code_Index_Pending_File);
+    if (pending != 0 && pending->file != 0){
+        linalloc_clear(&pending->arena);
+        block_zero_struct(pending);
+        result = true;
+    }
+    return(result);
+}
+
+// NOTE(allen): The tokens and the code index match the text once no pipeline
+// stage is left to run and no edit is waiting on the code index tick.
+function b32
+buffer_code_index_is_current(Application_Links *app, Buffer_ID buffer_id){
+    b32 result = false;
+    Managed_Scope scope = buffer_get_managed_scope(app, buffer_id);
+    Async_Task *lex_task_ptr = scope_attachment(app, scope, buffer_lex_task, Async_Task);
+    Async_Task *parse_task_ptr = scope_attachment(app, scope, buffer_parse_task, Async_Task);
+    Async_Task *index_task_ptr = scope_attachment(app, scope, buffer_index_task, Async_Task);
+    if (lex_task_ptr != 0 && parse_task_ptr != 0 && index_task_ptr != 0){
+        Async_System *async_system = &global_async_system;
+        Table_Lookup lookup = table_lookup(&global_buffer_modified_set.id_to_node, (u64)buffer_id);
+        result = (!lookup.found_match &&
+                  !async_task_is_running_or_pending(async_system, *lex_task_ptr) &&
+                  !async_task_is_running_or_pending(async_system, *parse_task_ptr) &&
+                  !async_task_is_running_or_pending(async_system, *index_task_ptr));
+    }
+    return(result);
+}
+
 BUFFER_HOOK_SIG(default_begin_buffer){
     ProfileScope(app, "begin buffer");
     
@@ -834,9 +1031,14 @@ BUFFER_HOOK_SIG(default_begin_buffer){
     }
     
     if (use_lexer){
-        ProfileBlock(app, "begin buffer kick off lexer");
-        Async_Task *lex_task_ptr = scope_attachment(app, scope, buffer_lex_task, Async_Task);
-        *lex_task_ptr = async_task_no_dep(&global_async_system, do_full_lex_async, make_data_struct(&buffer_id));
+        b32 loaded_from_cache = false;
+        if (def_get_config_b32(vars_save_string_lit("enable_code_index_cache"))){
+            loaded_from_cache = code_index_cache_load(app, buffer_id);
+        }
+        if (!loaded_from_cache){
+            ProfileBlock(app, "begin buffer kick off lexer");
+            buffer_start_lex_pipeline(app, buffer_id);
+        }
     }
     
     {
@@ -937,6 +1139,13 @@ BUFFER_HOOK_SIG(default_file_save){
         }break;
     }
     
+    // NOTE(allen): This runs before the text is written, so the cache entry gets
+    // the old write time and is picked up next time by its content hash.
+    if (def_get_config_b32(vars_save_string_lit("enable_code_index_cache")) &&
+        buffer_code_index_is_current(app, buffer_id)){
+        code_index_cache_store(app, buffer_id);
+    }
+    
     // no meaning for return
     return(0);
 }
@@ -948,6 +1157,7 @@ BUFFER_EDIT_RANGE_SIG(default_buffer_edit_range){
     Range_i64 old_range = Ii64(old_cursor_range.min.pos, old_cursor_range.max.pos);
     
     buffer_shift_fade_ranges(buffer_id, old_range.max, (new_range.max - old_range.max));
+    trigram_index_edit(app, buffer_id, old_range, range_size(new_range));
     
     {
         code_index_lock();
@@ -966,7 +1176,6 @@ BUFFER_EDIT_RANGE_SIG(default_buffer_edit_range){
     Managed_Scope scope = buffer_get_managed_scope(app, buffer_id);
     Async_Task *lex_task_ptr = scope_attachment(app, scope, buffer_lex_task, Async_Task);
     
-    Base_Allocator *allocator = managed_scope_allocator(app, scope);
     b32 do_full_relex = false;
     
     if (async_task_is_running_or_pending(&global_async_system, *lex_task_ptr)){
@@ -975,9 +1184,10 @@ BUFFER_EDIT_RANGE_SIG(default_buffer_edit_range){
         do_full_relex = true;
         *lex_task_ptr = 0;
     }
+    b32 index_is_stale = buffer_cancel_index_stages(app, buffer_id);
     
-    Token_Array *ptr = scope_attachment(app, scope, attachment_tokens, Token_Array);
-    if (ptr != 0 && ptr->tokens != 0){
+    Token_Chunks *ptr = scope_attachment(app, scope, attachment_tokens, Token_Chunks);
+    if (ptr != 0 && ptr->count > 0){
         ProfileBlockNamed(app, "attempt resync", profile_attempt_resync);
         
         i64 token_index_first = token_relex_first(ptr, old_range.first, 1);
@@ -988,10 +1198,10 @@ BUFFER_EDIT_RANGE_SIG(default_buffer_edit_range){
             do_full_relex = true;
         }
         else{
-            Token *token_first = ptr->tokens + token_index_first;
-            Token *token_resync = ptr->tokens + token_index_resync_guess;
+            Token token_first = token_chunks_read(ptr, token_index_first);
+            Token token_resync = token_chunks_read(ptr, token_index_resync_guess);
             
-            Range_i64 relex_range = Ii64(token_first->pos, token_resync->pos + token_resync->size + text_shift);
+            Range_i64 relex_range = Ii64(token_first.pos, token_resync.pos + token_resync.size + text_shift);
             String_Const_u8 partial_text = push_buffer_range(app, scratch, buffer_id, relex_range);
             
             Token_List relex_list = lex_full_input_cpp(scratch, partial_text);
@@ -999,7 +1209,7 @@ BUFFER_EDIT_RANGE_SIG(default_buffer_edit_range){
                 token_drop_eof(&relex_list);
             }
             
-            Token_Relex relex = token_relex(relex_list, relex_range.first - text_shift, ptr->tokens, token_index_first, token_index_resync_guess);
+            Token_Relex relex = token_relex(relex_list, relex_range.first - text_shift, ptr, token_index_first, token_index_resync_guess);
             
             ProfileCloseNow(profile_attempt_resync);
             
@@ -1011,41 +1221,39 @@ BUFFER_EDIT_RANGE_SIG(default_buffer_edit_range){
                 
                 i64 token_index_resync = relex.first_resync_index;
                 
-                Range_i64 head = Ii64(0, token_index_first);
                 Range_i64 replaced = Ii64(token_index_first, token_index_resync);
-                Range_i64 tail = Ii64(token_index_resync, ptr->count);
                 i64 resynced_count = (token_index_resync_guess + 1) - token_index_resync;
                 i64 relexed_count = relex_list.total_count - resynced_count;
-                i64 tail_shift = relexed_count - (token_index_resync - token_index_first);
                 
-                i64 new_tokens_count = ptr->count + tail_shift;
-                Token *new_tokens = base_array(allocator, Token, new_tokens_count);
+                Token *relexed_tokens = push_array(scratch, Token, relexed_count);
+                token_fill_memory_from_list(relexed_tokens, &relex_list, relexed_count);
+                for (i64 i = 0; i < relexed_count; i += 1){
+                    relexed_tokens[i].pos += relex_range.first;
+                }
+                token_chunks_replace(ptr, scratch, replaced, relexed_tokens, relexed_count, text_shift);
                 
-                Token *old_tokens = ptr->tokens;
-                block_copy_array_shift(new_tokens, old_tokens, head, 0);
-                token_fill_memory_from_list(new_tokens + replaced.first, &relex_list, relexed_count);
-                for (i64 i = 0, index = replaced.first; i < relexed_count; i += 1, index += 1){
-                    new_tokens[index].pos += relex_range.first;
+                // NOTE(allen): The code index only has to look again at the
+                // tokens that were relexed and the text that was put in.
+                i64 dirty_max = new_range.max;
+                if (relexed_count > 0){
+                    Token *last = &relexed_tokens[relexed_count - 1];
+                    dirty_max = Max(dirty_max, last->pos + last->size);
                 }
-                for (i64 i = tail.first; i < tail.one_past_last; i += 1){
-                    old_tokens[i].pos += text_shift;
+                Range_i64 dirty = Ii64(relex_range.first, dirty_max);
+                if (index_is_stale){
+                    buffer_mark_as_modified(buffer_id);
+                }
+                else{
+                    buffer_mark_as_modified(buffer_id, old_range, insert_size, dirty);
                 }
-                block_copy_array_shift(new_tokens, ptr->tokens, tail, tail_shift);
-                
-                base_free(allocator, ptr->tokens);
-                
-                ptr->tokens = new_tokens;
-                ptr->count = new_tokens_count;
-                ptr->max = new_tokens_count;
-                
-                buffer_mark_as_modified(buffer_id);
             }
         }
     }
     
     if (do_full_relex){
-        *lex_task_ptr = async_task_no_dep(&global_async_system, do_full_lex_async,
-                                          make_data_struct(&buffer_id));
+        // NOTE(allen): The lex pipeline indexes the buffer again when it is done.
+        buffer_unmark_as_modified(buffer_id);
+        buffer_start_lex_pipeline(app, buffer_id);
     }
     
     // no meaning for return
@@ -1058,10 +1266,10 @@ BUFFER_HOOK_SIG(default_end_buffer){
     if (lex_task_ptr != 0){
         async_task_cancel(app, &global_async_system, *lex_task_ptr);
     }
+    buffer_cancel_index_stages(app, buffer_id);
     buffer_unmark_as_modified(buffer_id);
-    code_index_lock();
     code_index_erase_file(buffer_id);
-    code_index_unlock();
+    trigram_index_release(app, buffer_id);
     // no meaning for return
     return(0);
 }
@@ -42,6 +42,8 @@
 #include "4coder_delta_rule.h"
 #include "4coder_layout_rule.h"
 #include "4coder_code_index.h"
+#include "4coder_code_index_cache.h"
+#include "4coder_trigram_index.h"
 #include "4coder_draw.h"
 #include "4coder_insertion.h"
 #include "4coder_command_map.h"
@@ -123,6 +125,9 @@
 #include "4coder_jump_sticky.cpp"
 #include "4coder_jump_lister.cpp"
 #include "4coder_code_index_listers.cpp"
+#include "4coder_code_index_cache.cpp"
+#include "4coder_parallel_lex.cpp"
+#include "4coder_trigram_index.cpp"
 #include "4coder_log_parser.cpp"
 #include "4coder_keyboard_macro.cpp"
 #include "4coder_cli_command.cpp"
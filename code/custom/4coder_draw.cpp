@@ -578,6 +578,25 @@ draw_cpp_token_colors(Application_Links *app, Text_Layout_ID text_layout_id, Tok
     }
 }
 
+function void
+draw_cpp_token_colors(Application_Links *app, Text_Layout_ID text_layout_id, Token_Chunks *chunks){
+    Range_i64 visible_range = text_layout_get_visible_range(app, text_layout_id);
+    i64 first_index = token_index_from_pos(chunks, visible_range.first);
+    Token_Iterator_Chunks it = token_iterator_index(0, chunks, first_index);
+    for (;;){
+        Token *token = token_it_read(&it);
+        if (token->pos >= visible_range.one_past_last){
+            break;
+        }
+        FColor color = get_token_color_cpp(*token);
+        ARGB_Color argb = fcolor_resolve(color);
+        paint_text_color(app, text_layout_id, Ii64_size(token->pos, token->size), argb);
+        if (!token_it_inc_all(&it)){
+            break;
+        }
+    }
+}
+
 function void
 draw_whitespace_highlight(Application_Links *app, Text_Layout_ID text_layout_id, Token_Array *array, f32 roundness){
     Range_i64 visible_range = text_layout_get_visible_range(app, text_layout_id);
@@ -599,6 +618,27 @@ draw_whitespace_highlight(Application_Links *app, Text_Layout_ID text_layout_id,
     }
 }
 
+function void
+draw_whitespace_highlight(Application_Links *app, Text_Layout_ID text_layout_id, Token_Chunks *chunks, f32 roundness){
+    Range_i64 visible_range = text_layout_get_visible_range(app, text_layout_id);
+    i64 first_index = token_index_from_pos(chunks, visible_range.first);
+    Token_Iterator_Chunks it = token_iterator_index(0, chunks, first_index);
+    for (;;){
+        Token *token = token_it_read(&it);
+        if (token->pos >= visible_range.one_past_last){
+            break;
+        }
+        if (token->kind == TokenBaseKind_Whitespace){
+            Range_i64 range = Ii64(token);
+            draw_character_block(app, text_layout_id, range, roundness,
+                                 fcolor_id(defcolor_highlight_white));
+        }
+        if (!token_it_inc_all(&it)){
+            break;
+        }
+    }
+}
+
 function void
 draw_whitespace_highlight(Application_Links *app, Buffer_ID buffer, Text_Layout_ID text_layout_id, f32 roundness){
     Range_i64 visible_range = text_layout_get_visible_range(app, text_layout_id);
@@ -664,6 +704,47 @@ draw_comment_highlights(Application_Links *app, Buffer_ID buffer, Text_Layout_ID
     }
 }
 
+function void
+draw_comment_highlights(Application_Links *app, Buffer_ID buffer, Text_Layout_ID text_layout_id,
+                        Token_Chunks *chunks, Comment_Highlight_Pair *pairs, i32 pair_count){
+    Scratch_Block scratch(app);
+    Range_i64 visible_range = text_layout_get_visible_range(app, text_layout_id);
+    i64 first_index = token_index_from_pos(chunks, visible_range.first);
+    Token_Iterator_Chunks it = token_iterator_index(buffer, chunks, first_index);
+    for (;;){
+        Temp_Memory_Block temp(scratch);
+        Token *token = token_it_read(&it);
+        if (token->pos >= visible_range.one_past_last){
+            break;
+        }
+        String_Const_u8 tail = {};
+        if (token_it_check_and_get_lexeme(app, scratch, &it, TokenBaseKind_Comment, &tail)){
+            for (i64 index = token->pos;
+                 tail.size > 0;
+                 tail = string_skip(tail, 1), index += 1){
+                Comment_Highlight_Pair *pair = pairs;
+                for (i32 i = 0; i < pair_count; i += 1, pair += 1){
+                    u64 needle_size = pair->needle.size;
+                    if (needle_size == 0){
+                        continue;
+                    }
+                    String_Const_u8 prefix = string_prefix(tail, needle_size);
+                    if (string_match(prefix, pair->needle)){
+                        Range_i64 range = Ii64_size(index, needle_size);
+                        paint_text_color(app, text_layout_id, range, pair->color);
+                        tail = string_skip(tail, needle_size - 1);
+                        index += needle_size - 1;
+                        break;
+                    }
+                }
+            }
+        }
+        if (!token_it_inc_non_whitespace(&it)){
+            break;
+        }
+    }
+}
+
 function Range_i64_Array
 get_enclosure_ranges(Application_Links *app, Arena *arena, Buffer_ID buffer, i64 pos, u32 flags){
     Range_i64_Array array = {};
@@ -760,9 +841,9 @@ draw_scope_highlight(Application_Links *app, Buffer_ID buffer, Text_Layout_ID te
 function void
 draw_paren_highlight(Application_Links *app, Buffer_ID buffer, Text_Layout_ID text_layout_id,
                      i64 pos, ARGB_Color *colors, i32 color_count){
-    Token_Array token_array = get_token_array_from_buffer(app, buffer);
-    if (token_array.tokens != 0){
-        Token_Iterator_Array it = token_iterator_pos(0, &token_array, pos);
+    Token_Chunks *token_chunks = get_token_chunks_from_buffer(app, buffer);
+    if (token_chunks != 0){
+        Token_Iterator_Chunks it = token_iterator_pos(0, token_chunks, pos);
         Token *token = token_it_read(&it);
         if (token != 0 && token->kind == TokenBaseKind_ParentheticalOpen){
             pos = token->pos + token->size;
@@ -12,18 +12,108 @@
 #if !defined(FCODER_HASH_FUNCTIONS_CPP)
 #define FCODER_HASH_FUNCTIONS_CPP
 
+// NOTE(allen): The mixing steps of wyhash (final version 4), a 64x64->128 bit
+// multiply folded back to 64 bits.
+static void
+table_hash__mum(u64 *a, u64 *b){
+#if COMPILER_CL && ARCH_X64
+    u64 hi = 0;
+    u64 lo = _umul128(*a, *b, &hi);
+#elif COMPILER_CL || ARCH_32BIT
+    u64 ha = *a >> 32;
+    u64 hb = *b >> 32;
+    u64 la = (u32)*a;
+    u64 lb = (u32)*b;
+    u64 rh = ha*hb;
+    u64 rm0 = ha*lb;
+    u64 rm1 = hb*la;
+    u64 rl = la*lb;
+    u64 t = rl + (rm0 << 32);
+    u64 c = (t < rl);
+    u64 lo = t + (rm1 << 32);
+    c += (lo < t);
+    u64 hi = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#else
+    __uint128_t r = (__uint128_t)(*a)*(*b);
+    u64 lo = (u64)r;
+    u64 hi = (u64)(r >> 64);
+#endif
+    *a = lo;
+    *b = hi;
+}
+static u64
+table_hash__mix(u64 a, u64 b){
+    table_hash__mum(&a, &b);
+    return(a ^ b);
+}
+
+global_const u64 table_hash_secret[4] = {
+    0x2d358dccaa6c78a5ULL, 0x8bb84b93962eacc9ULL,
+    0x4b33a62ed433d4a3ULL, 0x4d5a2da51de1aa47ULL,
+};
+
+// NOTE(allen): Unaligned reads, the memcpy turns into a single load.
+static u64
+table_hash__read_u64(u8 *p){
+    u64 result = 0;
+#if COMPILER_CL
+    result = *(u64*)p;
+#else
+    __builtin_memcpy(&result, p, 8);
+#endif
+    return(result);
+}
+static u64
+table_hash__read_u32(u8 *p){
+    u32 result = 0;
+#if COMPILER_CL
+    result = *(u32*)p;
+#else
+    __builtin_memcpy(&result, p, 4);
+#endif
+    return(result);
+}
+
+// NOTE(allen): wyhash, reads eight bytes at a time and mixes sixteen bytes per
+// multiply.
 static u64
 table_hash_u8(u8 *v, u64 size){
-    u64 hash = 0;
-    for (u8 *p = v, *e = v + size; p < e; p += 1){
-        u8 k = *p;
-        k *= 81;
-        k = ((u8)(k << 4)) | ((u8)(k >> 4));
-        hash ^= k;
-        hash *= 11;
-        hash += 237;
+    u8 *p = v;
+    u64 seed = table_hash__mix(table_hash_secret[0], table_hash_secret[1]);
+    u64 a = 0;
+    u64 b = 0;
+    if (size <= 16){
+        if (size >= 4){
+            u64 shift = (size >> 3) << 2;
+            a = (table_hash__read_u32(p) << 32) | table_hash__read_u32(p + shift);
+            b = (table_hash__read_u32(p + size - 4) << 32) | table_hash__read_u32(p + size - 4 - shift);
+        }
+        else if (size > 0){
+            a = (((u64)p[0]) << 16) | (((u64)p[size >> 1]) << 8) | p[size - 1];
+        }
     }
-    return(hash);
+    else{
+        u64 i = size;
+        if (i >= 48){
+            u64 see1 = seed;
+            u64 see2 = seed;
+            for (;i >= 48; i -= 48, p += 48){
+                seed = table_hash__mix(table_hash__read_u64(p) ^ table_hash_secret[1], table_hash__read_u64(p + 8) ^ seed);
+                see1 = table_hash__mix(table_hash__read_u64(p + 16) ^ table_hash_secret[2], table_hash__read_u64(p + 24) ^ see1);
+                see2 = table_hash__mix(table_hash__read_u64(p + 32) ^ table_hash_secret[3], table_hash__read_u64(p + 40) ^ see2);
+            }
+            seed ^= see1 ^ see2;
+        }
+        for (;i > 16; i -= 16, p += 16){
+            seed = table_hash__mix(table_hash__read_u64(p) ^ table_hash_secret[1], table_hash__read_u64(p + 8) ^ seed);
+        }
+        a = table_hash__read_u64(p + i - 16);
+        b = table_hash__read_u64(p + i - 8);
+    }
+    a ^= table_hash_secret[1];
+    b ^= seed;
+    table_hash__mum(&a, &b);
+    return(table_hash__mix(a ^ table_hash_secret[0] ^ size, b ^ table_hash_secret[1]));
 }
 static u64
 table_hash_u16(u16 *v, u64 size){
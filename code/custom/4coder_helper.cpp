@@ -54,9 +54,26 @@ get_token_array_from_buffer(Application_Links *app, Buffer_ID buffer){
     if (lex_task_ptr != 0){
         async_task_wait(app, &global_async_system, *lex_task_ptr);
     }
-    Token_Array *ptr = scope_attachment(app, scope, attachment_tokens, Token_Array);
+    Token_Chunks *ptr = scope_attachment(app, scope, attachment_tokens, Token_Chunks);
     if (ptr != 0){
-        result = *ptr;
+        result = token_chunks_flat(ptr);
+    }
+    return(result);
+}
+
+// NOTE(allen): Reading the chunks directly skips the copy that a Token_Array
+// needs after every edit, so code that runs every frame should prefer this.
+function Token_Chunks*
+get_token_chunks_from_buffer(Application_Links *app, Buffer_ID buffer){
+    Token_Chunks *result = 0;
+    Managed_Scope scope = buffer_get_managed_scope(app, buffer);
+    Async_Task *lex_task_ptr = scope_attachment(app, scope, buffer_lex_task, Async_Task);
+    if (lex_task_ptr != 0){
+        async_task_wait(app, &global_async_system, *lex_task_ptr);
+    }
+    Token_Chunks *ptr = scope_attachment(app, scope, attachment_tokens, Token_Chunks);
+    if (ptr != 0 && ptr->count > 0){
+        result = ptr;
     }
     return(result);
 }
@@ -615,32 +632,30 @@ boundary_inside_quotes(Application_Links *app, Buffer_ID buffer, Side side, Scan
 function i64
 boundary_token(Application_Links *app, Buffer_ID buffer, Side side, Scan_Direction direction, i64 pos){
     i64 result = boundary_non_whitespace(app, buffer, side, direction, pos);
-    Token_Array tokens = get_token_array_from_buffer(app, buffer);
-    if (tokens.tokens != 0){
+    Token_Chunks *tokens = get_token_chunks_from_buffer(app, buffer);
+    if (tokens != 0){
         switch (direction){
             case Scan_Forward:
             {
                 i64 buffer_size = buffer_get_size(app, buffer);
                 result = buffer_size;
-                if (tokens.count > 0){
-                    Token_Iterator_Array it = token_iterator_pos(0, &tokens, pos);
-                    Token *token = token_it_read(&it);
-                    if (token->kind == TokenBaseKind_Whitespace){
-                        token_it_inc_non_whitespace(&it);
-                        token = token_it_read(&it);
+                Token_Iterator_Chunks it = token_iterator_pos(0, tokens, pos);
+                Token *token = token_it_read(&it);
+                if (token->kind == TokenBaseKind_Whitespace){
+                    token_it_inc_non_whitespace(&it);
+                    token = token_it_read(&it);
+                }
+                if (token != 0){
+                    if (side == Side_Max){
+                        result = token->pos + token->size;
                     }
-                    if (token != 0){
-                        if (side == Side_Max){
-                            result = token->pos + token->size;
+                    else{
+                        if (token->pos <= pos){
+                            token_it_inc_non_whitespace(&it);
+                            token = token_it_read(&it);
                         }
-                        else{
-                            if (token->pos <= pos){
-                                token_it_inc_non_whitespace(&it);
-                                token = token_it_read(&it);
-                            }
-                            if (token != 0){
-                                result = token->pos;
-                            }
+                        if (token != 0){
+                            result = token->pos;
                         }
                     }
                 }
@@ -649,28 +664,26 @@ boundary_token(Application_Links *app, Buffer_ID buffer, Side side, Scan_Directi
             case Scan_Backward:
             {
                 result = 0;
-                if (tokens.count > 0){
-                    Token_Iterator_Array it = token_iterator_pos(0, &tokens, pos);
-                    Token *token = token_it_read(&it);
-                    if (token->kind == TokenBaseKind_Whitespace){
-                        token_it_dec_non_whitespace(&it);
-                        token = token_it_read(&it);
-                    }
-                    if (token != 0){
-                        if (side == Side_Min){
-                            if (token->pos >= pos){
-                                token_it_dec_non_whitespace(&it);
-                                token = token_it_read(&it);
-                            }
-                            result = token->pos;
+                Token_Iterator_Chunks it = token_iterator_pos(0, tokens, pos);
+                Token *token = token_it_read(&it);
+                if (token->kind == TokenBaseKind_Whitespace){
+                    token_it_dec_non_whitespace(&it);
+                    token = token_it_read(&it);
+                }
+                if (token != 0){
+                    if (side == Side_Min){
+                        if (token->pos >= pos){
+                            token_it_dec_non_whitespace(&it);
+                            token = token_it_read(&it);
                         }
-                        else{
-                            if (token->pos + token->size >= pos){
-                                token_it_dec_non_whitespace(&it);
-                                token = token_it_read(&it);
-                            }
-                            result = token->pos + token->size;
+                        result = token->pos;
+                    }
+                    else{
+                        if (token->pos + token->size >= pos){
+                            token_it_dec_non_whitespace(&it);
+                            token = token_it_read(&it);
                         }
+                        result = token->pos + token->size;
                     }
                 }
             }break;
@@ -1085,6 +1098,27 @@ token_it_check_and_get_lexeme(Application_Links *app, Arena *arena, Token_Iterat
     return(result);
 }
 
+function String_Const_u8
+token_it_lexeme(Application_Links *app, Arena *arena, Token_Iterator_Chunks *it){
+    String_Const_u8 result = {};
+    Token *token = token_it_read(it);
+    if (token != 0){
+        result = push_token_lexeme(app, arena, (Buffer_ID)it->user_id, token);
+    }
+    return(result);
+}
+
+function b32
+token_it_check_and_get_lexeme(Application_Links *app, Arena *arena, Token_Iterator_Chunks *it, Token_Base_Kind kind, String_Const_u8 *lexeme_out){
+    Token *token = token_it_read(it);
+    b32 result = {};
+    if (token != 0 && token->kind == kind){
+        result = true;
+        *lexeme_out = push_token_lexeme(app, arena, (Buffer_ID)it->user_id, token);
+    }
+    return(result);
+}
+
 function String_Const_u8
 token_it_lexeme(Application_Links *app, Arena *arena, Token_Iterator_List *it){
     String_Const_u8 result = {};
@@ -1390,9 +1424,13 @@ find_all_matches_all_buffers(Application_Links *app, Arena *arena, String_Const_
          buffer = get_buffer_next(app, buffer, Access_Always)){
         String_Match_List buffer_matches = {};
         for (i32 i = 0; i < match_patterns.count; i += 1){
-            Range_i64 range = buffer_range(app, buffer);
-            String_Match_List pattern_matches = buffer_find_all_matches(app, arena, buffer, i, range, match_patterns.vals[i],
-                                                                        &character_predicate_alpha_numeric_underscore_utf8, Scan_Forward);
+            String_Match_List pattern_matches = {};
+            Range_i64_Array ranges = trigram_index_candidate_ranges(app, arena, buffer, match_patterns.vals[i]);
+            for (i32 j = 0; j < ranges.count; j += 1){
+                String_Match_List range_matches = buffer_find_all_matches(app, arena, buffer, i, ranges.ranges[j], match_patterns.vals[i],
+                                                                          &character_predicate_alpha_numeric_underscore_utf8, Scan_Forward);
+                pattern_matches = string_match_list_join(&pattern_matches, &range_matches);
+            }
             string_match_list_filter_flags(&pattern_matches, must_have_flags, must_not_have_flags);
             if (pattern_matches.count > 0){
                 if (buffer_matches.count == 0){
@@ -2367,9 +2405,9 @@ find_nest_side(Application_Links *app, Buffer_ID buffer, i64 pos,
     }
     
     Managed_Scope scope = buffer_get_managed_scope(app, buffer);
-    Token_Array *tokens = scope_attachment(app, scope, attachment_tokens, Token_Array);
+    Token_Chunks *tokens = scope_attachment(app, scope, attachment_tokens, Token_Chunks);
     if (tokens != 0 && tokens->count > 0){
-        Token_Iterator_Array it = token_iterator_pos(0, tokens, pos);
+        Token_Iterator_Chunks it = token_iterator_pos(0, tokens, pos);
         i32 level = 0;
         for (;;){
             Token *token = token_it_read(&it);
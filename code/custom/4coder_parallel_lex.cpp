@@ -0,0 +1,267 @@
+/*
+4coder_parallel_lex.cpp - Lexing one big buffer on several workers.
+*/
+
+// TOP
+
+// NOTE(allen): The buffer is split at line starts and every piece is lexed from
+// the root state as if the line start were the start of the file.  Each piece
+// keeps going past its end to the first token boundary at or after it, and marks
+// the lexer state every few tokens along the way.
+//  The pieces are then joined in order.  Where the state the left piece ended in
+// is the fresh state the right piece started in the right piece is taken as is,
+// otherwise lexing picks up from the left piece's state and runs until it lands
+// on a mark of the right piece with the same state, so the tokens always match
+// lexing the whole buffer in one go.
+#define parallel_lex_min_size MB(4)
+#define parallel_lex_min_piece_size MB(1)
+#define parallel_lex_mark_period 256
+
+struct Parallel_Lex_Mark{
+    Parallel_Lex_Mark *next;
+    Lex_State_Cpp state;
+    i64 token_count;
+};
+
+struct Parallel_Lex_Piece{
+    Async_Task task;
+    b32 *cancel_signal;
+    String_Const_u8 contents;
+    Range_i64 range;
+    Arena arena;
+    Token_List list;
+    Parallel_Lex_Mark *first_mark;
+    Parallel_Lex_Mark *last_mark;
+    b32 finished;
+};
+
+struct Parallel_Lex{
+    Parallel_Lex_Piece *pieces;
+    i32 piece_count;
+};
+
+////////////////////////////////
+
+// NOTE(allen): A piece starts after a newline that has no backslash in front of
+// it and is not followed by whitespace, so the only tokens that run across the
+// start of a piece are block comments and raw strings.
+function i64
+parallel_lex_split_point(String_Const_u8 contents, i64 pos){
+    i64 result = (i64)contents.size;
+    for (i64 i = clamp_bot(1, pos); i < (i64)contents.size; i += 1){
+        if (contents.str[i - 1] == '\n' && !character_is_whitespace(contents.str[i])){
+            i64 j = i - 2;
+            if (j >= 0 && contents.str[j] == '\r'){
+                j -= 1;
+            }
+            if (j < 0 || contents.str[j] != '\\'){
+                result = i;
+                break;
+            }
+        }
+    }
+    return(result);
+}
+
+function b32
+parallel_lex_state_match(Lex_State_Cpp *a, Lex_State_Cpp *b){
+    return(a->ptr == b->ptr &&
+           a->flags_ZF0 == b->flags_ZF0 &&
+           a->flags_KF0 == b->flags_KF0 &&
+           a->flags_KB0 == b->flags_KB0);
+}
+
+function void
+parallel_lex_push_mark(Parallel_Lex_Piece *piece, Lex_State_Cpp *state){
+    Parallel_Lex_Mark *mark = push_array(&piece->arena, Parallel_Lex_Mark, 1);
+    sll_queue_push(piece->first_mark, piece->last_mark, mark);
+    block_copy_struct(&mark->state, state);
+    mark->token_count = piece->list.total_count;
+}
+
+function void
+parallel_lex_piece__inner(Async_Context *actx, Parallel_Lex_Piece *piece){
+    ProfileScope(actx->app, "async lex piece");
+    
+    Lex_State_Cpp state = {};
+    lex_full_input_cpp_init(&state, piece->contents);
+    u8 *first = piece->contents.str + piece->range.first;
+    state.delim_first = first;
+    state.delim_one_past_last = first;
+    state.emit_ptr = first;
+    state.ptr = first;
+    parallel_lex_push_mark(piece, &state);
+    
+    u8 *end_ptr = piece->contents.str + piece->range.one_past_last;
+    b32 is_last = (end_ptr == state.opl_ptr);
+    b32 canceled = false;
+    for (;is_last || state.ptr < end_ptr;){
+        u64 max = parallel_lex_mark_period;
+        if (!is_last){
+            // NOTE(allen): Close to the end take fewer tokens at a time so the
+            // lexer stops on the first token boundary past the end.
+            i64 remaining = (i64)(end_ptr - state.ptr);
+            max = clamp(1, remaining/16, parallel_lex_mark_period);
+        }
+        b32 done = lex_full_input_cpp_breaks(&piece->arena, &piece->list, &state, max);
+        parallel_lex_push_mark(piece, &state);
+        if (done){
+            break;
+        }
+        if (async_check_canceled(actx) || atomic_read_b32(piece->cancel_signal)){
+            canceled = true;
+            break;
+        }
+    }
+    
+    piece->finished = !canceled;
+}
+
+function void
+parallel_lex_piece_async(Async_Context *actx, String_Const_u8 data){
+    if (data.size == sizeof(Parallel_Lex_Piece*)){
+        Parallel_Lex_Piece *piece = *(Parallel_Lex_Piece**)data.str;
+        parallel_lex_piece__inner(actx, piece);
+    }
+}
+
+// NOTE(allen): Puts the tokens of src from first_index on at the end of dst
+// without copying them, so src has to stay around as long as dst is used.
+function void
+parallel_lex_append(Arena *arena, Token_List *dst, Token_List *src, i64 first_index){
+    i64 skip = first_index;
+    for (Token_Block *block = src->first;
+         block != 0;
+         block = block->next){
+        if (skip >= block->count){
+            skip -= block->count;
+        }
+        else{
+            Token_Block *view = push_array_zero(arena, Token_Block, 1);
+            view->tokens = block->tokens + skip;
+            view->count = block->count - skip;
+            view->max = view->count;
+            zdll_push_back(dst->first, dst->last, view);
+            dst->node_count += 1;
+            dst->total_count += view->count;
+            skip = 0;
+        }
+    }
+}
+
+function b32
+parallel_lex_stitch(Async_Context *actx, Arena *arena, Parallel_Lex *lex, Token_List *list_out){
+    ProfileScope(actx->app, "async lex stitch");
+    
+    Token_List list = {};
+    Parallel_Lex_Piece *piece = &lex->pieces[0];
+    parallel_lex_append(arena, &list, &piece->list, 0);
+    Lex_State_Cpp state = piece->last_mark->state;
+    b32 hit_eof = (lex->piece_count == 1);
+    b32 canceled = false;
+    
+    for (i32 i = 1; i < lex->piece_count && !hit_eof && !canceled; i += 1){
+        piece = &lex->pieces[i];
+        Parallel_Lex_Mark *mark = piece->first_mark;
+        b32 synced = false;
+        for (i64 counter = 1;; counter += 1){
+            for (;mark != 0 && mark->state.ptr < state.ptr; mark = mark->next);
+            if (mark == 0){
+                break;
+            }
+            // NOTE(allen): A mark at the very end may or may not have the end of
+            // file token behind it, so it is never a place to sync up.
+            if (mark->state.ptr < state.opl_ptr && parallel_lex_state_match(&mark->state, &state)){
+                synced = true;
+                break;
+            }
+            if (lex_full_input_cpp_breaks(arena, &list, &state, 1)){
+                hit_eof = true;
+                break;
+            }
+            if (counter%4096 == 0 && async_check_canceled(actx)){
+                canceled = true;
+                break;
+            }
+        }
+        if (synced){
+            parallel_lex_append(arena, &list, &piece->list, mark->token_count);
+            state = piece->last_mark->state;
+            hit_eof = (i + 1 == lex->piece_count);
+        }
+    }
+    
+    if (!canceled){
+        *list_out = list;
+    }
+    return(!canceled);
+}
+
+// NOTE(allen): Lexes contents on the calling task and as many workers as it is
+// worth splitting the buffer for.  The result points into the memory of the
+// pieces, so it is good until parallel_lex_release.
+function b32
+parallel_lex_run(Async_Context *actx, Arena *arena, String_Const_u8 contents,
+                 Parallel_Lex *lex, Token_List *list_out){
+    ProfileScope(actx->app, "async lex parallel");
+    Async_System *async_system = &global_async_system;
+    
+    i64 size = (i64)contents.size;
+    i32 piece_count_max = (i32)clamp(1, size/parallel_lex_min_piece_size, async_system->thread_count);
+    i64 *starts = push_array(arena, i64, piece_count_max);
+    i32 piece_count = 0;
+    starts[piece_count] = 0;
+    piece_count += 1;
+    for (i32 i = 1; i < piece_count_max; i += 1){
+        i64 pos = parallel_lex_split_point(contents, size*i/piece_count_max);
+        if (pos < size && pos > starts[piece_count - 1]){
+            starts[piece_count] = pos;
+            piece_count += 1;
+        }
+    }
+    
+    block_zero_struct(lex);
+    lex->pieces = push_array_zero(arena, Parallel_Lex_Piece, piece_count);
+    lex->piece_count = piece_count;
+    for (i32 i = 0; i < piece_count; i += 1){
+        Parallel_Lex_Piece *piece = &lex->pieces[i];
+        piece->cancel_signal = &actx->thread->cancel_signal;
+        piece->contents = contents;
+        piece->range.first = starts[i];
+        piece->range.one_past_last = (i + 1 < piece_count)?starts[i + 1]:size;
+        piece->arena = make_arena_system(KB(64));
+    }
+    
+    Async_Priority priority = actx->thread->node->priority;
+    for (i32 i = 1; i < piece_count; i += 1){
+        Parallel_Lex_Piece *piece = &lex->pieces[i];
+        piece->task = async_task_no_dep(async_system, parallel_lex_piece_async,
+                                        make_data_struct(&piece), priority);
+    }
+    parallel_lex_piece__inner(actx, &lex->pieces[0]);
+    for (i32 i = 1; i < piece_count; i += 1){
+        async_task_join(actx, async_system, lex->pieces[i].task);
+    }
+    
+    b32 result = true;
+    for (i32 i = 0; i < piece_count; i += 1){
+        if (!lex->pieces[i].finished){
+            result = false;
+            break;
+        }
+    }
+    if (result){
+        result = parallel_lex_stitch(actx, arena, lex, list_out);
+    }
+    return(result);
+}
+
+function void
+parallel_lex_release(Parallel_Lex *lex){
+    for (i32 i = 0; i < lex->piece_count; i += 1){
+        linalloc_clear(&lex->pieces[i].arena);
+    }
+    block_zero_struct(lex);
+}
+
+// BOTTOM
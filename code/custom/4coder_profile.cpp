@@ -31,6 +31,15 @@ prof__get_thread(Profile_Global_List *list, i32 thread_id){
     return(result);
 }
 
+function i32
+prof__thread_id(Thread_Context *tctx){
+    i32 result = tctx->prof_thread_id;
+    if (result == 0){
+        result = system_thread_get_id();
+    }
+    return(result);
+}
+
 function void
 profile_clear(Profile_Global_List *list){
     Mutex_Lock lock(list->mutex);
@@ -53,7 +62,7 @@ profile_thread_flush(Thread_Context *tctx, Profile_Global_List *list){
     if (tctx->prof_record_count > 0){
         Mutex_Lock lock(list->mutex);
         if (list->disable_bits == 0){
-            Profile_Thread* thread = prof__get_thread(list, system_thread_get_id());
+            Profile_Thread* thread = prof__get_thread(list, prof__thread_id(tctx));
             
             Arena_Node* node = push_array(&list->node_arena, Arena_Node, 1);
             sll_queue_push(list->first_arena, list->last_arena, node);
@@ -84,7 +93,7 @@ profile_thread_flush(Thread_Context *tctx, Profile_Global_List *list){
 function void
 profile_thread_set_name(Thread_Context *tctx, Profile_Global_List *list, String_Const_u8 name){
     Mutex_Lock lock(list->mutex);
-    Profile_Thread* thread = prof__get_thread(list, system_thread_get_id());
+    Profile_Thread* thread = prof__get_thread(list, prof__thread_id(tctx));
     thread->name = name;
 }
 
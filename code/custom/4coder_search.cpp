@@ -69,10 +69,305 @@ print_all_matches_all_buffers(Application_Links *app, String_Const_u8 pattern, S
     print_all_matches_all_buffers(app, array, must_have_flags, must_not_have_flags, out_buffer_id);
 }
 
+////////////////////////////////
+
+// NOTE(allen): The search job lists the matches in all buffers into the out
+// buffer from the async workers.  A worker takes a batch of buffers at a time
+// and copies their text while it holds the frame mutex, then matches on the
+// copies without it.  The results are written out in buffer order as soon as
+// all of the buffers before them are done, so the first lines show up after the
+// first batch instead of after the whole search.
+#define search_job_batch_size KB(256)
+#define search_job_batch_max_count 64
+
+global Search_Job global_search_job = {};
+
+// NOTE(allen): Takes the union of the parts of the buffer the trigram index
+// leaves for each pattern, grown out to whole lines, and copies them.  Called
+// with the frame mutex held.
+internal Search_Job_Chunk*
+search_job_push_chunks(Application_Links *app, Arena *arena, Search_Job *job, Buffer_ID buffer, u64 *size_out){
+    Scratch_Block scratch(app, arena);
+    Range_i64_Array ranges = {};
+    for (i32 i = 0; i < job->patterns.count; i += 1){
+        Range_i64_Array pattern_ranges = trigram_index_candidate_ranges(app, scratch, buffer, job->patterns.vals[i]);
+        Range_i64_Array merged = {};
+        merged.ranges = push_array(scratch, Range_i64, ranges.count + pattern_ranges.count);
+        for (i32 a = 0, b = 0; a < ranges.count || b < pattern_ranges.count;){
+            Range_i64 range = {};
+            if (b == pattern_ranges.count ||
+                (a < ranges.count && ranges.ranges[a].min < pattern_ranges.ranges[b].min)){
+                range = ranges.ranges[a];
+                a += 1;
+            }
+            else{
+                range = pattern_ranges.ranges[b];
+                b += 1;
+            }
+            if (merged.count > 0 && merged.ranges[merged.count - 1].max >= range.min){
+                merged.ranges[merged.count - 1].max = Max(merged.ranges[merged.count - 1].max, range.max);
+            }
+            else{
+                merged.ranges[merged.count] = range;
+                merged.count += 1;
+            }
+        }
+        ranges = merged;
+    }
+    
+    Search_Job_Chunk *first = 0;
+    Search_Job_Chunk *last = 0;
+    u64 size = 0;
+    for (i32 i = 0; i < ranges.count; i += 1){
+        i64 first_line = get_line_number_from_pos(app, buffer, ranges.ranges[i].min);
+        Range_i64 range = Ii64(get_line_start_pos(app, buffer, first_line),
+                               get_line_end_pos_from_pos(app, buffer, ranges.ranges[i].max));
+        if (last != 0 && last->range.max >= range.min){
+            last->range.max = Max(last->range.max, range.max);
+        }
+        else{
+            Search_Job_Chunk *chunk = push_array_zero(arena, Search_Job_Chunk, 1);
+            sll_queue_push(first, last, chunk);
+            chunk->range = range;
+            chunk->first_line = first_line;
+        }
+    }
+    for (Search_Job_Chunk *chunk = first;
+         chunk != 0;
+         chunk = chunk->next){
+        chunk->text = push_buffer_range(app, arena, buffer, chunk->range);
+        size += chunk->text.size;
+    }
+    
+    *size_out = size;
+    return(first);
+}
+
+internal String_Const_u8
+search_job_format_matches(Application_Links *app, Arena *arena, Search_Job *job,
+                          Buffer_ID buffer, String_Const_u8 file_name, Search_Job_Chunk *chunks,
+                          i32 *count_out){
+    Scratch_Block scratch(app, arena);
+    List_String_Const_u8 lines = {};
+    i32 count = 0;
+    for (Search_Job_Chunk *chunk = chunks;
+         chunk != 0;
+         chunk = chunk->next){
+        String_Const_u8 contents = chunk->text;
+        String_Match_List matches = {};
+        for (i32 i = 0; i < job->patterns.count; i += 1){
+            String_Match_List pattern_matches = string_find_all_matches(app, scratch, buffer, i, contents, chunk->range.min, job->patterns.vals[i],
+                                                                        &character_predicate_alpha_numeric_underscore_utf8, Scan_Forward);
+            string_match_list_filter_flags(&pattern_matches, job->must_have_flags, job->must_not_have_flags);
+            if (pattern_matches.count > 0){
+                if (matches.count == 0){
+                    matches = pattern_matches;
+                }
+                else{
+                    matches = string_match_list_merge_front_to_back(&matches, &pattern_matches);
+                }
+            }
+        }
+        
+        // NOTE(allen): The matches are in order, so the line of each one is found by
+        // counting on from the line of the one before it.
+        i64 line_number = chunk->first_line;
+        i64 line_start = 0;
+        i64 scan_pos = 0;
+        for (String_Match *node = matches.first;
+             node != 0;
+             node = node->next){
+            i64 pos = node->range.first - chunk->range.min;
+            for (;scan_pos < pos; scan_pos += 1){
+                if (contents.str[scan_pos] == '\n'){
+                    line_number += 1;
+                    line_start = scan_pos + 1;
+                }
+            }
+            i64 line_end = (i64)string_find_first(contents, (u64)line_start, '\n');
+            String_Const_u8 full_line_str = string_substring(contents, Ii64(line_start, line_end));
+            String_Const_u8 line_str = string_skip_chop_whitespace(full_line_str);
+            string_list_pushf(scratch, &lines, "%.*s:%d:%d: %.*s\n",
+                              string_expand(file_name), (i32)line_number, (i32)(pos - line_start + 1),
+                              string_expand(line_str));
+        }
+        count += matches.count;
+    }
+    
+    *count_out = count;
+    return(string_list_flatten(arena, lines));
+}
+
+// NOTE(allen): Writes out the results that all of the results before them are
+// done for.  Called with the frame mutex held.
+internal void
+search_job_flush(Application_Links *app, Search_Job *job){
+    Scratch_Block scratch(app);
+    List_String_Const_u8 list = {};
+    for (;job->next_flush < job->buffer_count && job->results[job->next_flush].finished;
+         job->next_flush += 1){
+        Search_Job_Result *result = &job->results[job->next_flush];
+        if (result->match_count > 0){
+            if (job->match_count > 0){
+                string_list_push(scratch, &list, string_u8_litexpr("\n"));
+            }
+            string_list_push(scratch, &list, result->text);
+            job->match_count += result->match_count;
+        }
+    }
+    if (job->next_flush == job->buffer_count && job->running_count == 0 && job->match_count == 0){
+        string_list_push(scratch, &list, string_u8_litexpr("no matches"));
+    }
+    
+    if (list.total_size > 0 && buffer_exists(app, job->out_buffer)){
+        String_Const_u8 text = string_list_flatten(scratch, list);
+        i64 size = buffer_get_size(app, job->out_buffer);
+        buffer_replace_range(app, job->out_buffer, Ii64(size), text);
+        animate_in_n_milliseconds(app, 0);
+        system_signal_step(0);
+    }
+}
+
+internal void
+search_job_worker__inner(Async_Context *actx, Search_Job_Worker *worker){
+    Application_Links *app = actx->app;
+    ProfileScope(app, "async search");
+    Search_Job *job = worker->job;
+    Arena *arena = &worker->arena;
+    
+    i32 batch_first = 0;
+    i32 batch_count = 0;
+    for (;;){
+        Scratch_Block scratch(app, arena);
+        Search_Job_Chunk **chunks = push_array_zero(scratch, Search_Job_Chunk*, search_job_batch_max_count);
+        String_Const_u8 *file_names = push_array_zero(scratch, String_Const_u8, search_job_batch_max_count);
+        
+        acquire_global_frame_mutex(app);
+        for (i32 i = 0; i < batch_count; i += 1){
+            job->results[batch_first + i].finished = true;
+        }
+        b32 canceled = async_check_canceled(actx);
+        if (!canceled){
+            search_job_flush(app, job);
+            
+            batch_first = job->next_buffer;
+            batch_count = 0;
+            u64 batch_size = 0;
+            for (;job->next_buffer < job->buffer_count &&
+                 batch_count < search_job_batch_max_count &&
+                 batch_size < search_job_batch_size;){
+                Buffer_ID buffer = job->buffers[job->next_buffer];
+                if (buffer_exists(app, buffer)){
+                    u64 size = 0;
+                    chunks[batch_count] = search_job_push_chunks(app, scratch, job, buffer, &size);
+                    file_names[batch_count] = push_buffer_file_name(app, scratch, buffer);
+                    if (file_names[batch_count].size == 0){
+                        file_names[batch_count] = push_buffer_unique_name(app, scratch, buffer);
+                    }
+                    batch_size += size;
+                }
+                job->next_buffer += 1;
+                batch_count += 1;
+            }
+        }
+        release_global_frame_mutex(app);
+        
+        if (canceled || batch_count == 0){
+            break;
+        }
+        
+        for (i32 i = 0; i < batch_count; i += 1){
+            Search_Job_Result *result = &job->results[batch_first + i];
+            result->text = search_job_format_matches(app, arena, job, job->buffers[batch_first + i],
+                                                     file_names[i], chunks[i], &result->match_count);
+            if (async_check_canceled(actx)){
+                break;
+            }
+        }
+    }
+    
+    acquire_global_frame_mutex(app);
+    job->running_count -= 1;
+    if (!async_check_canceled(actx)){
+        search_job_flush(app, job);
+    }
+    release_global_frame_mutex(app);
+}
+
+internal void
+search_job_worker_async(Async_Context *actx, String_Const_u8 data){
+    if (data.size == sizeof(Search_Job_Worker*)){
+        Search_Job_Worker *worker = *(Search_Job_Worker**)data.str;
+        search_job_worker__inner(actx, worker);
+    }
+}
+
+// NOTE(allen): Cancels the workers of the running search, if there is one, and
+// releases it.
+internal void
+search_job_stop(Application_Links *app){
+    Search_Job *job = &global_search_job;
+    for (i32 i = 0; i < job->worker_count; i += 1){
+        async_task_cancel(app, &global_async_system, job->workers[i].task);
+    }
+    for (i32 i = 0; i < job->worker_count; i += 1){
+        linalloc_clear(&job->workers[i].arena);
+    }
+    if (job->arena.base_allocator != 0){
+        linalloc_clear(&job->arena);
+    }
+    block_zero_struct(job);
+}
+
+internal void
+search_job_start(Application_Links *app, String_Const_u8_Array match_patterns, String_Match_Flag must_have_flags, String_Match_Flag must_not_have_flags, Buffer_ID out_buffer_id){
+    search_job_stop(app);
+    
+    Search_Job *job = &global_search_job;
+    job->arena = make_arena_system();
+    Arena *arena = &job->arena;
+    job->patterns.count = match_patterns.count;
+    job->patterns.vals = push_array(arena, String_Const_u8, match_patterns.count);
+    for (i32 i = 0; i < match_patterns.count; i += 1){
+        job->patterns.vals[i] = push_string_copy(arena, match_patterns.vals[i]);
+    }
+    job->must_have_flags = must_have_flags;
+    job->must_not_have_flags = must_not_have_flags;
+    job->out_buffer = out_buffer_id;
+    
+    i32 buffer_max = get_buffer_count(app);
+    job->buffers = push_array(arena, Buffer_ID, buffer_max);
+    for (Buffer_ID buffer = get_buffer_next(app, 0, Access_Always);
+         buffer != 0 && job->buffer_count < buffer_max;
+         buffer = get_buffer_next(app, buffer, Access_Always)){
+        if (buffer != out_buffer_id && !buffer_has_name_with_star(app, buffer)){
+            job->buffers[job->buffer_count] = buffer;
+            job->buffer_count += 1;
+        }
+    }
+    job->results = push_array_zero(arena, Search_Job_Result, job->buffer_count);
+    
+    Async_System *async_system = &global_async_system;
+    i32 worker_count = Min(async_system->thread_count, job->buffer_count);
+    job->worker_count = clamp_bot(1, worker_count);
+    job->running_count = job->worker_count;
+    job->workers = push_array_zero(arena, Search_Job_Worker, job->worker_count);
+    for (i32 i = 0; i < job->worker_count; i += 1){
+        Search_Job_Worker *worker = &job->workers[i];
+        worker->job = job;
+        worker->arena = make_arena_system(KB(64));
+        worker->task = async_task_no_dep(async_system, search_job_worker_async,
+                                         make_data_struct(&worker), AsyncPriority_High);
+    }
+}
+
 internal void
 print_all_matches_all_buffers_to_search(Application_Links *app, String_Const_u8_Array match_patterns, String_Match_Flag must_have_flags, String_Match_Flag must_not_have_flags, View_ID default_target_view){
+    search_job_stop(app);
     Buffer_ID search_buffer = create_or_switch_to_buffer_and_clear_by_name(app, search_name, default_target_view);
-    print_all_matches_all_buffers(app, match_patterns, must_have_flags, must_not_have_flags, search_buffer);
+    buffer_set_setting(app, search_buffer, BufferSetting_ReadOnly, true);
+    buffer_set_setting(app, search_buffer, BufferSetting_RecordsHistory, false);
+    search_job_start(app, match_patterns, must_have_flags, must_not_have_flags, search_buffer);
 }
 
 internal void
@@ -13,6 +13,48 @@ enum{
     ListAllLocationsFlag_MatchSubstring = 2,
 };
 
+struct Search_Job_Result{
+    String_Const_u8 text;
+    i32 match_count;
+    b32 finished;
+};
+
+// NOTE(allen): A run of whole lines from a buffer that the search looks in.
+struct Search_Job_Chunk{
+    Search_Job_Chunk *next;
+    Range_i64 range;
+    i64 first_line;
+    String_Const_u8 text;
+};
+
+struct Search_Job_Worker{
+    struct Search_Job *job;
+    Arena arena;
+    Async_Task task;
+};
+
+// NOTE(allen): Everything but the patterns and the buffer list is only touched
+// with the global frame mutex held.  Each result belongs to the worker that took
+// its buffer until it is marked finished.
+struct Search_Job{
+    Arena arena;
+    String_Const_u8_Array patterns;
+    String_Match_Flag must_have_flags;
+    String_Match_Flag must_not_have_flags;
+    Buffer_ID out_buffer;
+    
+    Buffer_ID *buffers;
+    Search_Job_Result *results;
+    i32 buffer_count;
+    i32 next_buffer;
+    i32 next_flush;
+    i32 match_count;
+    
+    Search_Job_Worker *workers;
+    i32 worker_count;
+    i32 running_count;
+};
+
 struct Word_Complete_Iterator{
     Application_Links *app;
     Arena *arena;
@@ -9,15 +9,102 @@ table_hash(String_Const_u8 key){
     return(table_hash_u8((u8*)key.str, key.size) | bit_64);
 }
 
-global_const u64 table_empty_slot = 0;
-global_const u64 table_erased_slot = 1;
-
 global_const u64 table_empty_key = 0;
 global_const u64 table_erased_key = max_u64;
 
 global_const u32 table_empty_u32_key = 0;
 global_const u32 table_erased_u32_key = max_u32;
 
+// NOTE(allen): The integer keyed tables probe linearly from key % slot_count,
+// with sentinel keys for empty and erased slots.  Their keys are mostly ids
+// handed out in order, which that way land in neighbouring slots.
+//
+// NOTE(allen): The tables keyed on strings have a control byte for every slot.
+// Zero is an empty slot, one is an erased slot, and a full slot has the top bit
+// set and seven bits of the hash in the rest, so zeroed memory is an empty
+// table.  Slots are probed in groups of sixteen, with one compare against the
+// control bytes of the whole group, and the groups are visited in triangular
+// steps, which covers them all because the group count is a power of two.  A
+// probe stops at the first group with an empty slot.
+
+global_const u8 table_ctrl_empty = 0;
+global_const u8 table_ctrl_erased = 1;
+
+#define table_group_size 16
+
+internal u8
+table__ctrl_from_hash(u64 hash){
+    return((u8)(0x80 | (hash & 0x7F)));
+}
+
+internal u32
+table__group_match(u8 *group, u8 ctrl){
+    u32 result = 0;
+#if ARCH_SSE2
+    __m128i g = _mm_loadu_si128((__m128i*)group);
+    result = (u32)_mm_movemask_epi8(_mm_cmpeq_epi8(g, _mm_set1_epi8((char)ctrl)));
+#else
+    for (u32 i = 0; i < table_group_size; i += 1){
+        if (group[i] == ctrl){
+            result |= (1 << i);
+        }
+    }
+#endif
+    return(result);
+}
+
+internal u32
+table__group_match_free(u8 *group){
+    u32 result = 0;
+#if ARCH_SSE2
+    __m128i g = _mm_loadu_si128((__m128i*)group);
+    result = (~(u32)_mm_movemask_epi8(g)) & 0xFFFF;
+#else
+    for (u32 i = 0; i < table_group_size; i += 1){
+        if ((group[i] & 0x80) == 0){
+            result |= (1 << i);
+        }
+    }
+#endif
+    return(result);
+}
+
+internal u32
+table__slot_count(u32 slot_count){
+    return(clamp_bot(table_group_size, round_up_pot_u32(slot_count)));
+}
+
+// NOTE(allen): Remembers the first free slot of the probe in the lookup, for an
+// insert to use.  Returns true when the group has an empty slot, which ends the
+// probe.
+internal b32
+table__probe_free(Table_Lookup *lookup, u8 *group, u32 first_index){
+    if (!lookup->found_empty_slot && !lookup->found_erased_slot){
+        u32 mask = table__group_match_free(group);
+        if (mask != 0){
+            u32 i = bit_scan_forward_u32(mask);
+            lookup->index = first_index + i;
+            if (group[i] == table_ctrl_empty){
+                lookup->found_empty_slot = true;
+            }
+            else{
+                lookup->found_erased_slot = true;
+            }
+        }
+    }
+    return(table__group_match(group, table_ctrl_empty) != 0);
+}
+
+// NOTE(allen): A slot whose group still has an empty slot was never stepped over
+// by a probe, so it can go straight back to empty instead of leaving a tombstone.
+internal b32
+table__erase_slot(u8 *ctrl, u32 index){
+    u8 *group = ctrl + (index & ~(table_group_size - 1));
+    b32 result = (table__group_match(group, table_ctrl_empty) != 0);
+    ctrl[index] = result?table_ctrl_empty:table_ctrl_erased;
+    return(result);
+}
+
 ////////////////////////////////
 
 internal Table_u64_u64
@@ -354,11 +441,12 @@ internal Table_Data_u64
 make_table_Data_u64__inner(Base_Allocator *allocator, u32 slot_count, String_Const_u8 location){
     Table_Data_u64 table = {};
     table.allocator = allocator;
-    slot_count = clamp_bot(8, slot_count);
-    String_Const_u8 mem = base_allocate__inner(allocator, slot_count*(sizeof(*table.hashes) + sizeof(*table.keys) + sizeof(*table.vals)), location);
+    slot_count = table__slot_count(slot_count);
+    String_Const_u8 mem = base_allocate__inner(allocator, slot_count*(sizeof(*table.ctrl) + sizeof(*table.hashes) + sizeof(*table.keys) + sizeof(*table.vals)), location);
     block_zero(mem.str, mem.size);
     table.memory = mem.str;
-    table.hashes = (u64*)table.memory;
+    table.ctrl = (u8*)table.memory;
+    table.hashes = (u64*)(table.ctrl + slot_count);
     table.keys = (String_Const_u8*)(table.hashes + slot_count);
     table.vals = (u64*)(table.keys + slot_count);
     table.slot_count = slot_count;
@@ -376,20 +464,23 @@ table_free(Table_Data_u64 *table){
 }
 
 internal Table_Lookup
-table_lookup(Table_Data_u64 *table, String_Const_u8 key){
+table_lookup(Table_Data_u64 *table, String_Const_u8 key, u64 hash){
     Table_Lookup result = {};
     
     if (table->slot_count > 0){
+        u8 *ctrl = table->ctrl;
         u64 *hashes = table->hashes;
-        u32 slot_count = table->slot_count;
+        u32 group_mask = table->slot_count/table_group_size - 1;
         
-        u64 hash = table_hash(key);
-        u32 first_index = hash % slot_count;
-        u32 index = first_index;
+        u32 group_index = (u32)(hash >> 7) & group_mask;
         result.hash = hash;
-        for (;;){
-            if (hash == hashes[index]){
-                if (data_match(key, table->keys[index])){
+        result.ctrl = table__ctrl_from_hash(hash);
+        for (u32 step = 1; step <= group_mask + 1; step += 1){
+            u32 first_index = group_index*table_group_size;
+            u8 *group = ctrl + first_index;
+            for (u32 mask = table__group_match(group, result.ctrl); mask != 0; mask &= mask - 1){
+                u32 index = first_index + bit_scan_forward_u32(mask);
+                if (hash == hashes[index] && data_match(key, table->keys[index])){
                     result.index = index;
                     result.found_match = true;
                     result.found_empty_slot = false;
@@ -397,32 +488,21 @@ table_lookup(Table_Data_u64 *table, String_Const_u8 key){
                     break;
                 }
             }
-            if (table_empty_slot == hashes[index]){
-                if (!result.found_erased_slot){
-                    result.index = index;
-                    result.found_empty_slot = true;
-                }
-                break;
-            }
-            if (table_erased_slot == hashes[index]){
-                if (!result.found_erased_slot){
-                    result.index = index;
-                    result.found_erased_slot = true;
-                }
-            }
-            index += 1;
-            if (index >= slot_count){
-                index = 0;
-            }
-            if (index == first_index){
+            if (result.found_match || table__probe_free(&result, group, first_index)){
                 break;
             }
+            group_index = (group_index + step) & group_mask;
         }
     }
     
     return(result);
 }
 
+internal Table_Lookup
+table_lookup(Table_Data_u64 *table, String_Const_u8 key){
+    return(table_lookup(table, key, table_hash(key)));
+}
+
 internal b32
 table_read(Table_Data_u64 *table, Table_Lookup lookup, u64 *val_out){
     b32 result = false;
@@ -452,6 +532,7 @@ table_read(Table_Data_u64 *table, String_Const_u8 key, u64 *val_out){
 internal void
 table_insert__inner(Table_Data_u64 *table, Table_Lookup lookup, String_Const_u8 key, u64 val){
     Assert(lookup.found_empty_slot || lookup.found_erased_slot);
+    table->ctrl[lookup.index] = lookup.ctrl;
     table->hashes[lookup.index] = lookup.hash;
     table->keys[lookup.index] = key;
     table->vals[lookup.index] = val;
@@ -466,11 +547,11 @@ table_rehash(Table_Data_u64 *dst, Table_Data_u64 *src){
     b32 result = false;
     u32 src_slot_count = src->slot_count;
     if ((dst->dirty_count + src->used_count)*8 < dst->slot_count*7){
-        u64 *src_hashes = src->hashes;
+        u8 *src_ctrl = src->ctrl;
         for (u32 i = 0; i < src_slot_count; i += 1){
-            if (HasFlag(src_hashes[i], bit_64)){
+            if (HasFlag(src_ctrl[i], 0x80)){
                 String_Const_u8 key = src->keys[i];
-                Table_Lookup lookup = table_lookup(dst, key);
+                Table_Lookup lookup = table_lookup(dst, key, src->hashes[i]);
                 table_insert__inner(dst, lookup, key, src->vals[i]);
             }
         }
@@ -494,7 +575,7 @@ table_insert(Table_Data_u64 *table, String_Const_u8 key, u64 val){
                 table_rehash(&new_table, table);
                 table_free(table);
                 *table = new_table;
-                lookup = table_lookup(table, key);
+                lookup = table_lookup(table, key, lookup.hash);
                 Assert(lookup.found_empty_slot);
             }
             table_insert__inner(table, lookup, key, val);
@@ -509,7 +590,10 @@ table_erase(Table_Data_u64 *table, String_Const_u8 key){
     b32 result = false;
     Table_Lookup lookup = table_lookup(table, key);
     if (lookup.found_match){
-        table->hashes[lookup.index] = table_erased_slot;
+        if (table__erase_slot(table->ctrl, lookup.index)){
+            table->dirty_count -= 1;
+        }
+        table->hashes[lookup.index] = 0;
         block_zero_struct(&table->keys[lookup.index]);
         table->vals[lookup.index] = 0;
         table->used_count -= 1;
@@ -520,6 +604,7 @@ table_erase(Table_Data_u64 *table, String_Const_u8 key){
 
 internal void
 table_clear(Table_Data_u64 *table){
+    block_zero_dynamic_array(table->ctrl, table->slot_count);
     block_zero_dynamic_array(table->hashes, table->slot_count);
     block_zero_dynamic_array(table->keys, table->slot_count);
     block_zero_dynamic_array(table->vals, table->slot_count);
@@ -702,11 +787,12 @@ internal Table_Data_Data
 make_table_Data_Data__inner(Base_Allocator *allocator, u32 slot_count, String_Const_u8 location){
     Table_Data_Data table = {};
     table.allocator = allocator;
-    slot_count = clamp_bot(8, slot_count);
-    String_Const_u8 mem = base_allocate__inner(allocator, slot_count*(sizeof(*table.hashes) + sizeof(*table.keys) + sizeof(*table.vals)), location);
+    slot_count = table__slot_count(slot_count);
+    String_Const_u8 mem = base_allocate__inner(allocator, slot_count*(sizeof(*table.ctrl) + sizeof(*table.hashes) + sizeof(*table.keys) + sizeof(*table.vals)), location);
     block_zero(mem.str, mem.size);
     table.memory = mem.str;
-    table.hashes = (u64*)table.memory;
+    table.ctrl = (u8*)table.memory;
+    table.hashes = (u64*)(table.ctrl + slot_count);
     table.keys = (String_Const_u8*)(table.hashes + slot_count);
     table.vals = (String_Const_u8*)(table.keys + slot_count);
     table.slot_count = slot_count;
@@ -724,20 +810,23 @@ table_free(Table_Data_Data *table){
 }
 
 internal Table_Lookup
-table_lookup(Table_Data_Data *table, String_Const_u8 key){
+table_lookup(Table_Data_Data *table, String_Const_u8 key, u64 hash){
     Table_Lookup result = {};
     
     if (table->slot_count > 0){
+        u8 *ctrl = table->ctrl;
         u64 *hashes = table->hashes;
-        u32 slot_count = table->slot_count;
+        u32 group_mask = table->slot_count/table_group_size - 1;
         
-        u64 hash = table_hash(key);
-        u32 first_index = hash % slot_count;
-        u32 index = first_index;
+        u32 group_index = (u32)(hash >> 7) & group_mask;
         result.hash = hash;
-        for (;;){
-            if (hash == hashes[index]){
-                if (data_match(key, table->keys[index])){
+        result.ctrl = table__ctrl_from_hash(hash);
+        for (u32 step = 1; step <= group_mask + 1; step += 1){
+            u32 first_index = group_index*table_group_size;
+            u8 *group = ctrl + first_index;
+            for (u32 mask = table__group_match(group, result.ctrl); mask != 0; mask &= mask - 1){
+                u32 index = first_index + bit_scan_forward_u32(mask);
+                if (hash == hashes[index] && data_match(key, table->keys[index])){
                     result.index = index;
                     result.found_match = true;
                     result.found_empty_slot = false;
@@ -745,30 +834,21 @@ table_lookup(Table_Data_Data *table, String_Const_u8 key){
                     break;
                 }
             }
-            if (table_empty_slot == hashes[index]){
-                if (!result.found_erased_slot){
-                    result.index = index;
-                    result.found_empty_slot = true;
-                }
-                break;
-            }
-            if (table_erased_slot == hashes[index] && !result.found_erased_slot){
-                result.index = index;
-                result.found_erased_slot = true;
-            }
-            index += 1;
-            if (index >= slot_count){
-                index = 0;
-            }
-            if (index == first_index){
+            if (result.found_match || table__probe_free(&result, group, first_index)){
                 break;
             }
+            group_index = (group_index + step) & group_mask;
         }
     }
     
     return(result);
 }
 
+internal Table_Lookup
+table_lookup(Table_Data_Data *table, String_Const_u8 key){
+    return(table_lookup(table, key, table_hash(key)));
+}
+
 internal b32
 table_read(Table_Data_Data *table, Table_Lookup lookup, String_Const_u8 *val_out){
     b32 result = false;
@@ -798,6 +878,7 @@ table_read(Table_Data_Data *table, String_Const_u8 key, String_Const_u8 *val_out
 internal void
 table_insert__inner(Table_Data_Data *table, Table_Lookup lookup, String_Const_u8 key, String_Const_u8 val){
     Assert(lookup.found_empty_slot || lookup.found_erased_slot);
+    table->ctrl[lookup.index] = lookup.ctrl;
     table->hashes[lookup.index] = lookup.hash;
     table->keys[lookup.index] = key;
     table->vals[lookup.index] = val;
@@ -812,11 +893,11 @@ table_rehash(Table_Data_Data *dst, Table_Data_Data *src){
     b32 result = false;
     u32 src_slot_count = src->slot_count;
     if ((dst->dirty_count + src->used_count)*8 < dst->slot_count*7){
-        u64 *src_hashes = src->hashes;
+        u8 *src_ctrl = src->ctrl;
         for (u32 i = 0; i < src_slot_count; i += 1){
-            if (HasFlag(src_hashes[i], bit_64)){
+            if (HasFlag(src_ctrl[i], 0x80)){
                 String_Const_u8 key = src->keys[i];
-                Table_Lookup lookup = table_lookup(dst, key);
+                Table_Lookup lookup = table_lookup(dst, key, src->hashes[i]);
                 table_insert__inner(dst, lookup, key, src->vals[i]);
             }
         }
@@ -840,7 +921,7 @@ table_insert(Table_Data_Data *table, String_Const_u8 key, String_Const_u8 val){
                 table_rehash(&new_table, table);
                 table_free(table);
                 *table = new_table;
-                lookup = table_lookup(table, key);
+                lookup = table_lookup(table, key, lookup.hash);
                 Assert(lookup.found_empty_slot);
             }
             table_insert__inner(table, lookup, key, val);
@@ -855,7 +936,10 @@ table_erase(Table_Data_Data *table, String_Const_u8 key){
     b32 result = false;
     Table_Lookup lookup = table_lookup(table, key);
     if (lookup.found_match){
-        table->hashes[lookup.index] = table_erased_slot;
+        if (table__erase_slot(table->ctrl, lookup.index)){
+            table->dirty_count -= 1;
+        }
+        table->hashes[lookup.index] = 0;
         block_zero_struct(&table->keys[lookup.index]);
         block_zero_struct(&table->vals[lookup.index]);
         table->used_count -= 1;
@@ -866,6 +950,7 @@ table_erase(Table_Data_Data *table, String_Const_u8 key){
 
 internal void
 table_clear(Table_Data_Data *table){
+    block_zero_dynamic_array(table->ctrl, table->slot_count);
     block_zero_dynamic_array(table->hashes, table->slot_count);
     block_zero_dynamic_array(table->keys, table->slot_count);
     block_zero_dynamic_array(table->vals, table->slot_count);
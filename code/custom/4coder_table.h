@@ -13,6 +13,7 @@ struct Table_Lookup{
     b8 found_match;
     b8 found_empty_slot;
     b8 found_erased_slot;
+    u8 ctrl;
 };
 
 struct Table_u64_u64{
@@ -38,6 +39,7 @@ struct Table_u32_u16{
 struct Table_Data_u64{
     Base_Allocator *allocator;
     void *memory;
+    u8 *ctrl;
     u64 *hashes;
     String_Const_u8 *keys;
     u64 *vals;
@@ -59,6 +61,7 @@ struct Table_u64_Data{
 struct Table_Data_Data{
     Base_Allocator *allocator;
     void *memory;
+    u8 *ctrl;
     u64 *hashes;
     String_Const_u8 *keys;
     String_Const_u8 *vals;
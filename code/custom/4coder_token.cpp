@@ -126,6 +126,358 @@ token_from_pos(Token_Array *tokens, u64 pos){
 
 ////////////////////////////////
 
+internal Token_Chunk*
+token_chunks__get(Token_Chunks *chunks, i64 chunk_index){
+    i64 slot = chunk_index;
+    if (chunk_index >= chunks->gap_first){
+        slot += chunks->chunk_max - chunks->chunk_count;
+    }
+    return(chunks->chunks[slot]);
+}
+
+internal i64
+token_chunks__first_index(Token_Chunks *chunks, i64 chunk_index){
+    i64 result = token_chunks__get(chunks, chunk_index)->first_index;
+    if (chunk_index >= chunks->gap_first){
+        result += chunks->tail_index;
+    }
+    return(result);
+}
+
+internal i64
+token_chunks__first_pos(Token_Chunks *chunks, i64 chunk_index){
+    i64 result = token_chunks__get(chunks, chunk_index)->first_pos;
+    if (chunk_index >= chunks->gap_first){
+        result += chunks->tail_pos;
+    }
+    return(result);
+}
+
+internal Token
+token_chunks__read(Token_Chunks *chunks, i64 chunk_index, i64 sub_index){
+    Token result = token_chunks__get(chunks, chunk_index)->tokens[sub_index];
+    result.pos += token_chunks__first_pos(chunks, chunk_index);
+    return(result);
+}
+
+// NOTE(allen): The last chunk whose first token is at or before index.
+internal i64
+token_chunks__chunk_from_index(Token_Chunks *chunks, i64 index){
+    i64 first = 0;
+    i64 one_past_last = chunks->chunk_count;
+    for (;first + 1 < one_past_last;){
+        i64 mid = (first + one_past_last) >> 1;
+        if (token_chunks__first_index(chunks, mid) <= index){
+            first = mid;
+        }
+        else{
+            one_past_last = mid;
+        }
+    }
+    return(first);
+}
+
+// NOTE(allen): The last chunk whose first token starts at or before pos.
+internal i64
+token_chunks__chunk_from_pos(Token_Chunks *chunks, i64 pos){
+    i64 first = 0;
+    i64 one_past_last = chunks->chunk_count;
+    for (;first + 1 < one_past_last;){
+        i64 mid = (first + one_past_last) >> 1;
+        if (token_chunks__first_pos(chunks, mid) <= pos){
+            first = mid;
+        }
+        else{
+            one_past_last = mid;
+        }
+    }
+    return(first);
+}
+
+// NOTE(allen): Chunks that cross the gap trade their absolute first index and
+// position for ones relative to the tail, or back.
+internal void
+token_chunks__move_gap(Token_Chunks *chunks, i64 gap_first){
+    i64 gap_size = chunks->chunk_max - chunks->chunk_count;
+    for (;chunks->gap_first > gap_first;){
+        chunks->gap_first -= 1;
+        Token_Chunk *chunk = chunks->chunks[chunks->gap_first];
+        chunk->first_index -= chunks->tail_index;
+        chunk->first_pos -= chunks->tail_pos;
+        chunks->chunks[chunks->gap_first + gap_size] = chunk;
+    }
+    for (;chunks->gap_first < gap_first;){
+        Token_Chunk *chunk = chunks->chunks[chunks->gap_first + gap_size];
+        chunk->first_index += chunks->tail_index;
+        chunk->first_pos += chunks->tail_pos;
+        chunks->chunks[chunks->gap_first] = chunk;
+        chunks->gap_first += 1;
+    }
+}
+
+internal void
+token_chunks__reserve(Token_Chunks *chunks, i64 extra_count){
+    if (chunks->chunk_count + extra_count > chunks->chunk_max){
+        i64 new_max = clamp_bot(64, (chunks->chunk_count + extra_count)*2);
+        Token_Chunk **new_table = base_array(chunks->allocator, Token_Chunk*, new_max);
+        i64 tail_count = chunks->chunk_count - chunks->gap_first;
+        block_copy_dynamic_array(new_table, chunks->chunks, chunks->gap_first);
+        block_copy_dynamic_array(new_table + new_max - tail_count,
+                                 chunks->chunks + chunks->chunk_max - tail_count, tail_count);
+        base_free(chunks->allocator, chunks->chunks);
+        chunks->chunks = new_table;
+        chunks->chunk_max = new_max;
+    }
+}
+
+internal Token_Chunk*
+token_chunks__alloc_chunk(Token_Chunks *chunks){
+    Token_Chunk *chunk = chunks->free_chunks;
+    if (chunk != 0){
+        chunks->free_chunks = chunk->next_free;
+    }
+    else{
+        chunk = base_array(chunks->allocator, Token_Chunk, 1);
+    }
+    chunk->next_free = 0;
+    return(chunk);
+}
+
+internal void
+token_chunks__free_chunk(Token_Chunks *chunks, Token_Chunk *chunk){
+    chunk->next_free = chunks->free_chunks;
+    chunks->free_chunks = chunk;
+}
+
+// NOTE(allen): Puts the tokens in new chunks just before the gap, split evenly so
+// no chunk ends up much smaller than the others.  The tokens have their real
+// positions and the first one goes at first_index.
+internal void
+token_chunks__push(Token_Chunks *chunks, Token *tokens, i64 count, i64 first_index){
+    if (count > 0){
+        i64 chunk_count = (count + token_chunk_cap - 1)/token_chunk_cap;
+        token_chunks__reserve(chunks, chunk_count);
+        i64 pos = 0;
+        for (i64 i = 0; i < chunk_count; i += 1){
+            i64 next_pos = (count*(i + 1))/chunk_count;
+            Token_Chunk *chunk = token_chunks__alloc_chunk(chunks);
+            chunk->first_index = first_index + pos;
+            chunk->first_pos = tokens[pos].pos;
+            chunk->count = next_pos - pos;
+            block_copy_dynamic_array(chunk->tokens, tokens + pos, chunk->count);
+            for (i64 j = 0; j < chunk->count; j += 1){
+                chunk->tokens[j].pos -= chunk->first_pos;
+            }
+            chunks->chunks[chunks->gap_first] = chunk;
+            chunks->gap_first += 1;
+            chunks->chunk_count += 1;
+            pos = next_pos;
+        }
+    }
+}
+
+internal void
+token_chunks_clear(Token_Chunks *chunks){
+    for (i64 i = 0; i < chunks->chunk_count; i += 1){
+        token_chunks__free_chunk(chunks, token_chunks__get(chunks, i));
+    }
+    chunks->chunk_count = 0;
+    chunks->gap_first = 0;
+    chunks->tail_index = 0;
+    chunks->tail_pos = 0;
+    chunks->count = 0;
+    chunks->flat_is_current = false;
+}
+
+internal void
+token_chunks_set(Token_Chunks *chunks, Base_Allocator *allocator, Token *tokens, i64 count){
+    if (chunks->allocator == 0){
+        chunks->allocator = allocator;
+    }
+    token_chunks_clear(chunks);
+    token_chunks__push(chunks, tokens, count, 0);
+    chunks->count = count;
+}
+
+internal void
+token_chunks_set(Token_Chunks *chunks, Base_Allocator *allocator, Token_List *list){
+    if (chunks->allocator == 0){
+        chunks->allocator = allocator;
+    }
+    token_chunks_clear(chunks);
+    for (Token_Block *block = list->first;
+         block != 0;
+         block = block->next){
+        token_chunks__push(chunks, block->tokens, block->count, chunks->count);
+        chunks->count += block->count;
+    }
+}
+
+// NOTE(allen): Replaces the tokens in the index range replaced with count new
+// tokens, which have their positions in the edited text, and moves every token
+// after replaced by text_shift.  The gap is put after the chunks that hold the
+// ends of replaced, those are the only ones rewritten, and everything after them
+// moves by changing tail_index and tail_pos.
+internal void
+token_chunks_replace(Token_Chunks *chunks, Arena *scratch, Range_i64 replaced,
+                     Token *tokens, i64 count, i64 text_shift){
+    if (chunks->chunk_count == 0){
+        token_chunks__push(chunks, tokens, count, 0);
+        chunks->count = count;
+    }
+    else{
+        Temp_Memory temp = begin_temp(scratch);
+        
+        i64 a = token_chunks__chunk_from_index(chunks, replaced.first);
+        i64 b = a;
+        if (replaced.one_past_last > replaced.first){
+            b = token_chunks__chunk_from_index(chunks, replaced.one_past_last - 1);
+        }
+        token_chunks__move_gap(chunks, b + 1);
+        
+        Token_Chunk *chunk_a = token_chunks__get(chunks, a);
+        Token_Chunk *chunk_b = token_chunks__get(chunks, b);
+        i64 first_index = chunk_a->first_index;
+        i64 prefix_count = replaced.first - chunk_a->first_index;
+        i64 suffix_first = replaced.one_past_last - chunk_b->first_index;
+        i64 suffix_count = chunk_b->count - suffix_first;
+        
+        Token *joined = push_array(scratch, Token, prefix_count + count + suffix_count + token_chunk_cap);
+        i64 joined_count = 0;
+        for (i64 i = 0; i < prefix_count; i += 1, joined_count += 1){
+            joined[joined_count] = chunk_a->tokens[i];
+            joined[joined_count].pos += chunk_a->first_pos;
+        }
+        block_copy_dynamic_array(joined + joined_count, tokens, count);
+        joined_count += count;
+        for (i64 i = suffix_first; i < chunk_b->count; i += 1, joined_count += 1){
+            joined[joined_count] = chunk_b->tokens[i];
+            joined[joined_count].pos += chunk_b->first_pos + text_shift;
+        }
+        
+        for (i64 i = a; i <= b; i += 1){
+            token_chunks__free_chunk(chunks, token_chunks__get(chunks, i));
+        }
+        chunks->chunk_count -= b - a + 1;
+        chunks->gap_first = a;
+        
+        i64 count_shift = count - range_size(replaced);
+        chunks->tail_index += count_shift;
+        chunks->tail_pos += text_shift;
+        chunks->count += count_shift;
+        
+        // NOTE(allen): A short run takes in the chunk after it, otherwise a run of
+        // edits leaves lots of tiny chunks behind.
+        if (joined_count < token_chunk_cap/2 && chunks->gap_first < chunks->chunk_count){
+            Token_Chunk *next = token_chunks__get(chunks, chunks->gap_first);
+            i64 next_first_pos = token_chunks__first_pos(chunks, chunks->gap_first);
+            for (i64 i = 0; i < next->count; i += 1, joined_count += 1){
+                joined[joined_count] = next->tokens[i];
+                joined[joined_count].pos += next_first_pos;
+            }
+            token_chunks__free_chunk(chunks, next);
+            chunks->chunk_count -= 1;
+        }
+        
+        token_chunks__push(chunks, joined, joined_count, first_index);
+        
+        end_temp(temp);
+    }
+    chunks->flat_is_current = false;
+}
+
+internal void
+token_fill_memory_from_chunks(Token *dst, Token_Chunks *chunks){
+    for (i64 i = 0; i < chunks->chunk_count; i += 1){
+        Token_Chunk *chunk = token_chunks__get(chunks, i);
+        i64 first_pos = token_chunks__first_pos(chunks, i);
+        block_copy_dynamic_array(dst, chunk->tokens, chunk->count);
+        for (i64 j = 0; j < chunk->count; j += 1){
+            dst[j].pos += first_pos;
+        }
+        dst += chunk->count;
+    }
+}
+
+internal Token_Array
+token_array_from_chunks(Arena *arena, Token_Chunks *chunks){
+    Token_Array array = {};
+    if (chunks->count > 0){
+        array.tokens = push_array(arena, Token, chunks->count);
+        token_fill_memory_from_chunks(array.tokens, chunks);
+        array.count = chunks->count;
+        array.max = array.count;
+    }
+    return(array);
+}
+
+// NOTE(allen): Copies the tokens out to chunks->flat when there has been an edit
+// since the last copy.
+internal Token_Array
+token_chunks_flat(Token_Chunks *chunks){
+    if (!chunks->flat_is_current && chunks->allocator != 0){
+        if (chunks->flat.max < chunks->count){
+            base_free(chunks->allocator, chunks->flat.tokens);
+            chunks->flat.tokens = base_array(chunks->allocator, Token, chunks->count);
+            chunks->flat.max = chunks->count;
+        }
+        token_fill_memory_from_chunks(chunks->flat.tokens, chunks);
+        chunks->flat.count = chunks->count;
+        chunks->flat_is_current = true;
+    }
+    return(chunks->flat);
+}
+
+internal i64
+token_index_from_pos(Token_Chunks *chunks, i64 pos){
+    i64 result = 0;
+    if (chunks->chunk_count > 0){
+        i64 chunk_index = token_chunks__chunk_from_pos(chunks, pos);
+        Token_Chunk *chunk = token_chunks__get(chunks, chunk_index);
+        i64 first_pos = token_chunks__first_pos(chunks, chunk_index);
+        result = (token_chunks__first_index(chunks, chunk_index) +
+                  token_index_from_pos(chunk->tokens, chunk->count, pos - first_pos));
+    }
+    return(result);
+}
+
+internal Token
+token_chunks_read(Token_Chunks *chunks, i64 index){
+    Token result = {};
+    if (0 <= index && index < chunks->count){
+        i64 chunk_index = token_chunks__chunk_from_index(chunks, index);
+        i64 sub_index = index - token_chunks__first_index(chunks, chunk_index);
+        result = token_chunks__read(chunks, chunk_index, sub_index);
+    }
+    return(result);
+}
+
+// NOTE(allen): Copies out the tokens from the one holding range.min through the
+// one holding range.max, for code that only looks at the tokens around an edit.
+internal Token_Array
+token_array_from_chunks_range(Arena *arena, Token_Chunks *chunks, Range_i64 range){
+    Token_Array array = {};
+    if (chunks->count > 0){
+        i64 first = token_index_from_pos(chunks, range.min);
+        i64 count = token_index_from_pos(chunks, range.max) + 1 - first;
+        array.tokens = push_array(arena, Token, count);
+        array.count = count;
+        array.max = count;
+        i64 chunk_index = token_chunks__chunk_from_index(chunks, first);
+        i64 sub_index = first - token_chunks__first_index(chunks, chunk_index);
+        for (i64 i = 0; i < count; i += 1, sub_index += 1){
+            if (sub_index == token_chunks__get(chunks, chunk_index)->count){
+                chunk_index += 1;
+                sub_index = 0;
+            }
+            array.tokens[i] = token_chunks__read(chunks, chunk_index, sub_index);
+        }
+    }
+    return(array);
+}
+
+////////////////////////////////
+
 internal Token_Iterator_Array
 token_iterator_index(u64 user_id, Token *tokens, i64 count, i64 token_index){
     Token_Iterator_Array it = {};
@@ -457,6 +809,148 @@ token_it_dec(Token_Iterator_List *it){
     return(result);
 }
 
+internal Token_Iterator_Chunks
+token_iterator_index(u64 user_id, Token_Chunks *chunks, i64 index){
+    Token_Iterator_Chunks it = {};
+    if (chunks->count > 0){
+        index = clamp(0, index, chunks->count - 1);
+        it.user_id = user_id;
+        it.chunks = chunks;
+        it.chunk_index = token_chunks__chunk_from_index(chunks, index);
+        it.sub_index = index - token_chunks__first_index(chunks, it.chunk_index);
+        it.token = token_chunks__read(chunks, it.chunk_index, it.sub_index);
+    }
+    return(it);
+}
+
+internal Token_Iterator_Chunks
+token_iterator(u64 user_id, Token_Chunks *chunks){
+    return(token_iterator_index(user_id, chunks, 0));
+}
+
+internal Token_Iterator_Chunks
+token_iterator_pos(u64 user_id, Token_Chunks *chunks, i64 pos){
+    i64 index = token_index_from_pos(chunks, pos);
+    return(token_iterator_index(user_id, chunks, index));
+}
+
+internal Token*
+token_it_read(Token_Iterator_Chunks *it){
+    Token *result = 0;
+    if (it->chunks != 0){
+        result = &it->token;
+    }
+    return(result);
+}
+
+internal i64
+token_it_index(Token_Iterator_Chunks *it){
+    i64 result = 0;
+    if (it->chunks != 0){
+        result = token_chunks__first_index(it->chunks, it->chunk_index) + it->sub_index;
+    }
+    return(result);
+}
+
+internal b32
+token_it_inc_all(Token_Iterator_Chunks *it){
+    b32 result = false;
+    if (it->chunks != 0){
+        Token_Chunk *chunk = token_chunks__get(it->chunks, it->chunk_index);
+        if (it->sub_index + 1 < chunk->count){
+            it->sub_index += 1;
+            result = true;
+        }
+        else if (it->chunk_index + 1 < it->chunks->chunk_count){
+            it->chunk_index += 1;
+            it->sub_index = 0;
+            result = true;
+        }
+        if (result){
+            it->token = token_chunks__read(it->chunks, it->chunk_index, it->sub_index);
+        }
+    }
+    return(result);
+}
+
+internal b32
+token_it_dec_all(Token_Iterator_Chunks *it){
+    b32 result = false;
+    if (it->chunks != 0){
+        if (it->sub_index > 0){
+            it->sub_index -= 1;
+            result = true;
+        }
+        else if (it->chunk_index > 0){
+            it->chunk_index -= 1;
+            it->sub_index = token_chunks__get(it->chunks, it->chunk_index)->count - 1;
+            result = true;
+        }
+        if (result){
+            it->token = token_chunks__read(it->chunks, it->chunk_index, it->sub_index);
+        }
+    }
+    return(result);
+}
+
+internal b32
+token_it_inc_non_whitespace(Token_Iterator_Chunks *it){
+    b32 result = false;
+    repeat:
+    if (token_it_inc_all(it)){
+        Token *token = token_it_read(it);
+        if (token != 0 && token->kind == TokenBaseKind_Whitespace){
+            goto repeat;
+        }
+        result = true;
+    }
+    return(result);
+}
+
+internal b32
+token_it_dec_non_whitespace(Token_Iterator_Chunks *it){
+    b32 result = false;
+    repeat:
+    if (token_it_dec_all(it)){
+        Token *token = token_it_read(it);
+        if (token != 0 && token->kind == TokenBaseKind_Whitespace){
+            goto repeat;
+        }
+        result = true;
+    }
+    return(result);
+}
+
+internal b32
+token_it_inc(Token_Iterator_Chunks *it){
+    b32 result = false;
+    repeat:
+    if (token_it_inc_all(it)){
+        Token *token = token_it_read(it);
+        if (token != 0 && (token->kind == TokenBaseKind_Whitespace ||
+                           token->kind == TokenBaseKind_Comment)){
+            goto repeat;
+        }
+        result = true;
+    }
+    return(result);
+}
+
+internal b32
+token_it_dec(Token_Iterator_Chunks *it){
+    b32 result = false;
+    repeat:
+    if (token_it_dec_all(it)){
+        Token *token = token_it_read(it);
+        if (token != 0 && (token->kind == TokenBaseKind_Whitespace ||
+                           token->kind == TokenBaseKind_Comment)){
+            goto repeat;
+        }
+        result = true;
+    }
+    return(result);
+}
+
 internal Token_Iterator
 token_iterator(Token_Iterator_Array it){
     Token_Iterator result = {};
@@ -473,6 +967,14 @@ token_iterator(Token_Iterator_List it){
     return(result);
 }
 
+internal Token_Iterator
+token_iterator(Token_Iterator_Chunks it){
+    Token_Iterator result = {};
+    result.kind = TokenIterator_Chunks;
+    result.chunks = it;
+    return(result);
+}
+
 internal Token*
 token_it_read(Token_Iterator *it){
     switch (it->kind){
@@ -484,6 +986,10 @@ token_it_read(Token_Iterator *it){
         {
             return(token_it_read(&it->list));
         }break;
+        case TokenIterator_Chunks:
+        {
+            return(token_it_read(&it->chunks));
+        }break;
     }
     return(0);
 }
@@ -499,6 +1005,10 @@ token_it_index(Token_Iterator *it){
         {
             return(token_it_index(&it->list));
         }break;
+        case TokenIterator_Chunks:
+        {
+            return(token_it_index(&it->chunks));
+        }break;
     }
     return(0);
 }
@@ -514,6 +1024,10 @@ token_it_inc_all(Token_Iterator *it){
         {
             return(token_it_inc_all(&it->list));
         }break;
+        case TokenIterator_Chunks:
+        {
+            return(token_it_inc_all(&it->chunks));
+        }break;
     }
     return(0);
 }
@@ -529,6 +1043,10 @@ token_it_dec_all(Token_Iterator *it){
         {
             return(token_it_dec_all(&it->list));
         }break;
+        case TokenIterator_Chunks:
+        {
+            return(token_it_dec_all(&it->chunks));
+        }break;
     }
     return(0);
 }
@@ -544,6 +1062,10 @@ token_it_inc_non_whitespace(Token_Iterator *it){
         {
             return(token_it_inc_non_whitespace(&it->list));
         }break;
+        case TokenIterator_Chunks:
+        {
+            return(token_it_inc_non_whitespace(&it->chunks));
+        }break;
     }
     return(0);
 }
@@ -559,6 +1081,10 @@ token_it_dec_non_whitespace(Token_Iterator *it){
         {
             return(token_it_dec_non_whitespace(&it->list));
         }break;
+        case TokenIterator_Chunks:
+        {
+            return(token_it_dec_non_whitespace(&it->chunks));
+        }break;
     }
     return(0);
 }
@@ -574,6 +1100,10 @@ token_it_inc(Token_Iterator *it){
         {
             return(token_it_inc(&it->list));
         }break;
+        case TokenIterator_Chunks:
+        {
+            return(token_it_inc(&it->chunks));
+        }break;
     }
     return(0);
 }
@@ -589,6 +1119,10 @@ token_it_dec(Token_Iterator *it){
         {
             return(token_it_dec(&it->list));
         }break;
+        case TokenIterator_Chunks:
+        {
+            return(token_it_dec(&it->chunks));
+        }break;
     }
     return(0);
 }
@@ -654,6 +1188,48 @@ token_relex_resync(Token_Array *tokens, i64 edit_range_first, i64 look_ahead_rep
     return(token_it_index(&it));
 }
 
+internal i64
+token_relex_first(Token_Chunks *tokens, i64 edit_range_first, i64 backup_repeats){
+    Token_Iterator_Chunks it = token_iterator_pos(0, tokens, edit_range_first);
+    b32 good_status = true;
+    for (i64 i = 0; i < backup_repeats && good_status; i += 1){
+        good_status = token_it_dec(&it);
+    }
+    if (good_status){
+        for (;;){
+            Token *token = token_it_read(&it);
+            if (!HasFlag(token->flags, TokenBaseFlag_PreprocessorBody)){
+                break;
+            }
+            if (!token_it_dec(&it)){
+                break;
+            }
+        }
+    }
+    return(token_it_index(&it));
+}
+
+internal i64
+token_relex_resync(Token_Chunks *tokens, i64 edit_range_first, i64 look_ahead_repeats){
+    Token_Iterator_Chunks it = token_iterator_pos(0, tokens, edit_range_first);
+    b32 good_status = true;
+    for (i64 i = 0; (i < look_ahead_repeats) && good_status; i += 1){
+        good_status = token_it_inc(&it);
+    }
+    if (good_status){
+        for (;;){
+            Token *token = token_it_read(&it);
+            if (!HasFlag(token->flags, TokenBaseFlag_PreprocessorBody)){
+                break;
+            }
+            if (!token_it_inc(&it)){
+                break;
+            }
+        }
+    }
+    return(token_it_index(&it));
+}
+
 internal Token_Relex
 token_relex(Token_List relex_list, i64 new_pos_to_old_pos_shift, Token *tokens, i64 relex_first, i64 relex_last){
     Token_Relex relex = {};
@@ -685,5 +1261,36 @@ token_relex(Token_List relex_list, i64 new_pos_to_old_pos_shift, Token *tokens,
     return(relex);
 }
 
+internal Token_Relex
+token_relex(Token_List relex_list, i64 new_pos_to_old_pos_shift, Token_Chunks *tokens, i64 relex_first, i64 relex_last){
+    Token_Relex relex = {};
+    if (relex_list.total_count > 0){
+        Token_Iterator_List it = token_iterator_index(0, &relex_list, relex_list.total_count - 1);
+        for (;;){
+            Token *token = token_it_read(&it);
+            i64 new_pos_rebased = token->pos + new_pos_to_old_pos_shift;
+            i64 old_token_index = token_index_from_pos(tokens, new_pos_rebased);
+            old_token_index = clamp(relex_first, old_token_index, relex_last);
+            Token old_token = token_chunks_read(tokens, old_token_index);
+            if (new_pos_rebased == old_token.pos &&
+                token->size == old_token.size &&
+                token->kind == old_token.kind &&
+                token->sub_kind == old_token.sub_kind &&
+                token->flags == old_token.flags &&
+                token->sub_flags == old_token.sub_flags){
+                relex.successful_resync = true;
+                relex.first_resync_index = old_token_index;
+            }
+            else{
+                break;
+            }
+            if (!token_it_dec_all(&it)){
+                break;
+            }
+        }
+    }
+    return(relex);
+}
+
 // BOTTOM
 
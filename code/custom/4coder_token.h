@@ -88,6 +88,38 @@ struct Token_List{
     i64 total_count;
 };
 
+// NOTE(allen): Token_Chunks keeps a buffer's tokens in chunks of at most
+// token_chunk_cap tokens, reached through a table of chunk pointers that has a
+// gap at the last edit.  A chunk keeps the index and position of its first token
+// and its tokens' positions are relative to that.  The chunks before the gap
+// count from the start of the buffer, the chunks after it count from tail_index
+// and tail_pos, so an edit shifts everything after it by changing those two.
+//  flat is a plain array copy made when something asks for a Token_Array, it is
+// only rebuilt after an edit.
+#define token_chunk_cap 512
+
+struct Token_Chunk{
+    Token_Chunk *next_free;
+    i64 first_index;
+    i64 first_pos;
+    i64 count;
+    Token tokens[token_chunk_cap];
+};
+
+struct Token_Chunks{
+    Base_Allocator *allocator;
+    Token_Chunk **chunks;
+    i64 chunk_count;
+    i64 chunk_max;
+    i64 gap_first;
+    i64 tail_index;
+    i64 tail_pos;
+    i64 count;
+    Token_Chunk *free_chunks;
+    Token_Array flat;
+    b32 flat_is_current;
+};
+
 struct Token_Relex{
     b32 successful_resync;
     i64 first_resync_index;
@@ -100,6 +132,16 @@ struct Token_Iterator_Array{
     i64 count;
 };
 
+// NOTE(allen): Reading gives a copy of the token with its position filled in,
+// so the pointer is only good until the iterator moves.
+struct Token_Iterator_Chunks{
+    u64 user_id;
+    Token_Chunks *chunks;
+    i64 chunk_index;
+    i64 sub_index;
+    Token token;
+};
+
 struct Token_Iterator_List{
     u64 user_id;
     i64 index;
@@ -115,6 +157,7 @@ typedef i32 Token_Iterator_Kind;
 enum{
     TokenIterator_Array,
     TokenIterator_List,
+    TokenIterator_Chunks,
 };
 
 struct Token_Iterator{
@@ -122,6 +165,7 @@ struct Token_Iterator{
     union{
         Token_Iterator_Array array;
         Token_Iterator_List list;
+        Token_Iterator_Chunks chunks;
     };
 };
 
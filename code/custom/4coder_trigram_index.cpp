@@ -0,0 +1,219 @@
+/*
+4coder_trigram_index.cpp - Per buffer trigram filters that narrow searches down.
+*/
+
+// TOP
+
+// NOTE(allen): The index is built the first time a buffer is searched with the
+// enable_trigram_index option on, and after that the edit hook rebuilds only the
+// blocks an edit touched.  A search only looks at the blocks that have every
+// trigram of the needle, which is all it takes to rule out most of a large set
+// of buffers for a needle of any real length.
+//  The blocks live in system memory, so the memory tab of the profiler shows
+// them, and the queries show up as "trigram index query" blocks.
+
+function u32
+trigram_index_bit(u8 a, u8 b, u8 c){
+    u32 x = ((u32)character_to_lower(a) |
+             ((u32)character_to_lower(b) << 8) |
+             ((u32)character_to_lower(c) << 16));
+    x *= 0x9E3779B1;
+    return(x >> (32 - 14));
+}
+
+function void
+trigram_index__fill_block(Trigram_Block *block, String_Const_u8 text){
+    block_zero_array(block->bits);
+    i64 count = Min(block->size, (i64)text.size - 2);
+    u8 *str = text.str;
+    for (i64 i = 0; i < count; i += 1){
+        u32 bit = trigram_index_bit(str[i], str[i + 1], str[i + 2]);
+        block->bits[bit/64] |= (1llu << (bit%64));
+    }
+}
+
+function b32
+trigram_index__block_has(Trigram_Block *block, u32 bit){
+    return((block->bits[bit/64] & (1llu << (bit%64))) != 0);
+}
+
+function void
+trigram_index__reserve(Trigram_Index *index, i32 count){
+    if (count > index->max){
+        Base_Allocator *allocator = get_base_allocator_system();
+        i32 new_max = clamp_bot(8, count + count/2);
+        Trigram_Block *new_blocks = base_array(allocator, Trigram_Block, new_max);
+        block_copy_dynamic_array(new_blocks, index->blocks, index->count);
+        base_free(allocator, index->blocks);
+        index->blocks = new_blocks;
+        index->max = new_max;
+    }
+}
+
+// NOTE(allen): Lays count blocks out evenly over the text from pos and fills
+// them, the text is read two bytes past each block for the trigrams that cross
+// into the next one.
+function void
+trigram_index__fill_blocks(Application_Links *app, Buffer_ID buffer, Trigram_Block *blocks, i32 count,
+                           i64 pos, i64 size){
+    Scratch_Block scratch(app);
+    i64 buffer_size = buffer_get_size(app, buffer);
+    for (i32 i = 0; i < count; i += 1){
+        Temp_Memory temp = begin_temp(scratch);
+        i64 block_first = pos + size*i/count;
+        i64 block_end = pos + size*(i + 1)/count;
+        blocks[i].size = block_end - block_first;
+        Range_i64 range = Ii64(block_first, clamp_top(block_end + 2, buffer_size));
+        String_Const_u8 text = push_buffer_range(app, scratch, buffer, range);
+        trigram_index__fill_block(&blocks[i], text);
+        end_temp(temp);
+    }
+}
+
+function i32
+trigram_index__block_count(i64 size){
+    return((i32)clamp_bot(1, (size + trigram_block_target_size/2)/trigram_block_target_size));
+}
+
+function void
+trigram_index_build(Application_Links *app, Buffer_ID buffer, Trigram_Index *index){
+    ProfileScope(app, "trigram index build");
+    i64 size = buffer_get_size(app, buffer);
+    i32 count = trigram_index__block_count(size);
+    index->count = 0;
+    trigram_index__reserve(index, count);
+    index->count = count;
+    index->size = size;
+    trigram_index__fill_blocks(app, buffer, index->blocks, count, 0, size);
+}
+
+function void
+trigram_index_release(Application_Links *app, Buffer_ID buffer){
+    Managed_Scope scope = buffer_get_managed_scope(app, buffer);
+    Trigram_Index *index = scope_attachment(app, scope, buffer_trigram_index, Trigram_Index);
+    if (index != 0 && index->blocks != 0){
+        base_free(get_base_allocator_system(), index->blocks);
+        block_zero_struct(index);
+    }
+}
+
+// NOTE(allen): Called from the edit hook once the text is replaced.  The blocks
+// from the one with the first trigram that read the old range to the one holding
+// its end are filled again from the new text.  They keep their count unless they
+// grew past twice or shrank under a quarter of the target size.
+function void
+trigram_index_edit(Application_Links *app, Buffer_ID buffer, Range_i64 old_range, i64 new_size){
+    Managed_Scope scope = buffer_get_managed_scope(app, buffer);
+    Trigram_Index *index = scope_attachment(app, scope, buffer_trigram_index, Trigram_Index);
+    if (index != 0 && index->blocks != 0){
+        ProfileScope(app, "trigram index edit");
+        i64 shift = new_size - range_size(old_range);
+        i64 affected_first = clamp_bot(0, old_range.min - 2);
+        
+        i32 first = index->count - 1;
+        i32 last = index->count - 1;
+        i64 first_pos = index->size - index->blocks[first].size;
+        i64 last_end = index->size;
+        {
+            i64 pos = 0;
+            b32 found_first = false;
+            for (i32 i = 0; i < index->count; i += 1){
+                i64 end = pos + index->blocks[i].size;
+                if (!found_first && affected_first < end){
+                    found_first = true;
+                    first = i;
+                    first_pos = pos;
+                }
+                if (found_first && old_range.max < end){
+                    last = i;
+                    last_end = end;
+                    break;
+                }
+                pos = end;
+            }
+        }
+        
+        i32 old_count = last - first + 1;
+        i64 size = (last_end - first_pos) + shift;
+        i32 count = old_count;
+        if (size > old_count*2*trigram_block_target_size ||
+            size*4 < old_count*trigram_block_target_size){
+            count = trigram_index__block_count(size);
+        }
+        if (count != old_count){
+            trigram_index__reserve(index, index->count + count - old_count);
+            block_copy_dynamic_array(index->blocks + first + count, index->blocks + last + 1,
+                                     index->count - (last + 1));
+            index->count += count - old_count;
+        }
+        index->size += shift;
+        trigram_index__fill_blocks(app, buffer, index->blocks + first, count, first_pos, size);
+    }
+}
+
+function Range_i64_Array
+trigram_index_candidate_ranges(Application_Links *app, Arena *arena, Buffer_ID buffer, String_Const_u8 needle){
+    ProfileScope(app, "trigram index query");
+    Range_i64_Array result = {};
+    i64 buffer_size = buffer_get_size(app, buffer);
+    
+    Trigram_Index *index = 0;
+    if (needle.size >= 3 && def_get_config_b32(vars_save_string_lit("enable_trigram_index"))){
+        Managed_Scope scope = buffer_get_managed_scope(app, buffer);
+        index = scope_attachment(app, scope, buffer_trigram_index, Trigram_Index);
+        if (index != 0 && (index->blocks == 0 || index->size != buffer_size)){
+            trigram_index_build(app, buffer, index);
+        }
+    }
+    
+    if (index == 0){
+        result.ranges = push_array(arena, Range_i64, 1);
+        result.ranges[0] = Ii64(0, buffer_size);
+        result.count = 1;
+    }
+    else{
+        Scratch_Block scratch(app, arena);
+        i32 bit_count = (i32)needle.size - 2;
+        u32 *bits = push_array(scratch, u32, bit_count);
+        for (i32 i = 0; i < bit_count; i += 1){
+            bits[i] = trigram_index_bit(needle.str[i], needle.str[i + 1], needle.str[i + 2]);
+        }
+        
+        // NOTE(allen): A match that starts in a block can have the rest of its
+        // trigrams in the blocks after it.  The ranges are one byte wider on each
+        // side than the matches that can be in them, so the matcher sees the
+        // characters around a match when it sets the sloppy flags.
+        result.ranges = push_array(arena, Range_i64, index->count);
+        i64 pos = 0;
+        for (i32 i = 0; i < index->count; i += 1){
+            Trigram_Block *block = &index->blocks[i];
+            i64 match_end = pos + block->size + needle.size - 1;
+            b32 is_candidate = true;
+            for (i32 j = 0; j < bit_count && is_candidate; j += 1){
+                b32 has_bit = false;
+                i64 block_pos = pos;
+                for (i32 k = i; k < index->count && block_pos < match_end && !has_bit; k += 1){
+                    has_bit = trigram_index__block_has(&index->blocks[k], bits[j]);
+                    block_pos += index->blocks[k].size;
+                }
+                is_candidate = has_bit;
+            }
+            if (is_candidate){
+                Range_i64 range = Ii64(clamp_bot(0, pos - 1), clamp_top(match_end + 1, buffer_size));
+                if (result.count > 0 && result.ranges[result.count - 1].max >= range.min){
+                    result.ranges[result.count - 1].max = range.max;
+                }
+                else{
+                    result.ranges[result.count] = range;
+                    result.count += 1;
+                }
+            }
+            pos += block->size;
+        }
+    }
+    
+    return(result);
+}
+
+// BOTTOM
+
@@ -0,0 +1,33 @@
+/*
+4coder_trigram_index.h - Per buffer trigram filters that narrow searches down.
+*/
+
+// TOP
+
+#if !defined(FCODER_TRIGRAM_INDEX_H)
+#define FCODER_TRIGRAM_INDEX_H
+
+#define trigram_block_target_size KB(16)
+#define trigram_block_bit_count (KB(2)*8)
+
+// NOTE(allen): A block marks every trigram that starts in it, the last two read
+// into the next block, lower cased so one filter serves both kinds of search.
+struct Trigram_Block{
+    i64 size;
+    u64 bits[trigram_block_bit_count/64];
+};
+
+struct Trigram_Index{
+    Trigram_Block *blocks;
+    i32 count;
+    i32 max;
+    i64 size;
+};
+
+function Range_i64_Array
+trigram_index_candidate_ranges(Application_Links *app, Arena *arena, Buffer_ID buffer, String_Const_u8 needle);
+
+#endif
+
+// BOTTOM
+
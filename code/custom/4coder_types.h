@@ -212,6 +212,7 @@ enum{
     BufferCreate_MustAttachToFile = 0x10,
     BufferCreate_NeverAttachToFile = 0x20,
     BufferCreate_SuppressNewFileHook = 0x40,
+    BufferCreate_PieceTree = 0x80,
 };
 
 api(custom)
@@ -753,6 +754,16 @@ struct Layout_Item_List{
 api(custom)
 typedef Layout_Item_List Layout_Function(Application_Links *app, Arena *arena, Buffer_ID buffer, Range_i64 range, Face_ID face, f32 width);
 
+api(custom)
+struct Layout_Cache_Stats{
+    u64 hit_count;
+    u64 miss_count;
+    u64 eviction_count;
+    u64 entry_count;
+    u64 bytes_in_use;
+    u64 byte_budget;
+};
+
 api(custom)
 struct View_Context{
     Render_Caller_Function *render_caller;
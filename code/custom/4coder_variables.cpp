@@ -66,6 +66,9 @@ vars_read_string(Arena *arena, String_ID id){
 global Variable vars_global_root = {};
 global Variable vars_nil = {};
 global Variable *vars_free_variables = 0;
+// NOTE(allen): Goes up on every change to the tree, so readers can keep things
+// they computed from variables until it moves.
+global u64 vars_change_counter = 0;
 
 function Variable_Handle
 vars_get_root(void){
@@ -203,6 +206,7 @@ function void
 vars_set_string(Variable_Handle var, String_ID string){
     if (var.ptr != &vars_nil){
         var.ptr->string = string;
+        vars_change_counter += 1;
     }
 }
 
@@ -251,6 +255,7 @@ vars_erase(Variable_Handle var, String_ID key){
                 var.ptr->last = prev;
             }
             sll_stack_push(vars_free_variables, node);
+            vars_change_counter += 1;
         }
     }
 }
@@ -295,6 +300,7 @@ vars_new_variable(Variable_Handle var, String_ID key){
         
         handle.ptr->string = 0;
         handle.ptr->first = handle.ptr->last = vars_get_nil().ptr;
+        vars_change_counter += 1;
     }
     return(handle);
 }
@@ -310,9 +316,15 @@ function void
 vars_clear_keys(Variable_Handle var){
     if (var.ptr != &vars_nil){
         _vars_free_variable_children(var.ptr);
+        vars_change_counter += 1;
     }
 }
 
+function u64
+vars_get_change_counter(void){
+    return(vars_change_counter);
+}
+
 function void
 vars_print_indented(Application_Links *app, Variable_Handle var, i32 indent){
     Scratch_Block scratch(app);
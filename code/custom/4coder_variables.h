@@ -64,6 +64,8 @@ function Variable_Handle vars_new_variable(Variable_Handle var, String_ID key);
 function Variable_Handle vars_new_variable(Variable_Handle var, String_ID key, String_ID string);
 function void            vars_clear_keys(Variable_Handle var);
 
+function u64             vars_get_change_counter(void);
+
 function void            vars_print_indented(Application_Links *app, Variable_Handle var, i32 indent);
 function void            vars_print(Application_Links *app, Variable_Handle var);
 
@@ -45,6 +45,8 @@ custom_api_fill_vtable(API_VTable_custom *vtable){
     vtable->buffer_set_dirty_state = buffer_set_dirty_state;
     vtable->buffer_set_layout = buffer_set_layout;
     vtable->buffer_clear_layout_cache = buffer_clear_layout_cache;
+    vtable->buffer_get_layout_cache_stats = buffer_get_layout_cache_stats;
+    vtable->set_layout_cache_budget = set_layout_cache_budget;
     vtable->buffer_get_layout = buffer_get_layout;
     vtable->buffer_get_setting = buffer_get_setting;
     vtable->buffer_set_setting = buffer_set_setting;
@@ -179,6 +181,7 @@ custom_api_fill_vtable(API_VTable_custom *vtable){
     vtable->open_color_picker = open_color_picker;
     vtable->animate_in_n_milliseconds = animate_in_n_milliseconds;
     vtable->buffer_find_all_matches = buffer_find_all_matches;
+    vtable->string_find_all_matches = string_find_all_matches;
     vtable->get_core_profile_list = get_core_profile_list;
     vtable->get_custom_layer_boundary_docs = get_custom_layer_boundary_docs;
 }
@@ -229,6 +232,8 @@ custom_api_read_vtable(API_VTable_custom *vtable){
     buffer_set_dirty_state = vtable->buffer_set_dirty_state;
     buffer_set_layout = vtable->buffer_set_layout;
     buffer_clear_layout_cache = vtable->buffer_clear_layout_cache;
+    buffer_get_layout_cache_stats = vtable->buffer_get_layout_cache_stats;
+    set_layout_cache_budget = vtable->set_layout_cache_budget;
     buffer_get_layout = vtable->buffer_get_layout;
     buffer_get_setting = vtable->buffer_get_setting;
     buffer_set_setting = vtable->buffer_set_setting;
@@ -363,6 +368,7 @@ custom_api_read_vtable(API_VTable_custom *vtable){
     open_color_picker = vtable->open_color_picker;
     animate_in_n_milliseconds = vtable->animate_in_n_milliseconds;
     buffer_find_all_matches = vtable->buffer_find_all_matches;
+    string_find_all_matches = vtable->string_find_all_matches;
     get_core_profile_list = vtable->get_core_profile_list;
     get_custom_layer_boundary_docs = vtable->get_custom_layer_boundary_docs;
 }
@@ -43,6 +43,8 @@
 #define custom_buffer_set_dirty_state_sig() b32 custom_buffer_set_dirty_state(Application_Links* app, Buffer_ID buffer_id, Dirty_State dirty_state)
 #define custom_buffer_set_layout_sig() b32 custom_buffer_set_layout(Application_Links* app, Buffer_ID buffer_id, Layout_Function* layout_func)
 #define custom_buffer_clear_layout_cache_sig() b32 custom_buffer_clear_layout_cache(Application_Links* app, Buffer_ID buffer_id)
+#define custom_buffer_get_layout_cache_stats_sig() Layout_Cache_Stats custom_buffer_get_layout_cache_stats(Application_Links* app, Buffer_ID buffer_id)
+#define custom_set_layout_cache_budget_sig() void custom_set_layout_cache_budget(Application_Links* app, u64 bytes_per_buffer)
 #define custom_buffer_get_layout_sig() Layout_Function* custom_buffer_get_layout(Application_Links* app, Buffer_ID buffer_id)
 #define custom_buffer_get_setting_sig() b32 custom_buffer_get_setting(Application_Links* app, Buffer_ID buffer_id, Buffer_Setting_ID setting, i64* value_out)
 #define custom_buffer_set_setting_sig() b32 custom_buffer_set_setting(Application_Links* app, Buffer_ID buffer_id, Buffer_Setting_ID setting, i64 value)
@@ -177,6 +179,7 @@
 #define custom_open_color_picker_sig() void custom_open_color_picker(Application_Links* app, Color_Picker* picker)
 #define custom_animate_in_n_milliseconds_sig() void custom_animate_in_n_milliseconds(Application_Links* app, u32 n)
 #define custom_buffer_find_all_matches_sig() String_Match_List custom_buffer_find_all_matches(Application_Links* app, Arena* arena, Buffer_ID buffer, i32 string_id, Range_i64 range, String_Const_u8 needle, Character_Predicate* predicate, Scan_Direction direction)
+#define custom_string_find_all_matches_sig() String_Match_List custom_string_find_all_matches(Application_Links* app, Arena* arena, Buffer_ID buffer, i32 string_id, String_Const_u8 string, i64 base_index, String_Const_u8 needle, Character_Predicate* predicate, Scan_Direction direction)
 #define custom_get_core_profile_list_sig() Profile_Global_List* custom_get_core_profile_list(Application_Links* app)
 #define custom_get_custom_layer_boundary_docs_sig() Doc_Cluster* custom_get_custom_layer_boundary_docs(Application_Links* app, Arena* arena)
 
@@ -223,6 +226,8 @@ typedef Dirty_State custom_buffer_get_dirty_state_type(Application_Links* app, B
 typedef b32 custom_buffer_set_dirty_state_type(Application_Links* app, Buffer_ID buffer_id, Dirty_State dirty_state);
 typedef b32 custom_buffer_set_layout_type(Application_Links* app, Buffer_ID buffer_id, Layout_Function* layout_func);
 typedef b32 custom_buffer_clear_layout_cache_type(Application_Links* app, Buffer_ID buffer_id);
+typedef Layout_Cache_Stats custom_buffer_get_layout_cache_stats_type(Application_Links* app, Buffer_ID buffer_id);
+typedef void custom_set_layout_cache_budget_type(Application_Links* app, u64 bytes_per_buffer);
 typedef Layout_Function* custom_buffer_get_layout_type(Application_Links* app, Buffer_ID buffer_id);
 typedef b32 custom_buffer_get_setting_type(Application_Links* app, Buffer_ID buffer_id, Buffer_Setting_ID setting, i64* value_out);
 typedef b32 custom_buffer_set_setting_type(Application_Links* app, Buffer_ID buffer_id, Buffer_Setting_ID setting, i64 value);
@@ -357,6 +362,7 @@ typedef void custom_draw_text_layout_type(Application_Links* app, Text_Layout_ID
 typedef void custom_open_color_picker_type(Application_Links* app, Color_Picker* picker);
 typedef void custom_animate_in_n_milliseconds_type(Application_Links* app, u32 n);
 typedef String_Match_List custom_buffer_find_all_matches_type(Application_Links* app, Arena* arena, Buffer_ID buffer, i32 string_id, Range_i64 range, String_Const_u8 needle, Character_Predicate* predicate, Scan_Direction direction);
+typedef String_Match_List custom_string_find_all_matches_type(Application_Links* app, Arena* arena, Buffer_ID buffer, i32 string_id, String_Const_u8 string, i64 base_index, String_Const_u8 needle, Character_Predicate* predicate, Scan_Direction direction);
 typedef Profile_Global_List* custom_get_core_profile_list_type(Application_Links* app);
 typedef Doc_Cluster* custom_get_custom_layer_boundary_docs_type(Application_Links* app, Arena* arena);
 
@@ -404,6 +410,8 @@ struct API_VTable_custom{
     custom_buffer_set_dirty_state_type *buffer_set_dirty_state;
     custom_buffer_set_layout_type *buffer_set_layout;
     custom_buffer_clear_layout_cache_type *buffer_clear_layout_cache;
+    custom_buffer_get_layout_cache_stats_type *buffer_get_layout_cache_stats;
+    custom_set_layout_cache_budget_type *set_layout_cache_budget;
     custom_buffer_get_layout_type *buffer_get_layout;
     custom_buffer_get_setting_type *buffer_get_setting;
     custom_buffer_set_setting_type *buffer_set_setting;
@@ -538,6 +546,7 @@ struct API_VTable_custom{
     custom_open_color_picker_type *open_color_picker;
     custom_animate_in_n_milliseconds_type *animate_in_n_milliseconds;
     custom_buffer_find_all_matches_type *buffer_find_all_matches;
+    custom_string_find_all_matches_type *string_find_all_matches;
     custom_get_core_profile_list_type *get_core_profile_list;
     custom_get_custom_layer_boundary_docs_type *get_custom_layer_boundary_docs;
 };
@@ -586,6 +595,8 @@ internal Dirty_State buffer_get_dirty_state(Application_Links* app, Buffer_ID bu
 internal b32 buffer_set_dirty_state(Application_Links* app, Buffer_ID buffer_id, Dirty_State dirty_state);
 internal b32 buffer_set_layout(Application_Links* app, Buffer_ID buffer_id, Layout_Function* layout_func);
 internal b32 buffer_clear_layout_cache(Application_Links* app, Buffer_ID buffer_id);
+internal Layout_Cache_Stats buffer_get_layout_cache_stats(Application_Links* app, Buffer_ID buffer_id);
+internal void set_layout_cache_budget(Application_Links* app, u64 bytes_per_buffer);
 internal Layout_Function* buffer_get_layout(Application_Links* app, Buffer_ID buffer_id);
 internal b32 buffer_get_setting(Application_Links* app, Buffer_ID buffer_id, Buffer_Setting_ID setting, i64* value_out);
 internal b32 buffer_set_setting(Application_Links* app, Buffer_ID buffer_id, Buffer_Setting_ID setting, i64 value);
@@ -720,6 +731,7 @@ internal void draw_text_layout(Application_Links* app, Text_Layout_ID layout_id,
 internal void open_color_picker(Application_Links* app, Color_Picker* picker);
 internal void animate_in_n_milliseconds(Application_Links* app, u32 n);
 internal String_Match_List buffer_find_all_matches(Application_Links* app, Arena* arena, Buffer_ID buffer, i32 string_id, Range_i64 range, String_Const_u8 needle, Character_Predicate* predicate, Scan_Direction direction);
+internal String_Match_List string_find_all_matches(Application_Links* app, Arena* arena, Buffer_ID buffer, i32 string_id, String_Const_u8 string, i64 base_index, String_Const_u8 needle, Character_Predicate* predicate, Scan_Direction direction);
 internal Profile_Global_List* get_core_profile_list(Application_Links* app);
 internal Doc_Cluster* get_custom_layer_boundary_docs(Application_Links* app, Arena* arena);
 #undef STATIC_LINK_API
@@ -768,6 +780,8 @@ global custom_buffer_get_dirty_state_type *buffer_get_dirty_state = 0;
 global custom_buffer_set_dirty_state_type *buffer_set_dirty_state = 0;
 global custom_buffer_set_layout_type *buffer_set_layout = 0;
 global custom_buffer_clear_layout_cache_type *buffer_clear_layout_cache = 0;
+global custom_buffer_get_layout_cache_stats_type *buffer_get_layout_cache_stats = 0;
+global custom_set_layout_cache_budget_type *set_layout_cache_budget = 0;
 global custom_buffer_get_layout_type *buffer_get_layout = 0;
 global custom_buffer_get_setting_type *buffer_get_setting = 0;
 global custom_buffer_set_setting_type *buffer_set_setting = 0;
@@ -902,6 +916,7 @@ global custom_draw_text_layout_type *draw_text_layout = 0;
 global custom_open_color_picker_type *open_color_picker = 0;
 global custom_animate_in_n_milliseconds_type *animate_in_n_milliseconds = 0;
 global custom_buffer_find_all_matches_type *buffer_find_all_matches = 0;
+global custom_string_find_all_matches_type *string_find_all_matches = 0;
 global custom_get_core_profile_list_type *get_core_profile_list = 0;
 global custom_get_custom_layer_boundary_docs_type *get_custom_layer_boundary_docs = 0;
 #undef DYNAMIC_LINK_API
@@ -280,6 +280,16 @@ custom_api_construct(Arena *arena){
         api_param(arena, call, "Application_Links*", "app");
         api_param(arena, call, "Buffer_ID", "buffer_id");
     }
+    {
+        API_Call *call = api_call_with_location(arena, result, string_u8_litexpr("buffer_get_layout_cache_stats"), string_u8_litexpr("Layout_Cache_Stats"), string_u8_litexpr(""));
+        api_param(arena, call, "Application_Links*", "app");
+        api_param(arena, call, "Buffer_ID", "buffer_id");
+    }
+    {
+        API_Call *call = api_call_with_location(arena, result, string_u8_litexpr("set_layout_cache_budget"), string_u8_litexpr("void"), string_u8_litexpr(""));
+        api_param(arena, call, "Application_Links*", "app");
+        api_param(arena, call, "u64", "bytes_per_buffer");
+    }
     {
         API_Call *call = api_call_with_location(arena, result, string_u8_litexpr("buffer_get_layout"), string_u8_litexpr("Layout_Function*"), string_u8_litexpr(""));
         api_param(arena, call, "Application_Links*", "app");
@@ -1033,6 +1043,18 @@ custom_api_construct(Arena *arena){
         api_param(arena, call, "Character_Predicate*", "predicate");
         api_param(arena, call, "Scan_Direction", "direction");
     }
+    {
+        API_Call *call = api_call_with_location(arena, result, string_u8_litexpr("string_find_all_matches"), string_u8_litexpr("String_Match_List"), string_u8_litexpr(""));
+        api_param(arena, call, "Application_Links*", "app");
+        api_param(arena, call, "Arena*", "arena");
+        api_param(arena, call, "Buffer_ID", "buffer");
+        api_param(arena, call, "i32", "string_id");
+        api_param(arena, call, "String_Const_u8", "string");
+        api_param(arena, call, "i64", "base_index");
+        api_param(arena, call, "String_Const_u8", "needle");
+        api_param(arena, call, "Character_Predicate*", "predicate");
+        api_param(arena, call, "Scan_Direction", "direction");
+    }
     {
         API_Call *call = api_call_with_location(arena, result, string_u8_litexpr("get_core_profile_list"), string_u8_litexpr("Profile_Global_List*"), string_u8_litexpr(""));
         api_param(arena, call, "Application_Links*", "app");
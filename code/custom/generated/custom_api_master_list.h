@@ -43,6 +43,8 @@ api(custom) function Dirty_State buffer_get_dirty_state(Application_Links* app,
 api(custom) function b32 buffer_set_dirty_state(Application_Links* app, Buffer_ID buffer_id, Dirty_State dirty_state);
 api(custom) function b32 buffer_set_layout(Application_Links* app, Buffer_ID buffer_id, Layout_Function* layout_func);
 api(custom) function b32 buffer_clear_layout_cache(Application_Links* app, Buffer_ID buffer_id);
+api(custom) function Layout_Cache_Stats buffer_get_layout_cache_stats(Application_Links* app, Buffer_ID buffer_id);
+api(custom) function void set_layout_cache_budget(Application_Links* app, u64 bytes_per_buffer);
 api(custom) function Layout_Function* buffer_get_layout(Application_Links* app, Buffer_ID buffer_id);
 api(custom) function b32 buffer_get_setting(Application_Links* app, Buffer_ID buffer_id, Buffer_Setting_ID setting, i64* value_out);
 api(custom) function b32 buffer_set_setting(Application_Links* app, Buffer_ID buffer_id, Buffer_Setting_ID setting, i64 value);
@@ -177,5 +179,6 @@ api(custom) function void draw_text_layout(Application_Links* app, Text_Layout_I
 api(custom) function void open_color_picker(Application_Links* app, Color_Picker* picker);
 api(custom) function void animate_in_n_milliseconds(Application_Links* app, u32 n);
 api(custom) function String_Match_List buffer_find_all_matches(Application_Links* app, Arena* arena, Buffer_ID buffer, i32 string_id, Range_i64 range, String_Const_u8 needle, Character_Predicate* predicate, Scan_Direction direction);
+api(custom) function String_Match_List string_find_all_matches(Application_Links* app, Arena* arena, Buffer_ID buffer, i32 string_id, String_Const_u8 string, i64 base_index, String_Const_u8 needle, Character_Predicate* predicate, Scan_Direction direction);
 api(custom) function Profile_Global_List* get_core_profile_list(Application_Links* app);
 api(custom) function Doc_Cluster* get_custom_layer_boundary_docs(Application_Links* app, Arena* arena);
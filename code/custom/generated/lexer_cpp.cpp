@@ -44,6 +44,76 @@ lexeme_table_lookup(u64 *hash_array, String_Const_u8 *key_array,
     return(result);
 }
 
+// NOTE(allen): Returns the first position in [ptr, opl_ptr) whose byte is not in
+// the skip set.  The set is given as inclusive byte ranges, the ranges of the
+// bytes in the set, or of the bytes out of it when ranges_stop is set.  The
+// generated lexer calls this on entering a state that loops on itself, such as a
+// comment or a run of whitespace, instead of taking the switch once per byte.
+internal u8*
+lexeme_skip(u8 *ptr, u8 *opl_ptr, u8 *ranges, i32 range_count, b32 ranges_stop){
+    b32 found = false;
+#if ARCH_AVX2
+    for (;!found && ptr + 32 <= opl_ptr;){
+        __m256i v = _mm256_loadu_si256((__m256i*)ptr);
+        __m256i in_ranges = _mm256_setzero_si256();
+        for (i32 i = 0; i < range_count; i += 1){
+            __m256i t = _mm256_sub_epi8(v, _mm256_set1_epi8((char)ranges[i*2]));
+            __m256i span = _mm256_set1_epi8((char)(ranges[i*2 + 1] - ranges[i*2]));
+            in_ranges = _mm256_or_si256(in_ranges, _mm256_cmpeq_epi8(_mm256_min_epu8(t, span), t));
+        }
+        u32 mask = (u32)_mm256_movemask_epi8(in_ranges);
+        if (!ranges_stop){
+            mask = ~mask;
+        }
+        if (mask != 0){
+            ptr += bit_scan_forward_u32(mask);
+            found = true;
+        }
+        else{
+            ptr += 32;
+        }
+    }
+#elif ARCH_SSE2
+    for (;!found && ptr + 16 <= opl_ptr;){
+        __m128i v = _mm_loadu_si128((__m128i*)ptr);
+        __m128i in_ranges = _mm_setzero_si128();
+        for (i32 i = 0; i < range_count; i += 1){
+            __m128i t = _mm_sub_epi8(v, _mm_set1_epi8((char)ranges[i*2]));
+            __m128i span = _mm_set1_epi8((char)(ranges[i*2 + 1] - ranges[i*2]));
+            in_ranges = _mm_or_si128(in_ranges, _mm_cmpeq_epi8(_mm_min_epu8(t, span), t));
+        }
+        u32 mask = (u32)_mm_movemask_epi8(in_ranges);
+        if (!ranges_stop){
+            mask = (~mask) & 0xFFFF;
+        }
+        if (mask != 0){
+            ptr += bit_scan_forward_u32(mask);
+            found = true;
+        }
+        else{
+            ptr += 16;
+        }
+    }
+#endif
+    for (;!found && ptr < opl_ptr;){
+        u8 c = *ptr;
+        b32 in_ranges = false;
+        for (i32 i = 0; i < range_count; i += 1){
+            if (ranges[i*2] <= c && c <= ranges[i*2 + 1]){
+                in_ranges = true;
+                break;
+            }
+        }
+        if (in_ranges == ranges_stop){
+            found = true;
+        }
+        else{
+            ptr += 1;
+        }
+    }
+    return(ptr);
+}
+
 #endif
 u64 cpp_main_keys_hash_array[116] = {
 0x864f5e32dc9e7c55,0x0de62d905719e809,0x0de62d90823f9af7,0x0000000000000000,
@@ -497,6 +567,27 @@ state_ptr->emit_ptr = input.str;
 state_ptr->ptr = input.str;
 state_ptr->opl_ptr = input.str + input.size;
 }
+u8 cpp_skip_ranges_2[] = {0x24,0x24,0x30,0x39,0x41,0x5a,0x5f,0x5f,0x61,0x7a,0x80,0xff,};
+u8 cpp_skip_ranges_3[] = {0x09,0x09,0x0b,0x0d,0x20,0x20,};
+u8 cpp_skip_ranges_4[] = {0x0a,0x0a,};
+u8 cpp_skip_ranges_5[] = {0x0d,0x0d,};
+u8 cpp_skip_ranges_8[] = {0x30,0x39,};
+u8 cpp_skip_ranges_10[] = {0x30,0x39,};
+u8 cpp_skip_ranges_13[] = {0x30,0x39,};
+u8 cpp_skip_ranges_16[] = {0x30,0x39,0x41,0x46,0x61,0x66,};
+u8 cpp_skip_ranges_18[] = {0x30,0x31,};
+u8 cpp_skip_ranges_25[] = {0x09,0x09,0x0b,0x0c,0x20,0x20,};
+u8 cpp_skip_ranges_26[] = {0x30,0x39,0x41,0x5a,0x5f,0x5f,0x61,0x7a,};
+u8 cpp_skip_ranges_27[] = {0x20,0x3b,0x3d,0x3d,0x3f,0x5f,0x61,0x7d,};
+u8 cpp_skip_ranges_28[] = {0x20,0x21,0x23,0x5f,0x61,0x7d,};
+u8 cpp_skip_ranges_34[] = {0x0a,0x0a,0x22,0x22,0x27,0x27,0x5c,0x5c,};
+u8 cpp_skip_ranges_38[] = {0x30,0x39,0x41,0x46,0x61,0x66,};
+u8 cpp_skip_ranges_47[] = {0x20,0x20,0x28,0x29,0x5c,0x5c,};
+u8 cpp_skip_ranges_48[] = {0x29,0x29,};
+u8 cpp_skip_ranges_51[] = {0x0a,0x0a,0x2a,0x2a,};
+u8 cpp_skip_ranges_52[] = {0x2a,0x2a,};
+u8 cpp_skip_ranges_53[] = {0x0a,0x0a,0x5c,0x5c,};
+u8 cpp_skip_ranges_54[] = {0x0d,0x0d,};
 internal b32
 lex_full_input_cpp_breaks(Arena *arena, Token_List *list, Lex_State_Cpp *state_ptr, u64 max){
 b32 result = false;
@@ -546,6 +637,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -629,6 +721,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -651,6 +744,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -683,6 +777,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -736,6 +831,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -777,6 +873,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -816,6 +913,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -843,6 +941,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -865,6 +964,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -893,6 +993,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -920,6 +1021,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -942,6 +1044,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -952,6 +1055,7 @@ goto state_label_1; // root
 }
 {
 state_label_2: // identifier
+state.ptr = lexeme_skip(state.ptr, state.opl_ptr, cpp_skip_ranges_2, 6, 0);
 if (state.ptr == state.opl_ptr){
 if ((true)){
 {
@@ -1024,6 +1128,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -1039,6 +1144,7 @@ goto state_label_2; // identifier
 }
 {
 state_label_3: // whitespace
+state.ptr = lexeme_skip(state.ptr, state.opl_ptr, cpp_skip_ranges_3, 3, 0);
 if (state.ptr == state.opl_ptr){
 if ((true)){
 {
@@ -1074,6 +1180,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -1097,6 +1204,7 @@ goto state_label_3; // whitespace
 }
 {
 state_label_4: // error_body
+state.ptr = lexeme_skip(state.ptr, state.opl_ptr, cpp_skip_ranges_4, 1, 1);
 if (state.ptr == state.opl_ptr){
 if ((true)){
 {
@@ -1137,6 +1245,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -1147,6 +1256,7 @@ goto state_label_1; // root
 }
 {
 state_label_5: // backslash
+state.ptr = lexeme_skip(state.ptr, state.opl_ptr, cpp_skip_ranges_5, 1, 0);
 if (state.ptr == state.opl_ptr){
 if ((true)){
 {
@@ -1182,6 +1292,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -1204,6 +1315,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -1254,6 +1366,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -1276,6 +1389,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -1332,6 +1446,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -1364,6 +1479,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -1374,6 +1490,7 @@ goto state_label_1; // root
 }
 {
 state_label_8: // number
+state.ptr = lexeme_skip(state.ptr, state.opl_ptr, cpp_skip_ranges_8, 1, 0);
 if (state.ptr == state.opl_ptr){
 if ((true)){
 {
@@ -1409,6 +1526,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -1485,6 +1603,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -1539,6 +1658,7 @@ goto state_label_22; // l_number
 }
 {
 state_label_10: // fnumber_decimal
+state.ptr = lexeme_skip(state.ptr, state.opl_ptr, cpp_skip_ranges_10, 1, 0);
 if (state.ptr == state.opl_ptr){
 if ((true)){
 {
@@ -1574,6 +1694,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -1607,6 +1728,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -1629,6 +1751,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -1674,6 +1797,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -1707,6 +1831,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -1729,6 +1854,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -1774,6 +1900,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -1802,6 +1929,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -1824,6 +1952,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -1834,6 +1963,7 @@ goto state_label_1; // root
 }
 {
 state_label_13: // fnumber_exponent_digits
+state.ptr = lexeme_skip(state.ptr, state.opl_ptr, cpp_skip_ranges_13, 1, 0);
 if (state.ptr == state.opl_ptr){
 if ((true)){
 {
@@ -1869,6 +1999,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -1897,6 +2028,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -1919,6 +2051,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -1964,6 +2097,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -2017,6 +2151,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -2032,6 +2167,7 @@ goto state_label_18; // number_bin
 }
 {
 state_label_16: // number_hex
+state.ptr = lexeme_skip(state.ptr, state.opl_ptr, cpp_skip_ranges_16, 3, 0);
 if (state.ptr == state.opl_ptr){
 if ((true)){
 {
@@ -2067,6 +2203,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -2135,6 +2272,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -2167,6 +2305,7 @@ goto state_label_22; // l_number
 }
 {
 state_label_18: // number_bin
+state.ptr = lexeme_skip(state.ptr, state.opl_ptr, cpp_skip_ranges_18, 1, 0);
 if (state.ptr == state.opl_ptr){
 if ((true)){
 {
@@ -2202,6 +2341,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -2297,6 +2437,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -2382,6 +2523,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -2424,6 +2566,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -2499,6 +2642,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -2536,6 +2680,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -2611,6 +2756,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -2648,6 +2794,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -2728,6 +2875,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -2765,6 +2913,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -2840,6 +2989,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -2877,6 +3027,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -2887,6 +3038,7 @@ goto state_label_1; // root
 }
 {
 state_label_25: // pp_directive_whitespace
+state.ptr = lexeme_skip(state.ptr, state.opl_ptr, cpp_skip_ranges_25, 3, 0);
 if (state.ptr == state.opl_ptr){
 if ((true)){
 {
@@ -2922,6 +3074,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -2952,6 +3105,7 @@ goto state_label_26; // pp_directive
 }
 {
 state_label_26: // pp_directive
+state.ptr = lexeme_skip(state.ptr, state.opl_ptr, cpp_skip_ranges_26, 4, 0);
 if (state.ptr == state.opl_ptr){
 if ((true)){
 state.delim_one_past_last = state.ptr;
@@ -3021,6 +3175,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -3044,6 +3199,7 @@ goto state_label_26; // pp_directive
 }
 {
 state_label_27: // include_pointy
+state.ptr = lexeme_skip(state.ptr, state.opl_ptr, cpp_skip_ranges_27, 4, 0);
 if (state.ptr == state.opl_ptr){
 if ((true)){
 {
@@ -3079,6 +3235,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -3118,6 +3275,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -3128,6 +3286,7 @@ goto state_label_1; // root
 }
 {
 state_label_28: // include_quotes
+state.ptr = lexeme_skip(state.ptr, state.opl_ptr, cpp_skip_ranges_28, 3, 0);
 if (state.ptr == state.opl_ptr){
 if ((true)){
 {
@@ -3163,6 +3322,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -3203,6 +3363,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -3335,6 +3496,7 @@ goto state_label_47; // raw_string_get_delim
 }
 {
 state_label_34: // string
+state.ptr = lexeme_skip(state.ptr, state.opl_ptr, cpp_skip_ranges_34, 4, 1);
 if (state.ptr == state.opl_ptr){
 if ((true)){
 {
@@ -3375,6 +3537,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -3418,6 +3581,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -3464,6 +3628,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -3587,6 +3752,7 @@ goto state_label_34; // string
 }
 {
 state_label_38: // string_esc_hex
+state.ptr = lexeme_skip(state.ptr, state.opl_ptr, cpp_skip_ranges_38, 3, 0);
 if (state.ptr == state.opl_ptr){
 if ((true)){
 goto state_label_34; // string
@@ -3785,6 +3951,7 @@ goto state_label_34; // string
 }
 {
 state_label_47: // raw_string_get_delim
+state.ptr = lexeme_skip(state.ptr, state.opl_ptr, cpp_skip_ranges_47, 3, 1);
 if (state.ptr == state.opl_ptr){
 if ((true)){
 {
@@ -3841,6 +4008,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -3857,6 +4025,7 @@ goto state_label_48; // raw_string_find_close
 }
 {
 state_label_48: // raw_string_find_close
+state.ptr = lexeme_skip(state.ptr, state.opl_ptr, cpp_skip_ranges_48, 1, 1);
 if (state.ptr == state.opl_ptr){
 if ((true)){
 {
@@ -3972,6 +4141,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -3982,6 +4152,7 @@ goto state_label_1; // root
 }
 {
 state_label_51: // comment_block
+state.ptr = lexeme_skip(state.ptr, state.opl_ptr, cpp_skip_ranges_51, 2, 1);
 if (state.ptr == state.opl_ptr){
 if ((true)){
 {
@@ -4038,6 +4209,7 @@ goto state_label_52; // comment_block_try_close
 }
 {
 state_label_52: // comment_block_try_close
+state.ptr = lexeme_skip(state.ptr, state.opl_ptr, cpp_skip_ranges_52, 1, 0);
 if (state.ptr == state.opl_ptr){
 if ((true)){
 {
@@ -4099,6 +4271,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -4109,6 +4282,7 @@ goto state_label_1; // root
 }
 {
 state_label_53: // comment_line
+state.ptr = lexeme_skip(state.ptr, state.opl_ptr, cpp_skip_ranges_53, 2, 1);
 if (state.ptr == state.opl_ptr){
 if ((true)){
 {
@@ -4149,6 +4323,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -4164,6 +4339,7 @@ goto state_label_54; // comment_line_backslashing
 }
 {
 state_label_54: // comment_line_backslashing
+state.ptr = lexeme_skip(state.ptr, state.opl_ptr, cpp_skip_ranges_54, 1, 0);
 if (state.ptr == state.opl_ptr){
 if ((true)){
 result = true;
@@ -4220,6 +4396,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -4242,6 +4419,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -4287,6 +4465,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -4309,6 +4488,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -4331,6 +4511,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -4376,6 +4557,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -4398,6 +4580,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -4420,6 +4603,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -4470,6 +4654,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -4492,6 +4677,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -4537,6 +4723,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -4592,6 +4779,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -4614,6 +4802,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -4664,6 +4853,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -4686,6 +4876,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -4731,6 +4922,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -4753,6 +4945,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -4798,6 +4991,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -4820,6 +5014,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -4865,6 +5060,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -4887,6 +5083,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -4932,6 +5129,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -4954,6 +5152,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -4999,6 +5198,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -5021,6 +5221,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -5066,6 +5267,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -5088,6 +5290,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -5133,6 +5336,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -5155,6 +5359,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -5200,6 +5405,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -5222,6 +5428,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -5267,6 +5474,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -5289,6 +5497,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -5334,6 +5543,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -5356,6 +5566,7 @@ token_list_push(arena, list, &token);
 emit_counter += 1;
 state.emit_ptr = state.ptr;
 if (emit_counter == max){
+state.flags_ZF0 = 0;
 goto end;
 }
 }
@@ -387,3 +387,4 @@ char *token_cpp_kind_names[] = {
 "PPUnknown",
 "PPDefined",
 };
+#define lexer_cpp_version 0x07e1182e64eb2f8fULL
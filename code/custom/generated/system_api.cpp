@@ -7,11 +7,19 @@ system_api_fill_vtable(API_VTable_system *vtable){
     vtable->get_canonical = system_get_canonical;
     vtable->get_file_list = system_get_file_list;
     vtable->quick_file_attributes = system_quick_file_attributes;
+    vtable->add_listener = system_add_listener;
+    vtable->remove_listener = system_remove_listener;
+    vtable->get_file_changes = system_get_file_changes;
     vtable->load_handle = system_load_handle;
     vtable->load_attributes = system_load_attributes;
     vtable->load_file = system_load_file;
+    vtable->load_map = system_load_map;
+    vtable->load_unmap = system_load_unmap;
     vtable->load_close = system_load_close;
     vtable->save_file = system_save_file;
+    vtable->append_file = system_append_file;
+    vtable->create_directory = system_create_directory;
+    vtable->delete_file = system_delete_file;
     vtable->load_library = system_load_library;
     vtable->release_library = system_release_library;
     vtable->get_proc = system_get_proc;
@@ -38,6 +46,7 @@ system_api_fill_vtable(API_VTable_system *vtable){
     vtable->thread_join = system_thread_join;
     vtable->thread_free = system_thread_free;
     vtable->thread_get_id = system_thread_get_id;
+    vtable->thread_get_processor_count = system_thread_get_processor_count;
     vtable->acquire_global_frame_mutex = system_acquire_global_frame_mutex;
     vtable->release_global_frame_mutex = system_release_global_frame_mutex;
     vtable->mutex_make = system_mutex_make;
@@ -69,11 +78,19 @@ system_api_read_vtable(API_VTable_system *vtable){
     system_get_canonical = vtable->get_canonical;
     system_get_file_list = vtable->get_file_list;
     system_quick_file_attributes = vtable->quick_file_attributes;
+    system_add_listener = vtable->add_listener;
+    system_remove_listener = vtable->remove_listener;
+    system_get_file_changes = vtable->get_file_changes;
     system_load_handle = vtable->load_handle;
     system_load_attributes = vtable->load_attributes;
     system_load_file = vtable->load_file;
+    system_load_map = vtable->load_map;
+    system_load_unmap = vtable->load_unmap;
     system_load_close = vtable->load_close;
     system_save_file = vtable->save_file;
+    system_append_file = vtable->append_file;
+    system_create_directory = vtable->create_directory;
+    system_delete_file = vtable->delete_file;
     system_load_library = vtable->load_library;
     system_release_library = vtable->release_library;
     system_get_proc = vtable->get_proc;
@@ -100,6 +117,7 @@ system_api_read_vtable(API_VTable_system *vtable){
     system_thread_join = vtable->thread_join;
     system_thread_free = vtable->thread_free;
     system_thread_get_id = vtable->thread_get_id;
+    system_thread_get_processor_count = vtable->thread_get_processor_count;
     system_acquire_global_frame_mutex = vtable->acquire_global_frame_mutex;
     system_release_global_frame_mutex = vtable->release_global_frame_mutex;
     system_mutex_make = vtable->mutex_make;
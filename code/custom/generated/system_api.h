@@ -5,11 +5,19 @@
 #define system_get_canonical_sig() String_Const_u8 system_get_canonical(Arena* arena, String_Const_u8 name)
 #define system_get_file_list_sig() File_List system_get_file_list(Arena* arena, String_Const_u8 directory)
 #define system_quick_file_attributes_sig() File_Attributes system_quick_file_attributes(Arena* scratch, String_Const_u8 file_name)
+#define system_add_listener_sig() b32 system_add_listener(Arena* scratch, String_Const_u8 dir_name)
+#define system_remove_listener_sig() b32 system_remove_listener(Arena* scratch, String_Const_u8 dir_name)
+#define system_get_file_changes_sig() List_String_Const_u8 system_get_file_changes(Arena* arena, u64 wait_us, b32* lost_changes)
 #define system_load_handle_sig() b32 system_load_handle(Arena* scratch, char* file_name, Plat_Handle* out)
 #define system_load_attributes_sig() File_Attributes system_load_attributes(Plat_Handle handle)
 #define system_load_file_sig() b32 system_load_file(Plat_Handle handle, char* buffer, u32 size)
+#define system_load_map_sig() void* system_load_map(Plat_Handle handle, u64 size)
+#define system_load_unmap_sig() b32 system_load_unmap(void* ptr, u64 size)
 #define system_load_close_sig() b32 system_load_close(Plat_Handle handle)
 #define system_save_file_sig() File_Attributes system_save_file(Arena* scratch, char* file_name, String_Const_u8 data)
+#define system_append_file_sig() b32 system_append_file(Arena* scratch, char* file_name, String_Const_u8 data)
+#define system_create_directory_sig() b32 system_create_directory(Arena* scratch, char* path)
+#define system_delete_file_sig() b32 system_delete_file(Arena* scratch, char* file_name)
 #define system_load_library_sig() b32 system_load_library(Arena* scratch, String_Const_u8 file_name, System_Library* out)
 #define system_release_library_sig() b32 system_release_library(System_Library handle)
 #define system_get_proc_sig() Void_Func* system_get_proc(System_Library handle, char* proc_name)
@@ -36,6 +44,7 @@
 #define system_thread_join_sig() void system_thread_join(System_Thread thread)
 #define system_thread_free_sig() void system_thread_free(System_Thread thread)
 #define system_thread_get_id_sig() i32 system_thread_get_id(void)
+#define system_thread_get_processor_count_sig() i32 system_thread_get_processor_count(void)
 #define system_acquire_global_frame_mutex_sig() void system_acquire_global_frame_mutex(Thread_Context* tctx)
 #define system_release_global_frame_mutex_sig() void system_release_global_frame_mutex(Thread_Context* tctx)
 #define system_mutex_make_sig() System_Mutex system_mutex_make(void)
@@ -63,11 +72,19 @@ typedef String_Const_u8 system_get_path_type(Arena* arena, System_Path_Code path
 typedef String_Const_u8 system_get_canonical_type(Arena* arena, String_Const_u8 name);
 typedef File_List system_get_file_list_type(Arena* arena, String_Const_u8 directory);
 typedef File_Attributes system_quick_file_attributes_type(Arena* scratch, String_Const_u8 file_name);
+typedef b32 system_add_listener_type(Arena* scratch, String_Const_u8 dir_name);
+typedef b32 system_remove_listener_type(Arena* scratch, String_Const_u8 dir_name);
+typedef List_String_Const_u8 system_get_file_changes_type(Arena* arena, u64 wait_us, b32* lost_changes);
 typedef b32 system_load_handle_type(Arena* scratch, char* file_name, Plat_Handle* out);
 typedef File_Attributes system_load_attributes_type(Plat_Handle handle);
 typedef b32 system_load_file_type(Plat_Handle handle, char* buffer, u32 size);
+typedef void* system_load_map_type(Plat_Handle handle, u64 size);
+typedef b32 system_load_unmap_type(void* ptr, u64 size);
 typedef b32 system_load_close_type(Plat_Handle handle);
 typedef File_Attributes system_save_file_type(Arena* scratch, char* file_name, String_Const_u8 data);
+typedef b32 system_append_file_type(Arena* scratch, char* file_name, String_Const_u8 data);
+typedef b32 system_create_directory_type(Arena* scratch, char* path);
+typedef b32 system_delete_file_type(Arena* scratch, char* file_name);
 typedef b32 system_load_library_type(Arena* scratch, String_Const_u8 file_name, System_Library* out);
 typedef b32 system_release_library_type(System_Library handle);
 typedef Void_Func* system_get_proc_type(System_Library handle, char* proc_name);
@@ -94,6 +111,7 @@ typedef System_Thread system_thread_launch_type(Thread_Function* proc, void* ptr
 typedef void system_thread_join_type(System_Thread thread);
 typedef void system_thread_free_type(System_Thread thread);
 typedef i32 system_thread_get_id_type(void);
+typedef i32 system_thread_get_processor_count_type(void);
 typedef void system_acquire_global_frame_mutex_type(Thread_Context* tctx);
 typedef void system_release_global_frame_mutex_type(Thread_Context* tctx);
 typedef System_Mutex system_mutex_make_type(void);
@@ -122,11 +140,19 @@ struct API_VTable_system{
     system_get_canonical_type *get_canonical;
     system_get_file_list_type *get_file_list;
     system_quick_file_attributes_type *quick_file_attributes;
+    system_add_listener_type *add_listener;
+    system_remove_listener_type *remove_listener;
+    system_get_file_changes_type *get_file_changes;
     system_load_handle_type *load_handle;
     system_load_attributes_type *load_attributes;
     system_load_file_type *load_file;
+    system_load_map_type *load_map;
+    system_load_unmap_type *load_unmap;
     system_load_close_type *load_close;
     system_save_file_type *save_file;
+    system_append_file_type *append_file;
+    system_create_directory_type *create_directory;
+    system_delete_file_type *delete_file;
     system_load_library_type *load_library;
     system_release_library_type *release_library;
     system_get_proc_type *get_proc;
@@ -153,6 +179,7 @@ struct API_VTable_system{
     system_thread_join_type *thread_join;
     system_thread_free_type *thread_free;
     system_thread_get_id_type *thread_get_id;
+    system_thread_get_processor_count_type *thread_get_processor_count;
     system_acquire_global_frame_mutex_type *acquire_global_frame_mutex;
     system_release_global_frame_mutex_type *release_global_frame_mutex;
     system_mutex_make_type *mutex_make;
@@ -182,11 +209,19 @@ internal String_Const_u8 system_get_path(Arena* arena, System_Path_Code path_cod
 internal String_Const_u8 system_get_canonical(Arena* arena, String_Const_u8 name);
 internal File_List system_get_file_list(Arena* arena, String_Const_u8 directory);
 internal File_Attributes system_quick_file_attributes(Arena* scratch, String_Const_u8 file_name);
+internal b32 system_add_listener(Arena* scratch, String_Const_u8 dir_name);
+internal b32 system_remove_listener(Arena* scratch, String_Const_u8 dir_name);
+internal List_String_Const_u8 system_get_file_changes(Arena* arena, u64 wait_us, b32* lost_changes);
 internal b32 system_load_handle(Arena* scratch, char* file_name, Plat_Handle* out);
 internal File_Attributes system_load_attributes(Plat_Handle handle);
 internal b32 system_load_file(Plat_Handle handle, char* buffer, u32 size);
+internal void* system_load_map(Plat_Handle handle, u64 size);
+internal b32 system_load_unmap(void* ptr, u64 size);
 internal b32 system_load_close(Plat_Handle handle);
 internal File_Attributes system_save_file(Arena* scratch, char* file_name, String_Const_u8 data);
+internal b32 system_append_file(Arena* scratch, char* file_name, String_Const_u8 data);
+internal b32 system_create_directory(Arena* scratch, char* path);
+internal b32 system_delete_file(Arena* scratch, char* file_name);
 internal b32 system_load_library(Arena* scratch, String_Const_u8 file_name, System_Library* out);
 internal b32 system_release_library(System_Library handle);
 internal Void_Func* system_get_proc(System_Library handle, char* proc_name);
@@ -213,6 +248,7 @@ internal System_Thread system_thread_launch(Thread_Function* proc, void* ptr);
 internal void system_thread_join(System_Thread thread);
 internal void system_thread_free(System_Thread thread);
 internal i32 system_thread_get_id(void);
+internal i32 system_thread_get_processor_count(void);
 internal void system_acquire_global_frame_mutex(Thread_Context* tctx);
 internal void system_release_global_frame_mutex(Thread_Context* tctx);
 internal System_Mutex system_mutex_make(void);
@@ -242,11 +278,19 @@ global system_get_path_type *system_get_path = 0;
 global system_get_canonical_type *system_get_canonical = 0;
 global system_get_file_list_type *system_get_file_list = 0;
 global system_quick_file_attributes_type *system_quick_file_attributes = 0;
+global system_add_listener_type *system_add_listener = 0;
+global system_remove_listener_type *system_remove_listener = 0;
+global system_get_file_changes_type *system_get_file_changes = 0;
 global system_load_handle_type *system_load_handle = 0;
 global system_load_attributes_type *system_load_attributes = 0;
 global system_load_file_type *system_load_file = 0;
+global system_load_map_type *system_load_map = 0;
+global system_load_unmap_type *system_load_unmap = 0;
 global system_load_close_type *system_load_close = 0;
 global system_save_file_type *system_save_file = 0;
+global system_append_file_type *system_append_file = 0;
+global system_create_directory_type *system_create_directory = 0;
+global system_delete_file_type *system_delete_file = 0;
 global system_load_library_type *system_load_library = 0;
 global system_release_library_type *system_release_library = 0;
 global system_get_proc_type *system_get_proc = 0;
@@ -273,6 +317,7 @@ global system_thread_launch_type *system_thread_launch = 0;
 global system_thread_join_type *system_thread_join = 0;
 global system_thread_free_type *system_thread_free = 0;
 global system_thread_get_id_type *system_thread_get_id = 0;
+global system_thread_get_processor_count_type *system_thread_get_processor_count = 0;
 global system_acquire_global_frame_mutex_type *system_acquire_global_frame_mutex = 0;
 global system_release_global_frame_mutex_type *system_release_global_frame_mutex = 0;
 global system_mutex_make_type *system_mutex_make = 0;
@@ -27,6 +27,22 @@ system_api_construct(Arena *arena){
         api_param(arena, call, "Arena*", "scratch");
         api_param(arena, call, "String_Const_u8", "file_name");
     }
+    {
+        API_Call *call = api_call_with_location(arena, result, string_u8_litexpr("add_listener"), string_u8_litexpr("b32"), string_u8_litexpr(""));
+        api_param(arena, call, "Arena*", "scratch");
+        api_param(arena, call, "String_Const_u8", "dir_name");
+    }
+    {
+        API_Call *call = api_call_with_location(arena, result, string_u8_litexpr("remove_listener"), string_u8_litexpr("b32"), string_u8_litexpr(""));
+        api_param(arena, call, "Arena*", "scratch");
+        api_param(arena, call, "String_Const_u8", "dir_name");
+    }
+    {
+        API_Call *call = api_call_with_location(arena, result, string_u8_litexpr("get_file_changes"), string_u8_litexpr("List_String_Const_u8"), string_u8_litexpr(""));
+        api_param(arena, call, "Arena*", "arena");
+        api_param(arena, call, "u64", "wait_us");
+        api_param(arena, call, "b32*", "lost_changes");
+    }
     {
         API_Call *call = api_call_with_location(arena, result, string_u8_litexpr("load_handle"), string_u8_litexpr("b32"), string_u8_litexpr(""));
         api_param(arena, call, "Arena*", "scratch");
@@ -43,6 +59,16 @@ system_api_construct(Arena *arena){
         api_param(arena, call, "char*", "buffer");
         api_param(arena, call, "u32", "size");
     }
+    {
+        API_Call *call = api_call_with_location(arena, result, string_u8_litexpr("load_map"), string_u8_litexpr("void*"), string_u8_litexpr(""));
+        api_param(arena, call, "Plat_Handle", "handle");
+        api_param(arena, call, "u64", "size");
+    }
+    {
+        API_Call *call = api_call_with_location(arena, result, string_u8_litexpr("load_unmap"), string_u8_litexpr("b32"), string_u8_litexpr(""));
+        api_param(arena, call, "void*", "ptr");
+        api_param(arena, call, "u64", "size");
+    }
     {
         API_Call *call = api_call_with_location(arena, result, string_u8_litexpr("load_close"), string_u8_litexpr("b32"), string_u8_litexpr(""));
         api_param(arena, call, "Plat_Handle", "handle");
@@ -53,6 +79,22 @@ system_api_construct(Arena *arena){
         api_param(arena, call, "char*", "file_name");
         api_param(arena, call, "String_Const_u8", "data");
     }
+    {
+        API_Call *call = api_call_with_location(arena, result, string_u8_litexpr("append_file"), string_u8_litexpr("b32"), string_u8_litexpr(""));
+        api_param(arena, call, "Arena*", "scratch");
+        api_param(arena, call, "char*", "file_name");
+        api_param(arena, call, "String_Const_u8", "data");
+    }
+    {
+        API_Call *call = api_call_with_location(arena, result, string_u8_litexpr("create_directory"), string_u8_litexpr("b32"), string_u8_litexpr(""));
+        api_param(arena, call, "Arena*", "scratch");
+        api_param(arena, call, "char*", "path");
+    }
+    {
+        API_Call *call = api_call_with_location(arena, result, string_u8_litexpr("delete_file"), string_u8_litexpr("b32"), string_u8_litexpr(""));
+        api_param(arena, call, "Arena*", "scratch");
+        api_param(arena, call, "char*", "file_name");
+    }
     {
         API_Call *call = api_call_with_location(arena, result, string_u8_litexpr("load_library"), string_u8_litexpr("b32"), string_u8_litexpr(""));
         api_param(arena, call, "Arena*", "scratch");
@@ -170,6 +212,10 @@ system_api_construct(Arena *arena){
         API_Call *call = api_call_with_location(arena, result, string_u8_litexpr("thread_get_id"), string_u8_litexpr("i32"), string_u8_litexpr(""));
         (void)call;
     }
+    {
+        API_Call *call = api_call_with_location(arena, result, string_u8_litexpr("thread_get_processor_count"), string_u8_litexpr("i32"), string_u8_litexpr(""));
+        (void)call;
+    }
     {
         API_Call *call = api_call_with_location(arena, result, string_u8_litexpr("acquire_global_frame_mutex"), string_u8_litexpr("void"), string_u8_litexpr(""));
         api_param(arena, call, "Thread_Context*", "tctx");
@@ -5,11 +5,19 @@ api(system) function String_Const_u8 get_path(Arena* arena, System_Path_Code pat
 api(system) function String_Const_u8 get_canonical(Arena* arena, String_Const_u8 name);
 api(system) function File_List get_file_list(Arena* arena, String_Const_u8 directory);
 api(system) function File_Attributes quick_file_attributes(Arena* scratch, String_Const_u8 file_name);
+api(system) function b32 add_listener(Arena* scratch, String_Const_u8 dir_name);
+api(system) function b32 remove_listener(Arena* scratch, String_Const_u8 dir_name);
+api(system) function List_String_Const_u8 get_file_changes(Arena* arena, u64 wait_us, b32* lost_changes);
 api(system) function b32 load_handle(Arena* scratch, char* file_name, Plat_Handle* out);
 api(system) function File_Attributes load_attributes(Plat_Handle handle);
 api(system) function b32 load_file(Plat_Handle handle, char* buffer, u32 size);
+api(system) function void* load_map(Plat_Handle handle, u64 size);
+api(system) function b32 load_unmap(void* ptr, u64 size);
 api(system) function b32 load_close(Plat_Handle handle);
 api(system) function File_Attributes save_file(Arena* scratch, char* file_name, String_Const_u8 data);
+api(system) function b32 append_file(Arena* scratch, char* file_name, String_Const_u8 data);
+api(system) function b32 create_directory(Arena* scratch, char* path);
+api(system) function b32 delete_file(Arena* scratch, char* file_name);
 api(system) function b32 load_library(Arena* scratch, String_Const_u8 file_name, System_Library* out);
 api(system) function b32 release_library(System_Library handle);
 api(system) function Void_Func* get_proc(System_Library handle, char* proc_name);
@@ -36,6 +44,7 @@ api(system) function System_Thread thread_launch(Thread_Function* proc, void* pt
 api(system) function void thread_join(System_Thread thread);
 api(system) function void thread_free(System_Thread thread);
 api(system) function i32 thread_get_id(void);
+api(system) function i32 thread_get_processor_count(void);
 api(system) function void acquire_global_frame_mutex(Thread_Context* tctx);
 api(system) function void release_global_frame_mutex(Thread_Context* tctx);
 api(system) function System_Mutex mutex_make(void);
@@ -0,0 +1,162 @@
+/*
+4coder_cpp_lexer_bench.cpp - Measures the throughput of the generated C++ lexer.
+
+Lexes every .c, .cpp, .h and .hpp file under the code directory, or under the
+folder passed as the first argument, and prints MB/s along with a checksum of
+the tokens so the output of two builds of the lexer can be compared.
+
+Build from the custom directory, for example:
+g++ -O2 -I. languages/4coder_cpp_lexer_bench.cpp -o cpp_lexer_bench
+add -mavx2 to measure the AVX2 skip loops.
+*/
+
+// TOP
+
+#include "4coder_base_types.h"
+#include "4coder_token.h"
+#include "generated/lexer_cpp.h"
+
+#include "4coder_base_types.cpp"
+#include "4coder_token.cpp"
+#include "generated/lexer_cpp.cpp"
+
+#include "4coder_stringf.cpp"
+#include "4coder_malloc_allocator.cpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <dirent.h>
+
+internal u64
+bench_now_us(void){
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return((u64)t.tv_sec*Million(1) + (u64)t.tv_nsec/Thousand(1));
+}
+
+internal String_Const_u8
+bench_read_file(Arena *arena, char *name){
+    String_Const_u8 result = {};
+    FILE *file = fopen(name, "rb");
+    if (file != 0){
+        fseek(file, 0, SEEK_END);
+        result.size = ftell(file);
+        fseek(file, 0, SEEK_SET);
+        result.str = push_array(arena, u8, result.size);
+        fread(result.str, result.size, 1, file);
+        fclose(file);
+    }
+    return(result);
+}
+
+internal b32
+bench_is_source(String_Const_u8 name){
+    String_Const_u8 ext = string_file_extension(name);
+    return(string_match(ext, string_u8_litexpr("c")) ||
+           string_match(ext, string_u8_litexpr("cpp")) ||
+           string_match(ext, string_u8_litexpr("h")) ||
+           string_match(ext, string_u8_litexpr("hpp")));
+}
+
+internal void
+bench_read_folder(Arena *arena, List_String_Const_u8 *list, char *folder){
+    DIR *dir = opendir(folder);
+    if (dir != 0){
+        for (struct dirent *entry = readdir(dir);
+             entry != 0;
+             entry = readdir(dir)){
+            if (entry->d_name[0] == '.'){
+                continue;
+            }
+            String_Const_u8 path = push_u8_stringf(arena, "%s/%s", folder, entry->d_name);
+            if (entry->d_type == DT_DIR){
+                bench_read_folder(arena, list, (char*)path.str);
+            }
+            else if (bench_is_source(SCu8(entry->d_name))){
+                String_Const_u8 text = bench_read_file(arena, (char*)path.str);
+                if (text.size > 0){
+                    string_list_push(arena, list, text);
+                }
+            }
+        }
+        closedir(dir);
+    }
+}
+
+internal u64
+bench_token_checksum(u64 hash, Token_List *list){
+    for (Token_Block *block = list->first;
+         block != 0;
+         block = block->next){
+        for (i64 i = 0; i < block->count; i += 1){
+            Token *token = &block->tokens[i];
+            u64 fields[] = {
+                (u64)token->pos, (u64)token->size,
+                (u64)token->kind | ((u64)token->sub_kind << 16),
+                (u64)token->flags | ((u64)token->sub_flags << 16),
+            };
+            for (i32 j = 0; j < ArrayCount(fields); j += 1){
+                hash = (hash ^ fields[j])*0x100000001b3;
+            }
+        }
+    }
+    return(hash);
+}
+
+int main(int argc, char **argv){
+    Arena arena_ = make_arena_malloc();
+    Arena *arena = &arena_;
+    
+    String_Const_u8 folder = {};
+    if (argc > 1){
+        folder = SCu8(argv[1]);
+    }
+    else{
+        String_Const_u8 path_to_self = string_u8_litexpr(__FILE__);
+        path_to_self = string_remove_last_folder(path_to_self);
+        path_to_self = string_remove_last_folder(path_to_self);
+        folder = push_u8_stringf(arena, "%.*s..", string_expand(path_to_self));
+    }
+    
+    List_String_Const_u8 corpus = {};
+    bench_read_folder(arena, &corpus, (char*)folder.str);
+    if (corpus.node_count == 0){
+        printf("error: no source files under %.*s\n", string_expand(folder));
+        exit(1);
+    }
+    
+    // NOTE(allen): Reports the fastest of several passes over the corpus, which
+    // holds up much better than the average on a busy machine.
+    i32 repeat = 20;
+    u64 best_time = max_u64;
+    u64 token_count = 0;
+    u64 checksum = 0xcbf29ce484222325;
+    for (i32 r = 0; r < repeat; r += 1){
+        u64 pass_time = 0;
+        for (Node_String_Const_u8 *node = corpus.first;
+             node != 0;
+             node = node->next){
+            Temp_Memory temp = begin_temp(arena);
+            u64 start = bench_now_us();
+            Token_List list = lex_full_input_cpp(arena, node->string);
+            u64 end = bench_now_us();
+            pass_time += end - start;
+            if (r == 0){
+                token_count += list.total_count;
+                checksum = bench_token_checksum(checksum, &list);
+            }
+            end_temp(temp);
+        }
+        best_time = Min(best_time, pass_time);
+    }
+    
+    f64 mb = (f64)corpus.total_size/(f64)MB(1);
+    printf("%d files %.1f MB %llu tokens checksum %016llx | lex_full_input_cpp %8.1f MB/s\n",
+           corpus.node_count, mb, token_count, checksum,
+           mb/((f64)clamp_bot(1, best_time)/Million(1)));
+    
+    return(0);
+}
+
+// BOTTOM
@@ -42,4 +42,74 @@ lexeme_table_lookup(u64 *hash_array, String_Const_u8 *key_array,
     return(result);
 }
 
+// NOTE(allen): Returns the first position in [ptr, opl_ptr) whose byte is not in
+// the skip set.  The set is given as inclusive byte ranges, the ranges of the
+// bytes in the set, or of the bytes out of it when ranges_stop is set.  The
+// generated lexer calls this on entering a state that loops on itself, such as a
+// comment or a run of whitespace, instead of taking the switch once per byte.
+internal u8*
+lexeme_skip(u8 *ptr, u8 *opl_ptr, u8 *ranges, i32 range_count, b32 ranges_stop){
+    b32 found = false;
+#if ARCH_AVX2
+    for (;!found && ptr + 32 <= opl_ptr;){
+        __m256i v = _mm256_loadu_si256((__m256i*)ptr);
+        __m256i in_ranges = _mm256_setzero_si256();
+        for (i32 i = 0; i < range_count; i += 1){
+            __m256i t = _mm256_sub_epi8(v, _mm256_set1_epi8((char)ranges[i*2]));
+            __m256i span = _mm256_set1_epi8((char)(ranges[i*2 + 1] - ranges[i*2]));
+            in_ranges = _mm256_or_si256(in_ranges, _mm256_cmpeq_epi8(_mm256_min_epu8(t, span), t));
+        }
+        u32 mask = (u32)_mm256_movemask_epi8(in_ranges);
+        if (!ranges_stop){
+            mask = ~mask;
+        }
+        if (mask != 0){
+            ptr += bit_scan_forward_u32(mask);
+            found = true;
+        }
+        else{
+            ptr += 32;
+        }
+    }
+#elif ARCH_SSE2
+    for (;!found && ptr + 16 <= opl_ptr;){
+        __m128i v = _mm_loadu_si128((__m128i*)ptr);
+        __m128i in_ranges = _mm_setzero_si128();
+        for (i32 i = 0; i < range_count; i += 1){
+            __m128i t = _mm_sub_epi8(v, _mm_set1_epi8((char)ranges[i*2]));
+            __m128i span = _mm_set1_epi8((char)(ranges[i*2 + 1] - ranges[i*2]));
+            in_ranges = _mm_or_si128(in_ranges, _mm_cmpeq_epi8(_mm_min_epu8(t, span), t));
+        }
+        u32 mask = (u32)_mm_movemask_epi8(in_ranges);
+        if (!ranges_stop){
+            mask = (~mask) & 0xFFFF;
+        }
+        if (mask != 0){
+            ptr += bit_scan_forward_u32(mask);
+            found = true;
+        }
+        else{
+            ptr += 16;
+        }
+    }
+#endif
+    for (;!found && ptr < opl_ptr;){
+        u8 c = *ptr;
+        b32 in_ranges = false;
+        for (i32 i = 0; i < range_count; i += 1){
+            if (ranges[i*2] <= c && c <= ranges[i*2 + 1]){
+                in_ranges = true;
+                break;
+            }
+        }
+        if (in_ranges == ranges_stop){
+            found = true;
+        }
+        else{
+            ptr += 1;
+        }
+    }
+    return(ptr);
+}
+
 #endif
\ No newline at end of file
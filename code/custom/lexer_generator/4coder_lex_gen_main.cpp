@@ -3533,7 +3533,16 @@ gen_SLOW_action_list__cont_flow(Arena *scratch, Token_Kind_Set tokens, Flag_Set
                 fprintf(out, "emit_counter += 1;\n");
                 fprintf(out, "state.emit_ptr = state.ptr;\n");
                 if (context != ActionContext_EndOfFile){
+                    // NOTE(allen): Lexing picks up again at the root, so the flags
+                    // that entering the root would zero get zeroed here, otherwise
+                    // the token after a break sees the last token's flags.
                     fprintf(out, "if (emit_counter == max){\n");
+                    for (i32 i = 0; i < FlagBindProperty_COUNT; i += 1){
+                        Flag_Bucket *bucket = &bucket_set.buckets[i][FlagResetRule_AutoZero];
+                        for (i32 j = 0; j < bucket->number_of_variables; j += 1){
+                            fprintf(out, "state.%.*s%d = 0;\n", string_expand(bucket->pretty_name), j);
+                        }
+                    }
                     fprintf(out, "goto end;\n");
                     fprintf(out, "}\n");
                 }
@@ -3595,6 +3604,51 @@ gen_flag_fill_lookup__cont_flow(Flag_Bucket *bucket){
     }
 }
 
+// NOTE(allen): lexeme_skip tests every range on every block of input, past this
+// many ranges the switch is about as fast.
+#define lexeme_skip_max_ranges 8
+
+// NOTE(allen): Marks the bytes on which the state goes straight back to itself
+// doing nothing but consuming the byte, and returns how many there are.
+internal i32
+opt_self_loop_inputs(Grouped_Input_Handler_List group_list, State *state, b8 *inputs_out){
+    block_zero(inputs_out, 256);
+    i32 result = 0;
+    for (Grouped_Input_Handler *group = group_list.first;
+         group != 0;
+         group = group->next){
+        Partial_Transition *partial = group->partial_transitions.first;
+        if (partial != 0 && partial->next == 0 && partial->dst_state == state &&
+            partial->actions.count == 1 && partial->actions.first->kind == ActionKind_Consume){
+            for (i32 i = 0; i < group->input_count; i += 1){
+                inputs_out[group->inputs[i]] = true;
+                result += 1;
+            }
+        }
+    }
+    return(result);
+}
+
+// NOTE(allen): Writes the inclusive ranges of bytes x with set[x] == value as
+// pairs into ranges_out and returns the number of ranges.
+internal i32
+opt_byte_ranges(b8 *set, b8 value, u8 *ranges_out){
+    i32 result = 0;
+    for (i32 x = 0; x < 256;){
+        if ((set[x] != 0) == (value != 0)){
+            i32 first = x;
+            for (;x < 256 && (set[x] != 0) == (value != 0); x += 1);
+            ranges_out[result*2] = (u8)first;
+            ranges_out[result*2 + 1] = (u8)(x - 1);
+            result += 1;
+        }
+        else{
+            x += 1;
+        }
+    }
+    return(result);
+}
+
 internal void
 gen_contiguous_control_flow_lexer(Arena *scratch, Token_Kind_Set tokens, Lexer_Model model, FILE *out){
     Temp_Memory temp = begin_temp(scratch);
@@ -3720,6 +3774,52 @@ gen_contiguous_control_flow_lexer(Arena *scratch, Token_Kind_Set tokens, Lexer_M
     fprintf(out, "state_ptr->opl_ptr = input.str + input.size;\n");
     fprintf(out, "}\n");
     
+    // NOTE(allen): States that loop on themselves over some set of bytes get a
+    // table of byte ranges for lexeme_skip, written as the set or as its
+    // complement, whichever takes fewer ranges.  Sets that still need more than
+    // lexeme_skip_max_ranges ranges are left to the switch.
+    i32 state_count = 0;
+    for (State *state = model.states.first;
+         state != 0;
+         state = state->next){
+        state_count = Max(state_count, state->number + 1);
+    }
+    i32 *skip_range_counts = push_array_zero(scratch, i32, state_count);
+    b32 *skip_ranges_stop = push_array_zero(scratch, b32, state_count);
+    for (State *state = model.states.first;
+         state != 0;
+         state = state->next){
+        Transition *trans = state->transitions.first;
+        if (trans->condition.kind == TransitionCaseKind_ConditionSet){
+            for (;trans != 0 && opt_condition_is_eof_only(trans->condition);
+                 trans = trans->next);
+            b8 skip[256];
+            i32 skip_count = 0;
+            if (trans != 0){
+                Grouped_Input_Handler_List group_list = opt_grouped_input_handlers(scratch, trans);
+                skip_count = opt_self_loop_inputs(group_list, state, skip);
+            }
+            if (skip_count > 0){
+                u8 skip_ranges[512];
+                u8 stop_ranges[512];
+                i32 skip_range_count = opt_byte_ranges(skip, true, skip_ranges);
+                i32 stop_range_count = opt_byte_ranges(skip, false, stop_ranges);
+                b32 ranges_stop = (stop_range_count < skip_range_count);
+                i32 range_count = ranges_stop?stop_range_count:skip_range_count;
+                u8 *ranges = ranges_stop?stop_ranges:skip_ranges;
+                if (range_count <= lexeme_skip_max_ranges){
+                    skip_range_counts[state->number] = range_count;
+                    skip_ranges_stop[state->number] = ranges_stop;
+                    fprintf(out, "u8 " LANG_NAME_LOWER_STR "_skip_ranges_%d[] = {", state->number);
+                    for (i32 i = 0; i < range_count*2; i += 1){
+                        fprintf(out, "0x%02x,", ranges[i]);
+                    }
+                    fprintf(out, "};\n");
+                }
+            }
+        }
+    }
+    
     fprintf(out, "internal b32\n");
     fprintf(out, "lex_full_input_" LANG_NAME_LOWER_STR "_breaks("
             "Arena *arena, Token_List *list, Lex_State_" LANG_NAME_CAMEL_STR " *state_ptr, u64 max){\n");
@@ -3791,6 +3891,13 @@ gen_contiguous_control_flow_lexer(Arena *scratch, Token_Kind_Set tokens, Lexer_M
             
             case TransitionCaseKind_ConditionSet:
             {
+                if (skip_range_counts[state->number] > 0){
+                    fprintf(out, "state.ptr = lexeme_skip(state.ptr, state.opl_ptr, "
+                            LANG_NAME_LOWER_STR "_skip_ranges_%d, %d, %d);\n",
+                            state->number, skip_range_counts[state->number],
+                            skip_ranges_stop[state->number]);
+                }
+                
                 {
                     fprintf(out, "if (state.ptr == state.opl_ptr){\n");
                     for (;
@@ -3905,6 +4012,26 @@ file_read_all(Arena *arena, FILE *file){
     return(result);
 }
 
+// NOTE(allen): FNV-1a, only used for the lexer version.
+internal u64
+lexer_version_hash(u64 hash, String_Const_u8 data){
+    for (u64 i = 0; i < data.size; i += 1){
+        hash = (hash ^ data.str[i])*0x100000001b3ULL;
+    }
+    return(hash);
+}
+
+internal String_Const_u8
+file_read_range(Arena *arena, FILE *file, i64 first, i64 one_past_last){
+    String_Const_u8 result = {};
+    result.size = (u64)(one_past_last - first);
+    result.str = push_array(arena, u8, result.size);
+    fseek(file, (long)first, SEEK_SET);
+    fread(result.str, result.size, 1, file);
+    fseek(file, 0, SEEK_END);
+    return(result);
+}
+
 int main(void){
     pcg32_srandom(time(0), time(0));
     
@@ -4006,13 +4133,13 @@ int main(void){
     String_Const_u8 out_cpp_name = push_u8_stringf(&ctx->arena, "%.*sgenerated/lexer_" LANG_NAME_LOWER_STR ".cpp",
                                                    string_expand(path_to_src));
     
-    FILE *out_h_file = fopen((char*)out_h_name.str, "wb");
+    FILE *out_h_file = fopen((char*)out_h_name.str, "w+b");
     if (out_h_file == 0){
         printf("error: could not open output file %.*s\n", string_expand(out_h_name));
         exit(1);
     }
     
-    FILE *out_cpp_file = fopen((char*)out_cpp_name.str, "wb");
+    FILE *out_cpp_file = fopen((char*)out_cpp_name.str, "w+b");
     if (out_cpp_file == 0){
         printf("error: could not open output file %.*s\n", string_expand(out_cpp_name));
         exit(1);
@@ -4033,7 +4160,33 @@ int main(void){
          set = set->next){
         gen_keyword_table(&ctx->arena, ctx->tokens, *set, out_cpp_file);
     }
+    i64 lexer_first = ftell(out_cpp_file);
     gen_contiguous_control_flow_lexer(&ctx->arena, ctx->tokens, ctx->model, out_cpp_file);
+    i64 lexer_one_past_last = ftell(out_cpp_file);
+    
+    // NOTE(allen): The version changes whenever the generated lexer could turn
+    // the same text into different tokens, so caches of lexed files can tell
+    // they are stale.  The keyword tables are reseeded on every run, so instead
+    // of their text the keywords that go in them are hashed.
+    {
+        u64 hash = 0xcbf29ce484222325ULL;
+        hash = lexer_version_hash(hash, file_read_range(&ctx->arena, out_h_file, 0, ftell(out_h_file)));
+        hash = lexer_version_hash(hash, hand_written);
+        hash = lexer_version_hash(hash, file_read_range(&ctx->arena, out_cpp_file, lexer_first, lexer_one_past_last));
+        for (Keyword_Set *set = ctx->keywords.first;
+             set != 0;
+             set = set->next){
+            hash = lexer_version_hash(hash, set->pretty_name);
+            hash = lexer_version_hash(hash, set->fallback_name);
+            for (Keyword *keyword = set->first;
+                 keyword != 0;
+                 keyword = keyword->next){
+                hash = lexer_version_hash(hash, keyword->name);
+                hash = lexer_version_hash(hash, keyword->lexeme);
+            }
+        }
+        fprintf(out_h_file, "#define lexer_" LANG_NAME_LOWER_STR "_version 0x%016llxULL\n", hash);
+    }
     
     fclose(out_h_file);
     fclose(out_cpp_file);
@@ -3,12 +3,16 @@
 function void
 font_api_fill_vtable(API_VTable_font *vtable){
     vtable->make_face = font_make_face;
+    vtable->make_glyph = font_make_glyph;
+    vtable->release_face = font_release_face;
 }
 
 #if defined(DYNAMIC_LINK_API)
 function void
 font_api_read_vtable(API_VTable_font *vtable){
     font_make_face = vtable->make_face;
+    font_make_glyph = vtable->make_glyph;
+    font_release_face = vtable->release_face;
 }
 #undef DYNAMIC_LINK_API
 #endif
@@ -1,18 +1,28 @@
 /* Generated by "code/4ed_font_api.cpp" */
 
 #define font_make_face_sig() Face* font_make_face(Arena* arena, Face_Description* description, f32 scale_factor)
+#define font_make_glyph_sig() b32 font_make_glyph(Face* face, u16 index)
+#define font_release_face_sig() void font_release_face(Face* face)
 
 typedef Face* font_make_face_type(Arena* arena, Face_Description* description, f32 scale_factor);
+typedef b32 font_make_glyph_type(Face* face, u16 index);
+typedef void font_release_face_type(Face* face);
 
 struct API_VTable_font{
     font_make_face_type *make_face;
+    font_make_glyph_type *make_glyph;
+    font_release_face_type *release_face;
 };
 
 #if defined(STATIC_LINK_API)
 internal Face* font_make_face(Arena* arena, Face_Description* description, f32 scale_factor);
+internal b32 font_make_glyph(Face* face, u16 index);
+internal void font_release_face(Face* face);
 #undef STATIC_LINK_API
 
 #elif defined(DYNAMIC_LINK_API)
 global font_make_face_type *font_make_face = 0;
+global font_make_glyph_type *font_make_glyph = 0;
+global font_release_face_type *font_release_face = 0;
 #undef DYNAMIC_LINK_API
 #endif
@@ -72,6 +72,7 @@
 #include <unistd.h>
 #include <locale.h>
 #include <errno.h>
+#include <signal.h>
 #include <pthread.h>
 
 #include <sys/epoll.h>
@@ -81,6 +82,8 @@
 #include <sys/wait.h>
 #include <sys/timerfd.h>
 #include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <poll.h>
 #include <sys/syscall.h>
 
 #define Cursor XCursor
@@ -155,6 +158,15 @@ struct Linux_Memory_Tracker_Node {
     u64 size;
 };
 
+// NOTE(allen): One inotify watch on a directory, shared by all of the files
+// in it that are open.
+struct Linux_Listener {
+    Node node;
+    String_Const_u8 dir_name;
+    int wd;
+    i32 ref_count;
+};
+
 struct Linux_Vars {
     Thread_Context tctx;
     Arena frame_arena;
@@ -207,6 +219,13 @@ struct Linux_Vars {
     Audio_Mix_Destination_Function* audio_dst_func;
     System_Thread audio_thread;
     
+    pthread_mutex_t listener_mutex;
+    int inotify_fd;
+    Node listeners;
+    Table_Data_u64 listener_name_table;
+    Table_u64_u64 listener_wd_table;
+    i32 dead_listener_count;
+    
     Atom atom_TARGETS;
     Atom atom_CLIPBOARD;
     Atom atom_UTF8_STRING;
@@ -619,6 +638,16 @@ font_make_face(Arena* arena, Face_Description* description, f32 scale_factor) {
     return(result);
 }
 
+internal b32
+font_make_glyph(Face* face, u16 index) {
+    return(ft__font_make_glyph(face, index));
+}
+
+internal void
+font_release_face(Face* face) {
+    ft__font_release_face(face);
+}
+
 ////////////////////////////
 
 internal b32
@@ -1767,6 +1796,8 @@ main(int argc, char **argv){
     pthread_mutex_init(&linuxvars.audio_mutex, &attr);
     pthread_cond_init(&linuxvars.audio_cond, NULL);
     
+    pthread_mutex_init(&linuxvars.listener_mutex, &attr);
+    
     // NOTE(allen): context setup
     {
         Base_Allocator* alloc = get_base_allocator_system();
@@ -1795,6 +1826,15 @@ main(int argc, char **argv){
     dll_init_sentinel(&linuxvars.free_linux_objects);
     dll_init_sentinel(&linuxvars.timer_objects);
     
+    // NOTE(allen): directory listeners
+    {
+        Base_Allocator* alloc = get_base_allocator_system();
+        linuxvars.inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        dll_init_sentinel(&linuxvars.listeners);
+        linuxvars.listener_name_table = make_table_Data_u64(alloc, 64);
+        linuxvars.listener_wd_table = make_table_u64_u64(alloc, 64);
+    }
+    
     //InitializeCriticalSection(&win32vars.thread_launch_mutex);
     //InitializeConditionVariable(&win32vars.thread_launch_cv);
     
@@ -192,6 +192,155 @@ system_quick_file_attributes(Arena* scratch, String_Const_u8 file_name){
     return(result);
 }
 
+// NOTE(allen): The working set listens on the directory of each file it has
+// open.  A directory that goes away or is renamed drops its watch, since its
+// events would no longer match the names of the files in it.  The caller is told
+// to check everything then.  The watch is tried again on each call to
+// get_file_changes until the directory is back under its name, and the caller
+// is told to check everything again when it is.
+#define LINUX_LISTENER_MASK (IN_CLOSE_WRITE | IN_MODIFY | IN_ATTRIB | IN_CREATE | IN_DELETE | \
+                             IN_MOVED_FROM | IN_MOVED_TO | IN_MOVE_SELF | IN_ONLYDIR | IN_EXCL_UNLINK)
+
+internal int
+linux_add_watch(Arena* scratch, String_Const_u8 dir_name){
+    Temp_Memory_Block temp(scratch);
+    String_Const_u8 c_dir_name = push_string_copy(scratch, dir_name);
+    return(inotify_add_watch(linuxvars.inotify_fd, (char*)c_dir_name.str, LINUX_LISTENER_MASK));
+}
+
+internal b32
+system_add_listener(Arena* scratch, String_Const_u8 dir_name){
+    LINUX_FN_DEBUG("%.*s", (int)dir_name.size, dir_name.str);
+    b32 result = false;
+    if (linuxvars.inotify_fd != -1){
+        pthread_mutex_lock(&linuxvars.listener_mutex);
+        u64 val = 0;
+        if (table_read(&linuxvars.listener_name_table, make_data(dir_name.str, dir_name.size), &val)){
+            Linux_Listener* listener = (Linux_Listener*)IntAsPtr(val);
+            listener->ref_count += 1;
+            result = true;
+        }
+        else{
+            // NOTE(allen): When the watch limit runs out this fails and the files
+            // in the directory are left to the poller.
+            int wd = linux_add_watch(scratch, dir_name);
+            if (wd != -1 && !table_read(&linuxvars.listener_wd_table, (u64)wd, &val)){
+                Base_Allocator* allocator = get_base_allocator_system();
+                Linux_Listener* listener = (Linux_Listener*)base_array(allocator, u8, sizeof(Linux_Listener) + dir_name.size);
+                block_zero_struct(listener);
+                listener->dir_name = SCu8((u8*)(listener + 1), dir_name.size);
+                block_copy(listener->dir_name.str, dir_name.str, dir_name.size);
+                listener->wd = wd;
+                listener->ref_count = 1;
+                dll_insert_back(&linuxvars.listeners, &listener->node);
+                table_insert(&linuxvars.listener_name_table, make_data(listener->dir_name.str, listener->dir_name.size), PtrAsInt(listener));
+                table_insert(&linuxvars.listener_wd_table, (u64)wd, PtrAsInt(listener));
+                result = true;
+            }
+        }
+        pthread_mutex_unlock(&linuxvars.listener_mutex);
+    }
+    return(result);
+}
+
+internal b32
+system_remove_listener(Arena* scratch, String_Const_u8 dir_name){
+    LINUX_FN_DEBUG("%.*s", (int)dir_name.size, dir_name.str);
+    b32 result = false;
+    pthread_mutex_lock(&linuxvars.listener_mutex);
+    u64 val = 0;
+    if (table_read(&linuxvars.listener_name_table, make_data(dir_name.str, dir_name.size), &val)){
+        Linux_Listener* listener = (Linux_Listener*)IntAsPtr(val);
+        listener->ref_count -= 1;
+        if (listener->ref_count == 0){
+            if (listener->wd != -1){
+                inotify_rm_watch(linuxvars.inotify_fd, listener->wd);
+                table_erase(&linuxvars.listener_wd_table, (u64)listener->wd);
+            }
+            else{
+                linuxvars.dead_listener_count -= 1;
+            }
+            table_erase(&linuxvars.listener_name_table, make_data(listener->dir_name.str, listener->dir_name.size));
+            dll_remove(&listener->node);
+            base_free(get_base_allocator_system(), listener);
+        }
+        result = true;
+    }
+    pthread_mutex_unlock(&linuxvars.listener_mutex);
+    return(result);
+}
+
+internal List_String_Const_u8
+system_get_file_changes(Arena* arena, u64 wait_us, b32* lost_changes){
+    List_String_Const_u8 result = {};
+    *lost_changes = false;
+    if (linuxvars.inotify_fd == -1){
+        system_sleep(wait_us);
+    }
+    else{
+        struct pollfd poll_fd = {};
+        poll_fd.fd = linuxvars.inotify_fd;
+        poll_fd.events = POLLIN;
+        poll(&poll_fd, 1, (int)(wait_us/Thousand(1)));
+        
+        pthread_mutex_lock(&linuxvars.listener_mutex);
+        u8 buffer[KB(4)] __attribute__((aligned(__alignof__(struct inotify_event))));
+        for (;;){
+            ssize_t size = read(linuxvars.inotify_fd, buffer, sizeof(buffer));
+            if (size <= 0){
+                break;
+            }
+            struct inotify_event* event = 0;
+            for (u8* ptr = buffer; ptr < buffer + size; ptr += sizeof(struct inotify_event) + event->len){
+                event = (struct inotify_event*)ptr;
+                u64 val = 0;
+                if (HasFlag(event->mask, IN_Q_OVERFLOW)){
+                    *lost_changes = true;
+                }
+                else if (table_read(&linuxvars.listener_wd_table, (u64)event->wd, &val)){
+                    Linux_Listener* listener = (Linux_Listener*)IntAsPtr(val);
+                    if (HasFlag(event->mask, IN_IGNORED) || HasFlag(event->mask, IN_MOVE_SELF)){
+                        if (HasFlag(event->mask, IN_MOVE_SELF)){
+                            inotify_rm_watch(linuxvars.inotify_fd, listener->wd);
+                        }
+                        table_erase(&linuxvars.listener_wd_table, (u64)listener->wd);
+                        listener->wd = -1;
+                        linuxvars.dead_listener_count += 1;
+                        *lost_changes = true;
+                    }
+                    else if (event->len > 0){
+                        String_Const_u8 name = SCu8(event->name);
+                        String_Const_u8 file_name = push_u8_stringf(arena, "%.*s%.*s",
+                                                                    string_expand(listener->dir_name),
+                                                                    string_expand(name));
+                        string_list_push(arena, &result, file_name);
+                    }
+                }
+            }
+        }
+        
+        if (linuxvars.dead_listener_count > 0){
+            for (Node* node = linuxvars.listeners.next;
+                 node != &linuxvars.listeners;
+                 node = node->next){
+                Linux_Listener* listener = CastFromMember(Linux_Listener, node, node);
+                if (listener->wd == -1){
+                    u64 val = 0;
+                    int wd = linux_add_watch(arena, listener->dir_name);
+                    if (wd != -1 && !table_read(&linuxvars.listener_wd_table, (u64)wd, &val)){
+                        listener->wd = wd;
+                        table_insert(&linuxvars.listener_wd_table, (u64)wd, PtrAsInt(listener));
+                        linuxvars.dead_listener_count -= 1;
+                        *lost_changes = true;
+                    }
+                }
+            }
+        }
+        pthread_mutex_unlock(&linuxvars.listener_mutex);
+    }
+    return(result);
+}
+
 internal b32
 system_load_handle(Arena* scratch, char* file_name, Plat_Handle* out){
     LINUX_FN_DEBUG("%s", file_name);
@@ -218,11 +367,192 @@ internal b32
 system_load_file(Plat_Handle handle, char* buffer, u32 size){
     LINUX_FN_DEBUG("%.*s", size, buffer);
     int fd = *(int*)&handle;
-    int bytes_read = read(fd, buffer, size);
-    if (bytes_read == size) {
-        return true;
+    // NOTE(allen): read is allowed to come back short, so keep going until the
+    // whole request is filled.
+    while (size > 0) {
+        ssize_t bytes_read = read(fd, buffer, size);
+        if (bytes_read == -1) {
+            if (errno != EINTR) {
+                break;
+            }
+        } else if (bytes_read == 0) {
+            break;
+        } else {
+            size -= (u32)bytes_read;
+            buffer += bytes_read;
+        }
     }
-    return false;
+    return size == 0;
+}
+
+// NOTE(allen): A private read-only mapping of the whole file.  The kernel pages
+// the text in as it is touched and may drop clean pages again under pressure, so
+// the resident size follows what is actually being looked at.  The mapping
+// outlives the handle, load_close can be called right after this.
+//
+// NOTE(allen): When another program makes a mapped file shorter, touching the
+// pages past its new end raises SIGBUS.  Every live mapping is kept in this
+// table.  mmap is not safe to call from a signal handler, so the handler only
+// writes the faulting page to a pipe and blocks reading the answer, and a patch
+// thread maps a zeroed page over it so the read goes on.  The file is reported
+// as changed on disk right after, and the buffer copies the text out, lets go of
+// the mapping and refuses to save until it is reopened.  A fault anywhere else
+// puts the default action back and happens again.
+//
+// NOTE(allen): Answers are the page address, with the low bit set if the page
+// could not be patched.  With several threads faulting at once a thread can read
+// an answer meant for another one, it then just returns and faults again.
+//
+
+struct Linux_Mapping{
+    u8* volatile base;
+    volatile u64 size;
+};
+
+global Linux_Mapping linux_mappings[256];
+global pthread_mutex_t linux_mapping_mutex = PTHREAD_MUTEX_INITIALIZER;
+global b32 linux_mapping_trap_installed = false;
+global uintptr_t linux_mapping_page_size = 0;
+global int linux_mapping_request_pipe[2] = {-1, -1};
+global int linux_mapping_answer_pipe[2] = {-1, -1};
+
+internal b32
+linux_mapping_pipe_write(int fd, uintptr_t val){
+    ssize_t written = 0;
+    do {
+        written = write(fd, &val, sizeof(val));
+    } while (written < 0 && errno == EINTR);
+    return written == sizeof(val);
+}
+
+internal b32
+linux_mapping_pipe_read(int fd, uintptr_t* val_out){
+    ssize_t bytes_read = 0;
+    do {
+        bytes_read = read(fd, val_out, sizeof(*val_out));
+    } while (bytes_read < 0 && errno == EINTR);
+    return bytes_read == sizeof(*val_out);
+}
+
+internal void*
+linux_mapping_patch_thread(void* ptr){
+    uintptr_t page = 0;
+    while (linux_mapping_pipe_read(linux_mapping_request_pipe[0], &page)) {
+        void* zero = mmap((void*)page, linux_mapping_page_size, PROT_READ,
+                          MAP_PRIVATE|MAP_ANONYMOUS|MAP_FIXED, -1, 0);
+        uintptr_t answer = page | ((zero == MAP_FAILED) ? 1 : 0);
+        linux_mapping_pipe_write(linux_mapping_answer_pipe[1], answer);
+    }
+    return 0;
+}
+
+internal void
+linux_mapping_sigbus_handler(int sig, siginfo_t* info, void* context){
+    int saved_errno = errno;
+    u8* addr = (u8*)info->si_addr;
+    b32 handled = false;
+    for (i32 i = 0; i < ArrayCount(linux_mappings); i += 1) {
+        u8* base = __atomic_load_n(&linux_mappings[i].base, __ATOMIC_ACQUIRE);
+        if (base != 0 && base <= addr && addr < base + linux_mappings[i].size) {
+            uintptr_t page = (uintptr_t)addr & ~(linux_mapping_page_size - 1);
+            uintptr_t answer = 0;
+            if (linux_mapping_pipe_write(linux_mapping_request_pipe[1], page) &&
+                linux_mapping_pipe_read(linux_mapping_answer_pipe[0], &answer)) {
+                handled = (answer != (page | 1));
+            }
+            break;
+        }
+    }
+    if (!handled) {
+        signal(SIGBUS, SIG_DFL);
+    }
+    errno = saved_errno;
+}
+
+internal b32
+linux_mapping_install_trap(){
+    b32 result = false;
+    linux_mapping_page_size = (uintptr_t)sysconf(_SC_PAGESIZE);
+    if (pipe2(linux_mapping_request_pipe, O_CLOEXEC) == 0) {
+        if (pipe2(linux_mapping_answer_pipe, O_CLOEXEC) == 0) {
+            pthread_t thread;
+            if (pthread_create(&thread, 0, linux_mapping_patch_thread, 0) == 0) {
+                pthread_detach(thread);
+                struct sigaction action = {};
+                action.sa_sigaction = linux_mapping_sigbus_handler;
+                action.sa_flags = SA_SIGINFO;
+                sigemptyset(&action.sa_mask);
+                result = (sigaction(SIGBUS, &action, 0) == 0);
+            }
+        }
+    }
+    return result;
+}
+
+internal b32
+linux_mapping_register(void* ptr, u64 size){
+    b32 result = false;
+    pthread_mutex_lock(&linux_mapping_mutex);
+    if (!linux_mapping_trap_installed) {
+        linux_mapping_trap_installed = linux_mapping_install_trap();
+    }
+    if (linux_mapping_trap_installed) {
+        for (i32 i = 0; i < ArrayCount(linux_mappings); i += 1) {
+            if (linux_mappings[i].base == 0) {
+                linux_mappings[i].size = size;
+                __atomic_store_n(&linux_mappings[i].base, (u8*)ptr, __ATOMIC_RELEASE);
+                result = true;
+                break;
+            }
+        }
+    }
+    pthread_mutex_unlock(&linux_mapping_mutex);
+    return result;
+}
+
+internal void
+linux_mapping_unregister(void* ptr){
+    pthread_mutex_lock(&linux_mapping_mutex);
+    for (i32 i = 0; i < ArrayCount(linux_mappings); i += 1) {
+        if (linux_mappings[i].base == (u8*)ptr) {
+            __atomic_store_n(&linux_mappings[i].base, (u8*)0, __ATOMIC_RELEASE);
+            break;
+        }
+    }
+    pthread_mutex_unlock(&linux_mapping_mutex);
+}
+
+// NOTE(allen): With no free slot in the table the mapping would not be covered,
+// so the caller gets 0 back and reads the file instead.
+internal void*
+system_load_map(Plat_Handle handle, u64 size){
+    LINUX_FN_DEBUG("%llu", size);
+    int fd = *(int*)&handle;
+    void* result = 0;
+    if (size > 0) {
+        result = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (result == MAP_FAILED) {
+            perror("mmap");
+            result = 0;
+        } else if (!linux_mapping_register(result, size)) {
+            munmap(result, size);
+            result = 0;
+        }
+    }
+    return result;
+}
+
+internal b32
+system_load_unmap(void* ptr, u64 size){
+    LINUX_FN_DEBUG("%p", ptr);
+    b32 result = false;
+    linux_mapping_unregister(ptr);
+    if (munmap(ptr, size) == 0) {
+        result = true;
+    } else {
+        perror("munmap");
+    }
+    return result;
 }
 
 internal b32
@@ -258,6 +588,46 @@ system_save_file(Arena* scratch, char* file_name, String_Const_u8 data){
     return result;
 }
 
+// NOTE(allen): Creates the file if it is not there yet.
+internal b32
+system_append_file(Arena* scratch, char* file_name, String_Const_u8 data){
+    LINUX_FN_DEBUG("%s", file_name);
+    b32 result = false;
+    int fd = open(file_name, O_APPEND|O_WRONLY|O_CREAT, 0666);
+    if (fd != -1){
+        for (;data.size > 0;){
+            ssize_t bytes_written = write(fd, data.str, data.size);
+            if (bytes_written == -1){
+                if (errno != EINTR){
+                    break;
+                }
+            }
+            else{
+                data.str += bytes_written;
+                data.size -= bytes_written;
+            }
+        }
+        result = (data.size == 0);
+        close(fd);
+    }
+    return(result);
+}
+
+// NOTE(allen): A directory that already exists counts as created.
+internal b32
+system_create_directory(Arena* scratch, char* path){
+    LINUX_FN_DEBUG("%s", path);
+    b32 result = (mkdir(path, 0777) == 0 || errno == EEXIST);
+    return(result);
+}
+
+internal b32
+system_delete_file(Arena* scratch, char* file_name){
+    LINUX_FN_DEBUG("%s", file_name);
+    b32 result = (unlink(file_name) == 0);
+    return(result);
+}
+
 internal b32
 system_load_library(Arena* scratch, String_Const_u8 file_name, System_Library* out){
     LINUX_FN_DEBUG("%.*s", (int)file_name.size, file_name.str);
@@ -587,6 +957,15 @@ system_thread_get_id(void){
     return id;
 }
 
+internal i32
+system_thread_get_processor_count(void){
+    i32 result = (i32)sysconf(_SC_NPROCESSORS_ONLN);
+    if (result < 1){
+        result = 1;
+    }
+    return(result);
+}
+
 internal void
 system_acquire_global_frame_mutex(Thread_Context* tctx){
     //LINUX_FN_DEBUG();
@@ -65,6 +65,7 @@
 #include <errno.h> // NOTE(yuval): Used for errno
 #include <fcntl.h> // NOTE(yuval): Used for open
 #include <pthread.h> // NOTE(yuval): Used for threads, mutexes, cvs
+#include <signal.h> // NOTE(allen): Used for sigaction
 #include <unistd.h> // NOTE(yuval): Used for getcwd, read, write, getpid
 #include <sys/mman.h> // NOTE(yuval): Used for mmap, munmap, mprotect
 #include <sys/stat.h> // NOTE(yuval): Used for stat
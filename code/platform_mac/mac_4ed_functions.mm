@@ -208,6 +208,26 @@ system_quick_file_attributes_sig(){
     return(result);
 }
 
+// NOTE(allen): There are no directory listeners on this platform yet, so every
+// file is left to the poller in the working set.
+function
+system_add_listener_sig(){
+    return(false);
+}
+
+function
+system_remove_listener_sig(){
+    return(false);
+}
+
+function
+system_get_file_changes_sig(){
+    List_String_Const_u8 result = {};
+    *lost_changes = false;
+    system_sleep(wait_us);
+    return(result);
+}
+
 function inline Plat_Handle
 mac_to_plat_handle(i32 fd){
     Plat_Handle result = *(Plat_Handle*)(&fd);
@@ -262,6 +282,163 @@ system_load_file_sig(){
     return(result);
 }
 
+// NOTE(allen): When another program makes a mapped file shorter, touching the
+// pages past its new end raises SIGBUS.  Live mappings are kept in a table.
+// mmap is not safe to call from a signal handler, so the handler only writes the
+// faulting page to a pipe and blocks reading the answer, and a patch thread maps
+// a zeroed page over it so the read goes on until the buffer sees the change,
+// copies its text out and stops saving until it is reopened.  Answers are the
+// page address, with the low bit set if the page could not be patched; a thread
+// that reads another thread's answer returns and faults again.  A fault anywhere
+// else puts the default action back and happens again.
+
+struct Mac_Mapping{
+    u8 *volatile base;
+    volatile u64 size;
+};
+
+global Mac_Mapping mac_mappings[256];
+global pthread_mutex_t mac_mapping_mutex = PTHREAD_MUTEX_INITIALIZER;
+global b32 mac_mapping_trap_installed = false;
+global uintptr_t mac_mapping_page_size = 0;
+global int mac_mapping_request_pipe[2] = {-1, -1};
+global int mac_mapping_answer_pipe[2] = {-1, -1};
+
+function b32
+mac_mapping_pipe_write(int fd, uintptr_t val){
+    ssize_t written = 0;
+    do{
+        written = write(fd, &val, sizeof(val));
+    } while (written < 0 && errno == EINTR);
+    return(written == sizeof(val));
+}
+
+function b32
+mac_mapping_pipe_read(int fd, uintptr_t *val_out){
+    ssize_t bytes_read = 0;
+    do{
+        bytes_read = read(fd, val_out, sizeof(*val_out));
+    } while (bytes_read < 0 && errno == EINTR);
+    return(bytes_read == sizeof(*val_out));
+}
+
+function void*
+mac_mapping_patch_thread(void *ptr){
+    uintptr_t page = 0;
+    while (mac_mapping_pipe_read(mac_mapping_request_pipe[0], &page)){
+        void *zero = mmap((void*)page, mac_mapping_page_size, PROT_READ,
+                          MAP_PRIVATE|MAP_ANON|MAP_FIXED, -1, 0);
+        uintptr_t answer = page | ((zero == MAP_FAILED)?1:0);
+        mac_mapping_pipe_write(mac_mapping_answer_pipe[1], answer);
+    }
+    return(0);
+}
+
+function void
+mac_mapping_sigbus_handler(int sig, siginfo_t *info, void *context){
+    int saved_errno = errno;
+    u8 *addr = (u8*)info->si_addr;
+    b32 handled = false;
+    for (i32 i = 0; i < ArrayCount(mac_mappings); i += 1){
+        u8 *base = __atomic_load_n(&mac_mappings[i].base, __ATOMIC_ACQUIRE);
+        if (base != 0 && base <= addr && addr < base + mac_mappings[i].size){
+            uintptr_t page = (uintptr_t)addr & ~(mac_mapping_page_size - 1);
+            uintptr_t answer = 0;
+            if (mac_mapping_pipe_write(mac_mapping_request_pipe[1], page) &&
+                mac_mapping_pipe_read(mac_mapping_answer_pipe[0], &answer)){
+                handled = (answer != (page | 1));
+            }
+            break;
+        }
+    }
+    if (!handled){
+        signal(SIGBUS, SIG_DFL);
+    }
+    errno = saved_errno;
+}
+
+function b32
+mac_mapping_install_trap(){
+    b32 result = false;
+    mac_mapping_page_size = (uintptr_t)sysconf(_SC_PAGESIZE);
+    if (pipe(mac_mapping_request_pipe) == 0 && pipe(mac_mapping_answer_pipe) == 0){
+        for (i32 i = 0; i < 2; i += 1){
+            fcntl(mac_mapping_request_pipe[i], F_SETFD, FD_CLOEXEC);
+            fcntl(mac_mapping_answer_pipe[i], F_SETFD, FD_CLOEXEC);
+        }
+        pthread_t thread;
+        if (pthread_create(&thread, 0, mac_mapping_patch_thread, 0) == 0){
+            pthread_detach(thread);
+            struct sigaction action = {};
+            action.sa_sigaction = mac_mapping_sigbus_handler;
+            action.sa_flags = SA_SIGINFO;
+            sigemptyset(&action.sa_mask);
+            result = (sigaction(SIGBUS, &action, 0) == 0);
+        }
+    }
+    return(result);
+}
+
+function b32
+mac_mapping_register(void *ptr, u64 size){
+    b32 result = false;
+    pthread_mutex_lock(&mac_mapping_mutex);
+    if (!mac_mapping_trap_installed){
+        mac_mapping_trap_installed = mac_mapping_install_trap();
+    }
+    if (mac_mapping_trap_installed){
+        for (i32 i = 0; i < ArrayCount(mac_mappings); i += 1){
+            if (mac_mappings[i].base == 0){
+                mac_mappings[i].size = size;
+                __atomic_store_n(&mac_mappings[i].base, (u8*)ptr, __ATOMIC_RELEASE);
+                result = true;
+                break;
+            }
+        }
+    }
+    pthread_mutex_unlock(&mac_mapping_mutex);
+    return(result);
+}
+
+function void
+mac_mapping_unregister(void *ptr){
+    pthread_mutex_lock(&mac_mapping_mutex);
+    for (i32 i = 0; i < ArrayCount(mac_mappings); i += 1){
+        if (mac_mappings[i].base == (u8*)ptr){
+            __atomic_store_n(&mac_mappings[i].base, (u8*)0, __ATOMIC_RELEASE);
+            break;
+        }
+    }
+    pthread_mutex_unlock(&mac_mapping_mutex);
+}
+
+// NOTE(allen): With no free slot in the table the mapping would not be covered,
+// so the caller gets 0 back and reads the file instead.
+function
+system_load_map_sig(){
+    i32 fd = mac_to_fd(handle);
+
+    void *result = 0;
+    if (size > 0){
+        result = mmap(0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (result == MAP_FAILED){
+            result = 0;
+        } else if (!mac_mapping_register(result, size)){
+            munmap(result, size);
+            result = 0;
+        }
+    }
+
+    return(result);
+}
+
+function
+system_load_unmap_sig(){
+    mac_mapping_unregister(ptr);
+    b32 result = (munmap(ptr, size) == 0);
+    return(result);
+}
+
 function
 system_load_close_sig(){
     b32 result = true;
@@ -304,6 +481,44 @@ system_save_file_sig(){
     return(result);
 }
 
+// NOTE(allen): Creates the file if it is not there yet.
+function
+system_append_file_sig(){
+    b32 result = false;
+    
+    i32 fd = open(file_name, O_WRONLY | O_APPEND | O_CREAT, 00640);
+    if (fd != -1){
+        for (;data.size > 0;){
+            ssize_t bytes_written = write(fd, data.str, data.size);
+            if (bytes_written == -1){
+                if (errno != EINTR){
+                    break;
+                }
+            }
+            else{
+                data.size -= bytes_written;
+                data.str += bytes_written;
+            }
+        }
+        result = (data.size == 0);
+        close(fd);
+    }
+    
+    return(result);
+}
+
+function
+system_create_directory_sig(){
+    b32 result = (mkdir(path, 0777) == 0 || errno == EEXIST);
+    return(result);
+}
+
+function
+system_delete_file_sig(){
+    b32 result = (unlink(file_name) == 0);
+    return(result);
+}
+
 ////////////////////////////////
 
 function inline System_Library
@@ -685,6 +900,15 @@ system_thread_get_id_sig(){
     return(result);
 }
 
+function
+system_thread_get_processor_count_sig(){
+    i32 result = (i32)sysconf(_SC_NPROCESSORS_ONLN);
+    if (result < 1){
+        result = 1;
+    }
+    return(result);
+}
+
 function
 system_mutex_make_sig(){
     Mac_Object *object = mac_alloc_object(MacObjectKind_Mutex);
@@ -995,4 +1219,15 @@ font_make_face_sig(){
     return(result);
 }
 
+function
+font_make_glyph_sig(){
+    b32 result = ft__font_make_glyph(face, index);
+    return(result);
+}
+
+function
+font_release_face_sig(){
+    ft__font_release_face(face);
+}
+
 ////////////////////////////////
@@ -680,6 +680,16 @@ font_make_face_sig(){
     return(ft__font_make_face(arena, description, scale_factor));
 }
 
+internal
+font_make_glyph_sig(){
+    return(ft__font_make_glyph(face, index));
+}
+
+internal
+font_release_face_sig(){
+    ft__font_release_face(face);
+}
+
 //
 // Helpers
 //
@@ -1115,6 +1125,14 @@ system_thread_get_id_sig(){
     return((i32)result);
 }
 
+internal
+system_thread_get_processor_count_sig(){
+    SYSTEM_INFO info = {};
+    GetSystemInfo(&info);
+    i32 result = clamp_bot(1, (i32)info.dwNumberOfProcessors);
+    return(result);
+}
+
 internal
 system_mutex_make_sig(){
     Win32_Object *object = win32_alloc_object(Win32ObjectKind_Mutex);
@@ -353,6 +353,26 @@ system_quick_file_attributes_sig(){
     return(result);
 }
 
+// NOTE(allen): There are no directory listeners on this platform yet, so every
+// file is left to the poller in the working set.
+internal
+system_add_listener_sig(){
+    return(false);
+}
+
+internal
+system_remove_listener_sig(){
+    return(false);
+}
+
+internal
+system_get_file_changes_sig(){
+    List_String_Const_u8 result = {};
+    *lost_changes = false;
+    system_sleep(wait_us);
+    return(result);
+}
+
 internal
 system_load_handle_sig(){
     b32 result = false;
@@ -383,6 +403,30 @@ system_load_file_sig(){
     return(result);
 }
 
+internal
+system_load_map_sig(){
+    HANDLE file = *(HANDLE*)(&handle);
+    void *result = 0;
+    if (size > 0){
+        HANDLE mapping = CreateFileMappingW(file, 0, PAGE_READONLY, 0, 0, 0);
+        if (mapping != 0){
+            result = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, (SIZE_T)size);
+            // NOTE(allen): The view keeps the mapping object alive on its own.
+            CloseHandle(mapping);
+        }
+    }
+    return(result);
+}
+
+internal
+system_load_unmap_sig(){
+    b32 result = false;
+    if (UnmapViewOfFile(ptr)){
+        result = true;
+    }
+    return(result);
+}
+
 internal
 system_load_close_sig(){
     b32 result = false;
@@ -426,6 +470,47 @@ system_save_file_sig(){
     return(result);
 }
 
+// NOTE(allen): Creates the file if it is not there yet.
+internal
+system_append_file_sig(){
+    b32 result = false;
+    
+    HANDLE file = CreateFile_utf8(scratch, (u8*)file_name, FILE_APPEND_DATA, FILE_SHARE_READ, 0, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, 0);
+    
+    if (file != INVALID_HANDLE_VALUE){
+        u64 written_total = 0;
+        for (;written_total < data.size;){
+            DWORD write_size = 0;
+            DWORD size = (DWORD)Min(data.size - written_total, max_u32);
+            if (!WriteFile(file, data.str + written_total, size, &write_size, 0)){
+                break;
+            }
+            written_total += write_size;
+        }
+        result = (written_total == data.size);
+        CloseHandle(file);
+    }
+    
+    return(result);
+}
+
+// NOTE(allen): A directory that already exists counts as created.
+internal
+system_create_directory_sig(){
+    b32 result = false;
+    if (CreateDirectory_utf8(scratch, (u8*)path, 0) ||
+        GetLastError() == ERROR_ALREADY_EXISTS){
+        result = true;
+    }
+    return(result);
+}
+
+internal
+system_delete_file_sig(){
+    b32 result = (DeleteFile_utf8(scratch, (u8*)file_name) != 0);
+    return(result);
+}
+
 ////////////////////////////////
 
 internal ARGB_Color
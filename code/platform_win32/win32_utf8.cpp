@@ -74,6 +74,24 @@ GetFileAttributes_utf8(Arena *scratch, u8 *name){
     return(result);
 }
 
+internal BOOL
+CreateDirectory_utf8(Arena *scratch, u8 *name, LPSECURITY_ATTRIBUTES security){
+    Temp_Memory temp = begin_temp(scratch);
+    String_u16 name_16 = string_u16_from_string_u8(scratch, SCu8(name), StringFill_NullTerminate);
+    BOOL result = CreateDirectoryW((LPWSTR)name_16.str, security);
+    end_temp(temp);
+    return(result);
+}
+
+internal BOOL
+DeleteFile_utf8(Arena *scratch, u8 *name){
+    Temp_Memory temp = begin_temp(scratch);
+    String_u16 name_16 = string_u16_from_string_u8(scratch, SCu8(name), StringFill_NullTerminate);
+    BOOL result = DeleteFileW((LPWSTR)name_16.str);
+    end_temp(temp);
+    return(result);
+}
+
 internal DWORD
 GetModuleFileName_utf8(Arena *scratch, HMODULE module, u8 *file_out, DWORD max){
     Temp_Memory temp = begin_temp(scratch);
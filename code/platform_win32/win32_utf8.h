@@ -24,6 +24,12 @@ FindFirstFile_utf8(Arena *scratch, u8 *name, LPWIN32_FIND_DATA find_data);
 function DWORD
 GetFileAttributes_utf8(Arena *scratch, u8 *name);
 
+function BOOL
+CreateDirectory_utf8(Arena *scratch, u8 *name, LPSECURITY_ATTRIBUTES security);
+
+function BOOL
+DeleteFile_utf8(Arena *scratch, u8 *name);
+
 function DWORD
 GetModuleFileName_utf8(Arena *scratch, HMODULE module, u8 *file_out, DWORD max);
 
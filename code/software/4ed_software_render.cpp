@@ -0,0 +1,502 @@
+/*
+4ed_software_render.cpp - Software render implementation.
+*/
+
+// TOP
+
+// NOTE(allen): Draws the same render groups the OpenGL backend does, into a
+// framebuffer in memory, with the fragment shader worked out on the CPU.  It
+// needs no GPU, so frames can be timed and compared on any machine.  Pixels
+// are ARGB like the colors in the vertices, sampled at their centers.
+
+#define SW_MAX_TEXTURE_COUNT 32
+
+struct SW_Texture{
+    Vec3_i32 dim;
+    u8 *data;
+};
+
+struct SW{
+    Base_Allocator *allocator;
+    
+    SW_Texture textures[SW_MAX_TEXTURE_COUNT + 1];
+    u32 texture_count;
+    u32 bound_texture;
+    
+    u32 *pixels;
+    i32 width;
+    i32 height;
+    i32 pixel_max;
+    
+    Render_Vertex *vertices;
+    i32 vertex_max;
+    
+    u32 *column_alpha;
+    i32 column_alpha_max;
+};
+
+global SW g_sw = {};
+
+internal void
+sw_init(Base_Allocator *allocator){
+    block_zero_struct(&g_sw);
+    g_sw.allocator = allocator;
+    // NOTE(allen): Texture zero is never handed out, like in OpenGL.
+    g_sw.texture_count = 1;
+}
+
+internal u32
+sw__get_texture(Vec3_i32 dim, Texture_Kind texture_kind){
+    u32 texid = 0;
+    if (g_sw.texture_count < ArrayCount(g_sw.textures)){
+        texid = g_sw.texture_count;
+        g_sw.texture_count += 1;
+    }
+    else{
+        for (u32 i = 1; i < g_sw.texture_count; i += 1){
+            if (g_sw.textures[i].data == 0){
+                texid = i;
+                break;
+            }
+        }
+    }
+    
+    if (texid != 0){
+        SW_Texture *texture = &g_sw.textures[texid];
+        u64 size = (u64)dim.x*dim.y*dim.z;
+        texture->dim = dim;
+        texture->data = base_array(g_sw.allocator, u8, clamp_bot(1, size));
+        block_zero(texture->data, size);
+        g_sw.bound_texture = texid;
+    }
+    
+    return(texid);
+}
+
+internal b32
+sw__fill_texture(Texture_Kind texture_kind, u32 texid, Vec3_i32 p, Vec3_i32 dim, void *data){
+    // NOTE(allen): Like the OpenGL version, zero means the last texture made and
+    // the result is always false.
+    b32 result = false;
+    if (texid == 0){
+        texid = g_sw.bound_texture;
+    }
+    if (0 < texid && texid < g_sw.texture_count && g_sw.textures[texid].data != 0){
+        SW_Texture *texture = &g_sw.textures[texid];
+        Vec3_i32 tex_dim = texture->dim;
+        u8 *src = (u8*)data;
+        for (i32 z = 0; z < dim.z; z += 1){
+            for (i32 y = 0; y < dim.y; y += 1){
+                i32 tz = p.z + z;
+                i32 ty = p.y + y;
+                if (0 <= tz && tz < tex_dim.z && 0 <= ty && ty < tex_dim.y){
+                    i32 x0 = clamp(0, p.x, tex_dim.x);
+                    i32 x1 = clamp(0, p.x + dim.x, tex_dim.x);
+                    u8 *dst = texture->data + ((u64)tz*tex_dim.y + ty)*tex_dim.x;
+                    u8 *src_line = src + ((u64)z*dim.y + y)*dim.x;
+                    for (i32 x = x0; x < x1; x += 1){
+                        dst[x] = src_line[x - p.x];
+                    }
+                }
+            }
+        }
+    }
+    return(result);
+}
+
+internal void
+sw__free_texture(u32 texid){
+    if (0 < texid && texid < g_sw.texture_count){
+        SW_Texture *texture = &g_sw.textures[texid];
+        if (texture->data != 0){
+            base_free(g_sw.allocator, texture->data);
+        }
+        block_zero_struct(texture);
+    }
+}
+
+////////////////////////////////
+
+// NOTE(allen): GL_LINEAR with GL_CLAMP_TO_EDGE, the layer is rounded.
+internal f32
+sw__sample(SW_Texture *texture, Vec3_f32 uvw){
+    f32 result = 0.f;
+    if (texture != 0 && texture->data != 0){
+        Vec3_i32 dim = texture->dim;
+        f32 x = uvw.x*dim.x - 0.5f;
+        f32 y = uvw.y*dim.y - 0.5f;
+        f32 fx = f32_floor32(x);
+        f32 fy = f32_floor32(y);
+        f32 tx = x - fx;
+        f32 ty = y - fy;
+        i32 x0 = clamp(0, (i32)fx, dim.x - 1);
+        i32 x1 = clamp(0, (i32)fx + 1, dim.x - 1);
+        i32 y0 = clamp(0, (i32)fy, dim.y - 1);
+        i32 y1 = clamp(0, (i32)fy + 1, dim.y - 1);
+        i32 z = clamp(0, (i32)f32_floor32(uvw.z + 0.5f), dim.z - 1);
+        u8 *layer = texture->data + (u64)z*dim.x*dim.y;
+        u8 *row0 = layer + y0*dim.x;
+        u8 *row1 = layer + y1*dim.x;
+        f32 top = row0[x0] + (row0[x1] - row0[x0])*tx;
+        f32 bot = row1[x0] + (row1[x1] - row1[x0])*tx;
+        result = (top + (bot - top)*ty)*(1.f/255.f);
+    }
+    return(result);
+}
+
+internal f32
+sw__smoothstep(f32 e0, f32 e1, f32 x){
+    f32 t = clamp(0.f, (x - e0)/(e1 - e0), 1.f);
+    return(t*t*(3.f - 2.f*t));
+}
+
+// NOTE(allen): The rounded rectangle part of the fragment shader of gl_render,
+// from the distance to the rectangle with its roundness taken off.
+internal f32
+sw__shape_value(f32 sd, f32 half_thickness){
+    sd = abs_f32(sd + half_thickness) - half_thickness;
+    return(1.f - sw__smoothstep(-1.f, 0.f, sd));
+}
+
+// NOTE(allen): The whole fragment shader.  A vertex with a thickness draws the
+// rounded rectangle centered on uvw.xy, one without draws a texel.
+internal f32
+sw__fragment_value(SW_Texture *texture, Vec2_f32 xy, Vec3_f32 uvw, Vec2_f32 adjusted_half_dim,
+                   f32 half_thickness){
+    f32 result = 0.f;
+    if (half_thickness >= 0.49f){
+        Vec2_f32 p = V2f32(xy.x - uvw.x, xy.y - uvw.y);
+        Vec2_f32 d = V2f32(abs_f32(p.x) - adjusted_half_dim.x, abs_f32(p.y) - adjusted_half_dim.y);
+        Vec2_f32 d_out = V2f32(Max(d.x, 0.f), Max(d.y, 0.f));
+        f32 sd = sqrt_f32(d_out.x*d_out.x + d_out.y*d_out.y) + Min(Max(d.x, d.y), 0.f);
+        result = sw__shape_value(sd - uvw.z, half_thickness);
+    }
+    else{
+        result = sw__sample(texture, uvw);
+    }
+    return(result);
+}
+
+// NOTE(allen): glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA) on all four
+// channels, in 8 bit fixed point.
+internal u32
+sw__alpha(u32 color, f32 value){
+    f32 alpha = ((color >> 24)/255.f)*value;
+    return((u32)(clamp(0.f, alpha, 1.f)*255.f + 0.5f));
+}
+
+internal void
+sw__blend(u32 *dst, u32 color, u32 a){
+    if (a == 255){
+        *dst = (color | 0xFF000000);
+    }
+    else if (a > 0){
+        u32 src = (color & 0x00FFFFFF) | (a << 24);
+        u32 inv = 255 - a;
+        u32 old = *dst;
+        u32 out = 0;
+        for (u32 shift = 0; shift < 32; shift += 8){
+            u32 s = (src >> shift) & 0xFF;
+            u32 d = (old >> shift) & 0xFF;
+            out |= ((s*a + d*inv + 127)/255) << shift;
+        }
+        *dst = out;
+    }
+}
+
+internal Vec2_f32
+sw__adjusted_half_dim(Render_Vertex *vertex){
+    Vec2_f32 half_dim = V2f32(abs_f32(vertex->xy.x - vertex->uvw.x),
+                              abs_f32(vertex->xy.y - vertex->uvw.y));
+    return(V2f32(half_dim.x - vertex->uvw.z + 0.5f, half_dim.y - vertex->uvw.z + 0.5f));
+}
+
+// NOTE(allen): Both draw functions of the render target write a quad as the six
+// vertices 0 1 2, 1 2 5, and most of them are axis aligned with one color.
+// Those are filled row by row without going through the triangle setup.
+internal b32
+sw__is_simple_quad(Render_Vertex *v){
+    return(v[3].xy == v[1].xy && v[4].xy == v[2].xy &&
+           v[3].uvw == v[1].uvw && v[4].uvw == v[2].uvw &&
+           v[0].xy.y == v[1].xy.y && v[0].xy.x == v[2].xy.x &&
+           v[5].xy.x == v[1].xy.x && v[5].xy.y == v[2].xy.y &&
+           v[0].uvw.y == v[1].uvw.y && v[0].uvw.x == v[2].uvw.x &&
+           v[5].uvw.x == v[1].uvw.x && v[5].uvw.y == v[2].uvw.y &&
+           v[0].uvw.z == v[5].uvw.z &&
+           v[0].color == v[1].color && v[0].color == v[2].color && v[0].color == v[5].color &&
+           v[0].half_thickness == v[1].half_thickness &&
+           v[0].half_thickness == v[2].half_thickness &&
+           v[0].half_thickness == v[5].half_thickness &&
+           v[0].xy.x != v[1].xy.x && v[0].xy.y != v[2].xy.y);
+}
+
+// NOTE(allen): The pixels with their centers in [min,max) on both axes.
+internal Rect_i32
+sw__quad_pixels(Rect_i32 clip, Render_Vertex *v){
+    Rect_f32 rect = Rf32(Min(v[0].xy.x, v[1].xy.x), Min(v[0].xy.y, v[2].xy.y),
+                         Max(v[0].xy.x, v[1].xy.x), Max(v[0].xy.y, v[2].xy.y));
+    Rect_i32 result = {};
+    result.x0 = Max(clip.x0, (i32)f32_ceil32(rect.x0 - 0.5f));
+    result.y0 = Max(clip.y0, (i32)f32_ceil32(rect.y0 - 0.5f));
+    result.x1 = Min(clip.x1, (i32)f32_ceil32(rect.x1 - 0.5f));
+    result.y1 = Min(clip.y1, (i32)f32_ceil32(rect.y1 - 0.5f));
+    return(result);
+}
+
+internal void
+sw__draw_glyph_quad(Rect_i32 clip, SW_Texture *texture, Render_Vertex *v){
+    Rect_i32 box = sw__quad_pixels(clip, v);
+    f32 x0 = v[0].xy.x;
+    f32 y0 = v[0].xy.y;
+    f32 du_dx = (v[1].uvw.x - v[0].uvw.x)/(v[1].xy.x - x0);
+    f32 dv_dy = (v[2].uvw.y - v[0].uvw.y)/(v[2].xy.y - y0);
+    u32 color = v[0].color;
+    for (i32 py = box.y0; py < box.y1; py += 1){
+        u32 *dst = g_sw.pixels + (i64)py*g_sw.width;
+        f32 tv = v[0].uvw.y + (py + 0.5f - y0)*dv_dy;
+        for (i32 px = box.x0; px < box.x1; px += 1){
+            f32 tu = v[0].uvw.x + (px + 0.5f - x0)*du_dx;
+            f32 value = sw__sample(texture, V3f32(tu, tv, v[0].uvw.z));
+            sw__blend(dst + px, color, sw__alpha(color, value));
+        }
+    }
+}
+
+internal void
+sw__reserve_column_alpha(i32 count){
+    if (count > g_sw.column_alpha_max){
+        if (g_sw.column_alpha != 0){
+            base_free(g_sw.allocator, g_sw.column_alpha);
+        }
+        g_sw.column_alpha_max = count + count/2;
+        g_sw.column_alpha = base_array(g_sw.allocator, u32, g_sw.column_alpha_max);
+    }
+}
+
+// NOTE(allen): Inside the rectangle the distance is the larger of the distances
+// to the nearest horizontal and vertical edge.  Along a row every pixel that is
+// further inside horizontally than the row is vertically has the same value, and
+// the ones at the sides have the value of their column, which is worked out once
+// for the whole quad.  Only the pixels outside on one of the axes are shaded on
+// their own.
+internal void
+sw__draw_shape_quad(Rect_i32 clip, Render_Vertex *v){
+    Rect_i32 box = sw__quad_pixels(clip, v);
+    u32 color = v[0].color;
+    Vec3_f32 uvw = v[0].uvw;
+    f32 half_thickness = v[0].half_thickness;
+    Vec2_f32 adjusted_half_dim = sw__adjusted_half_dim(&v[0]);
+    
+    local_const u32 shade_pixel = max_u32;
+    sw__reserve_column_alpha(box.x1 - box.x0);
+    u32 *column_alpha = g_sw.column_alpha - box.x0;
+    for (i32 px = box.x0; px < box.x1; px += 1){
+        f32 dx = abs_f32(px + 0.5f - uvw.x) - adjusted_half_dim.x;
+        column_alpha[px] = shade_pixel;
+        if (dx <= 0.f){
+            column_alpha[px] = sw__alpha(color, sw__shape_value(dx - uvw.z, half_thickness));
+        }
+    }
+    
+    for (i32 py = box.y0; py < box.y1; py += 1){
+        u32 *dst = g_sw.pixels + (i64)py*g_sw.width;
+        f32 y = py + 0.5f;
+        f32 dy = abs_f32(y - uvw.y) - adjusted_half_dim.y;
+        if (dy > 0.f){
+            for (i32 px = box.x0; px < box.x1; px += 1){
+                f32 value = sw__fragment_value(0, V2f32(px + 0.5f, y), uvw, adjusted_half_dim, half_thickness);
+                sw__blend(dst + px, color, sw__alpha(color, value));
+            }
+        }
+        else{
+            i32 span_x0 = box.x1;
+            i32 span_x1 = box.x1;
+            u32 span_a = 0;
+            f32 half_span = adjusted_half_dim.x + dy;
+            if (half_span >= 0.f){
+                span_x0 = clamp(box.x0, (i32)f32_ceil32(uvw.x - half_span - 0.5f), box.x1);
+                span_x1 = clamp(span_x0, (i32)f32_floor32(uvw.x + half_span - 0.5f) + 1, box.x1);
+                span_a = sw__alpha(color, sw__shape_value(dy - uvw.z, half_thickness));
+            }
+            for (i32 px = box.x0; px < box.x1; px += 1){
+                u32 a = span_a;
+                if (px < span_x0 || span_x1 <= px){
+                    a = column_alpha[px];
+                    if (a == shade_pixel){
+                        f32 value = sw__fragment_value(0, V2f32(px + 0.5f, y), uvw, adjusted_half_dim, half_thickness);
+                        a = sw__alpha(color, value);
+                    }
+                }
+                sw__blend(dst + px, color, a);
+            }
+        }
+    }
+}
+
+internal f32
+sw__edge(Vec2_f32 a, Vec2_f32 b, Vec2_f32 p){
+    return((b.x - a.x)*(p.y - a.y) - (b.y - a.y)*(p.x - a.x));
+}
+
+internal b32
+sw__edge_is_top_left(Vec2_f32 a, Vec2_f32 b, f32 area){
+    Vec2_f32 d = b - a;
+    if (area < 0.f){
+        d = V2f32(-d.x, -d.y);
+    }
+    return((d.y == 0.f && d.x < 0.f) || d.y > 0.f);
+}
+
+internal u32
+sw__lerp_color(u32 c0, u32 c1, u32 c2, f32 w0, f32 w1, f32 w2){
+    u32 result = 0;
+    for (u32 shift = 0; shift < 32; shift += 8){
+        f32 c = (((c0 >> shift) & 0xFF)*w0 +
+                 ((c1 >> shift) & 0xFF)*w1 +
+                 ((c2 >> shift) & 0xFF)*w2);
+        result |= ((u32)clamp(0.f, c + 0.5f, 255.f)) << shift;
+    }
+    return(result);
+}
+
+// NOTE(allen): Any other triangle, with every attribute interpolated and the
+// top left fill rule.
+internal void
+sw__draw_triangle(Rect_i32 clip, SW_Texture *texture, Render_Vertex *v0, Render_Vertex *v1, Render_Vertex *v2){
+    Vec2_f32 a = v0->xy;
+    Vec2_f32 b = v1->xy;
+    Vec2_f32 c = v2->xy;
+    f32 area = sw__edge(a, b, c);
+    if (area != 0.f){
+        f32 sign = (area < 0.f)?-1.f:1.f;
+        b32 top_left_bc = sw__edge_is_top_left(b, c, area);
+        b32 top_left_ca = sw__edge_is_top_left(c, a, area);
+        b32 top_left_ab = sw__edge_is_top_left(a, b, area);
+        
+        i32 px0 = Max(clip.x0, (i32)f32_floor32(Min(a.x, Min(b.x, c.x))));
+        i32 py0 = Max(clip.y0, (i32)f32_floor32(Min(a.y, Min(b.y, c.y))));
+        i32 px1 = Min(clip.x1, (i32)f32_ceil32(Max(a.x, Max(b.x, c.x))) + 1);
+        i32 py1 = Min(clip.y1, (i32)f32_ceil32(Max(a.y, Max(b.y, c.y))) + 1);
+        
+        Vec2_f32 hd0 = sw__adjusted_half_dim(v0);
+        Vec2_f32 hd1 = sw__adjusted_half_dim(v1);
+        Vec2_f32 hd2 = sw__adjusted_half_dim(v2);
+        
+        for (i32 py = py0; py < py1; py += 1){
+            u32 *dst = g_sw.pixels + (i64)py*g_sw.width;
+            for (i32 px = px0; px < px1; px += 1){
+                Vec2_f32 p = V2f32(px + 0.5f, py + 0.5f);
+                f32 e0 = sw__edge(b, c, p)*sign;
+                f32 e1 = sw__edge(c, a, p)*sign;
+                f32 e2 = sw__edge(a, b, p)*sign;
+                b32 inside = ((e0 > 0.f || (e0 == 0.f && top_left_bc)) &&
+                              (e1 > 0.f || (e1 == 0.f && top_left_ca)) &&
+                              (e2 > 0.f || (e2 == 0.f && top_left_ab)));
+                if (inside){
+                    f32 w0 = e0*sign/area;
+                    f32 w1 = e1*sign/area;
+                    f32 w2 = e2*sign/area;
+                    Vec3_f32 uvw = v0->uvw*w0 + v1->uvw*w1 + v2->uvw*w2;
+                    Vec2_f32 half_dim = hd0*w0 + hd1*w1 + hd2*w2;
+                    f32 half_thickness = (v0->half_thickness*w0 + v1->half_thickness*w1 +
+                                          v2->half_thickness*w2);
+                    u32 color = sw__lerp_color(v0->color, v1->color, v2->color, w0, w1, w2);
+                    f32 value = sw__fragment_value(texture, p, uvw, half_dim, half_thickness);
+                    sw__blend(dst + px, color, sw__alpha(color, value));
+                }
+            }
+        }
+    }
+}
+
+internal void
+sw__reserve_vertices(i32 count){
+    if (count > g_sw.vertex_max){
+        if (g_sw.vertices != 0){
+            base_free(g_sw.allocator, g_sw.vertices);
+        }
+        g_sw.vertex_max = count + count/2;
+        g_sw.vertices = base_array(g_sw.allocator, Render_Vertex, g_sw.vertex_max);
+    }
+}
+
+internal void
+sw_render(Render_Target *t){
+    Font_Set *font_set = (Font_Set*)t->font_set;
+    
+    i32 width = t->width;
+    i32 height = t->height;
+    
+    i32 pixel_count = clamp_bot(1, width*height);
+    if (pixel_count > g_sw.pixel_max){
+        if (g_sw.pixels != 0){
+            base_free(g_sw.allocator, g_sw.pixels);
+        }
+        g_sw.pixel_max = pixel_count;
+        g_sw.pixels = base_array(g_sw.allocator, u32, pixel_count);
+    }
+    g_sw.width = width;
+    g_sw.height = height;
+    
+    // NOTE(allen): The same magenta gl_render clears to.
+    for (i32 i = 0; i < width*height; i += 1){
+        g_sw.pixels[i] = 0xFFFF00FF;
+    }
+    
+    for (Render_Free_Texture *free_texture = t->free_texture_first;
+         free_texture != 0;
+         free_texture = free_texture->next){
+        sw__free_texture(free_texture->tex_id);
+    }
+    t->free_texture_first = 0;
+    t->free_texture_last = 0;
+    
+    for (Render_Group *group = t->group_first;
+         group != 0;
+         group = group->next){
+        Rect_i32 box = Ri32(group->clip_box);
+        Rect_i32 clip = {};
+        clip.x0 = clamp(0, box.x0, width);
+        clip.y0 = clamp(0, box.y0, height);
+        clip.x1 = clamp(clip.x0, box.x1, width);
+        clip.y1 = clamp(clip.y0, box.y1, height);
+        
+        i32 vertex_count = group->vertex_list.vertex_count;
+        if (vertex_count > 0 && clip.x0 < clip.x1 && clip.y0 < clip.y1){
+            SW_Texture *texture = 0;
+            Face *face = font_set_face_from_id(font_set, group->face_id);
+            if (face != 0 && 0 < face->texture && face->texture < g_sw.texture_count){
+                texture = &g_sw.textures[face->texture];
+            }
+            
+            sw__reserve_vertices(vertex_count);
+            Render_Vertex *vertices = g_sw.vertices;
+            i32 cursor = 0;
+            for (Render_Vertex_Array_Node *node = group->vertex_list.first;
+                 node != 0;
+                 node = node->next){
+                block_copy_dynamic_array(vertices + cursor, node->vertices, node->vertex_count);
+                cursor += node->vertex_count;
+            }
+            
+            for (i32 i = 0; i + 3 <= vertex_count;){
+                if (i + 6 <= vertex_count && sw__is_simple_quad(vertices + i)){
+                    if (vertices[i].half_thickness >= 0.49f){
+                        sw__draw_shape_quad(clip, vertices + i);
+                    }
+                    else{
+                        sw__draw_glyph_quad(clip, texture, vertices + i);
+                    }
+                    i += 6;
+                }
+                else{
+                    sw__draw_triangle(clip, texture, vertices + i, vertices + i + 1, vertices + i + 2);
+                    i += 3;
+                }
+            }
+        }
+    }
+}
+
+// BOTTOM
+